@@ -47,6 +47,7 @@ def config_etrace(cpu_cls, cpu_list, options):
             cpu.traceListener = m5.objects.ElasticTrace(
                                 instFetchTraceFile = options.inst_trace_file,
                                 dataDepTraceFile = options.data_trace_file,
+                                traceFormat = options.trace_format,
                                 depWindowSize = 3 * cpu.numROBEntries)
             # Make the number of entries in the ROB, LQ and SQ very
             # large so that there are no stalls due to resource
@@ -237,6 +237,26 @@ def addCommonOptions(parser):
                       help="""Data dependency trace file input to
                       Elastic Trace probe in a capture simulation and
                       Trace CPU in a replay simulation""", default="")
+    parser.add_option("--trace-format", action="store", type="choice",
+                      choices=["protobuf", "columnar"], default="protobuf",
+                      help="""Format of the traces captured by the Elastic
+                      Trace probe. The Trace CPU reads either format.""")
+    parser.add_option("--inst-trace-start-tick", action="store", type="int",
+                      default=0, help="""Tick of the instruction fetch
+                      trace to start a replay from (columnar traces only)""")
+    parser.add_option("--data-trace-start-seq-num", action="store",
+                      type="int", default=0, help="""Sequence number of the
+                      data dependency trace to start a replay from
+                      (columnar traces only)""")
+    parser.add_option("--branch-trace-file", action="store",
+                      type="string", default=None, help="""Record the
+                      branches committed by each CPU in a branch trace,
+                      which configs/example/bpred_replay.py replays""")
+    parser.add_option("--dcache-trace-file", action="store",
+                      type="string", default=None, help="""Record the
+                      requests each L1 data cache accepts, with their PC,
+                      in a packet trace, which
+                      configs/example/prefetcher_replay.py replays""")
 
     parser.add_option("-l", "--lpae", action="store_true")
     parser.add_option("-V", "--virtualisation", action="store_true")
@@ -302,6 +322,16 @@ def addCommonOptions(parser):
                       help="Enable basic block profiling for SimPoints")
     parser.add_option("--simpoint-interval", type="int", default=10000000,
                       help="SimPoint interval in num of instructions")
+    parser.add_option("--simpoint-cluster", action="store_true",
+                      help="Choose the SimPoints inside the simulator while "
+                      "profiling (writes simpoints and weights files)")
+    parser.add_option("--simpoint-max-k", type="int", default=30,
+                      help="Maximum number of SimPoint clusters")
+    parser.add_option("--simpoint-per-thread", action="store_true",
+                      help="Profile each hardware thread separately")
+    parser.add_option("--simpoint-online-checkpoints", action="store_true",
+                      help="Take the SimPoint checkpoints while profiling by "
+                      "keeping a candidate checkpoint per cluster")
     parser.add_option("--take-simpoint-checkpoints", action="store", type="string",
         help="<simpoint file,weight file,interval-length,warmup-length>")
     parser.add_option("--restore-simpoint-checkpoint", action="store_true",
@@ -355,6 +385,11 @@ def addCommonOptions(parser):
     parser.add_option("-F", "--fast-forward", action="store", type="string",
         default=None,
         help="Number of instructions to fast forward before switching")
+    parser.add_option("--functional-warming", action="store_true",
+        default=False,
+        help="""Train the branch predictor of the detailed CPU while fast
+                forwarding or restoring with a simple CPU, so that it is warm
+                when switching CPUs.""")
     parser.add_option("-S", "--simpoint", action="store_true", default=False,
         help="""Use workload simpoints as an instruction offset for
                 --checkpoint-restore or --take-checkpoint.""")
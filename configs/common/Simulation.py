@@ -385,6 +385,117 @@ def takeSimpointCheckpoints(simpoints, interval_length, cptdir):
     print("%d checkpoints taken" % num_checkpoints)
     sys.exit(code)
 
+# Fork a process holding the simulator state at the current point. The
+# child waits for the parent to send it the directory of a checkpoint to
+# write, and exits without writing one if the parent closes the pipe
+# instead. It closes the pipes of the other waiting children, so that
+# these see their pipe closed by the parent. Each child writes its output
+# to a directory of its own, named after the interval it starts.
+def forkSimpointCandidate(interval, other_pipes):
+    import os
+
+    read_end, write_end = os.pipe()
+    pid = m5.fork(simout="%%(parent)s/simpoint_candidate.%d" % interval)
+    if pid == 0:
+        os.close(write_end)
+        for pipe in other_pipes:
+            os.close(pipe)
+        with os.fdopen(read_end) as commands:
+            cpt_dir = commands.readline().strip()
+        if cpt_dir:
+            m5.checkpoint(cpt_dir)
+        os._exit(0)
+
+    os.close(read_end)
+    return (pid, write_end)
+
+# Let a waiting child write its checkpoint, or discard it if no
+# directory is given, and wait for it to exit.
+def releaseSimpointCandidate(candidate, cpt_dir=None):
+    import os
+
+    pid, pipe = candidate
+    if cpt_dir:
+        os.write(pipe, (cpt_dir + "\n").encode())
+    os.close(pipe)
+    os.waitpid(pid, 0)
+
+# Take SimPoint checkpoints in the profiling run. Rather than writing a
+# checkpoint at the start of every interval, the simulator is forked
+# there and the child process waits. If the SimPoint probe reports at the
+# end of the interval that it became the best candidate of one of its
+# online clusters, the child is kept in place of the cluster's previous
+# candidate, otherwise it is discarded. When the simulation ends, only
+# the candidates chosen as simulation points write their checkpoints,
+# named so that they can be restored with --restore-simpoint-checkpoint.
+# This keeps up to one waiting process per online cluster, which share
+# the memory of the simulator until it changes.
+def takeOnlineSimpointCheckpoints(testsys, interval_length, cptdir):
+    import os
+
+    cptdir = os.path.abspath(cptdir)
+    probe = testsys.cpu[0].probeListener
+
+    # Waiting child, interval and committed instruction count at the
+    # start of the interval, of the candidate of each online cluster
+    candidates = {}
+
+    interval = 0
+    start_inst = testsys.cpu[0].totalInsts()
+    pending = forkSimpointCandidate(interval, [])
+    while True:
+        exit_event = m5.simulate()
+        exit_cause = exit_event.getCause()
+        if exit_cause == "checkpoint":
+            print("Found 'checkpoint' exit event...ignoring...")
+            continue
+        if exit_cause != "simpoint interval boundary":
+            break
+
+        cluster = exit_event.getCode()
+        if cluster >= 0:
+            if cluster in candidates:
+                releaseSimpointCandidate(candidates[cluster][0])
+            candidates[cluster] = (pending, interval, start_inst)
+        else:
+            releaseSimpointCandidate(pending)
+
+        # Remember where the interval starts in terms of committed
+        # instructions, as intervals end on basic block boundaries and
+        # are thus slightly longer than the interval length
+        interval += 1
+        start_inst = testsys.cpu[0].totalInsts()
+        pending = forkSimpointCandidate(interval,
+            [c[0][1] for c in candidates.values()])
+    releaseSimpointCandidate(pending)
+
+    probe.dumpSimPoints()
+    outdir = m5.options.outdir if m5.options.outdir else getcwd()
+    simpoint_file = open(joinpath(outdir, probe.simpoints_file))
+    weight_file = open(joinpath(outdir, probe.weights_file))
+    chosen = {}
+    for line, weight_line in zip(simpoint_file, weight_file):
+        interval, index = [int(x) for x in line.split()]
+        chosen[interval] = (index, float(weight_line.split()[0]))
+
+    num_checkpoints = 0
+    for candidate, interval, start_inst in candidates.values():
+        if interval not in chosen:
+            releaseSimpointCandidate(candidate)
+            continue
+
+        index, weight = chosen[interval]
+        releaseSimpointCandidate(candidate, joinpath(cptdir,
+            "cpt.simpoint_%02d_inst_%d_weight_%f_interval_%d_warmup_%d"
+            % (index, start_inst, weight, interval_length, 0)))
+        print("Checkpoint #%d written. start inst:%d weight:%f" %
+            (index, start_inst, weight))
+        num_checkpoints += 1
+
+    print('Exiting @ tick %i because %s' % (m5.curTick(), exit_cause))
+    print("%d checkpoints taken" % num_checkpoints)
+    sys.exit(exit_event.getCode())
+
 def restoreSimpointCheckpoint():
     exit_event = m5.simulate()
     exit_cause = exit_event.getCause()
@@ -488,6 +599,14 @@ def run(options, root, testsys, cpu_class):
                     options.indirect_bp_type)
                 switch_cpus[i].branchPred.indirectBranchPred = \
                     IndirectBPClass()
+            if options.functional_warming:
+                if not isinstance(testsys.cpu[i], BaseSimpleCPU):
+                    fatal("--functional-warming requires a simple CPU to "
+                          "fast forward or restore with")
+                # The simple CPU trains the predictor of the detailed CPU
+                # on every committed branch. The predictor is owned by the
+                # detailed CPU, so it keeps its state across the switch.
+                testsys.cpu[i].branchPred = switch_cpus[i].branchPred
 
         # If elastic tracing is enabled attach the elastic trace probe
         # to the switch CPUs
@@ -612,6 +731,10 @@ def run(options, root, testsys, cpu_class):
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
     root.apply_config(options.param)
+    # SimPoint candidates are kept in forked processes, which requires
+    # the listeners to be disabled
+    if options.simpoint_online_checkpoints:
+        m5.disableAllListeners()
     m5.instantiate(checkpoint_dir)
 
     # Initialization is complete.  If we're not in control of simulation
@@ -709,6 +832,11 @@ def run(options, root, testsys, cpu_class):
     elif options.take_simpoint_checkpoints != None:
         takeSimpointCheckpoints(simpoints, interval_length, cptdir)
 
+    # Take SimPoint checkpoints while profiling
+    elif options.simpoint_online_checkpoints:
+        takeOnlineSimpointCheckpoints(testsys, options.simpoint_interval,
+                                      cptdir)
+
     # Restore from SimPoint checkpoints
     elif options.restore_simpoint_checkpoint:
         restoreSimpointCheckpoint()
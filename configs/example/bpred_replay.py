@@ -0,0 +1,68 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replay a branch trace, as recorded with the --branch-trace-file option
+# of se.py, on a branch predictor without simulating the CPU. The
+# mispredictions per thousand instructions and the predictions per host
+# second are reported as the stats of the replay object.
+
+import argparse
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+
+addToPath('../')
+
+from common import ObjectList
+
+parser = argparse.ArgumentParser(
+    description="Replay a branch trace on a branch predictor")
+parser.add_argument("trace_file", help="Branch trace to replay")
+parser.add_argument("--bp-type", choices=ObjectList.bp_list.get_names(),
+                    default="LTAGE", help="Branch predictor to evaluate")
+parser.add_argument("--indirect-bp-type",
+                    choices=ObjectList.indirect_bp_list.get_names(),
+                    default=None, help="Indirect branch predictor to use")
+parser.add_argument("--max-branches", type=int, default=0,
+                    help="Number of branches to replay, 0 for all")
+
+args = parser.parse_args()
+
+bpred = ObjectList.bp_list.get(args.bp_type)()
+if args.indirect_bp_type:
+    bpred.indirectBranchPred = \
+        ObjectList.indirect_bp_list.get(args.indirect_bp_type)()
+
+root = Root(full_system=False)
+root.replay = BranchTraceReplay(branchPred=bpred,
+                                traceFile=args.trace_file,
+                                maxBranches=args.max_branches)
+
+m5.instantiate()
+exit_event = m5.simulate()
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
@@ -0,0 +1,113 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replay a branch trace, as recorded with the --branch-trace-file option
+
+# Drive a single cache with random traffic and report how long the host
+# takes to simulate it. This is meant to compare tag stores and
+# replacement policies, e.g. a BaseSetAssoc against a PackedSetAssoc,
+# whose replacement policy keeps the replacement data of all blocks in
+# arrays of its own rather than in a heap object per block. The traffic
+# spans a working set larger than the cache, so that most accesses look
+# up a set, miss, and choose a victim.
+
+import argparse
+import time
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, convert
+
+addToPath('../')
+
+from common import ObjectList
+
+parser = argparse.ArgumentParser(
+    description="Benchmark the tag lookup and replacement of a cache")
+parser.add_argument("--tags", choices=["BaseSetAssoc", "PackedSetAssoc"],
+                    default="PackedSetAssoc", help="Tag store to use")
+parser.add_argument("--repl", choices=ObjectList.rp_list.get_names(),
+                    default="LRURP", help="Replacement policy to use")
+parser.add_argument("--size", default="1MB", help="Cache size")
+parser.add_argument("--assoc", type=int, default=16,
+                    help="Cache associativity")
+parser.add_argument("--working-set", default="4MB",
+                    help="Size of the address range accessed")
+parser.add_argument("--rd-perc", type=int, default=70,
+                    help="Percentage of read accesses")
+parser.add_argument("--duration", default="10ms",
+                    help="Simulated time to generate traffic for")
+
+args = parser.parse_args()
+
+system = System(membus=SystemXBar())
+system.clk_domain = SrcClockDomain(clock='2GHz',
+                                   voltage_domain=VoltageDomain())
+system.mem_ranges = [AddrRange(args.working_set)]
+system.mmap_using_noreserve = True
+
+system.tgen = PyTrafficGen()
+
+repl = ObjectList.rp_list.get(args.repl)()
+if args.repl == "TreePLRURP":
+    repl.num_leaves = args.assoc
+
+system.cache = Cache(size=args.size, assoc=args.assoc,
+                     tag_latency=2, data_latency=2, response_latency=2,
+                     mshrs=16, tgts_per_mshr=8, writeback_clean=False,
+                     replacement_policy=repl)
+system.cache.tags = getattr(m5.objects, args.tags)()
+
+system.tgen.port = system.cache.cpu_side
+system.cache.mem_side = system.membus.slave
+
+system.mem = SimpleMemory(range=system.mem_ranges[0], latency="10ns")
+system.mem.port = system.membus.master
+system.system_port = system.membus.slave
+
+root = Root(full_system=False, system=system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+duration = m5.ticks.fromSeconds(convert.anyToLatency(args.duration))
+block_size = system.cache_line_size.value
+
+def traffic():
+    yield system.tgen.createRandom(duration, 0, system.mem_ranges[0].end,
+                                   block_size, 1000, 1000, args.rd_perc, 0)
+    yield system.tgen.createExit(0)
+
+system.tgen.start(traffic())
+
+start = time.time()
+exit_event = m5.simulate()
+host_seconds = time.time() - start
+
+print("%s with %s: %d ways, %s, %.3f host seconds" %
+      (args.tags, args.repl, args.assoc, args.size, host_seconds))
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
@@ -0,0 +1,160 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Drive a cache with a compressor with read traffic and report how many
+# lines the host compresses per second. The memory is filled with an
+# image of cache lines of various kinds, e.g., zeroed, repeated values,
+# narrow values or pointers into a small region, so that every pattern
+# of the compressors is exercised. The traffic spans a working set
+# larger than the cache, so that most accesses miss and the line filled
+# in is compressed. Comparing the rate before and after a change to a
+# compressor gives its speedup, and the compression statistics, which
+# must not change, are printed along to check that.
+
+import argparse
+import os
+import random
+import struct
+import time
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, convert
+
+addToPath('../')
+
+from common import ObjectList
+
+compressor_list = ObjectList.ObjectList(
+    getattr(m5.objects, 'BaseCacheCompressor', None))
+
+parser = argparse.ArgumentParser(
+    description="Benchmark the compression throughput of a cache compressor")
+parser.add_argument("--compressor", choices=compressor_list.get_names(),
+                    default="BDI", help="Compressor to use")
+parser.add_argument("--data", choices=["mixed", "zero", "random"],
+                    default="mixed", help="Kind of data in memory")
+parser.add_argument("--size", default="256kB", help="Cache size")
+parser.add_argument("--assoc", type=int, default=8,
+                    help="Cache associativity")
+parser.add_argument("--working-set", default="16MB",
+                    help="Size of the address range accessed")
+parser.add_argument("--duration", default="10ms",
+                    help="Simulated time to generate traffic for")
+parser.add_argument("--seed", type=int, default=1,
+                    help="Seed of the memory image")
+
+args = parser.parse_args()
+
+def mixed_line(rng, qwords):
+    kind = rng.randrange(6)
+    if kind == 0:
+        return [0] * qwords
+    elif kind == 1:
+        return [rng.getrandbits(64)] * qwords
+    elif kind == 2:
+        base = rng.getrandbits(64)
+        return [(base + rng.randrange(-256, 256)) % 2**64
+                for i in range(qwords)]
+    elif kind == 3:
+        return [rng.randrange(300) | rng.randrange(70000) << 32
+                for i in range(qwords)]
+    elif kind == 4:
+        return [0 if rng.randrange(3) else
+                rng.getrandbits(64) >> rng.randrange(64)
+                for i in range(qwords)]
+    else:
+        return [rng.getrandbits(64) for i in range(qwords)]
+
+def write_image(path, size, block_size):
+    rng = random.Random(args.seed)
+    qwords = block_size // 8
+    with open(path, "wb") as image:
+        for line in range(size // block_size):
+            if args.data == "zero":
+                values = [0] * qwords
+            elif args.data == "random":
+                values = [rng.getrandbits(64) for i in range(qwords)]
+            else:
+                values = mixed_line(rng, qwords)
+            image.write(struct.pack("<%dQ" % qwords, *values))
+
+system = System(membus=SystemXBar())
+system.clk_domain = SrcClockDomain(clock='2GHz',
+                                   voltage_domain=VoltageDomain())
+system.mem_ranges = [AddrRange(args.working_set)]
+system.mmap_using_noreserve = True
+
+system.tgen = PyTrafficGen()
+
+system.cache = Cache(size=args.size, assoc=args.assoc,
+                     tag_latency=2, data_latency=2, response_latency=2,
+                     mshrs=16, tgts_per_mshr=8, writeback_clean=False)
+system.cache.tags = CompressedTags()
+system.cache.compressor = compressor_list.get(args.compressor)()
+
+system.tgen.port = system.cache.cpu_side
+system.cache.mem_side = system.membus.slave
+
+image = os.path.join(m5.options.outdir, "compressor_bench.img")
+write_image(image, system.mem_ranges[0].size(),
+            system.cache_line_size.value)
+
+system.mem = SimpleMemory(range=system.mem_ranges[0], latency="10ns",
+                          image_file=image)
+system.mem.port = system.membus.master
+system.system_port = system.membus.slave
+
+root = Root(full_system=False, system=system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+duration = m5.ticks.fromSeconds(convert.anyToLatency(args.duration))
+block_size = system.cache_line_size.value
+
+def traffic():
+    yield system.tgen.createRandom(duration, 0, system.mem_ranges[0].end,
+                                   block_size, 1000, 1000, 100, 0)
+    yield system.tgen.createExit(0)
+
+system.tgen.start(traffic())
+
+start = time.time()
+exit_event = m5.simulate()
+host_seconds = time.time() - start
+
+compressor = system.cache.compressor.getCCObject()
+compressions = compressor.resolveStat("compressions").value
+size_bits = compressor.resolveStat("compressionSizeBits").value
+
+print("%s on %s data: %d lines compressed to %.1f bits on average" %
+      (args.compressor, args.data, compressions,
+       size_bits / compressions if compressions else 0))
+print("%.3f host seconds, %.0f lines/s" %
+      (host_seconds, compressions / host_seconds))
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
@@ -110,6 +110,8 @@ for cpu in system.cpu:
 # Assign input trace files to the Trace CPU
 system.cpu.instTraceFile=options.inst_trace_file
 system.cpu.dataTraceFile=options.data_trace_file
+system.cpu.instTraceStartTick=options.inst_trace_start_tick
+system.cpu.dataTraceStartSeqNum=options.data_trace_start_seq_num
 
 # Configure the classic memory system options
 MemClass = Simulation.setMemClass(options)
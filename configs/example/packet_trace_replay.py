@@ -0,0 +1,98 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replay a packet trace with a traffic generator, to measure the rate at
+# which the host replays it, as reported by the hostPacketRate stat of
+# the generator. The trace is either a protobuf packet trace, as
+# recorded by a MemTraceProbe, or a binary packet trace as converted by
+# util/encode_binary_packet_trace.py, which the generator maps into
+# memory rather than decodes. Packets recorded at the same tick can be
+# sent in a single update of the generator.
+
+import argparse
+import time
+
+import m5
+from m5.objects import *
+from m5.util import convert
+
+parser = argparse.ArgumentParser(
+    description="Replay a packet trace and report the replay rate")
+parser.add_argument("trace", help="Packet trace to replay")
+parser.add_argument("--mem-size", default="4GB",
+                    help="Size of the memory the trace is replayed to")
+parser.add_argument("--mem-latency", default="30ns",
+                    help="Latency of the memory")
+parser.add_argument("--mem-bandwidth", default="1024GB/s",
+                    help="Bandwidth of the memory")
+parser.add_argument("--max-packets-per-update", type=int, default=1,
+                    help="Packets the generator may send in one update")
+parser.add_argument("--max-outstanding", type=int, default=0,
+                    help="Maximum outstanding requests, 0 for unlimited")
+parser.add_argument("--duration", default="1s",
+                    help="Maximum simulated time to replay the trace for")
+
+args = parser.parse_args()
+
+system = System(membus=SystemXBar(width=64))
+system.clk_domain = SrcClockDomain(clock='2GHz',
+                                   voltage_domain=VoltageDomain())
+system.mem_ranges = [AddrRange(args.mem_size)]
+system.mmap_using_noreserve = True
+
+system.tgen = PyTrafficGen(
+    max_packets_per_update=args.max_packets_per_update,
+    max_outstanding_reqs=args.max_outstanding)
+system.tgen.port = system.membus.cpu_side_ports
+
+system.mem = SimpleMemory(range=system.mem_ranges[0],
+                          latency=args.mem_latency,
+                          bandwidth=args.mem_bandwidth)
+system.mem.port = system.membus.mem_side_ports
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system=False, system=system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+duration = m5.ticks.fromSeconds(convert.anyToLatency(args.duration))
+
+def traffic():
+    yield system.tgen.createTrace(duration, args.trace)
+    yield system.tgen.createExit(0)
+
+system.tgen.start(traffic())
+
+start = time.time()
+exit_event = m5.simulate()
+host_seconds = time.time() - start
+
+m5.stats.dump()
+
+print("Replayed %s in %.3f host seconds" % (args.trace, host_seconds))
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
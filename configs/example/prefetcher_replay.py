@@ -0,0 +1,90 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replay a packet trace of the requests a cache accepted, as recorded with
+# the --dcache-trace-file option of se.py, on a prefetcher without
+# simulating the CPU or the memory system. The prefetcher trains on a
+# model that only keeps the tags of the cache. The accuracy, coverage and
+# timeliness of the prefetches, and the host time the prefetcher takes
+# per request, are reported as the stats of the replay object. Each run
+# takes seconds, so that configurations of a prefetcher can be swept by
+# running this script once for every configuration.
+
+import argparse
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+
+addToPath('../')
+
+from common import ObjectList
+
+parser = argparse.ArgumentParser(
+    description="Replay a packet trace on a prefetcher")
+parser.add_argument("trace_file", help="Packet trace to replay")
+parser.add_argument("--pf-type", choices=ObjectList.hwp_list.get_names(),
+                    default="StridePrefetcher",
+                    help="Prefetcher to evaluate")
+parser.add_argument("--pf-param", action="append", default=[],
+                    metavar="NAME=VALUE",
+                    help="Set a parameter of the prefetcher, e.g. "
+                    "degree=4, can be repeated")
+parser.add_argument("--size", default="32kB",
+                    help="Size of the modelled cache")
+parser.add_argument("--assoc", type=int, default=8,
+                    help="Associativity of the modelled cache")
+parser.add_argument("--fill-latency", default="50ns",
+                    help="Time from a miss or prefetch to its fill")
+parser.add_argument("--clock", default="2GHz",
+                    help="Clock of the prefetcher, as of the cache")
+parser.add_argument("--cacheline-size", type=int, default=64,
+                    help="Block size of the modelled cache")
+parser.add_argument("--max-accesses", type=int, default=0,
+                    help="Number of requests to replay, 0 for all")
+
+args = parser.parse_args()
+
+prefetcher = ObjectList.hwp_list.get(args.pf_type)()
+for param in args.pf_param:
+    name, _, value = param.partition("=")
+    setattr(prefetcher, name, value)
+
+system = System(cache_line_size=args.cacheline_size)
+system.clk_domain = SrcClockDomain(clock=args.clock,
+                                   voltage_domain=VoltageDomain())
+system.replay = PrefetcherTraceReplay(prefetcher=prefetcher,
+                                      trace_file=args.trace_file,
+                                      size=args.size, assoc=args.assoc,
+                                      fill_latency=args.fill_latency,
+                                      max_accesses=args.max_accesses)
+
+root = Root(full_system=False, system=system)
+
+m5.instantiate()
+exit_event = m5.simulate()
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
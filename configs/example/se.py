@@ -196,6 +196,12 @@ system.cpu_clk_domain = SrcClockDomain(clock = options.cpu_clock,
 if options.elastic_trace_en:
     CpuConfig.config_etrace(CPUClass, system.cpu, options)
 
+# If branch tracing is enabled, attach a branch trace probe to every cpu
+if options.branch_trace_file:
+    for i, cpu in enumerate(system.cpu):
+        cpu.branch_trace = BranchTraceProbe(manager=cpu,
+            traceFile="%s.%d" % (options.branch_trace_file, i))
+
 # All cpus belong to a common cpu_clk_domain, therefore running at a common
 # frequency.
 for cpu in system.cpu:
@@ -216,6 +222,8 @@ if options.simpoint_profile:
         fatal("SimPoint/BPProbe should be done with an atomic cpu")
     if np > 1:
         fatal("SimPoint generation not supported with more than one CPUs")
+if options.simpoint_online_checkpoints and not options.simpoint_profile:
+    fatal("--simpoint-online-checkpoints requires --simpoint-profile")
 
 for i in range(np):
     if options.smt:
@@ -226,7 +234,11 @@ for i in range(np):
         system.cpu[i].workload = multiprocesses[i]
 
     if options.simpoint_profile:
-        system.cpu[i].addSimPointProbe(options.simpoint_interval)
+        system.cpu[i].addSimPointProbe(options.simpoint_interval,
+            cluster_intervals=bool(options.simpoint_cluster),
+            max_k=options.simpoint_max_k,
+            per_thread=bool(options.simpoint_per_thread),
+            take_checkpoints=bool(options.simpoint_online_checkpoints))
 
     if options.checker:
         system.cpu[i].addCheckerCpu()
@@ -266,6 +278,16 @@ else:
     MemConfig.config_mem(options, system)
     config_filesystem(system, options)
 
+    # If cache tracing is enabled, record the requests of every L1 data
+    # cache, along with their PC
+    if options.dcache_trace_file:
+        if not options.caches:
+            fatal("--dcache-trace-file requires --caches")
+        for i, cpu in enumerate(system.cpu):
+            cpu.dcache_trace = MemTraceProbe(manager=cpu.dcache,
+                probe_name="PktRequestCPU", with_pc=True,
+                trace_file="%s.%d" % (options.dcache_trace_file, i))
+
 if options.wait_gdb:
     for cpu in system.cpu:
         cpu.wait_for_remote_gdb = True
@@ -76,6 +76,10 @@ parser.add_option("--addr-map", type="choice",
                   choices=ObjectList.dram_addr_map_list.get_names(),
                   default="RoRaBaCoCh", help = "NVM address map policy")
 
+parser.add_option("--analytical-timing", action="store_true",
+                  help = "Compute the NVM timing analytically at request \
+                          arrival rather than scheduling the NVM commands")
+
 (options, args) = parser.parse_args()
 
 if args:
@@ -119,6 +123,10 @@ system.mem_ctrls[0].nvm.null = True
 # Set the address mapping based on input argument
 system.mem_ctrls[0].nvm.addr_mapping = options.addr_map
 
+# Optionally use the analytical timing, e.g. to compare it against the
+# detailed command scheduling
+system.mem_ctrls[0].analytical_timing = bool(options.analytical_timing)
+
 # stay in each state for 0.25 ms, long enough to warm things up, and
 # short enough to avoid hitting a refresh
 period = 250000000
@@ -493,6 +493,12 @@ TLB::takeOverFrom(BaseTLB *_otlb)
         stage2Req = otlb->stage2Req;
         stage2DescReq = otlb->stage2DescReq;
 
+        /* Carry the cached translations over, most recently used
+         * first, so that the new CPU doesn't start with a cold TLB.
+         */
+        for (int i = 0; i < size; ++i)
+            table[i] = i < otlb->size ? otlb->table[i] : TlbEntry();
+
         /* Sync the stage2 MMU if they exist in both
          * the old CPU and the new
          */
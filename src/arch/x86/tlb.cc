@@ -37,8 +37,10 @@
 
 #include "arch/x86/tlb.hh"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 #include "arch/x86/faults.hh"
 #include "arch/x86/insts/microldstop.hh"
@@ -139,6 +141,28 @@ TLB::flushAll()
     }
 }
 
+void
+TLB::takeOverFrom(BaseTLB *otlb)
+{
+    TLB *old_tlb = dynamic_cast<TLB *>(otlb);
+    panic_if(!old_tlb, "Incompatible TLB type!");
+
+    flushAll();
+
+    // Re-insert the valid entries from the least to the most recently
+    // used one, so that the replacement order is carried over as well.
+    std::vector<const TlbEntry *> entries;
+    for (const auto &entry : old_tlb->tlb) {
+        if (entry.trieHandle)
+            entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const TlbEntry *a, const TlbEntry *b)
+              { return a->lruSeq < b->lruSeq; });
+    for (const auto *entry : entries)
+        insert(entry->vaddr, *entry);
+}
+
 void
 TLB::setConfigAddress(uint32_t addr)
 {
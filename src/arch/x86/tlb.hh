@@ -68,7 +68,7 @@ namespace X86ISA
         typedef X86TLBParams Params;
         TLB(const Params &p);
 
-        void takeOverFrom(BaseTLB *otlb) override {}
+        void takeOverFrom(BaseTLB *otlb) override;
 
         TlbEntry *lookup(Addr va, bool update_lru = true);
 
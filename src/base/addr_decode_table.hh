@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_ADDR_DECODE_TABLE_HH__
+#define __BASE_ADDR_DECODE_TABLE_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/types.hh"
+
+/**
+ * The AddrDecodeTable maps non-overlapping address ranges to values,
+ * e.g. port identifiers, and is meant for decoding addresses on every
+ * access rather than for managing the ranges. The ranges are compiled
+ * into a flat array of segments sorted by start address. Interleaved
+ * ranges covering the same span with the same interleaving bits share
+ * a single segment, with a value per stripe, and a lookup computes
+ * the stripe of the address directly. A lookup thus takes a binary
+ * search over the segments followed by an index, no matter how many
+ * interleaved ranges there are.
+ */
+template <typename V>
+class AddrDecodeTable
+{
+  private:
+    /** A span of the address space holding one or more ranges. */
+    struct Segment
+    {
+        /** The first range added for the segment. */
+        AddrRange range;
+        /** The size of the contiguous chunks of a stripe. */
+        Addr granularity;
+        /** Index of the first stripe in the array of targets. */
+        size_t firstTarget;
+    };
+
+    /** The value of a stripe of a segment, if there is one. */
+    struct Target
+    {
+        V value;
+        bool valid;
+    };
+
+    /** Start addresses of the segments, kept apart for searching. */
+    std::vector<Addr> starts;
+    std::vector<Segment> segments;
+    std::vector<Target> targets;
+    size_t numRanges = 0;
+
+    /**
+     * Find the segment an address falls in.
+     *
+     * @return The index of the segment, or -1 if there is none
+     */
+    int
+    findSegment(Addr a) const
+    {
+        auto it = std::upper_bound(starts.begin(), starts.end(), a);
+        if (it == starts.begin())
+            return -1;
+        const int idx = (it - starts.begin()) - 1;
+        return a < segments[idx].range.end() ? idx : -1;
+    }
+
+  public:
+    /**
+     * Add a range. Interleaved ranges can only be added alongside
+     * ranges that cover the same span with the same interleaving
+     * bits.
+     *
+     * @param r The range to add
+     * @param v The value of the range
+     * @return False if the range overlaps a range already added
+     */
+    bool
+    insert(const AddrRange &r, const V &v)
+    {
+        // find the first segment ending after the start of the range
+        auto it = std::upper_bound(starts.begin(), starts.end(),
+                                   r.start());
+        size_t idx = it - starts.begin();
+        if (idx > 0 && r.start() < segments[idx - 1].range.end())
+            idx--;
+
+        if (idx < segments.size() &&
+            segments[idx].range.start() < r.end()) {
+            // only a stripe of the same interleaving may go in an
+            // existing segment
+            const Segment &seg = segments[idx];
+            if (!r.interleaved() || !seg.range.mergesWith(r))
+                return false;
+            Target &target = targets[seg.firstTarget + r.stripe()];
+            if (target.valid)
+                return false;
+            target = Target{v, true};
+        } else {
+            starts.insert(starts.begin() + idx, r.start());
+            segments.insert(segments.begin() + idx,
+                            Segment{r, r.granularity(), targets.size()});
+            targets.resize(targets.size() + r.stripes(), Target{V(), false});
+            targets[segments[idx].firstTarget + r.stripe()] =
+                Target{v, true};
+        }
+        numRanges++;
+        return true;
+    }
+
+    /**
+     * Find the value of the range that contains the given range, that
+     * is the range every address of which is in one of the ranges of
+     * the table.
+     *
+     * @param r A range, which must not be interleaved
+     * @return The value of the containing range, or nullptr if none
+     */
+    const V *
+    contains(const AddrRange &r) const
+    {
+        assert(!r.interleaved());
+        const int idx = findSegment(r.start());
+        if (idx < 0)
+            return nullptr;
+
+        const Segment &seg = segments[idx];
+        const Addr last = r.end() - 1;
+        if (last >= seg.range.end())
+            return nullptr;
+
+        uint32_t stripe = 0;
+        if (seg.range.interleaved()) {
+            // the range must also be within a chunk of the stripe
+            stripe = seg.range.stripeOf(r.start());
+            if (seg.range.stripeOf(last) != stripe ||
+                r.size() > seg.granularity) {
+                return nullptr;
+            }
+        }
+        const Target &target = targets[seg.firstTarget + stripe];
+        return target.valid ? &target.value : nullptr;
+    }
+
+    /**
+     * Find the value of the range that contains an address.
+     *
+     * @param a An address
+     * @return The value of the containing range, or nullptr if none
+     */
+    const V *
+    contains(Addr a) const
+    {
+        const int idx = findSegment(a);
+        if (idx < 0)
+            return nullptr;
+        const Segment &seg = segments[idx];
+        const Target &target =
+            targets[seg.firstTarget + seg.range.stripeOf(a)];
+        return target.valid ? &target.value : nullptr;
+    }
+
+    /** Remove all ranges. */
+    void
+    clear()
+    {
+        starts.clear();
+        segments.clear();
+        targets.clear();
+        numRanges = 0;
+    }
+
+    /** The number of ranges added. */
+    size_t size() const { return numRanges; }
+
+    bool empty() const { return numRanges == 0; }
+};
+
+#endif // __BASE_ADDR_DECODE_TABLE_HH__
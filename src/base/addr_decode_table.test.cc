@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "base/addr_decode_table.hh"
+#include "base/addr_range_map.hh"
+
+/** Ranges that are not interleaved are found by address and range. */
+TEST(AddrDecodeTableTest, ContiguousRanges)
+{
+    AddrDecodeTable<int> table;
+    EXPECT_TRUE(table.empty());
+    EXPECT_TRUE(table.insert(RangeIn(0x100, 0x1ff), 1));
+    EXPECT_TRUE(table.insert(RangeIn(0x400, 0x4ff), 2));
+    EXPECT_TRUE(table.insert(RangeIn(0x200, 0x2ff), 3));
+    EXPECT_EQ(3, table.size());
+
+    EXPECT_EQ(nullptr, table.contains(Addr(0xff)));
+    EXPECT_EQ(1, *table.contains(Addr(0x100)));
+    EXPECT_EQ(3, *table.contains(Addr(0x2ff)));
+    EXPECT_EQ(nullptr, table.contains(Addr(0x300)));
+    EXPECT_EQ(2, *table.contains(Addr(0x480)));
+    EXPECT_EQ(nullptr, table.contains(Addr(0x500)));
+
+    EXPECT_EQ(1, *table.contains(RangeSize(0x1c0, 0x40)));
+    // a range straddling two ranges is not contained in either
+    EXPECT_EQ(nullptr, table.contains(RangeSize(0x1f0, 0x20)));
+
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(nullptr, table.contains(Addr(0x100)));
+}
+
+/** Overlapping ranges are rejected. */
+TEST(AddrDecodeTableTest, Overlaps)
+{
+    AddrDecodeTable<int> table;
+    EXPECT_TRUE(table.insert(RangeIn(0x100, 0x1ff), 1));
+    EXPECT_FALSE(table.insert(RangeIn(0x180, 0x27f), 2));
+    EXPECT_FALSE(table.insert(RangeIn(0x0, 0x100), 2));
+    EXPECT_FALSE(table.insert(RangeIn(0x0, 0x1000), 2));
+    EXPECT_TRUE(table.insert(RangeIn(0x200, 0x2ff), 2));
+
+    // the same stripe of an interleaving cannot be added twice, and
+    // a different interleaving cannot share the span
+    const std::vector<Addr> masks = {1 << 6};
+    EXPECT_TRUE(table.insert(AddrRange(0x1000, 0x2000, masks, 0), 3));
+    EXPECT_FALSE(table.insert(AddrRange(0x1000, 0x2000, masks, 0), 4));
+    EXPECT_FALSE(table.insert(AddrRange(0x1000, 0x2000, {1 << 7}, 1), 4));
+    EXPECT_TRUE(table.insert(AddrRange(0x1000, 0x2000, masks, 1), 4));
+    EXPECT_EQ(4, table.size());
+}
+
+/** The stripes of an interleaving are told apart by address. */
+TEST(AddrDecodeTableTest, InterleavedRanges)
+{
+    AddrDecodeTable<int> table;
+    // four channels interleaved at 256 bytes, with the upper bit also
+    // hashed with bit 12
+    const std::vector<Addr> masks = {1 << 8, 1 << 9 | 1 << 12};
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(table.insert(AddrRange(0, 0x10000, masks, i), i));
+    }
+
+    for (Addr a = 0; a < 0x10000; a += 0x40) {
+        const int expected = bits(a, 8) | (bits(a, 9) ^ bits(a, 12)) << 1;
+        ASSERT_NE(nullptr, table.contains(a));
+        EXPECT_EQ(expected, *table.contains(a));
+        EXPECT_EQ(expected, *table.contains(RangeSize(a, 0x40)));
+    }
+    // a range crossing a chunk boundary is in no single stripe
+    EXPECT_EQ(nullptr, table.contains(RangeSize(0xf0, 0x20)));
+    EXPECT_EQ(nullptr, table.contains(Addr(0x10000)));
+}
+
+/** Stripes that have not been added are not found. */
+TEST(AddrDecodeTableTest, MissingStripes)
+{
+    AddrDecodeTable<int> table;
+    const std::vector<Addr> masks = {1 << 6};
+    EXPECT_TRUE(table.insert(AddrRange(0, 0x1000, masks, 1), 1));
+    EXPECT_EQ(nullptr, table.contains(Addr(0x0)));
+    EXPECT_EQ(1, *table.contains(Addr(0x40)));
+}
+
+/** Lookups agree with an AddrRangeMap holding the same ranges. */
+TEST(AddrDecodeTableTest, MatchesAddrRangeMap)
+{
+    AddrDecodeTable<int> table;
+    AddrRangeMap<int> map;
+    auto add = [&](const AddrRange &r, int v) {
+        ASSERT_TRUE(table.insert(r, v));
+        ASSERT_NE(map.end(), map.insert(r, v));
+    };
+    const std::vector<Addr> masks = {1 << 7, 1 << 8};
+    for (int i = 0; i < 4; i++)
+        add(AddrRange(0x10000, 0x20000, masks, i), i);
+    add(RangeSize(0x0, 0x8000), 4);
+    add(RangeSize(0x20000, 0x1000), 5);
+    add(RangeSize(0x30000, 0x10000), 6);
+
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < 100000; i++) {
+        const Addr a = rng() % 0x48000;
+        const Addr size = 1 << (rng() % 9);
+        const AddrRange r = RangeSize(a, size);
+        auto it = map.contains(r);
+        const int *v = table.contains(r);
+        ASSERT_EQ(it == map.end(), v == nullptr) << r.to_string();
+        if (v) {
+            ASSERT_EQ(it->second, *v);
+        }
+    }
+}
@@ -287,6 +287,41 @@ class AddrRange
      */
     uint32_t stripes() const { return ULL(1) << masks.size(); }
 
+    /**
+     * Determine the stripe of the interleaving this range holds, i.e.
+     * the value the interleaving bits of an address have to take for
+     * the address to be in this range.
+     *
+     * @return The stripe of the range, or 0 if it is not interleaved
+     *
+     * @ingroup api_addr_range
+     */
+    uint32_t stripe() const { return intlvMatch; }
+
+    /**
+     * Determine the stripe an address falls in, by computing the
+     * interleaving bits of the address. The address does not have to
+     * be within the range.
+     *
+     * @param a Address to compute the stripe of
+     * @return The stripe of the address, or 0 if not interleaved
+     *
+     * @ingroup api_addr_range
+     */
+    uint32_t stripeOf(Addr a) const
+    {
+        uint32_t sel = 0;
+        for (int i = 0; i < masks.size(); i++) {
+            Addr masked = a & masks[i];
+            // The result of an xor operation is 1 if the number
+            // of bits set is odd or 0 othersize, thefore it
+            // suffices to count the number of bits set to
+            // determine the i-th bit of sel.
+            sel |= (popCount(masked) % 2) << i;
+        }
+        return sel;
+    }
+
     /**
      * Get the size of the address range. For a case where
      * interleaving is used we make the simplifying assumption that
@@ -438,19 +473,7 @@ class AddrRange
         // no interleaving, or with interleaving also if the selected
         // bits from the address match the interleaving value
         bool in_range = a >= _start && a < _end;
-        if (in_range) {
-            auto sel = 0;
-            for (int i = 0; i < masks.size(); i++) {
-                Addr masked = a & masks[i];
-                // The result of an xor operation is 1 if the number
-                // of bits set is odd or 0 othersize, thefore it
-                // suffices to count the number of bits set to
-                // determine the i-th bit of sel.
-                sel |= (popCount(masked) % 2) << i;
-            }
-            return sel == intlvMatch;
-        }
-        return false;
+        return in_range && stripeOf(a) == intlvMatch;
     }
 
     /**
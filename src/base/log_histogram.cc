@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/log_histogram.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "base/logging.hh"
+
+namespace
+{
+
+/** Check the sub-bucket bits before they size the bucket vector */
+unsigned
+checkSubBits(unsigned sub_bits)
+{
+    fatal_if(sub_bits > 16, "A log histogram can have at most 16 sub-bucket "
+             "bits, not %d.", sub_bits);
+    return sub_bits;
+}
+
+} // anonymous namespace
+
+LogHistogram::LogHistogram(unsigned sub_bits)
+    : subBits(checkSubBits(sub_bits)), subCount(1ULL << subBits),
+      buckets(size_t(65 - subBits) << subBits, 0)
+{
+    reset();
+}
+
+uint64_t
+LogHistogram::bucketLow(size_t idx) const
+{
+    if (idx < subCount)
+        return idx;
+    const unsigned shift = (idx >> subBits) - 1;
+    return (idx - (uint64_t(shift) << subBits)) << shift;
+}
+
+uint64_t
+LogHistogram::bucketHigh(size_t idx) const
+{
+    if (idx < subCount)
+        return idx;
+    const unsigned shift = (idx >> subBits) - 1;
+    return bucketLow(idx) + ((1ULL << shift) - 1);
+}
+
+uint64_t
+LogHistogram::quantile(double q) const
+{
+    if (!samples)
+        return 0;
+
+    // Rank of the sample sought, counting from one
+    const double rank = std::max(1.0, std::ceil(q * samples));
+    uint64_t seen = 0;
+    for (size_t idx = bucketIndex(min()); idx < buckets.size(); ++idx) {
+        seen += buckets[idx];
+        if (seen >= rank)
+            return std::min(bucketHigh(idx), maxVal);
+    }
+    return maxVal;
+}
+
+void
+LogHistogram::reset()
+{
+    std::fill(buckets.begin(), buckets.end(), 0);
+    samples = 0;
+    total = 0;
+    minVal = std::numeric_limits<uint64_t>::max();
+    maxVal = 0;
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_LOG_HISTOGRAM_HH__
+#define __BASE_LOG_HISTOGRAM_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * A histogram with a fixed set of logarithmically sized buckets, in
+ * the style of an HDR histogram. Values below 2^subBits each get a
+ * bucket of their own, and every power of two above that is split in
+ * 2^subBits buckets of equal size, so that the width of a bucket is
+ * never more than 2^-subBits of the values it holds. The buckets cover
+ * the full 64-bit range and are allocated up front, which makes
+ * sampling a shift, a compare and an increment, with none of the
+ * rescaling or floating point work of a Stats::Histogram.
+ */
+class LogHistogram
+{
+  public:
+    /**
+     * @param sub_bits Number of bits of each value kept below its
+     *        most significant one, between 0 and 16
+     */
+    LogHistogram(unsigned sub_bits = 4);
+
+    /** Add a number of samples of a value. */
+    void
+    sample(uint64_t val, uint64_t number = 1)
+    {
+        buckets[bucketIndex(val)] += number;
+        samples += number;
+        total += val * number;
+        if (val < minVal)
+            minVal = val;
+        if (val > maxVal)
+            maxVal = val;
+    }
+
+    /** Number of samples. */
+    uint64_t count() const { return samples; }
+
+    /** Sum of the values sampled. */
+    uint64_t sum() const { return total; }
+
+    /** Smallest value sampled, or zero if there are no samples. */
+    uint64_t min() const { return samples ? minVal : 0; }
+
+    /** Largest value sampled, or zero if there are no samples. */
+    uint64_t max() const { return maxVal; }
+
+    /** Mean of the values sampled, or zero if there are no samples. */
+    double mean() const { return samples ? double(total) / samples : 0; }
+
+    /**
+     * Estimate a quantile of the values sampled, as the largest value
+     * of the bucket holding it, but no more than the largest value
+     * sampled.
+     *
+     * @param q Quantile, between 0 and 1
+     * @return The estimate, or zero if there are no samples
+     */
+    uint64_t quantile(double q) const;
+
+    /** Number of buckets. */
+    size_t size() const { return buckets.size(); }
+
+    /** Number of samples in a bucket. */
+    uint64_t bucketCount(size_t idx) const { return buckets[idx]; }
+
+    /** Smallest value of a bucket. */
+    uint64_t bucketLow(size_t idx) const;
+
+    /** Largest value of a bucket. */
+    uint64_t bucketHigh(size_t idx) const;
+
+    /** Index of the bucket holding a value. */
+    size_t
+    bucketIndex(uint64_t val) const
+    {
+        if (val < subCount)
+            return val;
+        // Count the leading zeros rather than use floorLog2(), whose
+        // branches mispredict on values spread over several powers of
+        // two
+        const unsigned shift = 63 - __builtin_clzll(val) - subBits;
+        return (size_t(shift) << subBits) + (val >> shift);
+    }
+
+    /** Drop all samples. */
+    void reset();
+
+  private:
+    /** Bits of a value kept below its most significant one */
+    const unsigned subBits;
+
+    /** Number of buckets of each power of two */
+    const uint64_t subCount;
+
+    std::vector<uint64_t> buckets;
+
+    uint64_t samples;
+    uint64_t total;
+    uint64_t minVal;
+    uint64_t maxVal;
+};
+
+#endif // __BASE_LOG_HISTOGRAM_HH__
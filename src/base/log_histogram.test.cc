@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "base/log_histogram.hh"
+
+/** Small values are counted exactly. */
+TEST(LogHistogramTest, SmallValuesExact)
+{
+    LogHistogram hist(4);
+    for (uint64_t val = 0; val < 16; ++val) {
+        EXPECT_EQ(val, hist.bucketIndex(val));
+        EXPECT_EQ(val, hist.bucketLow(val));
+        EXPECT_EQ(val, hist.bucketHigh(val));
+    }
+}
+
+/**
+ * The buckets cover the full range without gaps or overlaps, and are
+ * no wider than the precision allows.
+ */
+TEST(LogHistogramTest, BucketsContiguous)
+{
+    for (unsigned sub_bits : {0, 2, 4, 7}) {
+        LogHistogram hist(sub_bits);
+        EXPECT_EQ(0, hist.bucketLow(0));
+        for (size_t idx = 1; idx < hist.size(); ++idx) {
+            ASSERT_EQ(hist.bucketHigh(idx - 1) + 1, hist.bucketLow(idx));
+            EXPECT_EQ(idx, hist.bucketIndex(hist.bucketLow(idx)));
+            EXPECT_EQ(idx, hist.bucketIndex(hist.bucketHigh(idx)));
+            const uint64_t width =
+                hist.bucketHigh(idx) - hist.bucketLow(idx) + 1;
+            EXPECT_LE(width, std::max<uint64_t>(
+                          1, hist.bucketLow(idx) >> sub_bits));
+        }
+        EXPECT_EQ(UINT64_MAX, hist.bucketHigh(hist.size() - 1));
+        EXPECT_EQ(hist.size() - 1, hist.bucketIndex(UINT64_MAX));
+    }
+}
+
+TEST(LogHistogramTest, Summary)
+{
+    LogHistogram hist(4);
+    EXPECT_EQ(0, hist.count());
+    EXPECT_EQ(0, hist.min());
+    EXPECT_EQ(0, hist.max());
+    EXPECT_EQ(0, hist.quantile(0.5));
+
+    hist.sample(10);
+    hist.sample(1000, 2);
+    hist.sample(3);
+    EXPECT_EQ(4, hist.count());
+    EXPECT_EQ(2013, hist.sum());
+    EXPECT_EQ(3, hist.min());
+    EXPECT_EQ(1000, hist.max());
+    EXPECT_DOUBLE_EQ(2013.0 / 4, hist.mean());
+    EXPECT_EQ(1, hist.bucketCount(hist.bucketIndex(10)));
+    EXPECT_EQ(2, hist.bucketCount(hist.bucketIndex(1000)));
+
+    hist.reset();
+    EXPECT_EQ(0, hist.count());
+    EXPECT_EQ(0, hist.sum());
+    EXPECT_EQ(0, hist.bucketCount(hist.bucketIndex(1000)));
+}
+
+/** Quantiles are within the precision of the exact ones. */
+TEST(LogHistogramTest, Quantiles)
+{
+    std::mt19937_64 gen(7);
+    std::lognormal_distribution<double> dist(8.0, 1.5);
+
+    LogHistogram hist(5);
+    std::vector<uint64_t> values;
+    for (int i = 0; i < 100000; ++i) {
+        const uint64_t val = dist(gen);
+        values.push_back(val);
+        hist.sample(val);
+    }
+    std::sort(values.begin(), values.end());
+
+    for (double q : {0.01, 0.5, 0.9, 0.99, 0.999}) {
+        const uint64_t exact = values[std::ceil(q * values.size()) - 1];
+        const uint64_t estimate = hist.quantile(q);
+        EXPECT_GE(estimate, exact);
+        EXPECT_LE(estimate - exact, exact / 32 + 1);
+    }
+    EXPECT_EQ(values.back(), hist.quantile(1.0));
+}
+
+/** More sub-bucket bits than supported are rejected. */
+TEST(LogHistogramTest, TooManySubBits)
+{
+    EXPECT_ANY_THROW(LogHistogram hist(17));
+    EXPECT_NO_THROW(LogHistogram hist(16));
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_SPSC_QUEUE_HH__
+#define __BASE_SPSC_QUEUE_HH__
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "base/intmath.hh"
+
+/**
+ * Bounded lock-free queue for exactly one producer thread and one consumer
+ * thread.
+ *
+ * The elements are preallocated and never destroyed: the producer fills
+ * the slot returned by back() in place and publishes it with push(), and
+ * the consumer reads the slot returned by front() in place and releases
+ * it with pop(). Elements owning memory, e.g., vectors, thus keep their
+ * capacity when slots are reused and the queue does not allocate in
+ * steady state.
+ *
+ * @tparam T Type of the elements. Must be default constructible.
+ */
+template <typename T>
+class SPSCQueue
+{
+  public:
+    /**
+     * @param capacity Minimum number of elements the queue can hold. It
+     *        is rounded up to a power of two.
+     */
+    explicit SPSCQueue(size_t capacity)
+        : buffer(capacity < 2 ? 2 : size_t(1) << ceilLog2(capacity)),
+          mask(buffer.size() - 1), head(0), tail(0)
+    {}
+
+    SPSCQueue(const SPSCQueue &) = delete;
+    SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+    /** Number of elements the queue can hold. */
+    size_t capacity() const { return buffer.size(); }
+
+    /**
+     * Slot to fill by the producer.
+     *
+     * @return The slot, or nullptr if the queue is full.
+     */
+    T *
+    back()
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == buffer.size())
+            return nullptr;
+        return &buffer[t & mask];
+    }
+
+    /** Publish the slot returned by back() to the consumer. */
+    void
+    push()
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        assert(t - head.load(std::memory_order_relaxed) < buffer.size());
+        tail.store(t + 1, std::memory_order_release);
+    }
+
+    /**
+     * Oldest element, to read by the consumer.
+     *
+     * @return The element, or nullptr if the queue is empty.
+     */
+    T *
+    front()
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return nullptr;
+        return &buffer[h & mask];
+    }
+
+    /** Give the slot returned by front() back to the producer. */
+    void
+    pop()
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        assert(h != tail.load(std::memory_order_relaxed));
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    /**
+     * Check if the queue is empty. Only meaningful if the other thread is
+     * not using the queue concurrently.
+     */
+    bool
+    empty() const
+    {
+        return head.load(std::memory_order_acquire) ==
+            tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Drop all the elements. Must not be called while the other thread is
+     * using the queue.
+     */
+    void
+    clear()
+    {
+        head.store(tail.load(std::memory_order_relaxed),
+                   std::memory_order_release);
+    }
+
+  private:
+    /** Storage of the elements. Its size is a power of two. */
+    std::vector<T> buffer;
+    /** Mask to turn an index into a position in the buffer. */
+    const size_t mask;
+
+    /**
+     * Monotonically increasing indices of the next element to pop and of
+     * the next element to push. They are kept on separate cache lines so
+     * that both threads do not keep stealing the line from each other.
+     */
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+};
+
+#endif // __BASE_SPSC_QUEUE_HH__
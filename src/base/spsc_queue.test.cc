@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "base/spsc_queue.hh"
+
+TEST(SPSCQueueTest, Capacity)
+{
+    EXPECT_EQ(2, SPSCQueue<int>(0).capacity());
+    EXPECT_EQ(8, SPSCQueue<int>(8).capacity());
+    EXPECT_EQ(16, SPSCQueue<int>(9).capacity());
+}
+
+TEST(SPSCQueueTest, PushPop)
+{
+    SPSCQueue<int> queue(4);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(nullptr, queue.front());
+
+    for (int i = 0; i < 4; ++i) {
+        int *slot = queue.back();
+        ASSERT_NE(nullptr, slot);
+        *slot = i;
+        queue.push();
+    }
+    // Full
+    EXPECT_EQ(nullptr, queue.back());
+    EXPECT_FALSE(queue.empty());
+
+    for (int i = 0; i < 4; ++i) {
+        int *elem = queue.front();
+        ASSERT_NE(nullptr, elem);
+        EXPECT_EQ(i, *elem);
+        queue.pop();
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(nullptr, queue.front());
+}
+
+TEST(SPSCQueueTest, Clear)
+{
+    SPSCQueue<int> queue(4);
+    *queue.back() = 1;
+    queue.push();
+    *queue.back() = 2;
+    queue.push();
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    ASSERT_NE(nullptr, queue.back());
+}
+
+/** Slots are reused in place, so they keep their contents and capacity */
+TEST(SPSCQueueTest, SlotsReused)
+{
+    SPSCQueue<std::vector<int>> queue(2);
+    for (int i = 0; i < 2; ++i) {
+        queue.back()->assign(100, i);
+        queue.push();
+    }
+    for (int i = 0; i < 2; ++i)
+        queue.pop();
+
+    std::vector<int> *slot = queue.back();
+    ASSERT_NE(nullptr, slot);
+    EXPECT_GE(slot->capacity(), 100);
+}
+
+TEST(SPSCQueueTest, Threads)
+{
+    const uint64_t count = 100000;
+    SPSCQueue<uint64_t> queue(64);
+
+    std::thread producer([&]() {
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t *slot;
+            while (!(slot = queue.back()))
+                std::this_thread::yield();
+            *slot = i;
+            queue.push();
+        }
+    });
+
+    uint64_t expected = 0;
+    while (expected < count) {
+        uint64_t *elem = queue.front();
+        if (!elem) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(expected, *elem);
+        queue.pop();
+        ++expected;
+    }
+    producer.join();
+    EXPECT_TRUE(queue.empty());
+}
@@ -344,6 +344,8 @@ BaseCPU::regProbePoints()
     ppRetiredLoads = pmuProbePoint("RetiredLoads");
     ppRetiredStores = pmuProbePoint("RetiredStores");
     ppRetiredBranches = pmuProbePoint("RetiredBranches");
+    ppRetiredBranchInfo = new ProbePointArg<RetiredBranch>(
+        getProbeManager(), "RetiredBranchInfo");
 
     ppSleeping = new ProbePointArg<bool>(this->getProbeManager(),
                                          "Sleeping");
@@ -367,6 +369,23 @@ BaseCPU::probeInstCommit(const StaticInstPtr &inst, Addr pc)
         ppRetiredBranches->notify(1);
 }
 
+void
+BaseCPU::probeBranchCommit(ThreadID tid, const StaticInstPtr &inst,
+                           const TheISA::PCState &pc)
+{
+    // Only build the record if anyone is listening
+    if (!ppRetiredBranchInfo->hasListeners())
+        return;
+
+    RetiredBranch branch;
+    branch.tid = tid;
+    branch.inst = inst.get();
+    branch.pc = pc.instAddr();
+    branch.target = pc.npc();
+    branch.taken = pc.branching();
+    ppRetiredBranchInfo->notify(branch);
+}
+
 BaseCPU::
 BaseCPUStats::BaseCPUStats(Stats::Group *parent)
     : Stats::Group(parent),
@@ -538,9 +557,8 @@ BaseCPU::switchOut()
     assert(!_switchedOut);
     _switchedOut = true;
 
-    // Flush all TLBs in the CPU to avoid having stale translations if
-    // it gets switched in later.
-    flushTLBs();
+    // The TLBs are flushed once the CPU taking over has copied their
+    // translations, see takeOverFrom().
 
     // Go to the power gating state
     powerState->set(Enums::PwrState::OFF);
@@ -606,6 +624,11 @@ BaseCPU::takeOverFrom(BaseCPU *oldCPU)
     // we are switching to.
     getInstPort().takeOverFrom(&oldCPU->getInstPort());
     getDataPort().takeOverFrom(&oldCPU->getDataPort());
+
+    // Now that this CPU has the translations, flush the TLBs of the
+    // old CPU to avoid having stale translations if it gets switched
+    // in later.
+    oldCPU->flushTLBs();
 }
 
 void
@@ -51,6 +51,7 @@
 #error Including BaseCPU in a system without CPU support
 #else
 #include "arch/generic/interrupts.hh"
+#include "arch/types.hh"
 #include "base/statistics.hh"
 #include "mem/port_proxy.hh"
 #include "sim/clocked_object.hh"
@@ -67,6 +68,24 @@ struct BaseCPUParams;
 class CheckerCPU;
 class ThreadContext;
 
+/**
+ * A committed control instruction, as passed to the listeners of the
+ * RetiredBranchInfo probe point.
+ */
+struct RetiredBranch
+{
+    /** Thread that committed the instruction */
+    ThreadID tid;
+    /** The control instruction */
+    const StaticInst *inst;
+    /** PC of the instruction */
+    Addr pc;
+    /** PC of the next instruction, the fall-through if not taken */
+    Addr target;
+    /** Whether the branch was taken */
+    bool taken;
+};
+
 struct AddressMonitor
 {
     AddressMonitor();
@@ -330,7 +349,8 @@ class BaseCPU : public ClockedObject
      * Prepare for another CPU to take over execution.
      *
      * When this method exits, all internal state should have been
-     * flushed. After the method returns, the simulator calls
+     * flushed, except for the TLBs whose translations the new CPU
+     * takes over. After the method returns, the simulator calls
      * takeOverFrom() on the new CPU with this CPU as its parameter.
      */
     virtual void switchOut();
@@ -352,10 +372,10 @@ class BaseCPU : public ClockedObject
      * Flush all TLBs in the CPU.
      *
      * This method is mainly used to flush stale translations when
-     * switching CPUs. It is also exported to the Python world to
-     * allow it to request a TLB flush after draining the CPU to make
-     * it easier to compare traces when debugging
-     * handover/checkpointing.
+     * switching CPUs, once the new CPU has taken them over. It is
+     * also exported to the Python world to allow it to request a TLB
+     * flush after draining the CPU to make it easier to compare
+     * traces when debugging handover/checkpointing.
      */
     void flushTLBs();
 
@@ -473,6 +493,19 @@ class BaseCPU : public ClockedObject
      */
     virtual void probeInstCommit(const StaticInstPtr &inst, Addr pc);
 
+    /**
+     * Helper method to trigger the probe point of committed control
+     * instructions. CPU models call this in addition to
+     * probeInstCommit().
+     *
+     * @param tid Thread that committed the instruction
+     * @param inst Control instruction that just committed
+     * @param pc PC state after executing the instruction, whose next PC
+     * is the branch target if the branch was taken
+     */
+    void probeBranchCommit(ThreadID tid, const StaticInstPtr &inst,
+                           const TheISA::PCState &pc);
+
    protected:
     /**
      * Helper method to instantiate probe points belonging to this
@@ -502,6 +535,9 @@ class BaseCPU : public ClockedObject
     /** Retired branches (any type) */
     ProbePoints::PMUUPtr ppRetiredBranches;
 
+    /** Retired branches with their outcome, see RetiredBranch */
+    ProbePointArg<RetiredBranch> *ppRetiredBranchInfo;
+
     /** CPU cycle counter even if any thread Context is suspended*/
     ProbePoints::PMUUPtr ppAllCycles;
 
@@ -425,6 +425,10 @@ BaseKvmCPU::switchOut()
 
     BaseCPU::switchOut();
 
+    // The TLBs are not kept up to date while running in KVM, so don't
+    // hand any translations over to the next CPU.
+    flushTLBs();
+
     // We should have drained prior to executing a switchOut, which
     // means that the tick event shouldn't be scheduled and the CPU is
     // idle.
@@ -881,6 +881,12 @@ Execute::doInstCommitAccounting(MinorDynInstPtr inst)
         inst->traceData->setCPSeq(thread->numOp);
 
     cpu.probeInstCommit(inst->staticInst, inst->pc.instAddr());
+    // The thread PC is only advanced past the instruction afterwards in
+    // tryToBranch, so it still holds the outcome of a branch
+    if (inst->staticInst->isControl()) {
+        cpu.probeBranchCommit(inst->id.threadId, inst->staticInst,
+                              cpu.getContext(inst->id.threadId)->pcState());
+    }
 }
 
 bool
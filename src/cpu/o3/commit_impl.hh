@@ -1176,7 +1176,7 @@ DefaultCommit<Impl>::commitInsts()
     }
 
     DPRINTF(CommitRate, "%i\n", num_committed);
-    stats.numCommittedDist.sample(num_committed);
+    cpu->cycleStats.sample(stats.numCommittedDist, num_committed);
 
     if (num_committed == commitWidth) {
         stats.commitEligibleSamples++;
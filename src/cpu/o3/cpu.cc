@@ -114,6 +114,7 @@ FullO3CPU<Impl>::FullO3CPU(const DerivO3CPUParams &params)
       activityRec(name(), NumStages,
                   params.backComSize + params.forwardComSize,
                   params.activity),
+      stallQuiesced(false),
 
       globalSeqNum(1),
       system(params.system),
@@ -501,6 +502,8 @@ FullO3CPU<Impl>::tick()
 
     ++baseStats.numCycles;
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
+    cycleStats.reset();
+    stallQuiesced = false;
 
 //    activity = false;
 
@@ -538,6 +541,7 @@ FullO3CPU<Impl>::tick()
             DPRINTF(O3CPU, "Idle!\n");
             lastRunningCycle = curCycle();
             cpuStats.timesIdled++;
+            stallQuiesced = _status != Idle;
         } else {
             schedule(tickEvent, clockEdge(Cycles(1)));
             DPRINTF(O3CPU, "Scheduling next tick!\n");
@@ -1501,6 +1505,8 @@ FullO3CPU<Impl>::instDone(ThreadID tid, const DynInstPtr &inst)
     cpuStats.committedOps[tid]++;
 
     probeInstCommit(inst->staticInst, inst->instAddr());
+    if (inst->isControl())
+        probeBranchCommit(tid, inst->staticInst, inst->pcState());
 }
 
 template <class Impl>
@@ -1683,7 +1689,13 @@ FullO3CPU<Impl>::wakeCPU()
         --cycles;
         cpuStats.idleCycles += cycles;
         baseStats.numCycles += cycles;
+
+        // The stages were stalled the whole time, account the skipped
+        // cycles to their stall statistics as if they had been ticked.
+        if (stallQuiesced)
+            cycleStats.repeat(cycles);
     }
+    stallQuiesced = false;
 
     schedule(tickEvent, clockEdge());
 }
@@ -1819,8 +1831,7 @@ FullO3CPU<Impl>::htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
     this->commit.resetHtmStartsStops(tid);
 
     // notify l1 d-cache (ruby) that core has aborted transaction
-    RequestPtr req =
-        std::make_shared<Request>(addr, size, flags, _dataRequestorId);
+    RequestPtr req = makeRequest(addr, size, flags, _dataRequestorId);
 
     req->taskId(taskId());
     req->setContext(this->thread[tid]->contextId());
@@ -55,6 +55,7 @@
 #include "config/the_isa.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/cpu_policy.hh"
+#include "cpu/o3/cycle_stats.hh"
 #include "cpu/o3/scoreboard.hh"
 #include "cpu/o3/thread_state.hh"
 #include "cpu/activity.hh"
@@ -632,7 +633,18 @@ class FullO3CPU : public BaseO3CPU
      */
     ActivityRecorder activityRec;
 
+    /**
+     * Whether the CPU stopped ticking while it had running threads
+     * because no stage had any activity left, i.e., it is waiting for
+     * an external event such as a memory response.
+     */
+    bool stallQuiesced;
+
   public:
+    /** Per-cycle stage statistics, repeated for the cycles skipped
+     * while the CPU is quiesced. */
+    CycleStatRecorder cycleStats;
+
     /** Records that there was time buffer activity this cycle. */
     void activityThisCycle() { activityRec.activity(); }
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_CYCLE_STATS_HH__
+#define __CPU_O3_CYCLE_STATS_HH__
+
+#include <utility>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+/**
+ * Records the per-cycle statistics updated by the pipeline stages
+ * during a CPU tick. Once the CPU has no activity left it stops
+ * ticking until an external event (e.g., a memory response) wakes it
+ * up. Every stage would take the same path on each of the skipped
+ * cycles, as no input reaches it in the meantime, so the statistics of
+ * the last tick can be repeated in bulk for the skipped cycles instead.
+ */
+class CycleStatRecorder
+{
+  private:
+    /** Counters incremented during the last tick. */
+    std::vector<Stats::Scalar *> scalars;
+
+    /** Distributions sampled during the last tick, and their sample. */
+    std::vector<std::pair<Stats::Distribution *, Stats::Counter>> dists;
+
+  public:
+    /** Forgets the statistics recorded during the previous tick. */
+    void
+    reset()
+    {
+        scalars.clear();
+        dists.clear();
+    }
+
+    /** Increments a per-cycle counter, remembering it was updated. */
+    void
+    inc(Stats::Scalar &stat)
+    {
+        ++stat;
+        scalars.push_back(&stat);
+    }
+
+    /** Samples a per-cycle distribution, remembering the sample. */
+    void
+    sample(Stats::Distribution &stat, Stats::Counter val)
+    {
+        stat.sample(val);
+        dists.emplace_back(&stat, val);
+    }
+
+    /** Accounts the updates of the last tick for a number of cycles. */
+    void
+    repeat(Cycles cycles)
+    {
+        for (auto stat : scalars)
+            *stat += cycles;
+        for (auto &dist : dists)
+            dist.first->sample(dist.second, cycles);
+    }
+};
+
+#endif // __CPU_O3_CYCLE_STATS_HH__
@@ -596,9 +596,9 @@ DefaultDecode<Impl>::decode(bool &status_change, ThreadID tid)
     //     check if stall conditions have passed
 
     if (decodeStatus[tid] == Blocked) {
-        ++stats.blockedCycles;
+        cpu->cycleStats.inc(stats.blockedCycles);
     } else if (decodeStatus[tid] == Squashing) {
-        ++stats.squashCycles;
+        cpu->cycleStats.inc(stats.squashCycles);
     }
 
     // Decode should try to decode as many instructions as its bandwidth
@@ -642,14 +642,14 @@ DefaultDecode<Impl>::decodeInsts(ThreadID tid)
         DPRINTF(Decode, "[tid:%i] Nothing to do, breaking out"
                 " early.\n",tid);
         // Should I change the status to idle?
-        ++stats.idleCycles;
+        cpu->cycleStats.inc(stats.idleCycles);
         return;
     } else if (decodeStatus[tid] == Unblocking) {
         DPRINTF(Decode, "[tid:%i] Unblocking, removing insts from skid "
                 "buffer.\n",tid);
-        ++stats.unblockCycles;
+        cpu->cycleStats.inc(stats.unblockCycles);
     } else if (decodeStatus[tid] == Running) {
-        ++stats.runCycles;
+        cpu->cycleStats.inc(stats.runCycles);
     }
 
     std::queue<DynInstPtr>
@@ -595,7 +595,7 @@ DefaultFetch<Impl>::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
     // Setup the memReq to do a read of the first instruction's address.
     // Set the appropriate read size and flags as well.
     // Build request here.
-    RequestPtr mem_req = std::make_shared<Request>(
+    RequestPtr mem_req = makeRequest(
         fetchBufferBlockPC, fetchBufferSize,
         Request::INST_FETCH, cpu->instRequestorId(), pc,
         cpu->thread[tid]->contextId());
@@ -897,7 +897,7 @@ DefaultFetch<Impl>::tick()
     }
 
     // Record number of instructions fetched this cycle for distribution.
-    fetchStats.nisnDist.sample(numInst);
+    cpu->cycleStats.sample(fetchStats.nisnDist, numInst);
 
     if (status_change) {
         // Change the fetch stage status if there was a status change.
@@ -1169,23 +1169,23 @@ DefaultFetch<Impl>::fetch(bool &status_change)
             fetchCacheLine(fetchAddr, tid, thisPC.instAddr());
 
             if (fetchStatus[tid] == IcacheWaitResponse)
-                ++fetchStats.icacheStallCycles;
+                cpu->cycleStats.inc(fetchStats.icacheStallCycles);
             else if (fetchStatus[tid] == ItlbWait)
-                ++fetchStats.tlbCycles;
+                cpu->cycleStats.inc(fetchStats.tlbCycles);
             else
-                ++fetchStats.miscStallCycles;
+                cpu->cycleStats.inc(fetchStats.miscStallCycles);
             return;
         } else if ((checkInterrupt(thisPC.instAddr()) && !delayedCommit[tid])) {
             // Stall CPU if an interrupt is posted and we're not issuing
             // an delayed commit micro-op currently (delayed commit instructions
             // are not interruptable by interrupts, only faults)
-            ++fetchStats.miscStallCycles;
+            cpu->cycleStats.inc(fetchStats.miscStallCycles);
             DPRINTF(Fetch, "[tid:%i] Fetch is stalled!\n", tid);
             return;
         }
     } else {
         if (fetchStatus[tid] == Idle) {
-            ++fetchStats.idleCycles;
+            cpu->cycleStats.inc(fetchStats.idleCycles);
             DPRINTF(Fetch, "[tid:%i] Fetch is idle!\n", tid);
         }
 
@@ -1592,35 +1592,35 @@ DefaultFetch<Impl>::profileStall(ThreadID tid) {
     // @todo Per-thread stats
 
     if (stalls[tid].drain) {
-        ++fetchStats.pendingDrainCycles;
+        cpu->cycleStats.inc(fetchStats.pendingDrainCycles);
         DPRINTF(Fetch, "Fetch is waiting for a drain!\n");
     } else if (activeThreads->empty()) {
-        ++fetchStats.noActiveThreadStallCycles;
+        cpu->cycleStats.inc(fetchStats.noActiveThreadStallCycles);
         DPRINTF(Fetch, "Fetch has no active thread!\n");
     } else if (fetchStatus[tid] == Blocked) {
-        ++fetchStats.blockedCycles;
+        cpu->cycleStats.inc(fetchStats.blockedCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is blocked!\n", tid);
     } else if (fetchStatus[tid] == Squashing) {
-        ++fetchStats.squashCycles;
+        cpu->cycleStats.inc(fetchStats.squashCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is squashing!\n", tid);
     } else if (fetchStatus[tid] == IcacheWaitResponse) {
-        ++fetchStats.icacheStallCycles;
+        cpu->cycleStats.inc(fetchStats.icacheStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting cache response!\n",
                 tid);
     } else if (fetchStatus[tid] == ItlbWait) {
-        ++fetchStats.tlbCycles;
+        cpu->cycleStats.inc(fetchStats.tlbCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting ITLB walk to "
                 "finish!\n", tid);
     } else if (fetchStatus[tid] == TrapPending) {
-        ++fetchStats.pendingTrapStallCycles;
+        cpu->cycleStats.inc(fetchStats.pendingTrapStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for a pending trap!\n",
                 tid);
     } else if (fetchStatus[tid] == QuiescePending) {
-        ++fetchStats.pendingQuiesceStallCycles;
+        cpu->cycleStats.inc(fetchStats.pendingQuiesceStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for a pending quiesce "
                 "instruction!\n", tid);
     } else if (fetchStatus[tid] == IcacheWaitRetry) {
-        ++fetchStats.icacheWaitRetryStallCycles;
+        cpu->cycleStats.inc(fetchStats.icacheWaitRetryStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for an I-cache retry!\n",
                 tid);
     } else if (fetchStatus[tid] == NoGoodAddr) {
@@ -871,10 +871,10 @@ DefaultIEW<Impl>::dispatch(ThreadID tid)
     //     check if stall conditions have passed
 
     if (dispatchStatus[tid] == Blocked) {
-        ++iewStats.blockCycles;
+        cpu->cycleStats.inc(iewStats.blockCycles);
 
     } else if (dispatchStatus[tid] == Squashing) {
-        ++iewStats.squashCycles;
+        cpu->cycleStats.inc(iewStats.squashCycles);
     }
 
     // Dispatch should try to dispatch as many instructions as its bandwidth
@@ -895,7 +895,7 @@ DefaultIEW<Impl>::dispatch(ThreadID tid)
         // the rest of unblocking.
         dispatchInsts(tid);
 
-        ++iewStats.unblockCycles;
+        cpu->cycleStats.inc(iewStats.unblockCycles);
 
         if (validInstsFromRename()) {
             // Add the current inputs to the skid buffer so they can be
@@ -981,7 +981,7 @@ DefaultIEW<Impl>::dispatchInsts(ThreadID tid)
             // get full in the IQ.
             toRename->iewUnblock[tid] = false;
 
-            ++iewStats.iqFullEvents;
+            cpu->cycleStats.inc(iewStats.iqFullEvents);
             break;
         }
 
@@ -1000,7 +1000,7 @@ DefaultIEW<Impl>::dispatchInsts(ThreadID tid)
             // get full in the IQ.
             toRename->iewUnblock[tid] = false;
 
-            ++iewStats.lsqFullEvents;
+            cpu->cycleStats.inc(iewStats.lsqFullEvents);
             break;
         }
 
@@ -917,7 +917,7 @@ InstructionQueue<Impl>::scheduleReadyInsts()
         }
     }
 
-    iqStats.numIssuedDist.sample(total_issued);
+    cpu->cycleStats.sample(iqStats.numIssuedDist, total_issued);
     iqStats.instsIssued+= total_issued;
 
     // If we issued any instructions, tell the CPU we had activity.
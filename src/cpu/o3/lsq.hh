@@ -413,7 +413,7 @@ class LSQ
                    const std::vector<bool>& byte_enable)
         {
             if (isAnyActiveElement(byte_enable.begin(), byte_enable.end())) {
-                auto request = std::make_shared<Request>(
+                auto request = makeRequest(
                         addr, size, _flags, _inst->requestorId(),
                         _inst->instAddr(), _inst->contextId(),
                         std::move(_amo_op));
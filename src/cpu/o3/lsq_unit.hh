@@ -44,9 +44,12 @@
 
 #include <algorithm>
 #include <cstring>
+#include <functional>
 #include <map>
 #include <memory>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include "arch/generic/debugfaults.hh"
 #include "arch/generic/vec_reg.hh"
@@ -100,10 +103,16 @@ class LSQUnit
         uint32_t _size;
         /** Valid entry. */
         bool _valid;
+        /** Whether the entry is recorded in the address index. */
+        bool _indexed;
+        /** First and last address index bucket covered by the entry. */
+        Addr _indexLo;
+        Addr _indexHi;
       public:
         /** Constructs an empty store queue entry. */
         LSQEntry()
-            : inst(nullptr), req(nullptr), _size(0), _valid(false)
+            : inst(nullptr), req(nullptr), _size(0), _valid(false),
+              _indexed(false), _indexLo(0), _indexHi(0)
         {
         }
 
@@ -126,6 +135,7 @@ class LSQUnit
             req = nullptr;
             _valid = false;
             _size = 0;
+            assert(!_indexed);
         }
 
         void
@@ -142,6 +152,9 @@ class LSQUnit
         /** Member accessors. */
         /** @{ */
         bool valid() const { return _valid; }
+        bool& indexed() { return _indexed; }
+        Addr& indexLo() { return _indexLo; }
+        Addr& indexHi() { return _indexHi; }
         uint32_t& size() { return _size; }
         const uint32_t& size() const { return _size; }
         const DynInstPtr& instruction() const { return inst; }
@@ -218,6 +231,105 @@ class LSQUnit
     using LoadQueue = CircularQueue<LQEntry>;
     using StoreQueue = CircularQueue<SQEntry>;
 
+  private:
+    /**
+     * Auxiliary index of the LQ or SQ by address. Every entry is
+     * recorded in each bucket its address range touches, where a bucket
+     * covers at least a cache line. A lookup returns a superset of the
+     * entries that may overlap a range, in no particular order; callers
+     * still apply the exact overlap checks of the linear scan to the
+     * candidates, so both searches find the same entries.
+     */
+    class AddrIndex
+    {
+      private:
+        /** Queue indices of the entries touching each bucket. */
+        std::unordered_map<Addr, std::vector<size_t>> buckets;
+
+        /**
+         * Number of entries whose bucket range is too wide to index
+         * (e.g., wrapped zero-sized accesses); while non-zero, lookups
+         * cannot be trusted and the queue must be scanned linearly.
+         */
+        int _unindexable = 0;
+
+      public:
+        /** Largest number of buckets a single entry may span. */
+        static constexpr Addr MaxBuckets = 16;
+
+        /** Records the entry at queue index idx in buckets [lo, hi]. */
+        void
+        insert(LSQEntry &entry, size_t idx, Addr lo, Addr hi)
+        {
+            assert(!entry.indexed());
+            entry.indexed() = true;
+            entry.indexLo() = lo;
+            entry.indexHi() = hi;
+            if (hi - lo >= MaxBuckets) {
+                ++_unindexable;
+                return;
+            }
+            for (Addr b = lo; b <= hi; b++)
+                buckets[b].push_back(idx);
+        }
+
+        /** Removes the entry at queue index idx, if indexed. */
+        void
+        remove(LSQEntry &entry, size_t idx)
+        {
+            if (!entry.indexed())
+                return;
+            entry.indexed() = false;
+            if (entry.indexHi() - entry.indexLo() >= MaxBuckets) {
+                --_unindexable;
+                return;
+            }
+            for (Addr b = entry.indexLo(); b <= entry.indexHi(); b++) {
+                auto it = buckets.find(b);
+                assert(it != buckets.end());
+                auto &v = it->second;
+                auto pos = std::find(v.begin(), v.end(), idx);
+                assert(pos != v.end());
+                *pos = v.back();
+                v.pop_back();
+                if (v.empty())
+                    buckets.erase(it);
+            }
+        }
+
+        /** Whether lookups cover all the entries of the queue. */
+        bool usable() const { return _unindexable == 0; }
+
+        /**
+         * Appends to out the queue indices of the entries touching
+         * buckets [lo, hi], without duplicates.
+         */
+        void
+        lookup(Addr lo, Addr hi, std::vector<size_t> &out) const
+        {
+            assert(hi - lo < MaxBuckets);
+            const auto first = out.size();
+            for (Addr b = lo; b <= hi; b++) {
+                auto it = buckets.find(b);
+                if (it != buckets.end())
+                    out.insert(out.end(), it->second.begin(),
+                               it->second.end());
+            }
+            if (hi != lo) {
+                std::sort(out.begin() + first, out.end());
+                out.erase(std::unique(out.begin() + first, out.end()),
+                          out.end());
+            }
+        }
+
+        void
+        clear()
+        {
+            buckets.clear();
+            _unindexable = 0;
+        }
+    };
+
   public:
     /** Constructs an LSQ unit. init() must be called prior to use. */
     LSQUnit(uint32_t lqEntries, uint32_t sqEntries);
@@ -387,6 +499,13 @@ class LSQUnit
     /** Handles completing the send of a store to memory. */
     void storePostSend();
 
+    /**
+     * Records the queue entry at idx in the address index, covering
+     * the accessed range [addr, addr + size).
+     */
+    void indexEntry(AddrIndex &index, LSQEntry &entry, size_t idx,
+                    Addr addr, unsigned size);
+
   public:
     /** Attempts to send a packet to the cache.
      * Check if there are ports available. Return true if
@@ -506,6 +625,21 @@ class LSQUnit
     /** Should loads be checked for dependency issues */
     bool checkLoads;
 
+    /** Use the address indices rather than scanning the LQ and SQ. */
+    bool indexedSearch;
+
+    /** log2 of the size of an address index bucket. */
+    unsigned indexShift;
+
+    /** Address index of the loads in the LQ. */
+    AddrIndex loadIndex;
+
+    /** Address index of the stores in the SQ. */
+    AddrIndex storeIndex;
+
+    /** Scratch list of queue indices visited by an LQ or SQ search. */
+    std::vector<size_t> searchIdx;
+
     /** The number of load instructions in the LQ. */
     int loads;
     /** The number of store instructions in the SQ. */
@@ -643,6 +777,11 @@ LSQUnit<Impl>::read(LSQRequest *req, int load_idx)
 
     assert(!load_inst->isExecuted());
 
+    // Index the load before any of the early returns below, as the
+    // violation checks must see local and HTM accesses too
+    indexEntry(loadIndex, load_req, load_idx, load_inst->effAddr,
+               load_inst->effSize);
+
     // Make sure this isn't a strictly ordered load
     // A bit of a hackish way to get strictly ordered accesses to work
     // only if they're at the head of the LSQ and are ready to commit
@@ -732,12 +871,39 @@ LSQUnit<Impl>::read(LSQRequest *req, int load_idx)
     }
 
     // Check the SQ for any previous stores that might lead to forwarding
-    auto store_it = load_inst->sqIt;
-    assert (store_it >= storeWBIt);
-    // End once we've reached the top of the LSQ
-    while (store_it != storeWBIt) {
-        // Move the index to one younger
-        store_it--;
+    assert (load_inst->sqIt >= storeWBIt);
+    searchIdx.clear();
+
+    // Any store that may forward to the load or stall it touches a byte
+    // in [req_s - 1, req_e], so only the buckets of that range need to
+    // be probed.
+    const Addr fwd_s = req->mainRequest()->getVaddr();
+    const Addr fwd_e = fwd_s + req->mainRequest()->getSize();
+    const Addr fwd_lo = (fwd_s ? fwd_s - 1 : 0) >> indexShift;
+    const Addr fwd_hi = fwd_e >> indexShift;
+    if (indexedSearch && storeIndex.usable() && fwd_lo <= fwd_hi &&
+        fwd_hi - fwd_lo < AddrIndex::MaxBuckets) {
+        storeIndex.lookup(fwd_lo, fwd_hi, searchIdx);
+        auto out = std::remove_if(searchIdx.begin(), searchIdx.end(),
+            [this, &load_inst](size_t idx) {
+                auto it = storeQueue.getIterator(idx);
+                return it < storeWBIt || it >= load_inst->sqIt;
+            });
+        searchIdx.erase(out, searchIdx.end());
+        // Visit the candidates youngest first, like the linear scan
+        std::sort(searchIdx.begin(), searchIdx.end(),
+                  std::greater<size_t>());
+    } else {
+        // End once we've reached the top of the LSQ
+        for (auto it = load_inst->sqIt; it != storeWBIt; ) {
+            // Move the index to one younger
+            it--;
+            searchIdx.push_back(it.idx());
+        }
+    }
+
+    for (size_t store_idx : searchIdx) {
+        auto store_it = storeQueue.getIterator(store_idx);
         assert(store_it->valid());
         assert(store_it->instruction()->seqNum < load_inst->seqNum);
         int store_size = store_it->size();
@@ -968,6 +1134,13 @@ LSQUnit<Impl>::write(LSQRequest *req, uint8_t *data, int store_idx)
     storeQueue[store_idx].setRequest(req);
     unsigned size = req->_size;
     storeQueue[store_idx].size() = size;
+
+    // Stores without data are never considered for forwarding
+    storeIndex.remove(storeQueue[store_idx], store_idx);
+    if (size != 0) {
+        indexEntry(storeIndex, storeQueue[store_idx], store_idx,
+                   storeQueue[store_idx].instruction()->effAddr, size);
+    }
     bool store_no_data =
         req->mainRequest()->getFlags() & Request::STORE_NO_DATA;
     storeQueue[store_idx].isAllZeros() = store_no_data;
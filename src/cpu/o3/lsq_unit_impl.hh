@@ -45,6 +45,7 @@
 
 #include "arch/generic/debugfaults.hh"
 #include "arch/locked_mem.hh"
+#include "base/intmath.hh"
 #include "base/str.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
@@ -231,6 +232,9 @@ LSQUnit<Impl>::init(O3CPU *cpu_ptr, IEW *iew_ptr,
     depCheckShift = params.LSQDepCheckShift;
     checkLoads = params.LSQCheckLoads;
     needsTSO = params.needsTSO;
+    indexedSearch = params.LSQIndexedSearch;
+    indexShift = std::max<unsigned>(depCheckShift,
+                                    floorLog2(cpu->cacheLineSize()));
 
     resetState();
 }
@@ -254,6 +258,22 @@ LSQUnit<Impl>::resetState()
     stalled = false;
 
     cacheBlockMask = ~(cpu->cacheLineSize() - 1);
+
+    loadIndex.clear();
+    storeIndex.clear();
+}
+
+template<class Impl>
+void
+LSQUnit<Impl>::indexEntry(AddrIndex &index, LSQEntry &entry, size_t idx,
+                          Addr addr, unsigned size)
+{
+    // Use the hull of the range, as the overlap checks compare the
+    // first and last bytes of zero-sized accesses the wrong way round
+    const Addr first = addr >> indexShift;
+    const Addr last = (addr + size - 1) >> indexShift;
+    index.remove(entry, idx);
+    index.insert(entry, idx, std::min(first, last), std::max(first, last));
 }
 
 template<class Impl>
@@ -538,15 +558,38 @@ LSQUnit<Impl>::checkViolations(typename LoadQueue::iterator& loadIt,
     Addr inst_eff_addr1 = inst->effAddr >> depCheckShift;
     Addr inst_eff_addr2 = (inst->effAddr + inst->effSize - 1) >> depCheckShift;
 
+    // Overlapping loads share at least a bucket with the hull of the
+    // instruction's range, whichever way round its ends are.
+    const Addr first = inst->effAddr >> indexShift;
+    const Addr last = (inst->effAddr + inst->effSize - 1) >> indexShift;
+    const Addr lo = std::min(first, last);
+    const Addr hi = std::max(first, last);
+
+    searchIdx.clear();
+    if (indexedSearch && loadIndex.usable() &&
+        hi - lo < AddrIndex::MaxBuckets) {
+        loadIndex.lookup(lo, hi, searchIdx);
+        auto out = std::remove_if(searchIdx.begin(), searchIdx.end(),
+            [this, &loadIt](size_t idx) {
+                return loadQueue.getIterator(idx) < loadIt;
+            });
+        searchIdx.erase(out, searchIdx.end());
+        // Visit the candidates oldest first, like the linear scan
+        std::sort(searchIdx.begin(), searchIdx.end());
+    } else {
+        for (; loadIt != loadQueue.end(); ++loadIt)
+            searchIdx.push_back(loadIt.idx());
+    }
+
     /** @todo in theory you only need to check an instruction that has executed
      * however, there isn't a good way in the pipeline at the moment to check
      * all instructions that will execute before the store writes back. Thus,
      * like the implementation that came before it, we're overly conservative.
      */
-    while (loadIt != loadQueue.end()) {
+    for (size_t ld_idx : searchIdx) {
+        loadIt = loadQueue.getIterator(ld_idx);
         DynInstPtr ld_inst = loadIt->instruction();
         if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered()) {
-            ++loadIt;
             continue;
         }
 
@@ -602,8 +645,6 @@ LSQUnit<Impl>::checkViolations(typename LoadQueue::iterator& loadIt,
                     inst->seqNum, ld_inst->seqNum, ld_eff_addr1);
             }
         }
-
-        ++loadIt;
     }
     return NoFault;
 }
@@ -739,6 +780,7 @@ LSQUnit<Impl>::commitLoad()
     DPRINTF(LSQUnit, "Committing head load instruction, PC %s\n",
             loadQueue.front().instruction()->pcState());
 
+    loadIndex.remove(loadQueue.front(), loadQueue.head());
     loadQueue.front().clear();
     loadQueue.pop_front();
 
@@ -978,6 +1020,7 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
         }
         // Clear the smart pointer to make sure it is decremented.
         loadQueue.back().instruction()->setSquashed();
+        loadIndex.remove(loadQueue.back(), loadQueue.tail());
         loadQueue.back().clear();
 
         --loads;
@@ -1051,6 +1094,7 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
         // Must delete request now that it wasn't handed off to
         // memory.  This is quite ugly.  @todo: Figure out the proper
         // place to really handle request deletes.
+        storeIndex.remove(storeQueue.back(), storeQueue.tail());
         storeQueue.back().clear();
         --stores;
 
@@ -1171,6 +1215,7 @@ LSQUnit<Impl>::completeStore(typename StoreQueue::iterator store_idx)
     DynInstPtr store_inst = store_idx->instruction();
     if (store_idx == storeQueue.begin()) {
         do {
+            storeIndex.remove(storeQueue.front(), storeQueue.head());
             storeQueue.front().clear();
             storeQueue.pop_front();
             --stores;
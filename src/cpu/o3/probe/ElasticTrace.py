@@ -35,6 +35,8 @@
 
 from m5.objects.Probe import *
 
+class TraceFileFormat(Enum): vals = ['protobuf', 'columnar']
+
 class ElasticTrace(ProbeListenerObject):
     type = 'ElasticTrace'
     cxx_header = 'cpu/o3/probe/elastic_trace.hh'
@@ -45,6 +47,14 @@ class ElasticTrace(ProbeListenerObject):
                                         "instruction fetch tracing")
     dataDepTraceFile = Param.String(desc="Protobuf trace file name for " \
                                     "data dependency tracing")
+    # The columnar format stores the records in compressed blocks with an
+    # index, which is cheaper to write and lets the TraceCPU start the
+    # replay mid-trace. The TraceCPU reads either format.
+    traceFormat = Param.TraceFileFormat('protobuf', "Format of the " \
+                                        "instruction fetch and data " \
+                                        "dependency traces")
+    columnarBlockRecords = Param.Unsigned(4096, "Number of records in a " \
+                                          "block of a columnar trace")
     # The dependency window size param must be equal to or greater than the
     # number of entries in the O3CPU ROB, a typical value is 3 times ROB size
     depWindowSize = Param.Unsigned(desc="Instruction window size used for " \
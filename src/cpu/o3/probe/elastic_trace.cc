@@ -71,11 +71,20 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams &params)
                 "trace file path to instFetchTraceFile");
     fatal_if(params.dataDepTraceFile == "", "Assign data dependency "\
                 "trace file path to dataDepTraceFile");
-    std::string filename = simout.resolve(name() + "." +
+    std::string inst_filename = simout.resolve(name() + "." +
                                             params.instFetchTraceFile);
-    instTraceStream = new ProtoOutputStream(filename);
-    filename = simout.resolve(name() + "." + params.dataDepTraceFile);
-    dataTraceStream = new ProtoOutputStream(filename);
+    std::string data_filename = simout.resolve(name() + "." +
+                                            params.dataDepTraceFile);
+    if (params.traceFormat == Enums::columnar) {
+        const uint32_t block_records = params.columnarBlockRecords;
+        instTraceStream = new ColumnarOutputStream(inst_filename,
+                                                   block_records);
+        dataTraceStream = new ColumnarOutputStream(data_filename,
+                                                   block_records);
+    } else {
+        instTraceStream = new ProtoOutputStream(inst_filename);
+        dataTraceStream = new ProtoOutputStream(data_filename);
+    }
     // Create a protobuf message for the header and write it to the stream
     ProtoMessage::PacketHeader inst_pkt_header;
     inst_pkt_header.set_obj_id(name());
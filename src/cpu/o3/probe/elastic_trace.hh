@@ -54,6 +54,7 @@
 #include "cpu/o3/impl.hh"
 #include "mem/request.hh"
 #include "params/ElasticTrace.hh"
+#include "proto/columnar_io.hh"
 #include "proto/inst_dep_record.pb.h"
 #include "proto/packet.pb.h"
 #include "proto/protoio.hh"
@@ -344,11 +345,11 @@ class ElasticTrace : public ProbeListenerObject
      */
     uint32_t depWindowSize;
 
-    /** Protobuf output stream for data dependency trace */
-    ProtoOutputStream* dataTraceStream;
+    /** Output stream for data dependency trace */
+    TraceOutputStream* dataTraceStream;
 
-    /** Protobuf output stream for instruction fetch trace. */
-    ProtoOutputStream* instTraceStream;
+    /** Output stream for instruction fetch trace. */
+    TraceOutputStream* instTraceStream;
 
     /** Number of instructions after which to enable tracing. */
     const InstSeqNum startTraceInst;
@@ -465,11 +465,11 @@ DefaultRename<Impl>::rename(bool &status_change, ThreadID tid)
     //     check if stall conditions have passed
 
     if (renameStatus[tid] == Blocked) {
-        ++stats.blockCycles;
+        cpu->cycleStats.inc(stats.blockCycles);
     } else if (renameStatus[tid] == Squashing) {
-        ++stats.squashCycles;
+        cpu->cycleStats.inc(stats.squashCycles);
     } else if (renameStatus[tid] == SerializeStall) {
-        ++stats.serializeStallCycles;
+        cpu->cycleStats.inc(stats.serializeStallCycles);
         // If we are currently in SerializeStall and resumeSerialize
         // was set, then that means that we are resuming serializing
         // this cycle.  Tell the previous stages to block.
@@ -524,12 +524,12 @@ DefaultRename<Impl>::renameInsts(ThreadID tid)
         DPRINTF(Rename, "[tid:%i] Nothing to do, breaking out early.\n",
                 tid);
         // Should I change status to idle?
-        ++stats.idleCycles;
+        cpu->cycleStats.inc(stats.idleCycles);
         return;
     } else if (renameStatus[tid] == Unblocking) {
-        ++stats.unblockCycles;
+        cpu->cycleStats.inc(stats.unblockCycles);
     } else if (renameStatus[tid] == Running) {
-        ++stats.runCycles;
+        cpu->cycleStats.inc(stats.runCycles);
     }
 
     // Will have to do a different calculation for the number of free
@@ -673,7 +673,7 @@ DefaultRename<Impl>::renameInsts(ThreadID tid)
                     " lack of free physical registers to rename to.\n");
             blockThisCycle = true;
             insts_to_rename.push_front(inst);
-            ++stats.fullRegistersEvents;
+            cpu->cycleStats.inc(stats.fullRegistersEvents);
 
             break;
         }
@@ -1414,16 +1414,16 @@ DefaultRename<Impl>::incrFullStat(const FullSource &source)
 {
     switch (source) {
       case ROB:
-        ++stats.ROBFullEvents;
+        cpu->cycleStats.inc(stats.ROBFullEvents);
         break;
       case IQ:
-        ++stats.IQFullEvents;
+        cpu->cycleStats.inc(stats.IQFullEvents);
         break;
       case LQ:
-        ++stats.LQFullEvents;
+        cpu->cycleStats.inc(stats.LQFullEvents);
         break;
       case SQ:
-        ++stats.SQFullEvents;
+        cpu->cycleStats.inc(stats.SQFullEvents);
         break;
       default:
         panic("Rename full stall stat should be incremented for a reason!");
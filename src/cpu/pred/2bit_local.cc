@@ -31,6 +31,7 @@
 #include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
+#include "cpu/pred/table_checkpoint.hh"
 #include "debug/Fetch.hh"
 
 LocalBP::LocalBP(const LocalBPParams &params)
@@ -133,3 +134,17 @@ void
 LocalBP::uncondBranch(ThreadID tid, Addr pc, void *&bp_history)
 {
 }
+
+void
+LocalBP::serialize(CheckpointOut &cp) const
+{
+    BPredUnit::serialize(cp);
+    serializeCounters(cp, "localCtrs", localCtrs);
+}
+
+void
+LocalBP::unserialize(CheckpointIn &cp)
+{
+    BPredUnit::unserialize(cp);
+    unserializeCounters(cp, "localCtrs", localCtrs);
+}
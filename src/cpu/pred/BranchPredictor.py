@@ -143,6 +143,10 @@ class TAGEBase(SimObject):
     speculativeHistUpdate = Param.Bool(True,
         "Use speculative update for histories")
 
+    batchedIndexing = Param.Bool(True, "Compute the indices and tags of " \
+        "all the tagged tables in one pass, rather than table by table " \
+        "(the results are identical)")
+
 # TAGE branch predictor as described in https://www.jilp.org/vol8/v8paper1.pdf
 # The default sizes below are for the 8C-TAGE configuration (63.5 Kbits)
 class TAGE(BranchPredictor):
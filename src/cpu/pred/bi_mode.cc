@@ -34,6 +34,7 @@
 
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
+#include "cpu/pred/table_checkpoint.hh"
 
 BiModeBP::BiModeBP(const BiModeBPParams &params)
     : BPredUnit(params),
@@ -225,3 +226,23 @@ BiModeBP::updateGlobalHistReg(ThreadID tid, bool taken)
                                (globalHistoryReg[tid] << 1);
     globalHistoryReg[tid] &= historyRegisterMask;
 }
+
+void
+BiModeBP::serialize(CheckpointOut &cp) const
+{
+    BPredUnit::serialize(cp);
+    serializeCounters(cp, "choiceCounters", choiceCounters);
+    serializeCounters(cp, "takenCounters", takenCounters);
+    serializeCounters(cp, "notTakenCounters", notTakenCounters);
+    SERIALIZE_CONTAINER(globalHistoryReg);
+}
+
+void
+BiModeBP::unserialize(CheckpointIn &cp)
+{
+    BPredUnit::unserialize(cp);
+    unserializeCounters(cp, "choiceCounters", choiceCounters);
+    unserializeCounters(cp, "takenCounters", takenCounters);
+    unserializeCounters(cp, "notTakenCounters", notTakenCounters);
+    unserializeTable(cp, "globalHistoryReg", globalHistoryReg);
+}
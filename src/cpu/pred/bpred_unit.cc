@@ -46,6 +46,7 @@
 
 #include "arch/types.hh"
 #include "arch/utility.hh"
+#include "base/cprintf.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "debug/Branch.hh"
@@ -116,6 +117,31 @@ BPredUnit::drainSanityCheck() const
         assert(ph.empty());
 }
 
+void
+BPredUnit::serialize(CheckpointOut &cp) const
+{
+    BTB.serializeSection(cp, "btb");
+    for (unsigned tid = 0; tid < numThreads; ++tid)
+        RAS[tid].serializeSection(cp, csprintf("ras%d", tid));
+}
+
+void
+BPredUnit::unserialize(CheckpointIn &cp)
+{
+    // Checkpoints taken before the predictor state was saved leave the
+    // predictor cold
+    const std::string section = Serializable::currentSection();
+    if (!cp.sectionExists(section + ".btb"))
+        return;
+
+    BTB.unserializeSection(cp, "btb");
+    for (unsigned tid = 0; tid < numThreads; ++tid) {
+        const std::string ras = csprintf("ras%d", tid);
+        if (cp.sectionExists(section + "." + ras))
+            RAS[tid].unserializeSection(cp, ras);
+    }
+}
+
 bool
 BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
                    TheISA::PCState &pc, ThreadID tid)
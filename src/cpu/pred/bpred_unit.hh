@@ -73,6 +73,14 @@ class BPredUnit : public SimObject
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /**
+     * Save the BTB and RAS contents. Predictors override these to add
+     * their own tables, and are only checkpointed while drained, so no
+     * speculative history is outstanding.
+     */
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
     /**
      * Predicts whether or not the instruction is a taken branch, and the
      * target of the branch if it is taken.
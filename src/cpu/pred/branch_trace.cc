@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_trace.hh"
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "proto/branch.pb.h"
+#include "sim/core.hh"
+
+BranchTraceProbe::BranchTraceProbe(const BranchTraceProbeParams &params)
+    : ProbeListenerObject(params),
+      traceStream(new ColumnarOutputStream(
+                      simout.resolve(params.traceFile), params.blockRecords)),
+      numInsts(0)
+{
+    // Register a callback to compensate for the destructor not
+    // being called. The callback writes out the last block and the
+    // index, and closes the output file.
+    registerExitCallback([this]() { closeStreams(); });
+}
+
+void
+BranchTraceProbe::regProbeListeners()
+{
+    typedef ProbeListenerArg<BranchTraceProbe, uint64_t> InstsListener;
+    typedef ProbeListenerArg<BranchTraceProbe, RetiredBranch>
+        BranchListener;
+    listeners.push_back(new InstsListener(this, "RetiredInsts",
+                                          &BranchTraceProbe::retiredInsts));
+    listeners.push_back(new BranchListener(this, "RetiredBranchInfo",
+                                           &BranchTraceProbe::retiredBranch));
+}
+
+void
+BranchTraceProbe::startup()
+{
+    ProtoMessage::BranchTraceHeader header_msg;
+    header_msg.set_obj_id(name());
+    header_msg.set_tick_freq(SimClock::Frequency);
+    traceStream->write(header_msg);
+}
+
+void
+BranchTraceProbe::retiredBranch(const RetiredBranch &branch)
+{
+    uint32_t type = 0;
+    if (branch.inst->isCondCtrl())
+        type |= 1;
+    if (branch.inst->isIndirectCtrl())
+        type |= 2;
+    if (branch.inst->isCall())
+        type |= 4;
+    if (branch.inst->isReturn())
+        type |= 8;
+
+    ProtoMessage::BranchRecord branch_msg;
+    branch_msg.set_insts(numInsts);
+    branch_msg.set_pc(branch.pc);
+    branch_msg.set_target(branch.target);
+    branch_msg.set_taken(branch.taken);
+    branch_msg.set_type(type);
+    if (branch.tid != 0)
+        branch_msg.set_tid(branch.tid);
+    traceStream->write(branch_msg);
+}
+
+void
+BranchTraceProbe::closeStreams()
+{
+    delete traceStream;
+    traceStream = nullptr;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a probe listener that records the control instructions
+ * committed by a CPU in a branch trace, which the BranchTraceReplay
+ * feeds to a branch predictor.
+ */
+
+#ifndef __CPU_PRED_BRANCH_TRACE_HH__
+#define __CPU_PRED_BRANCH_TRACE_HH__
+
+#include <cstdint>
+
+#include "cpu/base.hh"
+#include "params/BranchTraceProbe.hh"
+#include "proto/columnar_io.hh"
+#include "sim/probe/probe.hh"
+
+/**
+ * The BranchTraceProbe listens to the RetiredBranchInfo and RetiredInsts
+ * probe points of a CPU, and writes a BranchRecord for every committed
+ * control instruction. The trace is always written in the columnar
+ * format, which keeps it a small fraction of the size of the equivalent
+ * protobuf trace.
+ */
+class BranchTraceProbe : public ProbeListenerObject
+{
+  public:
+    BranchTraceProbe(const BranchTraceProbeParams &params);
+
+    /** Register the probe listeners. */
+    void regProbeListeners() override;
+
+    /** Write the header of the trace. */
+    void startup() override;
+
+  private:
+    /** Count the committed instructions. */
+    void retiredInsts(const uint64_t &num) { numInsts += num; }
+
+    /** Write a record for a committed branch. */
+    void retiredBranch(const RetiredBranch &branch);
+
+    /**
+     * Callback to flush and close the output stream on exit. If we were
+     * calling the destructor it could be done there.
+     */
+    void closeStreams();
+
+    /** Trace output stream */
+    ColumnarOutputStream *traceStream;
+
+    /** Number of instructions committed so far */
+    uint64_t numInsts;
+};
+
+#endif //__CPU_PRED_BRANCH_TRACE_HH__
@@ -28,6 +28,9 @@
 
 #include "cpu/pred/btb.hh"
 
+#include <vector>
+
+#include "base/cprintf.hh"
 #include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/Fetch.hh"
@@ -136,3 +139,59 @@ DefaultBTB::update(Addr instPC, const TheISA::PCState &target, ThreadID tid)
     btb[btb_idx].target = target;
     btb[btb_idx].tag = getTag(instPC);
 }
+
+void
+DefaultBTB::serialize(CheckpointOut &cp) const
+{
+    std::vector<unsigned> valid_idx;
+    std::vector<Addr> valid_tag;
+    std::vector<ThreadID> valid_tid;
+    for (unsigned i = 0; i < numEntries; ++i) {
+        if (!btb[i].valid)
+            continue;
+        valid_idx.push_back(i);
+        valid_tag.push_back(btb[i].tag);
+        valid_tid.push_back(btb[i].tid);
+        btb[i].target.serializeSection(cp, csprintf("target%d", i));
+    }
+
+    SERIALIZE_SCALAR(numEntries);
+    SERIALIZE_SCALAR(tagBits);
+    SERIALIZE_CONTAINER(valid_idx);
+    SERIALIZE_CONTAINER(valid_tag);
+    SERIALIZE_CONTAINER(valid_tid);
+}
+
+void
+DefaultBTB::unserialize(CheckpointIn &cp)
+{
+    reset();
+
+    unsigned num_entries;
+    unsigned tag_bits;
+    paramIn(cp, "numEntries", num_entries);
+    paramIn(cp, "tagBits", tag_bits);
+    if (num_entries != numEntries || tag_bits != tagBits) {
+        warn("BTB geometry changed, not restoring its contents\n");
+        return;
+    }
+
+    std::vector<unsigned> valid_idx;
+    std::vector<Addr> valid_tag;
+    std::vector<ThreadID> valid_tid;
+    UNSERIALIZE_CONTAINER(valid_idx);
+    UNSERIALIZE_CONTAINER(valid_tag);
+    UNSERIALIZE_CONTAINER(valid_tid);
+    fatal_if(valid_tag.size() != valid_idx.size() ||
+             valid_tid.size() != valid_idx.size(),
+             "Inconsistent BTB checkpoint\n");
+
+    for (size_t i = 0; i < valid_idx.size(); ++i) {
+        BTBEntry &entry = btb[valid_idx[i]];
+        entry.valid = true;
+        entry.tag = valid_tag[i];
+        entry.tid = valid_tid[i];
+        entry.target.unserializeSection(cp,
+                                        csprintf("target%d", valid_idx[i]));
+    }
+}
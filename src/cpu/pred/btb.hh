@@ -33,8 +33,9 @@
 #include "base/logging.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
+#include "sim/serialize.hh"
 
-class DefaultBTB
+class DefaultBTB : public Serializable
 {
   private:
     struct BTBEntry
@@ -90,6 +91,10 @@ class DefaultBTB
     void update(Addr instPC, const TheISA::PCState &targetPC,
                 ThreadID tid);
 
+    /** Saves the valid entries of the BTB. */
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
   private:
     /** Returns the index into the BTB, based on the branch's PC.
      *  @param inst_PC The branch to look up.
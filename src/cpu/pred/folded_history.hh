@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Folded global histories of the TAGE family of predictors.
+ */
+
+#ifndef __CPU_PRED_FOLDED_HISTORY_HH__
+#define __CPU_PRED_FOLDED_HISTORY_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Folded History Table - compressed history to mix with instruction PC
+ * to index partially tagged tables. This is the history of a single
+ * table, which FoldedHistories keeps for all the tables at once.
+ */
+struct FoldedHistory
+{
+    unsigned comp;
+    int compLength;
+    int origLength;
+    int outpoint;
+
+    FoldedHistory() : comp(0), compLength(0), origLength(0), outpoint(0)
+    {}
+
+    void init(int original_length, int compressed_length)
+    {
+        origLength = original_length;
+        compLength = compressed_length;
+        outpoint = original_length % compressed_length;
+    }
+
+    void update(const uint8_t *h)
+    {
+        comp = (comp << 1) | h[0];
+        comp ^= h[origLength] << outpoint;
+        comp ^= (comp >> compLength);
+        comp &= (1ULL << compLength) - 1;
+    }
+};
+
+/**
+ * The folded histories used for the index and the two tag hashes of
+ * every tagged table of a predictor. The histories are kept as arrays
+ * rather than as a FoldedHistory per table and hash, so that a new
+ * outcome is folded into all of them in a single loop the compiler can
+ * vectorize, and so that saving and restoring them around speculative
+ * updates is a single copy. The results are identical to those of the
+ * separate FoldedHistory objects.
+ */
+class FoldedHistories
+{
+  public:
+    /** The hashes a history is folded for */
+    enum Kind
+    {
+        Index = 0,
+        Tag0,
+        Tag1,
+        NumKinds
+    };
+
+    FoldedHistories() : numBanks(0) {}
+
+    /**
+     * Allocate the histories of the given number of banks. The histories
+     * of a bank are cleared until they are initialized.
+     */
+    void
+    resize(unsigned num_banks)
+    {
+        numBanks = num_banks;
+        const size_t size = NumKinds * num_banks;
+        _comp.assign(size, 0);
+        origLength.assign(size, 0);
+        compLength.assign(size, 0);
+        outpoint.assign(size, 0);
+        mask.assign(size, 0);
+    }
+
+    /**
+     * Set the history and folded lengths of a history.
+     *
+     * @param kind Hash the history is used for
+     * @param bank Tagged table the history belongs to
+     * @param original_length Length of the global history
+     * @param compressed_length Length of the folded history
+     */
+    void
+    init(Kind kind, int bank, int original_length, int compressed_length)
+    {
+        assert(compressed_length > 0 && compressed_length < 32);
+        const size_t i = pos(kind, bank);
+        origLength[i] = original_length;
+        compLength[i] = compressed_length;
+        outpoint[i] = original_length % compressed_length;
+        mask[i] = (1U << compressed_length) - 1;
+    }
+
+    /** Folded history of a bank, for the given hash */
+    unsigned comp(Kind kind, int bank) const { return _comp[pos(kind, bank)]; }
+    unsigned &comp(Kind kind, int bank) { return _comp[pos(kind, bank)]; }
+
+    unsigned index(int bank) const { return comp(Index, bank); }
+    unsigned tag0(int bank) const { return comp(Tag0, bank); }
+    unsigned tag1(int bank) const { return comp(Tag1, bank); }
+
+    /**
+     * Fold the most recent outcome of the global history into all the
+     * histories.
+     *
+     * @param h Global history, with the most recent outcome first
+     */
+    void
+    update(const uint8_t *h)
+    {
+        const unsigned newest = h[0];
+        unsigned *comp = _comp.data();
+        const unsigned *orig_length = origLength.data();
+        const unsigned *comp_length = compLength.data();
+        const unsigned *out = outpoint.data();
+        const unsigned *m = mask.data();
+        const size_t size = _comp.size();
+        for (size_t i = 0; i < size; i++) {
+            unsigned c = (comp[i] << 1) | newest;
+            c ^= unsigned(h[orig_length[i]]) << out[i];
+            c ^= c >> comp_length[i];
+            comp[i] = c & m[i];
+        }
+    }
+
+    /** Number of values save() writes and restore() reads */
+    size_t size() const { return _comp.size(); }
+
+    /**
+     * Copy the histories out, the index histories of all banks first,
+     * followed by those of the first and the second tag hash.
+     */
+    template <typename T>
+    void save(T *dst) const { std::copy(_comp.begin(), _comp.end(), dst); }
+
+    /** Restore the histories saved by save(). */
+    template <typename T>
+    void
+    restore(const T *src)
+    {
+        std::copy(src, src + _comp.size(), _comp.begin());
+    }
+
+  private:
+    size_t pos(Kind kind, int bank) const { return kind * numBanks + bank; }
+
+    unsigned numBanks;
+
+    std::vector<unsigned> _comp;
+    std::vector<unsigned> origLength;
+    std::vector<unsigned> compLength;
+    std::vector<unsigned> outpoint;
+    std::vector<unsigned> mask;
+};
+
+#endif // __CPU_PRED_FOLDED_HISTORY_HH__
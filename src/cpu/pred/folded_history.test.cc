@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "cpu/pred/folded_history.hh"
+
+namespace {
+
+/** Global history, with the most recent outcome first */
+class History
+{
+  public:
+    History(size_t length) : buffer(2 * length), pos(length) {}
+
+    void
+    push(bool taken)
+    {
+        if (pos == 0) {
+            std::copy(buffer.begin(), buffer.begin() + buffer.size() / 2,
+                      buffer.begin() + buffer.size() / 2);
+            pos = buffer.size() / 2;
+        }
+        buffer[--pos] = taken;
+    }
+
+    const uint8_t *data() const { return &buffer[pos]; }
+
+  private:
+    std::vector<uint8_t> buffer;
+    size_t pos;
+};
+
+const int numBanks = 8;
+const int histLengths[numBanks] = {0, 4, 9, 17, 33, 64, 130, 640};
+const int compLengths[numBanks] = {0, 9, 10, 10, 11, 11, 12, 13};
+
+void
+initHistories(FoldedHistories &packed,
+              std::vector<FoldedHistory> (&reference)[3])
+{
+    packed.resize(numBanks);
+    for (auto &histories : reference)
+        histories.resize(numBanks);
+    for (int i = 1; i < numBanks; i++) {
+        packed.init(FoldedHistories::Index, i, histLengths[i],
+                    compLengths[i]);
+        packed.init(FoldedHistories::Tag0, i, histLengths[i],
+                    compLengths[i] - 1);
+        packed.init(FoldedHistories::Tag1, i, histLengths[i],
+                    compLengths[i] - 2);
+        reference[0][i].init(histLengths[i], compLengths[i]);
+        reference[1][i].init(histLengths[i], compLengths[i] - 1);
+        reference[2][i].init(histLengths[i], compLengths[i] - 2);
+    }
+}
+
+void
+expectEqual(const FoldedHistories &packed,
+            const std::vector<FoldedHistory> (&reference)[3])
+{
+    for (int i = 1; i < numBanks; i++) {
+        EXPECT_EQ(packed.index(i), reference[0][i].comp);
+        EXPECT_EQ(packed.tag0(i), reference[1][i].comp);
+        EXPECT_EQ(packed.tag1(i), reference[2][i].comp);
+    }
+}
+
+} // anonymous namespace
+
+/*
+ * Folding random outcomes into the packed histories gives the same
+ * histories as folding them into a FoldedHistory per table and hash.
+ */
+TEST(FoldedHistoriesTest, MatchesReference)
+{
+    FoldedHistories packed;
+    std::vector<FoldedHistory> reference[3];
+    initHistories(packed, reference);
+
+    History history(1024);
+    std::mt19937 rng(1);
+    for (int n = 0; n < 10000; n++) {
+        history.push(rng() & 1);
+        packed.update(history.data());
+        for (auto &histories : reference) {
+            for (int i = 1; i < numBanks; i++)
+                histories[i].update(history.data());
+        }
+        expectEqual(packed, reference);
+    }
+}
+
+/*
+ * The histories saved before a speculative update are restored when the
+ * update is squashed.
+ */
+TEST(FoldedHistoriesTest, SaveRestore)
+{
+    FoldedHistories packed;
+    std::vector<FoldedHistory> reference[3];
+    initHistories(packed, reference);
+
+    History history(1024);
+    std::mt19937 rng(2);
+    for (int n = 0; n < 100; n++) {
+        history.push(rng() & 1);
+        packed.update(history.data());
+        for (auto &histories : reference) {
+            for (int i = 1; i < numBanks; i++)
+                histories[i].update(history.data());
+        }
+    }
+
+    std::vector<int> saved(packed.size());
+    packed.save(saved.data());
+    for (int n = 0; n < 10; n++) {
+        history.push(rng() & 1);
+        packed.update(history.data());
+    }
+    packed.restore(saved.data());
+    expectEqual(packed, reference);
+}
@@ -33,8 +33,11 @@
 
 #include "cpu/pred/loop_predictor.hh"
 
+#include <vector>
+
 #include "base/random.hh"
 #include "base/trace.hh"
+#include "cpu/pred/table_checkpoint.hh"
 #include "debug/LTage.hh"
 #include "params/LoopPredictor.hh"
 
@@ -76,6 +79,70 @@ LoopPredictor::init()
     ltable = new LoopEntry[ULL(1) << logSizeLoopPred];
 }
 
+void
+LoopPredictor::serialize(CheckpointOut &cp) const
+{
+    const size_t size = ULL(1) << logSizeLoopPred;
+    std::vector<uint16_t> num_iter(size);
+    std::vector<uint16_t> current_iter(size);
+    std::vector<uint16_t> current_iter_spec(size);
+    std::vector<uint8_t> confidence(size);
+    std::vector<uint16_t> tag(size);
+    std::vector<uint8_t> age(size);
+    std::vector<uint8_t> dir(size);
+    for (size_t i = 0; i < size; i++) {
+        num_iter[i] = ltable[i].numIter;
+        current_iter[i] = ltable[i].currentIter;
+        current_iter_spec[i] = ltable[i].currentIterSpec;
+        confidence[i] = ltable[i].confidence;
+        tag[i] = ltable[i].tag;
+        age[i] = ltable[i].age;
+        dir[i] = ltable[i].dir;
+    }
+
+    SERIALIZE_CONTAINER(num_iter);
+    SERIALIZE_CONTAINER(current_iter);
+    SERIALIZE_CONTAINER(current_iter_spec);
+    SERIALIZE_CONTAINER(confidence);
+    SERIALIZE_CONTAINER(tag);
+    SERIALIZE_CONTAINER(age);
+    SERIALIZE_CONTAINER(dir);
+    SERIALIZE_SCALAR(loopUseCounter);
+}
+
+void
+LoopPredictor::unserialize(CheckpointIn &cp)
+{
+    const size_t size = ULL(1) << logSizeLoopPred;
+    std::vector<uint16_t> num_iter(size);
+    std::vector<uint16_t> current_iter(size);
+    std::vector<uint16_t> current_iter_spec(size);
+    std::vector<uint8_t> confidence(size);
+    std::vector<uint16_t> tag(size);
+    std::vector<uint8_t> age(size);
+    std::vector<uint8_t> dir(size);
+    if (!unserializeTable(cp, "num_iter", num_iter) ||
+        !unserializeTable(cp, "current_iter", current_iter) ||
+        !unserializeTable(cp, "current_iter_spec", current_iter_spec) ||
+        !unserializeTable(cp, "confidence", confidence) ||
+        !unserializeTable(cp, "tag", tag) ||
+        !unserializeTable(cp, "age", age) ||
+        !unserializeTable(cp, "dir", dir)) {
+        return;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        ltable[i].numIter = num_iter[i];
+        ltable[i].currentIter = current_iter[i];
+        ltable[i].currentIterSpec = current_iter_spec[i];
+        ltable[i].confidence = confidence[i];
+        ltable[i].tag = tag[i];
+        ltable[i].age = age[i];
+        ltable[i].dir = dir[i];
+    }
+    UNSERIALIZE_SCALAR(loopUseCounter);
+}
+
 LoopPredictor::BranchInfo*
 LoopPredictor::makeBranchInfo()
 {
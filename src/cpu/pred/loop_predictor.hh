@@ -252,6 +252,9 @@ class LoopPredictor : public SimObject
      */
     void init() override;
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
     LoopPredictor(const LoopPredictorParams &p);
 
     size_t getSizeInBits() const;
@@ -38,6 +38,7 @@
 
 #include "cpu/pred/multiperspective_perceptron.hh"
 
+#include "base/cprintf.hh"
 #include "base/random.hh"
 #include "debug/Branch.hh"
 
@@ -49,6 +50,46 @@ int
 MultiperspectivePerceptron::xlat4[] =
     {0,4,5,7,9,11,12,14,16,17,19,22,28,33,39,45,};
 
+namespace
+{
+
+/** Save a set of tables, one entry per table */
+template <class T>
+void
+serializeTables(CheckpointOut &cp, const std::string &name,
+                const std::vector<std::vector<T>> &tables)
+{
+    for (size_t i = 0; i < tables.size(); i++)
+        arrayParamOut(cp, csprintf("%s%d", name, i), tables[i]);
+}
+
+void
+serializeTables(CheckpointOut &cp, const std::string &name,
+                const std::vector<std::vector<bool>> &tables)
+{
+    for (size_t i = 0; i < tables.size(); i++)
+        serializeBits(cp, csprintf("%s%d", name, i), tables[i]);
+}
+
+template <class T>
+void
+unserializeTables(CheckpointIn &cp, const std::string &name,
+                  std::vector<std::vector<T>> &tables)
+{
+    for (size_t i = 0; i < tables.size(); i++)
+        unserializeTable(cp, csprintf("%s%d", name, i), tables[i]);
+}
+
+void
+unserializeTables(CheckpointIn &cp, const std::string &name,
+                  std::vector<std::vector<bool>> &tables)
+{
+    for (size_t i = 0; i < tables.size(); i++)
+        unserializeBits(cp, csprintf("%s%d", name, i), tables[i]);
+}
+
+} // anonymous namespace
+
 MultiperspectivePerceptron::ThreadData::ThreadData(int num_filters,
         int n_local_histories, int local_history_length, int assoc,
         const std::vector<std::vector<int>> &blurrypath_bits, int path_length,
@@ -136,6 +177,107 @@ MultiperspectivePerceptron::setExtraBits(int bits)
     extrabits = bits;
 }
 
+void
+MultiperspectivePerceptron::ThreadData::serialize(CheckpointOut &cp) const
+{
+    std::vector<bool> seen_taken;
+    std::vector<bool> seen_untaken;
+    for (const auto &entry : filterTable) {
+        seen_taken.push_back(entry.seenTaken);
+        seen_untaken.push_back(entry.seenUntaken);
+    }
+    serializeBits(cp, "seen_taken", seen_taken);
+    serializeBits(cp, "seen_untaken", seen_untaken);
+
+    serializeTables(cp, "acyclic_histories", acyclic_histories);
+    serializeTables(cp, "acyclic2_histories", acyclic2_histories);
+    serializeTables(cp, "blurrypath_histories", blurrypath_histories);
+    SERIALIZE_CONTAINER(ghist_words);
+    serializeTables(cp, "modpath_histories", modpath_histories);
+    serializeTables(cp, "mod_histories", mod_histories);
+    SERIALIZE_CONTAINER(path_history);
+    SERIALIZE_CONTAINER(imli_counter);
+    localHistories.serialize(cp);
+    SERIALIZE_CONTAINER(recency_stack);
+    SERIALIZE_SCALAR(last_ghist_bit);
+    SERIALIZE_SCALAR(occupancy);
+    SERIALIZE_CONTAINER(mpreds);
+    serializeTables(cp, "tables", tables);
+
+    for (size_t i = 0; i < sign_bits.size(); i++) {
+        std::vector<bool> bits;
+        for (const auto &entry : sign_bits[i]) {
+            bits.push_back(entry[0]);
+            bits.push_back(entry[1]);
+        }
+        serializeBits(cp, csprintf("sign_bits%d", i), bits);
+    }
+}
+
+void
+MultiperspectivePerceptron::ThreadData::unserialize(CheckpointIn &cp)
+{
+    std::vector<bool> seen_taken(filterTable.size());
+    std::vector<bool> seen_untaken(filterTable.size());
+    if (unserializeBits(cp, "seen_taken", seen_taken) &&
+        unserializeBits(cp, "seen_untaken", seen_untaken)) {
+        for (size_t i = 0; i < filterTable.size(); i++) {
+            filterTable[i].seenTaken = seen_taken[i];
+            filterTable[i].seenUntaken = seen_untaken[i];
+        }
+    }
+
+    unserializeTables(cp, "acyclic_histories", acyclic_histories);
+    unserializeTables(cp, "acyclic2_histories", acyclic2_histories);
+    unserializeTables(cp, "blurrypath_histories", blurrypath_histories);
+    unserializeTable(cp, "ghist_words", ghist_words);
+    unserializeTables(cp, "modpath_histories", modpath_histories);
+    unserializeTables(cp, "mod_histories", mod_histories);
+    unserializeTable(cp, "path_history", path_history);
+    unserializeTable(cp, "imli_counter", imli_counter);
+    localHistories.unserialize(cp);
+    unserializeTable(cp, "recency_stack", recency_stack);
+    optParamIn(cp, "last_ghist_bit", last_ghist_bit, false);
+    optParamIn(cp, "occupancy", occupancy, false);
+    unserializeTable(cp, "mpreds", mpreds);
+    unserializeTables(cp, "tables", tables);
+
+    for (size_t i = 0; i < sign_bits.size(); i++) {
+        std::vector<bool> bits(sign_bits[i].size() * 2);
+        if (!unserializeBits(cp, csprintf("sign_bits%d", i), bits))
+            continue;
+        for (size_t j = 0; j < sign_bits[i].size(); j++) {
+            sign_bits[i][j][0] = bits[2 * j];
+            sign_bits[i][j][1] = bits[2 * j + 1];
+        }
+    }
+}
+
+void
+MultiperspectivePerceptron::serialize(CheckpointOut &cp) const
+{
+    BPredUnit::serialize(cp);
+    SERIALIZE_SCALAR(thresholdCounter);
+    SERIALIZE_SCALAR(theta);
+    for (size_t tid = 0; tid < threadData.size(); tid++)
+        threadData[tid]->serializeSection(cp, csprintf("thread%d", tid));
+}
+
+void
+MultiperspectivePerceptron::unserialize(CheckpointIn &cp)
+{
+    BPredUnit::unserialize(cp);
+    optParamIn(cp, "thresholdCounter", thresholdCounter, false);
+    optParamIn(cp, "theta", theta, false);
+
+    const std::string section = Serializable::currentSection();
+    for (size_t tid = 0; tid < threadData.size(); tid++) {
+        const std::string thread = csprintf("thread%d", tid);
+        if (cp.sectionExists(section + "." + thread))
+            threadData[tid]->unserializeSection(cp, thread);
+    }
+}
+
 void
 MultiperspectivePerceptron::init()
 {
@@ -43,6 +43,7 @@
 #include <vector>
 
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/table_checkpoint.hh"
 #include "params/MultiperspectivePerceptron.hh"
 
 class MultiperspectivePerceptron : public BPredUnit
@@ -208,6 +209,16 @@ class MultiperspectivePerceptron : public BPredUnit
         {
             return localHistoryLength * localHistories.size();
         }
+
+        void serialize(CheckpointOut &cp) const
+        {
+            SERIALIZE_CONTAINER(localHistories);
+        }
+
+        void unserialize(CheckpointIn &cp)
+        {
+            unserializeTable(cp, "localHistories", localHistories);
+        }
     };
 
     /**
@@ -285,7 +296,7 @@ class MultiperspectivePerceptron : public BPredUnit
     static int xlat4[];
 
     /** History data is kept for each thread */
-    struct ThreadData {
+    struct ThreadData : public Serializable {
         ThreadData(int num_filter, int n_local_histories,
             int local_history_length, int assoc,
             const std::vector<std::vector<int>> &blurrypath_bits,
@@ -344,6 +355,9 @@ class MultiperspectivePerceptron : public BPredUnit
         std::vector<int> mpreds;
         std::vector<std::vector<short int>> tables;
         std::vector<std::vector<std::array<bool, 2>>> sign_bits;
+
+        void serialize(CheckpointOut &cp) const override;
+        void unserialize(CheckpointIn &cp) override;
     };
     std::vector<ThreadData *> threadData;
 
@@ -1023,6 +1037,9 @@ class MultiperspectivePerceptron : public BPredUnit
 
     void init() override;
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
     void uncondBranch(ThreadID tid, Addr pc, void * &bp_history) override;
     void squash(ThreadID tid, void *bp_history) override;
     bool lookup(ThreadID tid, Addr instPC, void * &bp_history) override;
@@ -220,11 +220,7 @@ MPP_TAGE::updatePathAndGlobalHistory(
         path >>= 1;
         updateGHist(tHist.gHist, dir, tHist.globalHistory, tHist.ptGhist);
         tHist.pathHist = (tHist.pathHist << 1) ^ pathbit;
-        for (int i = 1; i <= nHistoryTables; i++) {
-            tHist.computeIndices[i].update(tHist.gHist);
-            tHist.computeTags[0][i].update(tHist.gHist);
-            tHist.computeTags[1][i].update(tHist.gHist);
-        }
+        tHist.folded.update(tHist.gHist);
     }
 }
 
@@ -681,3 +677,21 @@ MultiperspectivePerceptronTAGE::squash(ThreadID tid, void *bp_history)
     MPPTAGEBranchInfo *bi = static_cast<MPPTAGEBranchInfo*>(bp_history);
     delete bi;
 }
+
+void
+MPP_StatisticalCorrector::serialize(CheckpointOut &cp) const
+{
+    StatisticalCorrector::serialize(cp);
+    serializeGEHL(cp, "pgehl", pgehl, pnb, wp);
+    serializeGEHL(cp, "ggehl", ggehl, gnb, wg);
+    SERIALIZE_SCALAR(thirdH);
+}
+
+void
+MPP_StatisticalCorrector::unserialize(CheckpointIn &cp)
+{
+    StatisticalCorrector::unserialize(cp);
+    unserializeGEHL(cp, "pgehl", pgehl, pnb, wp);
+    unserializeGEHL(cp, "ggehl", ggehl, gnb, wg);
+    optParamIn(cp, "thirdH", thirdH, false);
+}
@@ -139,6 +139,24 @@ class MPP_StatisticalCorrector : public StatisticalCorrector {
             }
         }
         unsigned int getPointer() const { return historyStackPointer; }
+
+        void
+        serialize(CheckpointOut &cp) const override
+        {
+            SCThreadHistory::serialize(cp);
+            SERIALIZE_SCALAR(globalHist);
+            SERIALIZE_CONTAINER(historyStack);
+            SERIALIZE_SCALAR(historyStackPointer);
+        }
+
+        void
+        unserialize(CheckpointIn &cp) override
+        {
+            SCThreadHistory::unserialize(cp);
+            optParamIn(cp, "globalHist", globalHist, false);
+            if (unserializeTable(cp, "historyStack", historyStack))
+                UNSERIALIZE_SCALAR(historyStackPointer);
+        }
     };
 
   public:
@@ -148,6 +166,9 @@ class MPP_StatisticalCorrector : public StatisticalCorrector {
     };
     MPP_StatisticalCorrector(const MPP_StatisticalCorrectorParams &p);
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
     void initBias() override;
     unsigned getIndBias(Addr branch_pc, StatisticalCorrector::BranchInfo* bi,
                         bool bias) const override;
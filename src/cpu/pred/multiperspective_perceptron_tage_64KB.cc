@@ -215,3 +215,19 @@ MultiperspectivePerceptronTAGE64KB::createSpecs()
     addSpec(new RECENCY(9, 3, -1, 2.51, 0, 6, *this));
     addSpec(new ACYCLIC(12, -1, -1, 2.0, 0, 6, *this));
 }
+
+void
+MPP_StatisticalCorrector_64KB::serialize(CheckpointOut &cp) const
+{
+    MPP_StatisticalCorrector::serialize(cp);
+    serializeGEHL(cp, "sgehl", sgehl, snb, ws);
+    serializeGEHL(cp, "tgehl", tgehl, tnb, wt);
+}
+
+void
+MPP_StatisticalCorrector_64KB::unserialize(CheckpointIn &cp)
+{
+    MPP_StatisticalCorrector::unserialize(cp);
+    unserializeGEHL(cp, "sgehl", sgehl, snb, ws);
+    unserializeGEHL(cp, "tgehl", tgehl, tnb, wt);
+}
@@ -74,6 +74,9 @@ class MPP_StatisticalCorrector_64KB : public MPP_StatisticalCorrector {
   public:
     MPP_StatisticalCorrector_64KB(
             const MPP_StatisticalCorrector_64KBParams &p);
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
     size_t getSizeInBits() const override;
 };
 
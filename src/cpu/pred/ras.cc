@@ -28,6 +28,9 @@
 
 #include "cpu/pred/ras.hh"
 
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+
 void
 ReturnAddrStack::init(unsigned _numEntries)
 {
@@ -79,3 +82,31 @@ ReturnAddrStack::restore(unsigned top_entry_idx,
         ++usedEntries;
     }
 }
+
+void
+ReturnAddrStack::serialize(CheckpointOut &cp) const
+{
+    SERIALIZE_SCALAR(numEntries);
+    SERIALIZE_SCALAR(usedEntries);
+    SERIALIZE_SCALAR(tos);
+    for (unsigned i = 0; i < numEntries; ++i)
+        addrStack[i].serializeSection(cp, csprintf("entry%d", i));
+}
+
+void
+ReturnAddrStack::unserialize(CheckpointIn &cp)
+{
+    unsigned num_entries;
+    paramIn(cp, "numEntries", num_entries);
+    if (num_entries != numEntries) {
+        warn("RAS size changed from %d to %d entries, not restoring it\n",
+             num_entries, numEntries);
+        reset();
+        return;
+    }
+
+    UNSERIALIZE_SCALAR(usedEntries);
+    UNSERIALIZE_SCALAR(tos);
+    for (unsigned i = 0; i < numEntries; ++i)
+        addrStack[i].unserializeSection(cp, csprintf("entry%d", i));
+}
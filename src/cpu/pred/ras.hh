@@ -34,9 +34,10 @@
 #include "arch/types.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
+#include "sim/serialize.hh"
 
 /** Return address stack class, implements a simple RAS. */
-class ReturnAddrStack
+class ReturnAddrStack : public Serializable
 {
   public:
     /** Creates a return address stack, but init() must be called prior to
@@ -75,6 +76,10 @@ class ReturnAddrStack
      bool empty() { return usedEntries == 0; }
 
      bool full() { return usedEntries == numEntries; }
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
   private:
     /** Increments the top of stack index. */
     inline void incrTos()
@@ -41,6 +41,7 @@
 
  #include "cpu/pred/statistical_corrector.hh"
 
+ #include "base/cprintf.hh"
  #include "params/StatisticalCorrector.hh"
 
  StatisticalCorrector::StatisticalCorrector(
@@ -390,6 +391,83 @@ StatisticalCorrector::init()
     initBias();
 }
 
+void
+StatisticalCorrector::SCThreadHistory::serialize(CheckpointOut &cp) const
+{
+    SERIALIZE_SCALAR(bwHist);
+    SERIALIZE_SCALAR(imliCount);
+    for (unsigned i = 0; i < numOrdinalHistories; i++) {
+        arrayParamOut(cp, csprintf("localHistories%d", i),
+                      localHistories[i]);
+    }
+}
+
+void
+StatisticalCorrector::SCThreadHistory::unserialize(CheckpointIn &cp)
+{
+    optParamIn(cp, "bwHist", bwHist, false);
+    optParamIn(cp, "imliCount", imliCount, false);
+    for (unsigned i = 0; i < numOrdinalHistories; i++) {
+        unserializeTable(cp, csprintf("localHistories%d", i),
+                         localHistories[i]);
+    }
+}
+
+void
+StatisticalCorrector::serializeGEHL(CheckpointOut &cp,
+    const std::string &name, const std::vector<int8_t> * tab, unsigned nbr,
+    const std::vector<int8_t> & w) const
+{
+    for (unsigned i = 0; i < nbr; i++)
+        arrayParamOut(cp, csprintf("%s%d", name, i), tab[i]);
+    arrayParamOut(cp, name + "_w", w);
+}
+
+void
+StatisticalCorrector::unserializeGEHL(CheckpointIn &cp,
+    const std::string &name, std::vector<int8_t> * tab, unsigned nbr,
+    std::vector<int8_t> & w)
+{
+    for (unsigned i = 0; i < nbr; i++)
+        unserializeTable(cp, csprintf("%s%d", name, i), tab[i]);
+    unserializeTable(cp, name + "_w", w);
+}
+
+void
+StatisticalCorrector::serialize(CheckpointOut &cp) const
+{
+    serializeGEHL(cp, "bwgehl", bwgehl, bwnb, wbw);
+    serializeGEHL(cp, "lgehl", lgehl, lnb, wl);
+    serializeGEHL(cp, "igehl", igehl, inb, wi);
+    SERIALIZE_CONTAINER(bias);
+    SERIALIZE_CONTAINER(biasSK);
+    SERIALIZE_CONTAINER(biasBank);
+    SERIALIZE_CONTAINER(wb);
+    SERIALIZE_SCALAR(updateThreshold);
+    SERIALIZE_CONTAINER(pUpdateThreshold);
+    SERIALIZE_SCALAR(firstH);
+    SERIALIZE_SCALAR(secondH);
+    scHistory->serializeSection(cp, "history");
+}
+
+void
+StatisticalCorrector::unserialize(CheckpointIn &cp)
+{
+    unserializeGEHL(cp, "bwgehl", bwgehl, bwnb, wbw);
+    unserializeGEHL(cp, "lgehl", lgehl, lnb, wl);
+    unserializeGEHL(cp, "igehl", igehl, inb, wi);
+    unserializeTable(cp, "bias", bias);
+    unserializeTable(cp, "biasSK", biasSK);
+    unserializeTable(cp, "biasBank", biasBank);
+    unserializeTable(cp, "wb", wb);
+    optParamIn(cp, "updateThreshold", updateThreshold, false);
+    unserializeTable(cp, "pUpdateThreshold", pUpdateThreshold);
+    optParamIn(cp, "firstH", firstH, false);
+    optParamIn(cp, "secondH", secondH, false);
+    if (cp.sectionExists(Serializable::currentSection() + ".history"))
+        scHistory->unserializeSection(cp, "history");
+}
+
 size_t
 StatisticalCorrector::getSizeInBits() const
 {
@@ -44,7 +44,9 @@
 
 #include "base/statistics.hh"
 #include "base/types.hh"
+#include "cpu/pred/table_checkpoint.hh"
 #include "cpu/static_inst.hh"
+#include "sim/serialize.hh"
 #include "sim/sim_object.hh"
 
 struct StatisticalCorrectorParams;
@@ -66,7 +68,7 @@ class StatisticalCorrector : public SimObject
         }
     }
     // histories used for the statistical corrector
-    struct SCThreadHistory {
+    struct SCThreadHistory : public Serializable {
         SCThreadHistory() {
             bwHist = 0;
             numOrdinalHistories = 0;
@@ -114,6 +116,9 @@ class StatisticalCorrector : public SimObject
             localHistories[idx][entry] = hist;
         }
 
+        void serialize(CheckpointOut &cp) const override;
+        void unserialize(CheckpointIn &cp) override;
+
       private:
         std::vector<int64_t> * localHistories;
         std::vector<int> shifts;
@@ -262,7 +267,19 @@ class StatisticalCorrector : public SimObject
     virtual void gUpdates( ThreadID tid, Addr pc, bool taken, BranchInfo* bi,
         int64_t phist) = 0;
 
+    /**
+     * Save/restore the tables of a GEHL component and their weights
+     * @param name Name of the component in the checkpoint
+     */
+    void serializeGEHL(CheckpointOut &cp, const std::string &name,
+        const std::vector<int8_t> * tab, unsigned nbr,
+        const std::vector<int8_t> & w) const;
+    void unserializeGEHL(CheckpointIn &cp, const std::string &name,
+        std::vector<int8_t> * tab, unsigned nbr, std::vector<int8_t> & w);
+
     void init() override;
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
     void updateStats(bool taken, BranchInfo *bi);
 
     virtual void condBranchUpdate(ThreadID tid, Addr branch_pc, bool taken,
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Helpers to checkpoint the tables of the branch predictors. Tables are
+ * only restored if their size matches the one of the checkpoint, so that
+ * a checkpoint can be restored into a differently sized predictor, which
+ * then simply starts cold. Tables missing from the checkpoint, e.g., in
+ * checkpoints taken before predictor state was saved, are left untouched.
+ */
+
+#ifndef __CPU_PRED_TABLE_CHECKPOINT_HH__
+#define __CPU_PRED_TABLE_CHECKPOINT_HH__
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/logging.hh"
+#include "base/sat_counter.hh"
+#include "sim/serialize.hh"
+
+/**
+ * Restore a table saved with SERIALIZE_CONTAINER or arrayParamOut.
+ *
+ * @param cp The checkpoint.
+ * @param name Name of the table in the checkpoint.
+ * @param table The table, sized as configured.
+ * @return True if the table was restored.
+ */
+template <class T>
+bool
+unserializeTable(CheckpointIn &cp, const std::string &name,
+                 std::vector<T> &table)
+{
+    if (!cp.entryExists(Serializable::currentSection(), name))
+        return false;
+
+    std::vector<T> saved;
+    arrayParamIn(cp, name, saved);
+    if (saved.size() != table.size()) {
+        warn("Not restoring %s:%s, its size changed from %d to %d.\n",
+             Serializable::currentSection(), name, saved.size(),
+             table.size());
+        return false;
+    }
+    table = std::move(saved);
+    return true;
+}
+
+/** Save a table of bits. */
+inline void
+serializeBits(CheckpointOut &cp, const std::string &name,
+              const std::vector<bool> &bits)
+{
+    const std::vector<uint8_t> values(bits.begin(), bits.end());
+    arrayParamOut(cp, name, values);
+}
+
+/** Restore a table of bits. @sa unserializeTable */
+inline bool
+unserializeBits(CheckpointIn &cp, const std::string &name,
+                std::vector<bool> &bits)
+{
+    std::vector<uint8_t> values(bits.size());
+    if (!unserializeTable(cp, name, values))
+        return false;
+    bits.assign(values.begin(), values.end());
+    return true;
+}
+
+/** Save a table of saturating counters. */
+inline void
+serializeCounters(CheckpointOut &cp, const std::string &name,
+                  const std::vector<SatCounter8> &counters)
+{
+    std::vector<uint8_t> values;
+    values.reserve(counters.size());
+    for (const auto &counter : counters)
+        values.push_back(counter);
+    arrayParamOut(cp, name, values);
+}
+
+/** Restore a table of saturating counters. @sa unserializeTable */
+inline bool
+unserializeCounters(CheckpointIn &cp, const std::string &name,
+                    std::vector<SatCounter8> &counters)
+{
+    std::vector<uint8_t> values(counters.size());
+    if (!unserializeTable(cp, name, values))
+        return false;
+    for (size_t i = 0; i < counters.size(); i++) {
+        // Counters can only be set through their arithmetic operators
+        counters[i] -= uint8_t(counters[i]);
+        counters[i] += values[i];
+    }
+    return true;
+}
+
+#endif // __CPU_PRED_TABLE_CHECKPOINT_HH__
@@ -37,8 +37,13 @@
 
 #include "cpu/pred/tage_base.hh"
 
+#include <algorithm>
+
+#include "base/bitfield.hh"
+#include "base/cprintf.hh"
 #include "base/intmath.hh"
 #include "base/logging.hh"
+#include "cpu/pred/table_checkpoint.hh"
 #include "debug/Fetch.hh"
 #include "debug/Tage.hh"
 
@@ -55,6 +60,7 @@ TAGEBase::TAGEBase(const TAGEBaseParams &p)
      tagTableTagWidths(p.tagTableTagWidths),
      logTagTableSizes(p.logTagTableSizes),
      threadHistory(p.numThreads),
+     batchedIndexing(p.batchedIndexing),
      logUResetPeriod(p.logUResetPeriod),
      initialTCounterValue(p.initialTCounterValue),
      numUseAltOnNa(p.numUseAltOnNa),
@@ -120,14 +126,26 @@ TAGEBase::init()
     // implementation
     assert(tagTableTagWidths[0] == 0);
 
-    for (auto& history : threadHistory) {
-        history.computeIndices = new FoldedHistory[nHistoryTables+1];
-        history.computeTags[0] = new FoldedHistory[nHistoryTables+1];
-        history.computeTags[1] = new FoldedHistory[nHistoryTables+1];
+    // The hit banks of a lookup are gathered in a 64-bit mask
+    fatal_if(nHistoryTables >= 64, "%s: TAGE supports at most 63 tagged "
+             "tables, not %d.", name(), nHistoryTables);
 
+    for (auto& history : threadHistory) {
+        history.folded.resize(nHistoryTables + 1);
         initFoldedHistories(history);
     }
 
+    bankHashes.resize(nHistoryTables + 1);
+    for (int i = 1; i <= nHistoryTables; i++) {
+        const int hlen = std::min<int>(histLengths[i], pathHistBits);
+        BankHash &hash = bankHashes[i];
+        hash.indexMask = (ULL(1) << logTagTableSizes[i]) - 1;
+        hash.tagMask = (ULL(1) << tagTableTagWidths[i]) - 1;
+        hash.pcShift = abs(logTagTableSizes[i] - i) + 1;
+        hash.pathMask = (ULL(1) << hlen) - 1;
+        hash.logSize = logTagTableSizes[i];
+    }
+
     const uint64_t bimodalTableSize = ULL(1) << logTagTableSizes[0];
     btablePrediction.resize(bimodalTableSize, false);
     btableHysteresis.resize(bimodalTableSize >> logRatioBiModalHystEntries,
@@ -145,12 +163,12 @@ void
 TAGEBase::initFoldedHistories(ThreadHistory & history)
 {
     for (int i = 1; i <= nHistoryTables; i++) {
-        history.computeIndices[i].init(
+        history.folded.init(FoldedHistories::Index, i,
             histLengths[i], (logTagTableSizes[i]));
-        history.computeTags[0][i].init(
-            history.computeIndices[i].origLength, tagTableTagWidths[i]);
-        history.computeTags[1][i].init(
-            history.computeIndices[i].origLength, tagTableTagWidths[i]-1);
+        history.folded.init(FoldedHistories::Tag0, i,
+            histLengths[i], tagTableTagWidths[i]);
+        history.folded.init(FoldedHistories::Tag1, i,
+            histLengths[i], tagTableTagWidths[i]-1);
         DPRINTF(Tage, "HistLength:%d, TTSize:%d, TTTWidth:%d\n",
                 histLengths[i], logTagTableSizes[i], tagTableTagWidths[i]);
     }
@@ -164,6 +182,124 @@ TAGEBase::buildTageTables()
     }
 }
 
+size_t
+TAGEBase::gtableSize(int bank) const
+{
+    return ULL(1) << logTagTableSizes[bank];
+}
+
+void
+TAGEBase::serialize(CheckpointOut &cp) const
+{
+    serializeBits(cp, "btablePrediction", btablePrediction);
+    serializeBits(cp, "btableHysteresis", btableHysteresis);
+
+    for (int i = 1; i <= nHistoryTables; i++) {
+        const size_t size = gtableSize(i);
+        if (!size)
+            continue;
+        std::vector<int8_t> ctr(size);
+        std::vector<uint16_t> tag(size);
+        std::vector<uint8_t> u(size);
+        for (size_t j = 0; j < size; j++) {
+            ctr[j] = gtable[i][j].ctr;
+            tag[j] = gtable[i][j].tag;
+            u[j] = gtable[i][j].u;
+        }
+        arrayParamOut(cp, csprintf("gtable%d.ctr", i), ctr);
+        arrayParamOut(cp, csprintf("gtable%d.tag", i), tag);
+        arrayParamOut(cp, csprintf("gtable%d.u", i), u);
+    }
+
+    SERIALIZE_SCALAR(tCounter);
+    SERIALIZE_CONTAINER(useAltPredForNewlyAllocated);
+
+    for (size_t tid = 0; tid < threadHistory.size(); tid++) {
+        const ThreadHistory &history = threadHistory[tid];
+        ScopedCheckpointSection sec(cp, csprintf("thread%d", tid));
+
+        std::vector<unsigned> index_comp;
+        std::vector<unsigned> tag0_comp;
+        std::vector<unsigned> tag1_comp;
+        for (int i = 1; i <= nHistoryTables; i++) {
+            index_comp.push_back(history.folded.index(i));
+            tag0_comp.push_back(history.folded.tag0(i));
+            tag1_comp.push_back(history.folded.tag1(i));
+        }
+
+        paramOut(cp, "pathHist", history.pathHist);
+        paramOut(cp, "ptGhist", history.ptGhist);
+        arrayParamOut(cp, "globalHistory", history.globalHistory,
+                      histBufferSize);
+        SERIALIZE_CONTAINER(index_comp);
+        SERIALIZE_CONTAINER(tag0_comp);
+        SERIALIZE_CONTAINER(tag1_comp);
+    }
+}
+
+void
+TAGEBase::unserialize(CheckpointIn &cp)
+{
+    unserializeBits(cp, "btablePrediction", btablePrediction);
+    unserializeBits(cp, "btableHysteresis", btableHysteresis);
+
+    for (int i = 1; i <= nHistoryTables; i++) {
+        const size_t size = gtableSize(i);
+        if (!size)
+            continue;
+        std::vector<int8_t> ctr(size);
+        std::vector<uint16_t> tag(size);
+        std::vector<uint8_t> u(size);
+        if (!unserializeTable(cp, csprintf("gtable%d.ctr", i), ctr) ||
+            !unserializeTable(cp, csprintf("gtable%d.tag", i), tag) ||
+            !unserializeTable(cp, csprintf("gtable%d.u", i), u)) {
+            continue;
+        }
+        for (size_t j = 0; j < size; j++) {
+            gtable[i][j].ctr = ctr[j];
+            gtable[i][j].tag = tag[j];
+            gtable[i][j].u = u[j];
+        }
+    }
+
+    optParamIn(cp, "tCounter", tCounter, false);
+    unserializeTable(cp, "useAltPredForNewlyAllocated",
+                     useAltPredForNewlyAllocated);
+
+    const std::string section = Serializable::currentSection();
+    for (size_t tid = 0; tid < threadHistory.size(); tid++) {
+        const std::string thread = csprintf("thread%d", tid);
+        if (!cp.sectionExists(section + "." + thread))
+            continue;
+
+        ThreadHistory &history = threadHistory[tid];
+        ScopedCheckpointSection sec(cp, thread);
+
+        std::vector<uint8_t> global_history(histBufferSize);
+        std::vector<unsigned> index_comp(nHistoryTables);
+        std::vector<unsigned> tag0_comp(nHistoryTables);
+        std::vector<unsigned> tag1_comp(nHistoryTables);
+        if (!unserializeTable(cp, "globalHistory", global_history) ||
+            !unserializeTable(cp, "index_comp", index_comp) ||
+            !unserializeTable(cp, "tag0_comp", tag0_comp) ||
+            !unserializeTable(cp, "tag1_comp", tag1_comp)) {
+            continue;
+        }
+
+        paramIn(cp, "pathHist", history.pathHist);
+        paramIn(cp, "ptGhist", history.ptGhist);
+        std::copy(global_history.begin(), global_history.end(),
+                  history.globalHistory);
+        history.gHist = &history.globalHistory[history.ptGhist];
+        for (int i = 1; i <= nHistoryTables; i++) {
+            history.folded.comp(FoldedHistories::Index, i) =
+                index_comp[i - 1];
+            history.folded.comp(FoldedHistories::Tag0, i) = tag0_comp[i - 1];
+            history.folded.comp(FoldedHistories::Tag1, i) = tag1_comp[i - 1];
+        }
+    }
+}
+
 void
 TAGEBase::calculateParameters()
 {
@@ -186,14 +322,8 @@ TAGEBase::btbUpdate(ThreadID tid, Addr branch_pc, BranchInfo* &bi)
         DPRINTF(Tage, "BTB miss resets prediction: %lx\n", branch_pc);
         assert(tHist.gHist == &tHist.globalHistory[tHist.ptGhist]);
         tHist.gHist[0] = 0;
-        for (int i = 1; i <= nHistoryTables; i++) {
-            tHist.computeIndices[i].comp = bi->ci[i];
-            tHist.computeTags[0][i].comp = bi->ct0[i];
-            tHist.computeTags[1][i].comp = bi->ct1[i];
-            tHist.computeIndices[i].update(tHist.gHist);
-            tHist.computeTags[0][i].update(tHist.gHist);
-            tHist.computeTags[1][i].update(tHist.gHist);
-        }
+        tHist.folded.restore(bi->ci);
+        tHist.folded.update(tHist.gHist);
     }
 }
 
@@ -230,7 +360,7 @@ TAGEBase::gindex(ThreadID tid, Addr pc, int bank) const
     index =
         shiftedPc ^
         (shiftedPc >> ((int) abs(logTagTableSizes[bank] - bank) + 1)) ^
-        threadHistory[tid].computeIndices[bank].comp ^
+        threadHistory[tid].folded.index(bank) ^
         F(threadHistory[tid].pathHist, hlen, bank);
 
     return (index & ((ULL(1) << (logTagTableSizes[bank])) - 1));
@@ -242,8 +372,8 @@ uint16_t
 TAGEBase::gtag(ThreadID tid, Addr pc, int bank) const
 {
     int tag = (pc >> instShiftAmt) ^
-              threadHistory[tid].computeTags[0][bank].comp ^
-              (threadHistory[tid].computeTags[1][bank].comp << 1);
+              threadHistory[tid].folded.tag0(bank) ^
+              (threadHistory[tid].folded.tag1(bank) << 1);
 
     return (tag & ((ULL(1) << tagTableTagWidths[bank]) - 1));
 }
@@ -334,13 +464,42 @@ void
 TAGEBase::calculateIndicesAndTags(ThreadID tid, Addr branch_pc,
                                   BranchInfo* bi)
 {
-    // computes the table addresses and the partial tags
+    if (!batchedIndexing) {
+        // computes the table addresses and the partial tags
+        for (int i = 1; i <= nHistoryTables; i++) {
+            tableIndices[i] = gindex(tid, branch_pc, i);
+            bi->tableIndices[i] = tableIndices[i];
+            tableTags[i] = gtag(tid, branch_pc, i);
+            bi->tableTags[i] = tableTags[i];
+        }
+        return;
+    }
+
+    // Same hashes as gindex() and gtag(), for all the tables at once
+    // with the per-table constants computed up front
+    const ThreadHistory &tHist = threadHistory[tid];
+    const unsigned shifted_pc = branch_pc >> instShiftAmt;
+    const int path_hist = tHist.pathHist;
     for (int i = 1; i <= nHistoryTables; i++) {
-        tableIndices[i] = gindex(tid, branch_pc, i);
-        bi->tableIndices[i] = tableIndices[i];
-        tableTags[i] = gtag(tid, branch_pc, i);
-        bi->tableTags[i] = tableTags[i];
+        const BankHash &hash = bankHashes[i];
+
+        // Path history folding of F()
+        int a = path_hist & hash.pathMask;
+        int a1 = a & hash.indexMask;
+        int a2 = a >> hash.logSize;
+        a2 = ((a2 << i) & hash.indexMask) + (a2 >> (hash.logSize - i));
+        a = a1 ^ a2;
+        a = ((a << i) & hash.indexMask) + (a >> (hash.logSize - i));
+
+        tableIndices[i] = (shifted_pc ^ (shifted_pc >> hash.pcShift) ^
+                           tHist.folded.index(i) ^ a) & hash.indexMask;
+        tableTags[i] = (shifted_pc ^ tHist.folded.tag0(i) ^
+                        (tHist.folded.tag1(i) << 1)) & hash.tagMask;
     }
+    std::copy(tableIndices + 1, tableIndices + nHistoryTables + 1,
+              bi->tableIndices + 1);
+    std::copy(tableTags + 1, tableTags + nHistoryTables + 1,
+              bi->tableTags + 1);
 }
 
 unsigned
@@ -364,25 +523,25 @@ TAGEBase::tagePredict(ThreadID tid, Addr branch_pc,
 
         bi->bimodalIndex = bindex(pc);
 
+        // Check all the banks for a matching tag, and take the one
+        // with the longest history as the provider and the next one as
+        // the alternate
+        uint64_t hits = 0;
+        for (int i = 1; i <= nHistoryTables; i++) {
+            const bool hit = noSkip[i] &&
+                gtable[i][tableIndices[i]].tag == tableTags[i];
+            hits |= uint64_t(hit) << i;
+        }
         bi->hitBank = 0;
         bi->altBank = 0;
-        //Look for the bank with longest matching history
-        for (int i = nHistoryTables; i > 0; i--) {
-            if (noSkip[i] &&
-                gtable[i][tableIndices[i]].tag == tableTags[i]) {
-                bi->hitBank = i;
-                bi->hitBankIndex = tableIndices[bi->hitBank];
-                break;
-            }
+        if (hits) {
+            bi->hitBank = findMsbSet(hits);
+            bi->hitBankIndex = tableIndices[bi->hitBank];
+            hits &= ~(ULL(1) << bi->hitBank);
         }
-        //Look for the alternate bank
-        for (int i = bi->hitBank - 1; i > 0; i--) {
-            if (noSkip[i] &&
-                gtable[i][tableIndices[i]].tag == tableTags[i]) {
-                bi->altBank = i;
-                bi->altBankIndex = tableIndices[bi->altBank];
-                break;
-            }
+        if (hits) {
+            bi->altBank = findMsbSet(hits);
+            bi->altBankIndex = tableIndices[bi->altBank];
         }
         //computes the prediction and the alternate prediction
         if (bi->hitBank > 0) {
@@ -601,17 +760,10 @@ TAGEBase::updateHistories(ThreadID tid, Addr branch_pc, bool taken,
     }
 
     //prepare next index and tag computations for user branchs
-    for (int i = 1; i <= nHistoryTables; i++)
-    {
-        if (speculative) {
-            bi->ci[i]  = tHist.computeIndices[i].comp;
-            bi->ct0[i] = tHist.computeTags[0][i].comp;
-            bi->ct1[i] = tHist.computeTags[1][i].comp;
-        }
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
+    if (speculative) {
+        tHist.folded.save(bi->ci);
     }
+    tHist.folded.update(tHist.gHist);
     DPRINTF(Tage, "Updating global histories with branch:%lx; taken?:%d, "
             "path Hist: %x; pointer:%d\n", branch_pc, taken, tHist.pathHist,
             tHist.ptGhist);
@@ -635,14 +787,8 @@ TAGEBase::squash(ThreadID tid, bool taken, TAGEBase::BranchInfo *bi,
     tHist.ptGhist = bi->ptGhist;
     tHist.gHist = &(tHist.globalHistory[tHist.ptGhist]);
     tHist.gHist[0] = (taken ? 1 : 0);
-    for (int i = 1; i <= nHistoryTables; i++) {
-        tHist.computeIndices[i].comp = bi->ci[i];
-        tHist.computeTags[0][i].comp = bi->ct0[i];
-        tHist.computeTags[1][i].comp = bi->ct1[i];
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
-    }
+    tHist.folded.restore(bi->ci);
+    tHist.folded.update(tHist.gHist);
 }
 
 void
@@ -51,6 +51,7 @@
 #include <vector>
 
 #include "base/statistics.hh"
+#include "cpu/pred/folded_history.hh"
 #include "cpu/static_inst.hh"
 #include "params/TAGEBase.hh"
 #include "sim/sim_object.hh"
@@ -61,48 +62,20 @@ class TAGEBase : public SimObject
     TAGEBase(const TAGEBaseParams &p);
     void init() override;
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
   protected:
     // Prediction Structures
 
-    // Tage Entry
+    // Tage Entry, with the tag first so that an entry packs into
+    // 4 bytes and a table line holds 16 of them
     struct TageEntry
     {
-        int8_t ctr;
         uint16_t tag;
+        int8_t ctr;
         uint8_t u;
-        TageEntry() : ctr(0), tag(0), u(0) { }
-    };
-
-    // Folded History Table - compressed history
-    // to mix with instruction PC to index partially
-    // tagged tables.
-    struct FoldedHistory
-    {
-        unsigned comp;
-        int compLength;
-        int origLength;
-        int outpoint;
-        int bufferSize;
-
-        FoldedHistory()
-        {
-            comp = 0;
-        }
-
-        void init(int original_length, int compressed_length)
-        {
-            origLength = original_length;
-            compLength = compressed_length;
-            outpoint = original_length % compressed_length;
-        }
-
-        void update(uint8_t * h)
-        {
-            comp = (comp << 1) | h[0];
-            comp ^= h[origLength] << outpoint;
-            comp ^= (comp >> compLength);
-            comp &= (ULL(1) << compLength) - 1;
-        }
+        TageEntry() : tag(0), ctr(0), u(0) { }
     };
 
   public:
@@ -140,7 +113,9 @@ class TAGEBase : public SimObject
         int *storage;
 
         // Pointers to actual saved array within the dynamically
-        // allocated storage.
+        // allocated storage. The saved folded histories ci, ct0 and
+        // ct1 follow each other, as FoldedHistories::save() lays them
+        // out.
         int *tableIndices;
         int *tableTags;
         int *ci;
@@ -345,6 +320,14 @@ class TAGEBase : public SimObject
      */
     virtual void buildTageTables();
 
+    /**
+     * Number of entries allocated by buildTageTables() for a tagged bank
+     * @param bank The bank
+     * @return The number of entries, or 0 if the bank shares the entries
+     * of another one
+     */
+    virtual size_t gtableSize(int bank) const;
+
     /**
      * Calculates the history lengths
      * and some other paramters in derived classes
@@ -353,7 +336,10 @@ class TAGEBase : public SimObject
 
     /**
      * On a prediction, calculates the TAGE indices and tags for
-     * all the different history lengths
+     * all the different history lengths. Unless batchedIndexing is
+     * disabled, this computes the hashes of gindex() and gtag() for
+     * all the tables in a single pass, so a derived class that changes
+     * these hashes must override this method as well.
      */
     virtual void calculateIndicesAndTags(
         ThreadID tid, Addr branch_pc, BranchInfo* bi);
@@ -448,8 +434,7 @@ class TAGEBase : public SimObject
         int ptGhist;
 
         // Speculative folded histories.
-        FoldedHistory *computeIndices;
-        FoldedHistory *computeTags[2];
+        FoldedHistories folded;
     };
 
     std::vector<ThreadHistory> threadHistory;
@@ -463,6 +448,23 @@ class TAGEBase : public SimObject
     int *tableIndices;
     int *tableTags;
 
+    /**
+     * Constants of the index and tag hashes of a tagged table, which
+     * calculateIndicesAndTags() uses to hash all the tables in one pass.
+     */
+    struct BankHash
+    {
+        unsigned indexMask;
+        unsigned tagMask;
+        unsigned pcShift;
+        unsigned pathMask;
+        int logSize;
+    };
+    std::vector<BankHash> bankHashes;
+
+    /** Compute the indices and tags in one pass rather than per table */
+    const bool batchedIndexing;
+
     std::vector<int8_t> useAltPredForNewlyAllocated;
     int64_t tCounter;
     uint64_t logUResetPeriod;
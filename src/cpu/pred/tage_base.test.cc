@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cpu/pred/tage_base.hh"
+#include "params/TAGEBase.hh"
+
+namespace {
+
+/** Exposes the hashes and the lookup state of a TAGEBase */
+class TestTAGE : public TAGEBase
+{
+  public:
+    TestTAGE(const TAGEBaseParams &p) : TAGEBase(p) {}
+
+    using TAGEBase::gindex;
+    using TAGEBase::gtag;
+    using TAGEBase::nHistoryTables;
+};
+
+/** The default TAGEBase configuration, with a short history buffer */
+TAGEBaseParams
+makeParams(const std::string &name, bool batched)
+{
+    TAGEBaseParams p;
+    p.name = name;
+    p.eventq_index = 0;
+    p.numThreads = 1;
+    p.instShiftAmt = 2;
+    p.nHistoryTables = 7;
+    p.minHist = 5;
+    p.maxHist = 130;
+    p.tagTableTagWidths = {0, 9, 9, 10, 10, 11, 11, 12};
+    p.logTagTableSizes = {13, 9, 9, 9, 9, 9, 9, 9};
+    p.logRatioBiModalHystEntries = 2;
+    p.tagTableCounterBits = 3;
+    p.tagTableUBits = 2;
+    // Short enough for the global history to wrap around many times
+    p.histBufferSize = 1024;
+    p.pathHistBits = 16;
+    p.logUResetPeriod = 12;
+    p.numUseAltOnNa = 1;
+    p.initialTCounterValue = 1 << 11;
+    p.useAltOnNaBits = 4;
+    p.maxNumAlloc = 1;
+    p.speculativeHistUpdate = true;
+    p.batchedIndexing = batched;
+    return p;
+}
+
+} // anonymous namespace
+
+/**
+ * Drive a batched and a per-table TAGEBase with the same branches. The
+ * indices and tags of the batched lookup must be the ones gindex() and
+ * gtag() give, and the two predictors must predict and update alike.
+ */
+TEST(TAGEBaseTest, BatchedIndexingMatchesPerTable)
+{
+    TestTAGE batched(makeParams("batched", true));
+    TestTAGE per_table(makeParams("per_table", false));
+    batched.init();
+    per_table.init();
+    const int num_tables = batched.nHistoryTables;
+
+    // A loop of branches, each taken but once every few iterations,
+    // which the tagged tables learn from the global history. Some noise
+    // keeps mispredicting and allocating entries.
+    std::mt19937 rng(0x7a6e);
+    const int num_branches = 16;
+    std::vector<Addr> pcs(num_branches);
+    for (auto &pc : pcs)
+        pc = (rng() & 0xffffff) << 2;
+
+    unsigned provided = 0;
+    for (int n = 0; n < 200000; n++) {
+        const int iter = n / num_branches;
+        const int branch = n % num_branches;
+        const Addr pc = pcs[branch];
+        const bool cond = branch % 8 != 7;
+        const bool taken = !cond ||
+            ((iter % (branch % 5 + 2) != 0) != (rng() % 128 == 0));
+        const int nrand = rng() & 3;
+
+        std::unique_ptr<TAGEBase::BranchInfo> bi_b(batched.makeBranchInfo());
+        std::unique_ptr<TAGEBase::BranchInfo> bi_p(
+            per_table.makeBranchInfo());
+
+        // The reference hashes, on the histories of the lookup
+        std::vector<int> indices(num_tables + 1);
+        std::vector<int> tags(num_tables + 1);
+        for (int i = 1; i <= num_tables; i++) {
+            indices[i] = batched.gindex(0, pc, i);
+            tags[i] = batched.gtag(0, pc, i);
+        }
+
+        const bool pred_b = batched.tagePredict(0, pc, cond, bi_b.get());
+        const bool pred_p = per_table.tagePredict(0, pc, cond, bi_p.get());
+        ASSERT_EQ(pred_p, pred_b) << "branch " << n;
+
+        if (cond) {
+            for (int i = 1; i <= num_tables; i++) {
+                ASSERT_EQ(indices[i], bi_b->tableIndices[i])
+                    << "branch " << n << ", table " << i;
+                ASSERT_EQ(tags[i], bi_b->tableTags[i])
+                    << "branch " << n << ", table " << i;
+                ASSERT_EQ(bi_p->tableIndices[i], bi_b->tableIndices[i]);
+                ASSERT_EQ(bi_p->tableTags[i], bi_b->tableTags[i]);
+            }
+            ASSERT_EQ(bi_p->hitBank, bi_b->hitBank);
+            ASSERT_EQ(bi_p->altBank, bi_b->altBank);
+            ASSERT_EQ(bi_p->provider, bi_b->provider);
+            ASSERT_EQ(bi_p->tagePred, bi_b->tagePred);
+            ASSERT_EQ(bi_p->altTaken, bi_b->altTaken);
+            provided += bi_b->hitBank > 0;
+        }
+
+        // Update the histories with the prediction, and resolve the
+        // branch right away as a CPU would at commit
+        batched.updateHistories(0, pc, pred_b, bi_b.get(), true);
+        per_table.updateHistories(0, pc, pred_p, bi_p.get(), true);
+        if (pred_b != taken) {
+            batched.squash(0, taken, bi_b.get(), MaxAddr);
+            per_table.squash(0, taken, bi_p.get(), MaxAddr);
+        }
+        if (cond) {
+            batched.condBranchUpdate(0, pc, taken, bi_b.get(), nrand,
+                                     MaxAddr, pred_b);
+            per_table.condBranchUpdate(0, pc, taken, bi_p.get(), nrand,
+                                       MaxAddr, pred_p);
+        }
+    }
+
+    // Make sure the tagged tables were actually exercised
+    EXPECT_GT(provided, 100000);
+}
@@ -91,6 +91,8 @@ class TAGE_SC_L_TAGE : public TAGEBase {
 
     void buildTageTables() override;
 
+    size_t gtableSize(int bank) const override;
+
     void calculateIndicesAndTags(
         ThreadID tid, Addr branch_pc, TAGEBase::BranchInfo* bi) override;
 
@@ -200,8 +200,8 @@ uint16_t
 TAGE_SC_L_TAGE_64KB::gtag(ThreadID tid, Addr pc, int bank) const
 {
     // very similar to the TAGE implementation, but w/o shifting the pc
-    int tag = pc ^ threadHistory[tid].computeTags[0][bank].comp ^
-              (threadHistory[tid].computeTags[1][bank].comp << 1);
+    int tag = pc ^ threadHistory[tid].folded.tag0(bank) ^
+              (threadHistory[tid].folded.tag1(bank) << 1);
 
     return (tag & ((ULL(1) << tagTableTagWidths[bank]) - 1));
 }
@@ -307,3 +307,23 @@ TAGE_SC_L_64KB::TAGE_SC_L_64KB(const TAGE_SC_L_64KBParams &params)
   : TAGE_SC_L(params)
 {
 }
+
+void
+TAGE_SC_L_64KB_StatisticalCorrector::serialize(CheckpointOut &cp) const
+{
+    StatisticalCorrector::serialize(cp);
+    serializeGEHL(cp, "pgehl", pgehl, pnb, wp);
+    serializeGEHL(cp, "sgehl", sgehl, snb, ws);
+    serializeGEHL(cp, "tgehl", tgehl, tnb, wt);
+    serializeGEHL(cp, "imgehl", imgehl, imnb, wim);
+}
+
+void
+TAGE_SC_L_64KB_StatisticalCorrector::unserialize(CheckpointIn &cp)
+{
+    StatisticalCorrector::unserialize(cp);
+    unserializeGEHL(cp, "pgehl", pgehl, pnb, wp);
+    unserializeGEHL(cp, "sgehl", sgehl, snb, ws);
+    unserializeGEHL(cp, "tgehl", tgehl, tnb, wt);
+    unserializeGEHL(cp, "imgehl", imgehl, imnb, wim);
+}
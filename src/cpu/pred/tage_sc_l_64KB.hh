@@ -102,6 +102,20 @@ class TAGE_SC_L_64KB_StatisticalCorrector : public StatisticalCorrector
     struct SC_64KB_ThreadHistory : public SCThreadHistory
     {
         std::vector<int64_t> imHist;
+
+        void
+        serialize(CheckpointOut &cp) const override
+        {
+            SCThreadHistory::serialize(cp);
+            SERIALIZE_CONTAINER(imHist);
+        }
+
+        void
+        unserialize(CheckpointIn &cp) override
+        {
+            SCThreadHistory::unserialize(cp);
+            unserializeTable(cp, "imHist", imHist);
+        }
     };
 
     SCThreadHistory *makeThreadHistory() override;
@@ -123,6 +137,9 @@ class TAGE_SC_L_64KB_StatisticalCorrector : public StatisticalCorrector
 
     void gUpdates(ThreadID tid, Addr pc, bool taken, BranchInfo* bi,
             int64_t phist) override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
 };
 
 class TAGE_SC_L_64KB : public TAGE_SC_L
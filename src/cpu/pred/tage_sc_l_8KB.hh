@@ -82,6 +82,20 @@ class TAGE_SC_L_8KB_StatisticalCorrector : public StatisticalCorrector
             globalHist = 0;
         }
         int64_t globalHist; // global history
+
+        void
+        serialize(CheckpointOut &cp) const override
+        {
+            SCThreadHistory::serialize(cp);
+            SERIALIZE_SCALAR(globalHist);
+        }
+
+        void
+        unserialize(CheckpointIn &cp) override
+        {
+            SCThreadHistory::unserialize(cp);
+            optParamIn(cp, "globalHist", globalHist, false);
+        }
     };
 
     SCThreadHistory *makeThreadHistory() override;
@@ -98,6 +112,9 @@ class TAGE_SC_L_8KB_StatisticalCorrector : public StatisticalCorrector
 
     int gIndexLogsSubstr(int nbr, int i) override;
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
     void scHistoryUpdate(
         Addr branch_pc, const StaticInstPtr &inst, bool taken,
         BranchInfo * tage_bi, Addr corrTarget) override;
@@ -42,6 +42,7 @@
 
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
+#include "cpu/pred/table_checkpoint.hh"
 
 TournamentBP::TournamentBP(const TournamentBPParams &params)
     : BPredUnit(params),
@@ -343,6 +344,28 @@ TournamentBP::squash(ThreadID tid, void *bp_history)
     delete history;
 }
 
+void
+TournamentBP::serialize(CheckpointOut &cp) const
+{
+    BPredUnit::serialize(cp);
+    serializeCounters(cp, "localCtrs", localCtrs);
+    serializeCounters(cp, "globalCtrs", globalCtrs);
+    serializeCounters(cp, "choiceCtrs", choiceCtrs);
+    SERIALIZE_CONTAINER(localHistoryTable);
+    SERIALIZE_CONTAINER(globalHistory);
+}
+
+void
+TournamentBP::unserialize(CheckpointIn &cp)
+{
+    BPredUnit::unserialize(cp);
+    unserializeCounters(cp, "localCtrs", localCtrs);
+    unserializeCounters(cp, "globalCtrs", globalCtrs);
+    unserializeCounters(cp, "choiceCtrs", choiceCtrs);
+    unserializeTable(cp, "localHistoryTable", localHistoryTable);
+    unserializeTable(cp, "globalHistory", globalHistory);
+}
+
 #ifdef DEBUG
 int
 TournamentBP::BPHistory::newCount = 0;
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/trace_replay.hh"
+
+#include <chrono>
+#include <memory>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/Branch.hh"
+#include "proto/branch.pb.h"
+#include "proto/columnar_io.hh"
+#include "sim/sim_exit.hh"
+
+namespace {
+
+static TheISA::ExtMachInst branchMachInst;
+
+/**
+ * Stand-in for a traced control instruction, which only carries the
+ * flags the predictor looks at.
+ */
+class TraceBranchInst : public StaticInst
+{
+  public:
+    TraceBranchInst(uint32_t type)
+        : StaticInst("trace branch", branchMachInst, No_OpClass)
+    {
+        flags[IsControl] = true;
+        flags[IsCondControl] = type & 1;
+        flags[IsUncondControl] = !(type & 1);
+        flags[IsIndirectControl] = type & 2;
+        flags[IsDirectControl] = !(type & 2);
+        flags[IsCall] = type & 4;
+        flags[IsReturn] = type & 8;
+    }
+
+    Fault
+    execute(ExecContext *xc, Trace::InstRecord *traceData) const override
+    {
+        panic("Trace branches cannot be executed.\n");
+    }
+
+    void
+    advancePC(TheISA::PCState &pcState) const override
+    {
+        pcState.advance();
+    }
+
+    std::string
+    generateDisassembly(Addr pc,
+            const Loader::SymbolTable *symtab) const override
+    {
+        return mnemonic;
+    }
+};
+
+} // anonymous namespace
+
+BranchTraceReplay::BranchTraceReplay(const BranchTraceReplayParams &params)
+    : SimObject(params),
+      bpred(params.branchPred),
+      traceFile(params.traceFile),
+      numThreads(params.numThreads),
+      maxBranches(params.maxBranches),
+      replayEvent([this]{ replay(); }, name()),
+      stats(this)
+{
+    for (uint32_t type = 0; type < 16; ++type)
+        branchInsts[type] = new TraceBranchInst(type);
+}
+
+void
+BranchTraceReplay::startup()
+{
+    schedule(replayEvent, curTick());
+}
+
+void
+BranchTraceReplay::replay()
+{
+    std::unique_ptr<TraceInputStream> trace(openTraceInputStream(traceFile));
+
+    ProtoMessage::BranchTraceHeader header_msg;
+    fatal_if(!trace->read(header_msg),
+             "Failed to read the header of branch trace %s.\n", traceFile);
+
+    ProtoMessage::BranchRecord branch_msg;
+    InstSeqNum seq_num = 1;
+    uint64_t insts = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    while ((!maxBranches || seq_num <= maxBranches) &&
+           trace->read(branch_msg)) {
+        const ThreadID tid = branch_msg.tid();
+        fatal_if(tid >= numThreads, "Branch trace %s holds thread %d, but "
+                 "the predictor only has %d threads.\n", traceFile, tid,
+                 numThreads);
+
+        const StaticInstPtr &inst = branchInsts[branch_msg.type() & 0xf];
+        TheISA::PCState pc(branch_msg.pc());
+        // The target of a branch that was not taken is its fall-through
+        if (!branch_msg.taken())
+            pc.npc(branch_msg.target());
+
+        bpred->predict(inst, seq_num, pc, tid);
+        if (pc.instAddr() != branch_msg.target()) {
+            DPRINTF(Branch, "Trace branch %#x mispredicted as %#x, "
+                    "target %#x\n", branch_msg.pc(), pc.instAddr(),
+                    branch_msg.target());
+            ++stats.mispredicts;
+            if (inst->isCondCtrl())
+                ++stats.condMispredicts;
+            bpred->squash(seq_num, TheISA::PCState(branch_msg.target()),
+                          branch_msg.taken(), tid);
+        }
+        bpred->update(seq_num, tid);
+
+        ++stats.branches;
+        if (inst->isCondCtrl())
+            ++stats.condBranches;
+        insts = branch_msg.insts();
+        ++seq_num;
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    stats.insts = insts;
+    stats.hostSeconds = elapsed.count();
+
+    exitSimLoop("branch trace replay complete");
+}
+
+BranchTraceReplay::BranchTraceReplayStats::BranchTraceReplayStats(
+        Stats::Group *parent)
+    : Stats::Group(parent),
+      ADD_STAT(insts, UNIT_COUNT,
+               "Number of instructions covered by the replayed branches"),
+      ADD_STAT(branches, UNIT_COUNT, "Number of branches replayed"),
+      ADD_STAT(condBranches, UNIT_COUNT,
+               "Number of conditional branches replayed"),
+      ADD_STAT(mispredicts, UNIT_COUNT,
+               "Number of branches with a mispredicted next PC"),
+      ADD_STAT(condMispredicts, UNIT_COUNT,
+               "Number of conditional branches with a mispredicted next PC"),
+      ADD_STAT(mpki, UNIT_RATIO,
+               "Number of mispredictions per thousand instructions",
+               mispredicts * 1000 / insts),
+      ADD_STAT(hostSeconds, UNIT_SECOND,
+               "Host time spent replaying the trace"),
+      ADD_STAT(predictionRate,
+               UNIT_RATE(Stats::Units::Count, Stats::Units::Second),
+               "Number of predictions per host second",
+               branches / hostSeconds)
+{
+    mpki.precision(4);
+    predictionRate.precision(0);
+}
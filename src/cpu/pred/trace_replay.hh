@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a harness that evaluates a branch predictor on a branch
+ * trace, without simulating the rest of the CPU.
+ */
+
+#ifndef __CPU_PRED_TRACE_REPLAY_HH__
+#define __CPU_PRED_TRACE_REPLAY_HH__
+
+#include <cstdint>
+#include <string>
+
+#include "base/statistics.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/static_inst.hh"
+#include "params/BranchTraceReplay.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * The BranchTraceReplay feeds the records of a branch trace, as written
+ * by the BranchTraceProbe, to a branch predictor in the order they were
+ * committed. Every branch is predicted and then resolved right away, by
+ * squashing the predictor on a misprediction and committing the branch.
+ * The replay runs at startup and exits the simulation loop once the
+ * trace is exhausted, reporting the mispredictions per thousand
+ * instructions and the host throughput of the predictor.
+ *
+ * The fall-through of a taken branch is not part of the trace and is
+ * taken to be the next instruction of the ISA's default size, which
+ * is what the return address stack records for a call. This is exact
+ * for ISAs with fixed-size instructions.
+ */
+class BranchTraceReplay : public SimObject
+{
+  public:
+    BranchTraceReplay(const BranchTraceReplayParams &params);
+
+    /** Schedule the replay. */
+    void startup() override;
+
+  private:
+    /** Replay the trace and exit the simulation loop. */
+    void replay();
+
+    /** Predictor under evaluation */
+    BPredUnit *const bpred;
+
+    /** Path of the trace to replay */
+    const std::string traceFile;
+
+    /** Number of threads the predictor is configured for */
+    const unsigned numThreads;
+
+    /** Maximum number of branches to replay, or zero for all */
+    const uint64_t maxBranches;
+
+    /**
+     * Control instructions standing in for the traced branches, indexed
+     * by the type bits of the records.
+     */
+    StaticInstPtr branchInsts[16];
+
+    /** Event running the replay */
+    EventFunctionWrapper replayEvent;
+
+    struct BranchTraceReplayStats : public Stats::Group
+    {
+        BranchTraceReplayStats(Stats::Group *parent);
+
+        /** Instructions covered by the replayed branches */
+        Stats::Scalar insts;
+        /** Branches replayed */
+        Stats::Scalar branches;
+        /** Conditional branches replayed */
+        Stats::Scalar condBranches;
+        /** Branches whose next PC was mispredicted */
+        Stats::Scalar mispredicts;
+        /** Conditional branches whose next PC was mispredicted */
+        Stats::Scalar condMispredicts;
+        /** Mispredictions per thousand instructions */
+        Stats::Formula mpki;
+        /** Host time spent replaying the trace */
+        Stats::Scalar hostSeconds;
+        /** Predictions per host second */
+        Stats::Formula predictionRate;
+    } stats;
+};
+
+#endif //__CPU_PRED_TRACE_REPLAY_HH__
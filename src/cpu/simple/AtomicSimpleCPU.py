@@ -60,7 +60,7 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
 
-    def addSimPointProbe(self, interval):
-        simpoint = SimPoint()
+    def addSimPointProbe(self, interval, **kwargs):
+        simpoint = SimPoint(**kwargs)
         simpoint.interval = interval
         self.probeListener = simpoint
@@ -460,6 +460,8 @@ BaseSimpleCPU::postExecute()
 
     // Call CPU instruction commit probes
     probeInstCommit(curStaticInst, instAddr);
+    if (curStaticInst->isControl())
+        probeBranchCommit(curThread, curStaticInst, pc);
 }
 
 void
@@ -34,6 +34,7 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 from m5.params import *
+from m5.SimObject import cxxMethod
 from m5.objects.Probe import ProbeListenerObject
 
 class SimPoint(ProbeListenerObject):
@@ -44,3 +45,42 @@ class SimPoint(ProbeListenerObject):
 
     interval = Param.UInt64(100000000, "Interval Size (insts)")
     profile_file = Param.String("simpoint.bb.gz", "BBV (output) file")
+
+    # The intervals can be clustered in the simulator instead of running
+    # the SimPoint tool on the BBV file. Like SimPoint, the BBVs are
+    # randomly projected and clustered with k-means, choosing the number
+    # of clusters with the BIC score. The results are written at the end
+    # of the simulation, or when dumpSimPoints() is called.
+    cluster_intervals = Param.Bool(False,
+        "Choose the simulation points inside the simulator")
+    simpoints_file = Param.String("simpoints",
+        "Simulation points (output) file")
+    weights_file = Param.String("weights", "Weights (output) file")
+    projection_dims = Param.Unsigned(15,
+        "Dimensions of the randomly projected BBVs")
+    max_k = Param.Unsigned(30, "Maximum number of clusters")
+    max_iterations = Param.Unsigned(100,
+        "Maximum number of k-means iterations")
+    bic_threshold = Param.Float(0.9,
+        "Fraction of the BIC score range the clustering must reach")
+    seed = Param.UInt64(493575226, "Seed of the projection and k-means")
+
+    # To checkpoint the simulation points in the same run, the simulation
+    # loop exits at the end of every interval with the cause 'simpoint
+    # interval boundary'. The exit code is the online cluster the
+    # interval that just ended is now the best candidate of, or -1. The
+    # run script is expected to keep a checkpoint of the start of the
+    # interval in that case (see configs/common/Simulation.py).
+    take_checkpoints = Param.Bool(False,
+        "Exit at every interval to keep candidate checkpoints (implies "
+        "cluster_intervals)")
+
+    per_thread = Param.Bool(False,
+        "Profile each hardware thread separately. The output files are "
+        "prefixed with 'thread<id>.'")
+
+    @cxxMethod
+    def dumpSimPoints(self):
+        """Cluster the intervals profiled so far and write the
+        simulation points and weights files."""
+        pass
@@ -37,25 +37,46 @@
 
 #include "cpu/simple/probes/simpoint.hh"
 
+#include <algorithm>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
 #include "base/output.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
 
 SimPoint::SimPoint(const SimPointParams &p)
     : ProbeListenerObject(p),
       intervalSize(p.interval),
-      intervalCount(0),
-      intervalDrift(0),
-      simpointStream(NULL),
-      currentBBV(0, 0),
-      currentBBVInstCount(0)
+      profileFile(p.profile_file),
+      simpointsFile(p.simpoints_file),
+      weightsFile(p.weights_file),
+      perThread(p.per_thread),
+      clusterIntervals(p.cluster_intervals || p.take_checkpoints),
+      takeCheckpoints(p.take_checkpoints),
+      projectionDims(p.projection_dims),
+      maxK(p.max_k),
+      maxIters(p.max_iterations),
+      bicThreshold(p.bic_threshold),
+      seed(p.seed)
 {
-    simpointStream = simout.create(p.profile_file, false);
-    if (!simpointStream)
-        fatal("unable to open SimPoint profile_file");
+    fatal_if(takeCheckpoints && perThread,
+             "SimPoint checkpoints can't be taken for per thread profiles");
+
+    // Per thread profiles are created when their thread first commits
+    if (!perThread)
+        createProfile(0);
+
+    if (clusterIntervals)
+        registerExitCallback([this]() { dumpSimPoints(); });
 }
 
 SimPoint::~SimPoint()
 {
-    simout.close(simpointStream);
+    for (auto &profile : profiles) {
+        if (profile)
+            simout.close(profile->simpointStream);
+    }
 }
 
 void
@@ -71,6 +92,29 @@ SimPoint::regProbeListeners()
                                              &SimPoint::profile));
 }
 
+void
+SimPoint::createProfile(ThreadID tid)
+{
+    if (profiles.size() <= tid)
+        profiles.resize(tid + 1);
+
+    std::unique_ptr<Profile> profile(new Profile);
+    if (perThread)
+        profile->prefix = csprintf("thread%d.", tid);
+
+    profile->simpointStream =
+        simout.create(profile->prefix + profileFile, false);
+    if (!profile->simpointStream)
+        fatal("unable to open SimPoint profile_file");
+
+    if (clusterIntervals) {
+        profile->clusterer.reset(new SimPointClusterer(
+            projectionDims, maxK, maxIters, bicThreshold, seed));
+    }
+
+    profiles[tid] = std::move(profile);
+}
+
 void
 SimPoint::profile(const std::pair<SimpleThread*, StaticInstPtr>& p)
 {
@@ -80,61 +124,117 @@ SimPoint::profile(const std::pair<SimpleThread*, StaticInstPtr>& p)
     if (inst->isMicroop() && !inst->isLastMicroop())
         return;
 
-    if (!currentBBVInstCount)
-        currentBBV.first = thread->pcState().instAddr();
+    const ThreadID tid = perThread ? thread->threadId() : 0;
+    if (profiles.size() <= tid || !profiles[tid])
+        createProfile(tid);
+    Profile &prof = *profiles[tid];
 
-    ++intervalCount;
-    ++currentBBVInstCount;
+    if (!prof.currentBBVInstCount)
+        prof.currentBBV.first = thread->pcState().instAddr();
+
+    ++prof.intervalCount;
+    ++prof.currentBBVInstCount;
 
     // If inst is control inst, assume end of basic block.
     if (inst->isControl()) {
-        currentBBV.second = thread->pcState().instAddr();
+        prof.currentBBV.second = thread->pcState().instAddr();
 
-        auto map_itr = bbMap.find(currentBBV);
-        if (map_itr == bbMap.end()){
+        auto map_itr = prof.bbMap.find(prof.currentBBV);
+        if (map_itr == prof.bbMap.end()){
             // If a new (previously unseen) basic block is found,
             // add a new unique id, record num of insts and insert
             // into bbMap.
             BBInfo info;
-            info.id = bbMap.size() + 1;
-            info.insts = currentBBVInstCount;
-            info.count = currentBBVInstCount;
-            bbMap.insert(std::make_pair(currentBBV, info));
+            info.id = prof.bbMap.size() + 1;
+            info.insts = prof.currentBBVInstCount;
+            info.count = prof.currentBBVInstCount;
+            prof.bbMap.insert(std::make_pair(prof.currentBBV, info));
         } else {
             // If basic block is seen before, just increment the count by the
             // number of insts in basic block.
             BBInfo& info = map_itr->second;
-            info.count += currentBBVInstCount;
+            info.count += prof.currentBBVInstCount;
         }
-        currentBBVInstCount = 0;
+        prof.currentBBVInstCount = 0;
 
         // Reached end of interval if the sum of the current inst count
         // (intervalCount) and the excessive inst count from the previous
         // interval (intervalDrift) is greater than/equal to the interval size.
-        if (intervalCount + intervalDrift >= intervalSize) {
-            // summarize interval and display BBV info
-            std::vector<std::pair<uint64_t, uint64_t> > counts;
-            for (auto map_itr = bbMap.begin(); map_itr != bbMap.end();
-                    ++map_itr) {
-                BBInfo& info = map_itr->second;
-                if (info.count != 0) {
-                    counts.push_back(std::make_pair(info.id, info.count));
-                    info.count = 0;
-                }
-            }
-            std::sort(counts.begin(), counts.end());
-
-            // Print output BBV info
-            *simpointStream->stream() << "T";
-            for (auto cnt_itr = counts.begin(); cnt_itr != counts.end();
-                    ++cnt_itr) {
-                *simpointStream->stream() << ":" << cnt_itr->first
-                                << ":" << cnt_itr->second << " ";
-            }
-            *simpointStream->stream() << "\n";
-
-            intervalDrift = (intervalCount + intervalDrift) - intervalSize;
-            intervalCount = 0;
+        if (prof.intervalCount + prof.intervalDrift >= intervalSize) {
+            endInterval(prof);
+
+            prof.intervalDrift =
+                (prof.intervalCount + prof.intervalDrift) - intervalSize;
+            prof.intervalCount = 0;
         }
     }
 }
+
+void
+SimPoint::endInterval(Profile &prof)
+{
+    // summarize interval and display BBV info
+    SimPointClusterer::BBV counts;
+    for (auto map_itr = prof.bbMap.begin(); map_itr != prof.bbMap.end();
+            ++map_itr) {
+        BBInfo& info = map_itr->second;
+        if (info.count != 0) {
+            counts.push_back(std::make_pair(info.id, info.count));
+            info.count = 0;
+        }
+    }
+    std::sort(counts.begin(), counts.end());
+
+    // Print output BBV info
+    *prof.simpointStream->stream() << "T";
+    for (auto cnt_itr = counts.begin(); cnt_itr != counts.end();
+            ++cnt_itr) {
+        *prof.simpointStream->stream() << ":" << cnt_itr->first
+                        << ":" << cnt_itr->second << " ";
+    }
+    *prof.simpointStream->stream() << "\n";
+
+    if (prof.clusterer) {
+        const int cluster = prof.clusterer->addInterval(counts);
+
+        // The code tells the run script which online cluster, if any,
+        // the checkpoint taken at the start of this interval is now the
+        // best candidate of.
+        if (takeCheckpoints)
+            exitSimLoop("simpoint interval boundary", cluster);
+    }
+}
+
+void
+SimPoint::dumpSimPoints()
+{
+    for (auto &profile : profiles) {
+        if (!profile || !profile->clusterer)
+            continue;
+
+        // Nothing changed since the last time
+        const int64_t intervals = profile->clusterer->numIntervals();
+        if (profile->dumpedIntervals == intervals)
+            continue;
+
+        const auto simpoints = profile->clusterer->cluster(takeCheckpoints);
+
+        OutputStream *points =
+            simout.create(profile->prefix + simpointsFile, false);
+        OutputStream *weights =
+            simout.create(profile->prefix + weightsFile, false);
+        if (!points || !weights)
+            fatal("unable to open SimPoint simpoints_file or weights_file");
+
+        for (size_t i = 0; i < simpoints.intervals.size(); ++i) {
+            ccprintf(*points->stream(), "%d %d\n",
+                     simpoints.intervals[i], i);
+            ccprintf(*weights->stream(), "%f %d\n",
+                     simpoints.weights[i], i);
+        }
+
+        simout.close(points);
+        simout.close(weights);
+        profile->dumpedIntervals = intervals;
+    }
+}
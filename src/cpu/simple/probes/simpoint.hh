@@ -38,9 +38,13 @@
 #ifndef __CPU_SIMPLE_PROBES_SIMPOINT_HH__
 #define __CPU_SIMPLE_PROBES_SIMPOINT_HH__
 
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "base/output.hh"
+#include "cpu/simple/probes/simpoint_cluster.hh"
 #include "cpu/simple_thread.hh"
 #include "params/SimPoint.hh"
 #include "sim/probe/probe.hh"
@@ -86,17 +90,14 @@ class SimPoint : public ProbeListenerObject
      */
     void profile(const std::pair<SimpleThread*, StaticInstPtr>&);
 
-  private:
-    /** SimPoint profiling interval size in instructions */
-    const uint64_t intervalSize;
-
-    /** Inst count in current basic block */
-    uint64_t intervalCount;
-    /** Excess inst count from previous interval*/
-    uint64_t intervalDrift;
-    /** Pointer to SimPoint BBV output stream */
-    OutputStream *simpointStream;
+    /**
+     * Cluster the intervals profiled so far and write the simulation
+     * points and their weights in the format of the SimPoint tool. Does
+     * nothing unless clustering is enabled.
+     */
+    void dumpSimPoints();
 
+  private:
     /** Basic Block information */
     struct BBInfo {
         /** Unique ID */
@@ -107,12 +108,68 @@ class SimPoint : public ProbeListenerObject
         uint64_t count;
     };
 
-    /** Hash table containing all previously seen basic blocks */
-    std::unordered_map<BasicBlockRange, BBInfo> bbMap;
-    /** Currently executing basic block */
-    BasicBlockRange currentBBV;
-    /** inst count in current basic block */
-    uint64_t currentBBVInstCount;
+    /**
+     * Profiling state of a hardware thread, or of the whole core when
+     * threads are not profiled separately.
+     */
+    struct Profile {
+        /** Inst count in current basic block */
+        uint64_t intervalCount = 0;
+        /** Excess inst count from previous interval*/
+        uint64_t intervalDrift = 0;
+        /** Pointer to SimPoint BBV output stream */
+        OutputStream *simpointStream = nullptr;
+        /** Prefix of the output file names */
+        std::string prefix;
+
+        /** Hash table containing all previously seen basic blocks */
+        std::unordered_map<BasicBlockRange, BBInfo> bbMap;
+        /** Currently executing basic block */
+        BasicBlockRange currentBBV = BasicBlockRange(0, 0);
+        /** inst count in current basic block */
+        uint64_t currentBBVInstCount = 0;
+
+        /** Clustering of the intervals, if enabled */
+        std::unique_ptr<SimPointClusterer> clusterer;
+        /** Number of intervals the dumped simpoints were based on */
+        int64_t dumpedIntervals = -1;
+    };
+
+    /** Create the profile of a thread and open its output file */
+    void createProfile(ThreadID tid);
+
+    /** Output and reset the BBV of a profile at the end of an interval */
+    void endInterval(Profile &profile);
+
+    /** SimPoint profiling interval size in instructions */
+    const uint64_t intervalSize;
+
+    /** Name of the BBV output file */
+    const std::string profileFile;
+    /** Name of the simulation points output file */
+    const std::string simpointsFile;
+    /** Name of the weights output file */
+    const std::string weightsFile;
+
+    /** Profile each hardware thread separately */
+    const bool perThread;
+    /** Cluster the intervals inside the simulator */
+    const bool clusterIntervals;
+    /**
+     * Exit the simulation loop at the end of every interval so that the
+     * run script can keep candidate checkpoints
+     */
+    const bool takeCheckpoints;
+
+    /** Parameters of the clustering */
+    const unsigned projectionDims;
+    const unsigned maxK;
+    const unsigned maxIters;
+    const double bicThreshold;
+    const uint64_t seed;
+
+    /** Profile of each thread, or a single one for the whole core */
+    std::vector<std::unique_ptr<Profile>> profiles;
 };
 
 #endif // __CPU_SIMPLE_PROBES_SIMPOINT_HH__
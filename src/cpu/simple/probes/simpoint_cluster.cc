@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/probes/simpoint_cluster.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+
+namespace
+{
+
+/** Lower bound of the variance used by the BIC score */
+const double minVariance = 1e-10;
+
+/**
+ * Mixing function of splitmix64. Used to derive the projection matrix
+ * from the basic block ids, so that it does not have to be stored.
+ */
+uint64_t
+mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+} // anonymous namespace
+
+SimPointClusterer::SimPointClusterer(unsigned _dims, unsigned max_k,
+                                     unsigned max_iters,
+                                     double bic_threshold, uint64_t _seed)
+    : dims(_dims), maxK(max_k), maxIters(max_iters),
+      bicThreshold(bic_threshold), seed(_seed)
+{
+    assert(dims > 0 && maxK > 0);
+}
+
+SimPointClusterer::Vector
+SimPointClusterer::project(const BBV &bbv) const
+{
+    Vector v(dims, 0.0);
+
+    uint64_t total = 0;
+    for (const auto &bb : bbv)
+        total += bb.second;
+    if (!total)
+        return v;
+
+    // Like SimPoint, the vector is normalized to the interval length and
+    // multiplied by a matrix with entries uniformly distributed in
+    // [-1, 1).
+    for (const auto &bb : bbv) {
+        const double freq = double(bb.second) / total;
+        const uint64_t row = mix(seed ^ mix(bb.first));
+        for (unsigned d = 0; d < dims; ++d) {
+            const double r = std::ldexp(double(mix(row + d) >> 11), -53);
+            v[d] += freq * (2.0 * r - 1.0);
+        }
+    }
+    return v;
+}
+
+double
+SimPointClusterer::distance(const Vector &a, const Vector &b)
+{
+    double dist = 0.0;
+    for (size_t d = 0; d < a.size(); ++d)
+        dist += (a[d] - b[d]) * (a[d] - b[d]);
+    return dist;
+}
+
+int
+SimPointClusterer::addInterval(const BBV &bbv)
+{
+    const uint64_t interval = points.size();
+    points.push_back(project(bbv));
+    const Vector &point = points.back();
+
+    int nearest = -1;
+    double nearest_dist = std::numeric_limits<double>::max();
+    for (size_t c = 0; c < online.size(); ++c) {
+        const double dist = distance(point, online[c].centroid);
+        if (dist < nearest_dist) {
+            nearest = c;
+            nearest_dist = dist;
+        }
+    }
+
+    // The first distinct intervals seed the clusters
+    if (online.size() < maxK && (nearest < 0 || nearest_dist > 0.0)) {
+        online.push_back({point, 1, interval});
+        return online.size() - 1;
+    }
+
+    OnlineCluster &cluster = online[nearest];
+    ++cluster.size;
+    for (unsigned d = 0; d < dims; ++d)
+        cluster.centroid[d] += (point[d] - cluster.centroid[d]) / cluster.size;
+
+    // The centroid moved, so the distance of the current candidate has to
+    // be computed again.
+    if (distance(point, cluster.centroid) <
+        distance(points[cluster.candidate], cluster.centroid)) {
+        cluster.candidate = interval;
+        return nearest;
+    }
+    return -1;
+}
+
+std::vector<uint64_t>
+SimPointClusterer::candidates() const
+{
+    std::vector<uint64_t> intervals;
+    for (const auto &cluster : online)
+        intervals.push_back(cluster.candidate);
+    return intervals;
+}
+
+double
+SimPointClusterer::kmeans(unsigned k, std::vector<Vector> &centroids,
+                          std::vector<unsigned> &assignment) const
+{
+    const size_t n = points.size();
+    assert(k > 0 && k <= n);
+
+    // Seed with k-means++, deterministically for a given k
+    std::mt19937_64 rng(seed + k);
+    centroids.clear();
+    centroids.push_back(
+        points[std::uniform_int_distribution<size_t>(0, n - 1)(rng)]);
+    std::vector<double> dists(n);
+    for (size_t i = 0; i < n; ++i)
+        dists[i] = distance(points[i], centroids[0]);
+    while (centroids.size() < k) {
+        const double sum = std::accumulate(dists.begin(), dists.end(), 0.0);
+        size_t next = 0;
+        if (sum > 0.0) {
+            double target =
+                std::uniform_real_distribution<double>(0.0, sum)(rng);
+            while (next < n - 1 && target >= dists[next])
+                target -= dists[next++];
+        } else {
+            next = std::uniform_int_distribution<size_t>(0, n - 1)(rng);
+        }
+        centroids.push_back(points[next]);
+        for (size_t i = 0; i < n; ++i) {
+            dists[i] = std::min(dists[i],
+                                distance(points[i], centroids.back()));
+        }
+    }
+
+    std::vector<uint64_t> sizes(k);
+    assignment.assign(n, 0);
+    for (unsigned iter = 0; iter < maxIters; ++iter) {
+        bool changed = iter == 0;
+        for (size_t i = 0; i < n; ++i) {
+            unsigned nearest = 0;
+            double nearest_dist = distance(points[i], centroids[0]);
+            for (unsigned c = 1; c < k; ++c) {
+                const double dist = distance(points[i], centroids[c]);
+                if (dist < nearest_dist) {
+                    nearest = c;
+                    nearest_dist = dist;
+                }
+            }
+            if (assignment[i] != nearest) {
+                assignment[i] = nearest;
+                changed = true;
+            }
+        }
+        if (!changed)
+            break;
+
+        for (auto &centroid : centroids)
+            std::fill(centroid.begin(), centroid.end(), 0.0);
+        std::fill(sizes.begin(), sizes.end(), 0);
+        for (size_t i = 0; i < n; ++i) {
+            ++sizes[assignment[i]];
+            for (unsigned d = 0; d < dims; ++d)
+                centroids[assignment[i]][d] += points[i][d];
+        }
+        for (unsigned c = 0; c < k; ++c) {
+            if (sizes[c]) {
+                for (unsigned d = 0; d < dims; ++d)
+                    centroids[c][d] /= sizes[c];
+            } else {
+                // Restart empty clusters on the worst fitted interval
+                size_t worst = 0;
+                double worst_dist = -1.0;
+                for (size_t i = 0; i < n; ++i) {
+                    const double dist =
+                        distance(points[i], centroids[assignment[i]]);
+                    if (dist > worst_dist) {
+                        worst = i;
+                        worst_dist = dist;
+                    }
+                }
+                centroids[c] = points[worst];
+            }
+        }
+    }
+
+    // BIC of a spherical gaussian mixture, as in X-means and SimPoint
+    double sse = 0.0;
+    std::fill(sizes.begin(), sizes.end(), 0);
+    for (size_t i = 0; i < n; ++i) {
+        ++sizes[assignment[i]];
+        sse += distance(points[i], centroids[assignment[i]]);
+    }
+    const double r = n;
+    const double m = dims;
+    const double variance =
+        std::max(n > k ? sse / (n - k) : 0.0, minVariance);
+    double log_likelihood = -r * std::log(r) -
+        r / 2 * std::log(2 * M_PI) - r * m / 2 * std::log(variance) -
+        (r - k) / 2;
+    for (const auto size : sizes) {
+        if (size)
+            log_likelihood += size * std::log(double(size));
+    }
+    const double params = (k - 1) + m * k + 1;
+    return log_likelihood - params / 2 * std::log(r);
+}
+
+SimPointClusterer::SimPoints
+SimPointClusterer::cluster(bool candidates_only) const
+{
+    SimPoints simpoints;
+    const size_t n = points.size();
+    if (!n)
+        return simpoints;
+
+    // Score every k and pick the smallest one reaching the threshold
+    const unsigned max_k = std::min<uint64_t>(maxK, n);
+    std::vector<Vector> centroids;
+    std::vector<unsigned> assignment;
+    std::vector<double> scores;
+    for (unsigned k = 1; k <= max_k; ++k)
+        scores.push_back(kmeans(k, centroids, assignment));
+    const auto range = std::minmax_element(scores.begin(), scores.end());
+    const double target =
+        *range.first + bicThreshold * (*range.second - *range.first);
+    unsigned k = 1;
+    while (scores[k - 1] < target)
+        ++k;
+    kmeans(k, centroids, assignment);
+
+    std::vector<bool> eligible(n, !candidates_only);
+    if (candidates_only) {
+        for (const auto interval : candidates())
+            eligible[interval] = true;
+    }
+
+    std::vector<uint64_t> sizes(k);
+    for (const auto c : assignment)
+        ++sizes[c];
+
+    for (unsigned c = 0; c < k; ++c) {
+        if (!sizes[c])
+            continue;
+
+        // Pick the eligible interval closest to the centroid, preferring
+        // the ones belonging to the cluster. Only online candidates may
+        // fall outside of it.
+        size_t best = n;
+        bool best_member = false;
+        double best_dist = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < n; ++i) {
+            if (!eligible[i])
+                continue;
+            const bool member = assignment[i] == c;
+            const double dist = distance(points[i], centroids[c]);
+            if ((member && !best_member) ||
+                (member == best_member && dist < best_dist)) {
+                best = i;
+                best_member = member;
+                best_dist = dist;
+            }
+        }
+        assert(best < n);
+
+        const double weight = double(sizes[c]) / n;
+        auto it = std::find(simpoints.intervals.begin(),
+                            simpoints.intervals.end(), best);
+        if (it != simpoints.intervals.end()) {
+            simpoints.weights[it - simpoints.intervals.begin()] += weight;
+        } else {
+            simpoints.intervals.push_back(best);
+            simpoints.weights.push_back(weight);
+        }
+    }
+    return simpoints;
+}
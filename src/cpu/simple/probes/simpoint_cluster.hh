@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_PROBES_SIMPOINT_CLUSTER_HH__
+#define __CPU_SIMPLE_PROBES_SIMPOINT_CLUSTER_HH__
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * In-simulator version of the SimPoint 3 phase analysis.
+ *
+ * Basic block vectors are reduced to a few dimensions with a random
+ * linear projection as soon as an interval ends, so only the projected
+ * vectors are kept. They are clustered with k-means when the results are
+ * requested, choosing the number of clusters with the Bayesian
+ * Information Criterion (BIC) the same way the offline tool does.
+ *
+ * A sequential k-means is maintained alongside while the intervals are
+ * added. It tracks, for each online cluster, the interval closest to its
+ * centroid so far, which lets the simulator keep one candidate
+ * checkpoint per cluster instead of needing a second pass to take the
+ * checkpoints once the simulation points are known.
+ */
+class SimPointClusterer
+{
+  public:
+    /** Basic block vector as (basic block id, instruction count) pairs */
+    typedef std::vector<std::pair<uint64_t, uint64_t>> BBV;
+
+    /** Chosen simulation points */
+    struct SimPoints
+    {
+        /** Representative interval of each phase */
+        std::vector<uint64_t> intervals;
+        /** Fraction of the execution each interval stands for */
+        std::vector<double> weights;
+    };
+
+    /**
+     * @param dims Dimensions of the projected vectors.
+     * @param max_k Maximum number of clusters.
+     * @param max_iters Maximum number of k-means iterations.
+     * @param bic_threshold Fraction of the BIC range the chosen
+     *        clustering must reach.
+     * @param seed Seed of the projection and of the k-means seeding.
+     */
+    SimPointClusterer(unsigned dims, unsigned max_k, unsigned max_iters,
+                      double bic_threshold, uint64_t seed);
+
+    /**
+     * Record the basic block vector of the next interval.
+     *
+     * @param bbv Basic block vector of the interval.
+     * @return Online cluster the interval is now the candidate of, or -1
+     *         if it did not replace any candidate.
+     */
+    int addInterval(const BBV &bbv);
+
+    /** Number of intervals recorded so far */
+    uint64_t numIntervals() const { return points.size(); }
+
+    /** Current candidate interval of each online cluster */
+    std::vector<uint64_t> candidates() const;
+
+    /**
+     * Cluster all the intervals recorded so far.
+     *
+     * @param candidates_only Only pick online candidates as the
+     *        representative intervals.
+     * @return Representative intervals and their weights.
+     */
+    SimPoints cluster(bool candidates_only) const;
+
+  private:
+    typedef std::vector<double> Vector;
+
+    /** Randomly project and normalize a basic block vector */
+    Vector project(const BBV &bbv) const;
+
+    /** Squared euclidean distance between two vectors */
+    static double distance(const Vector &a, const Vector &b);
+
+    /**
+     * Cluster the intervals with k-means, seeded with k-means++.
+     *
+     * @param k Number of clusters.
+     * @param centroids Resulting centroids.
+     * @param assignment Resulting cluster of each interval.
+     * @return BIC score of the clustering.
+     */
+    double kmeans(unsigned k, std::vector<Vector> &centroids,
+                  std::vector<unsigned> &assignment) const;
+
+    /** Dimensions of the projected vectors */
+    const unsigned dims;
+    /** Maximum number of clusters */
+    const unsigned maxK;
+    /** Maximum number of k-means iterations */
+    const unsigned maxIters;
+    /** Fraction of the BIC range the chosen clustering must reach */
+    const double bicThreshold;
+    /** Seed of the projection and of the k-means seeding */
+    const uint64_t seed;
+
+    /** Projected vector of each interval */
+    std::vector<Vector> points;
+
+    /** Cluster of the sequential k-means */
+    struct OnlineCluster
+    {
+        Vector centroid;
+        uint64_t size;
+        /** Interval closest to the centroid so far */
+        uint64_t candidate;
+    };
+
+    /** Clusters of the sequential k-means */
+    std::vector<OnlineCluster> online;
+};
+
+#endif // __CPU_SIMPLE_PROBES_SIMPOINT_CLUSTER_HH__
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+#include "cpu/simple/probes/simpoint_cluster.hh"
+
+namespace
+{
+
+/** BBV of an interval spending all its time in a given set of blocks */
+SimPointClusterer::BBV
+phase(uint64_t first_bb, unsigned num_bbs)
+{
+    SimPointClusterer::BBV bbv;
+    for (unsigned i = 0; i < num_bbs; ++i)
+        bbv.emplace_back(first_bb + i, 1000 + i);
+    return bbv;
+}
+
+} // anonymous namespace
+
+TEST(SimPointClusterTest, NoIntervals)
+{
+    SimPointClusterer clusterer(15, 10, 100, 0.9, 1);
+    const auto simpoints = clusterer.cluster(false);
+    EXPECT_TRUE(simpoints.intervals.empty());
+    EXPECT_TRUE(simpoints.weights.empty());
+}
+
+TEST(SimPointClusterTest, SinglePhase)
+{
+    SimPointClusterer clusterer(15, 10, 100, 0.9, 1);
+    for (int i = 0; i < 20; ++i)
+        clusterer.addInterval(phase(1, 8));
+
+    const auto simpoints = clusterer.cluster(false);
+    ASSERT_EQ(1, simpoints.intervals.size());
+    EXPECT_DOUBLE_EQ(1.0, simpoints.weights[0]);
+}
+
+TEST(SimPointClusterTest, TwoPhases)
+{
+    SimPointClusterer clusterer(15, 10, 100, 0.9, 1);
+    // Three quarters of the execution in the first phase
+    for (int i = 0; i < 40; ++i)
+        clusterer.addInterval(i % 4 == 3 ? phase(100, 8) : phase(1, 8));
+    EXPECT_EQ(40, clusterer.numIntervals());
+
+    const auto simpoints = clusterer.cluster(false);
+    ASSERT_EQ(2, simpoints.intervals.size());
+    EXPECT_DOUBLE_EQ(1.0, std::accumulate(simpoints.weights.begin(),
+                                          simpoints.weights.end(), 0.0));
+    for (size_t i = 0; i < simpoints.intervals.size(); ++i) {
+        const bool second_phase = simpoints.intervals[i] % 4 == 3;
+        EXPECT_DOUBLE_EQ(second_phase ? 0.25 : 0.75, simpoints.weights[i]);
+    }
+}
+
+TEST(SimPointClusterTest, OnlineCandidates)
+{
+    SimPointClusterer clusterer(15, 2, 100, 0.9, 1);
+    // The first interval of each phase seeds an online cluster
+    EXPECT_EQ(0, clusterer.addInterval(phase(1, 8)));
+    EXPECT_EQ(1, clusterer.addInterval(phase(100, 8)));
+    // Identical intervals never replace the candidate
+    EXPECT_EQ(-1, clusterer.addInterval(phase(1, 8)));
+    EXPECT_EQ(-1, clusterer.addInterval(phase(100, 8)));
+
+    const auto candidates = clusterer.candidates();
+    ASSERT_EQ(2, candidates.size());
+    EXPECT_EQ(0, candidates[0]);
+    EXPECT_EQ(1, candidates[1]);
+
+    // Only candidates are picked when asked to
+    const auto simpoints = clusterer.cluster(true);
+    ASSERT_EQ(2, simpoints.intervals.size());
+    for (const auto interval : simpoints.intervals)
+        EXPECT_LT(interval, 2);
+}
+
+TEST(SimPointClusterTest, CandidateMovesToCentroid)
+{
+    SimPointClusterer clusterer(15, 1, 100, 0.9, 1);
+    SimPointClusterer::BBV skewed = phase(1, 8);
+    skewed[0].second *= 4;
+    EXPECT_EQ(0, clusterer.addInterval(skewed));
+    // Halfway between both intervals, so the candidate stays
+    EXPECT_EQ(-1, clusterer.addInterval(phase(1, 8)));
+    // The centroid keeps moving towards the unskewed intervals
+    EXPECT_EQ(0, clusterer.addInterval(phase(1, 8)));
+    EXPECT_EQ(2, clusterer.candidates()[0]);
+}
@@ -73,6 +73,27 @@ class BaseTrafficGen(ClockedObject):
     max_outstanding_reqs = Param.Int(0,
                             "Maximum number of outstanding requests")
 
+    # Maximum number of packets sent in one update. Further packets
+    # are only sent if they are already due, e.g. packets of a trace
+    # recorded at the same tick, or a replay that is running behind,
+    # which saves scheduling an event for each of them.
+    max_packets_per_update = Param.Unsigned(1, "Maximum number of packets "
+                                            "sent in one update")
+
+    # Number of packets the stochastic generators (linear, random,
+    # strided, DRAM and NVM) create ahead of time. Creating a batch at
+    # once keeps the generator state and random number generator hot,
+    # and the whole batch is sent in one update at the tick its first
+    # packet is due. The batches keep the average rate of the
+    # generator, but its packets go out in bursts of the batch size,
+    # with their requests stamped when sent. The generators draw from
+    # the global random number generator ahead of time, so unless it
+    # is the only thing drawing from it, e.g. with several traffic
+    # generators, or across a state transition, which drops the
+    # packets generated ahead, batching changes the packet streams.
+    batch_size = Param.Unsigned(1, "Number of packets created ahead of "
+                                "time by stochastic generators")
+
     # Let the user know if we have waited for a retry and not made any
     # progress for a long period of time. The default value is
     # somewhat arbitrary and may well have to be tuned.
@@ -36,12 +36,14 @@
  */
 #include "cpu/testers/traffic_gen/base.hh"
 
+#include <algorithm>
 #include <sstream>
 
 #include "base/intmath.hh"
 #include "base/random.hh"
 #include "config/have_protobuf.hh"
 #include "cpu/testers/traffic_gen/base_gen.hh"
+#include "cpu/testers/traffic_gen/batched_gen.hh"
 #include "cpu/testers/traffic_gen/dram_gen.hh"
 #include "cpu/testers/traffic_gen/dram_rot_gen.hh"
 #include "cpu/testers/traffic_gen/exit_gen.hh"
@@ -74,6 +76,8 @@ BaseTrafficGen::BaseTrafficGen(const BaseTrafficGenParams &p)
       nextTransitionTick(0),
       nextPacketTick(0),
       maxOutstandingReqs(p.max_outstanding_reqs),
+      maxPacketsPerUpdate(p.max_packets_per_update),
+      batchSize(p.batch_size),
       port(name() + ".port", *this),
       retryPkt(NULL),
       retryPktTick(0), blockedWaitingResp(false),
@@ -82,6 +86,11 @@ BaseTrafficGen::BaseTrafficGen(const BaseTrafficGenParams &p)
       requestorId(system->getRequestorId(this)),
       streamGenerator(StreamGen::create(p))
 {
+    fatal_if(maxPacketsPerUpdate == 0,
+             "%s must be able to send at least one packet per update\n",
+             name());
+    fatal_if(batchSize == 0, "%s must have a batch size of at least 1\n",
+             name());
 }
 
 BaseTrafficGen::~BaseTrafficGen()
@@ -166,6 +175,8 @@ BaseTrafficGen::unserialize(CheckpointIn &cp)
 void
 BaseTrafficGen::update()
 {
+    ++stats.numUpdates;
+
     // shift our progress-tracking event forward
     reschedule(noProgressEvent, curTick() + progressCheck, true);
 
@@ -175,43 +186,24 @@ BaseTrafficGen::update()
         transition();
     } else {
         assert(curTick() >= nextPacketTick);
-        // get the next packet and try to send it
-        PacketPtr pkt = activeGenerator->getNextPacket();
-
-        // If generating stream/substream IDs are enabled,
-        // try to pick and assign them to the new packet
-        if (streamGenerator) {
-            auto sid = streamGenerator->pickStreamID();
-            auto ssid = streamGenerator->pickSubstreamID();
-
-            pkt->req->setStreamId(sid);
-
-            if (streamGenerator->ssidValid()) {
-                pkt->req->setSubstreamId(ssid);
+        sendNextPacket();
+
+        // keep on sending the packets that are already due, such as
+        // the packets of a trace recorded at the same tick, rather
+        // than schedule an update for each of them, but leave the
+        // state transition to its own update once it is due, and send a
+        // whole window of a batched generator, which is due at once
+        const unsigned max_packets = std::max(maxPacketsPerUpdate,
+                                              batchSize);
+        for (unsigned sent = 1; sent < max_packets && !retryPkt; ++sent) {
+            if (curTick() >= nextTransitionTick)
+                break;
+            nextPacketTick = activeGenerator->nextPacketTick(elasticReq, 0);
+            if (nextPacketTick > curTick()) {
+                scheduleUpdate();
+                return;
             }
-        }
-
-        // suppress packets that are not destined for a memory, such as
-        // device accesses that could be part of a trace
-        if (pkt && system->isMemAddr(pkt->getAddr())) {
-            stats.numPackets++;
-            // Only attempts to send if not blocked by pending responses
-            blockedWaitingResp = allocateWaitingRespSlot(pkt);
-            if (blockedWaitingResp || !port.sendTimingReq(pkt)) {
-                retryPkt = pkt;
-                retryPktTick = curTick();
-            }
-        } else if (pkt) {
-            DPRINTF(TrafficGen, "Suppressed packet %s 0x%x\n",
-                    pkt->cmdString(), pkt->getAddr());
-
-            ++stats.numSuppressed;
-            if (!(static_cast<int>(stats.numSuppressed.value()) % 10000))
-                warn("%s suppressed %d packets with non-memory addresses\n",
-                     name(), stats.numSuppressed.value());
-
-            delete pkt;
-            pkt = nullptr;
+            sendNextPacket();
         }
     }
 
@@ -224,6 +216,49 @@ BaseTrafficGen::update()
     }
 }
 
+void
+BaseTrafficGen::sendNextPacket()
+{
+    // get the next packet and try to send it
+    PacketPtr pkt = activeGenerator->getNextPacket();
+
+    // If generating stream/substream IDs are enabled,
+    // try to pick and assign them to the new packet
+    if (streamGenerator) {
+        auto sid = streamGenerator->pickStreamID();
+        auto ssid = streamGenerator->pickSubstreamID();
+
+        pkt->req->setStreamId(sid);
+
+        if (streamGenerator->ssidValid()) {
+            pkt->req->setSubstreamId(ssid);
+        }
+    }
+
+    // suppress packets that are not destined for a memory, such as
+    // device accesses that could be part of a trace
+    if (pkt && system->isMemAddr(pkt->getAddr())) {
+        stats.numPackets++;
+        // Only attempts to send if not blocked by pending responses
+        blockedWaitingResp = allocateWaitingRespSlot(pkt);
+        if (blockedWaitingResp || !port.sendTimingReq(pkt)) {
+            retryPkt = pkt;
+            retryPktTick = curTick();
+        }
+    } else if (pkt) {
+        DPRINTF(TrafficGen, "Suppressed packet %s 0x%x\n",
+                pkt->cmdString(), pkt->getAddr());
+
+        ++stats.numSuppressed;
+        if (!(static_cast<int>(stats.numSuppressed.value()) % 10000))
+            warn("%s suppressed %d packets with non-memory addresses\n",
+                 name(), stats.numSuppressed.value());
+
+        delete pkt;
+        pkt = nullptr;
+    }
+}
+
 void
 BaseTrafficGen::transition()
 {
@@ -335,6 +370,8 @@ BaseTrafficGen::StatGroup::StatGroup(Stats::Group *parent)
       ADD_STAT(numSuppressed, UNIT_COUNT,
                "Number of suppressed packets to non-memory space"),
       ADD_STAT(numPackets, UNIT_COUNT, "Number of packets generated"),
+      ADD_STAT(numUpdates, UNIT_COUNT,
+               "Number of update events sending packets or transitioning"),
       ADD_STAT(numRetries, UNIT_COUNT, "Number of retries"),
       ADD_STAT(retryTicks, UNIT_TICK,
                "Time spent waiting due to back-pressure"),
@@ -356,8 +393,31 @@ BaseTrafficGen::StatGroup::StatGroup(Stats::Group *parent)
       ADD_STAT(readBW, UNIT_RATE(Stats::Units::Byte, Stats::Units::Second),
                "Read bandwidth", bytesRead / simSeconds),
       ADD_STAT(writeBW, UNIT_RATE(Stats::Units::Byte, Stats::Units::Second),
-               "Write bandwidth", bytesWritten / simSeconds)
+               "Write bandwidth", bytesWritten / simSeconds),
+      ADD_STAT(hostPacketRate,
+               UNIT_RATE(Stats::Units::Count, Stats::Units::Second),
+               "Simulator packet generation rate (packet/s)",
+               numPackets / hostSeconds),
+      ADD_STAT(packetsPerUpdate,
+               UNIT_RATE(Stats::Units::Count, Stats::Units::Count),
+               "Packets generated per update event",
+               numPackets / numUpdates)
 {
+    hostPacketRate
+        .precision(0);
+
+    packetsPerUpdate
+        .precision(2);
+}
+
+std::shared_ptr<BaseGen>
+BaseTrafficGen::batched(const std::shared_ptr<BaseGen> &gen)
+{
+    if (batchSize <= 1)
+        return gen;
+
+    return std::shared_ptr<BaseGen>(new BatchedGen(*this, requestorId,
+                                                   gen, batchSize));
 }
 
 std::shared_ptr<BaseGen>
@@ -380,12 +440,13 @@ BaseTrafficGen::createLinear(Tick duration,
                              Tick min_period, Tick max_period,
                              uint8_t read_percent, Addr data_limit)
 {
-    return std::shared_ptr<BaseGen>(new LinearGen(*this, requestorId,
-                                                  duration, start_addr,
-                                                  end_addr, blocksize,
-                                                  system->cacheLineSize(),
-                                                  min_period, max_period,
-                                                  read_percent, data_limit));
+    std::shared_ptr<BaseGen> gen(new LinearGen(*this, requestorId,
+                                               duration, start_addr,
+                                               end_addr, blocksize,
+                                               system->cacheLineSize(),
+                                               min_period, max_period,
+                                               read_percent, data_limit));
+    return batched(gen);
 }
 
 std::shared_ptr<BaseGen>
@@ -394,12 +455,13 @@ BaseTrafficGen::createRandom(Tick duration,
                              Tick min_period, Tick max_period,
                              uint8_t read_percent, Addr data_limit)
 {
-    return std::shared_ptr<BaseGen>(new RandomGen(*this, requestorId,
-                                                  duration, start_addr,
-                                                  end_addr, blocksize,
-                                                  system->cacheLineSize(),
-                                                  min_period, max_period,
-                                                  read_percent, data_limit));
+    std::shared_ptr<BaseGen> gen(new RandomGen(*this, requestorId,
+                                               duration, start_addr,
+                                               end_addr, blocksize,
+                                               system->cacheLineSize(),
+                                               min_period, max_period,
+                                               read_percent, data_limit));
+    return batched(gen);
 }
 
 std::shared_ptr<BaseGen>
@@ -413,17 +475,18 @@ BaseTrafficGen::createDram(Tick duration,
                            Enums::AddrMap addr_mapping,
                            unsigned int nbr_of_ranks)
 {
-    return std::shared_ptr<BaseGen>(new DramGen(*this, requestorId,
-                                                duration, start_addr,
-                                                end_addr, blocksize,
-                                                system->cacheLineSize(),
-                                                min_period, max_period,
-                                                read_percent, data_limit,
-                                                num_seq_pkts, page_size,
-                                                nbr_of_banks,
-                                                nbr_of_banks_util,
-                                                addr_mapping,
-                                                nbr_of_ranks));
+    std::shared_ptr<BaseGen> gen(new DramGen(*this, requestorId,
+                                             duration, start_addr,
+                                             end_addr, blocksize,
+                                             system->cacheLineSize(),
+                                             min_period, max_period,
+                                             read_percent, data_limit,
+                                             num_seq_pkts, page_size,
+                                             nbr_of_banks,
+                                             nbr_of_banks_util,
+                                             addr_mapping,
+                                             nbr_of_ranks));
+    return batched(gen);
 }
 
 std::shared_ptr<BaseGen>
@@ -439,18 +502,19 @@ BaseTrafficGen::createDramRot(Tick duration,
                               unsigned int nbr_of_ranks,
                               unsigned int max_seq_count_per_rank)
 {
-    return std::shared_ptr<BaseGen>(new DramRotGen(*this, requestorId,
-                                                   duration, start_addr,
-                                                   end_addr, blocksize,
-                                                   system->cacheLineSize(),
-                                                   min_period, max_period,
-                                                   read_percent, data_limit,
-                                                   num_seq_pkts, page_size,
-                                                   nbr_of_banks,
-                                                   nbr_of_banks_util,
-                                                   addr_mapping,
-                                                   nbr_of_ranks,
-                                                   max_seq_count_per_rank));
+    std::shared_ptr<BaseGen> gen(new DramRotGen(*this, requestorId,
+                                                duration, start_addr,
+                                                end_addr, blocksize,
+                                                system->cacheLineSize(),
+                                                min_period, max_period,
+                                                read_percent, data_limit,
+                                                num_seq_pkts, page_size,
+                                                nbr_of_banks,
+                                                nbr_of_banks_util,
+                                                addr_mapping,
+                                                nbr_of_ranks,
+                                                max_seq_count_per_rank));
+    return batched(gen);
 }
 
 std::shared_ptr<BaseGen>
@@ -474,26 +538,27 @@ BaseTrafficGen::createHybrid(Tick duration,
                            unsigned int nbr_of_ranks_nvm,
                            uint8_t nvm_percent)
 {
-    return std::shared_ptr<BaseGen>(new HybridGen(*this, requestorId,
-                                                duration, start_addr_dram,
-                                                end_addr_dram, blocksize_dram,
-                                                start_addr_nvm,
-                                                end_addr_nvm, blocksize_nvm,
-                                                system->cacheLineSize(),
-                                                min_period, max_period,
-                                                read_percent, data_limit,
-                                                num_seq_pkts_dram,
-                                                page_size_dram,
-                                                nbr_of_banks_dram,
-                                                nbr_of_banks_util_dram,
-                                                num_seq_pkts_nvm,
-                                                buffer_size_nvm,
-                                                nbr_of_banks_nvm,
-                                                nbr_of_banks_util_nvm,
-                                                addr_mapping,
-                                                nbr_of_ranks_dram,
-                                                nbr_of_ranks_nvm,
-                                                nvm_percent));
+    std::shared_ptr<BaseGen> gen(new HybridGen(*this, requestorId,
+                                             duration, start_addr_dram,
+                                             end_addr_dram, blocksize_dram,
+                                             start_addr_nvm,
+                                             end_addr_nvm, blocksize_nvm,
+                                             system->cacheLineSize(),
+                                             min_period, max_period,
+                                             read_percent, data_limit,
+                                             num_seq_pkts_dram,
+                                             page_size_dram,
+                                             nbr_of_banks_dram,
+                                             nbr_of_banks_util_dram,
+                                             num_seq_pkts_nvm,
+                                             buffer_size_nvm,
+                                             nbr_of_banks_nvm,
+                                             nbr_of_banks_util_nvm,
+                                             addr_mapping,
+                                             nbr_of_ranks_dram,
+                                             nbr_of_ranks_nvm,
+                                             nvm_percent));
+    return batched(gen);
 }
 
 std::shared_ptr<BaseGen>
@@ -507,17 +572,18 @@ BaseTrafficGen::createNvm(Tick duration,
                            Enums::AddrMap addr_mapping,
                            unsigned int nbr_of_ranks)
 {
-    return std::shared_ptr<BaseGen>(new NvmGen(*this, requestorId,
-                                                duration, start_addr,
-                                                end_addr, blocksize,
-                                                system->cacheLineSize(),
-                                                min_period, max_period,
-                                                read_percent, data_limit,
-                                                num_seq_pkts, buffer_size,
-                                                nbr_of_banks,
-                                                nbr_of_banks_util,
-                                                addr_mapping,
-                                                nbr_of_ranks));
+    std::shared_ptr<BaseGen> gen(new NvmGen(*this, requestorId,
+                                             duration, start_addr,
+                                             end_addr, blocksize,
+                                             system->cacheLineSize(),
+                                             min_period, max_period,
+                                             read_percent, data_limit,
+                                             num_seq_pkts, buffer_size,
+                                             nbr_of_banks,
+                                             nbr_of_banks_util,
+                                             addr_mapping,
+                                             nbr_of_ranks));
+    return batched(gen);
 }
 
 std::shared_ptr<BaseGen>
@@ -527,13 +593,14 @@ BaseTrafficGen::createStrided(Tick duration,
                              Tick min_period, Tick max_period,
                              uint8_t read_percent, Addr data_limit)
 {
-    return std::shared_ptr<BaseGen>(new StridedGen(*this, requestorId,
-                                                  duration, start_addr,
-                                                  end_addr, blocksize,
-                                                  system->cacheLineSize(),
-                                                  stride_size, gen_id,
-                                                  min_period, max_period,
-                                                  read_percent, data_limit));
+    std::shared_ptr<BaseGen> gen(new StridedGen(*this, requestorId,
+                                               duration, start_addr,
+                                               end_addr, blocksize,
+                                               system->cacheLineSize(),
+                                               stride_size, gen_id,
+                                               min_period, max_period,
+                                               read_percent, data_limit));
+    return batched(gen);
 }
 
 std::shared_ptr<BaseGen>
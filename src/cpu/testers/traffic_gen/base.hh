@@ -122,6 +122,19 @@ class BaseTrafficGen : public ClockedObject
 
     const int maxOutstandingReqs;
 
+    /**
+     * Maximum number of packets sent in one update, as long as the
+     * following packets are already due.
+     */
+    const unsigned maxPacketsPerUpdate;
+
+    /**
+     * Number of packets a stochastic generator creates ahead of time
+     * and sends in one update, or one to create each packet when it
+     * is sent.
+     */
+    const unsigned batchSize;
+
 
     /** Request port specialisation for the traffic generator */
     class TrafficGenPort : public RequestPort
@@ -157,6 +170,12 @@ class BaseTrafficGen : public ClockedObject
      */
     void update();
 
+    /**
+     * Get the next packet from the active generator and try to send
+     * it, leaving it in retryPkt if it cannot be sent.
+     */
+    void sendNextPacket();
+
     /** The instance of request port used by the traffic generator. */
     TrafficGenPort port;
 
@@ -200,6 +219,9 @@ class BaseTrafficGen : public ClockedObject
         /** Count the number of generated packets. */
         Stats::Scalar numPackets;
 
+        /** Count the number of update events. */
+        Stats::Scalar numUpdates;
+
         /** Count the number of retries. */
         Stats::Scalar numRetries;
 
@@ -235,6 +257,12 @@ class BaseTrafficGen : public ClockedObject
 
         /** Write bandwidth in bytes/s  */
         Stats::Formula writeBW;
+
+        /** Packets generated per second of host time */
+        Stats::Formula hostPacketRate;
+
+        /** Packets generated per update event */
+        Stats::Formula packetsPerUpdate;
     } stats;
 
   public:
@@ -252,6 +280,16 @@ class BaseTrafficGen : public ClockedObject
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 
+  protected:
+    /**
+     * Wrap a generator in a BatchedGen if packets are to be created
+     * in batches.
+     *
+     * @param gen Generator to wrap
+     * @return The batched generator, or gen itself for a batch size of 1
+     */
+    std::shared_ptr<BaseGen> batched(const std::shared_ptr<BaseGen> &gen);
+
   public: // Generator factory methods
     std::shared_ptr<BaseGen> createIdle(Tick duration);
     std::shared_ptr<BaseGen> createExit(Tick duration);
@@ -53,20 +53,19 @@ BaseGen::getPacket(Addr addr, unsigned size, const MemCmd& cmd,
                    Request::FlagsType flags)
 {
     // Create new request
-    RequestPtr req = std::make_shared<Request>(addr, size, flags,
-                                               requestorId);
+    RequestPtr req = makeRequest(addr, size, flags, requestorId);
     // Dummy PC to have PC-based prefetchers latch on; get entropy into higher
     // bits
     req->setPC(((Addr)requestorId) << 2);
 
-    // Embed it in a packet
+    // Embed it in a packet, with payloads of up to a cache line held
+    // in the packet itself rather than allocated on their own
     PacketPtr pkt = new Packet(req, cmd);
-
-    uint8_t* pkt_data = new uint8_t[req->getSize()];
-    pkt->dataDynamic(pkt_data);
+    pkt->allocate();
 
     if (cmd.isWrite()) {
-        std::fill_n(pkt_data, req->getSize(), (uint8_t)requestorId);
+        std::fill_n(pkt->getPtr<uint8_t>(), req->getSize(),
+                    (uint8_t)requestorId);
     }
 
     return pkt;
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/batched_gen.hh"
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+
+BatchedGen::BatchedGen(SimObject &obj, RequestorID requestor_id,
+                       std::shared_ptr<BaseGen> _gen, unsigned batch_size)
+    : BaseGen(obj, requestor_id, _gen->duration),
+      gen(_gen), window(batch_size), lastTick(0), genComplete(false),
+      windowIssued(false)
+{
+    fatal_if(batch_size == 0, "%s: a batch needs at least one packet\n",
+             name());
+}
+
+BatchedGen::~BatchedGen()
+{
+    clear();
+}
+
+void
+BatchedGen::enter()
+{
+    gen->enter();
+
+    clear();
+    lastTick = curTick();
+    genComplete = false;
+    windowIssued = false;
+}
+
+void
+BatchedGen::fill() const
+{
+    // Ask the generator for its packets in the same order as the
+    // traffic generator would, the wait before a packet first. The
+    // generator counts the wait from the current tick, whereas the
+    // packets of the window follow on from one another.
+    while (!window.full() && !genComplete) {
+        const Tick next = gen->nextPacketTick(false, 0);
+        if (next == MaxTick) {
+            genComplete = true;
+            break;
+        }
+        lastTick += next - curTick();
+        window.push_back(std::make_pair(lastTick, gen->getNextPacket()));
+    }
+
+    DPRINTF(TrafficGen, "BatchedGen::fill: %d packets up to tick %d\n",
+            window.size(), lastTick);
+}
+
+void
+BatchedGen::clear()
+{
+    for (auto &entry : window)
+        delete entry.second;
+    window.flush();
+}
+
+PacketPtr
+BatchedGen::getNextPacket()
+{
+    // the traffic generator only asks for a packet once it is due, so
+    // the window is never empty here
+    assert(!window.empty());
+
+    PacketPtr pkt = window.front().second;
+    window.pop_front();
+    windowIssued = !window.empty();
+
+    // the request was created when the window was filled
+    pkt->req->setTime(curTick());
+    return pkt;
+}
+
+void
+BatchedGen::exit()
+{
+    // drop the packets that were generated ahead of the transition
+    clear();
+    windowIssued = false;
+    gen->exit();
+}
+
+Tick
+BatchedGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    // the rest of a window goes out along with its first packet
+    if (windowIssued)
+        return curTick();
+
+    if (window.empty())
+        fill();
+
+    if (window.empty())
+        return MaxTick;
+
+    // The packets of the window are due at ticks computed without
+    // any back pressure. Without batching, the next packet of an
+    // elastic generator is due its wait after the previous packet was
+    // sent rather than when it was meant to be sent, and that of an
+    // inelastic one no earlier than now, and the packets after it
+    // follow on from there. Shift the window, and the packets still to
+    // be generated, accordingly. In either case, never hand out a
+    // tick in the past.
+    const Tick front = window.front().first;
+    Tick shift = elastic ? delay : 0;
+    if (front + shift < curTick())
+        shift = curTick() - front;
+
+    if (shift) {
+        for (auto &entry : window)
+            entry.first += shift;
+        lastTick += shift;
+    }
+
+    return window.front().first;
+}
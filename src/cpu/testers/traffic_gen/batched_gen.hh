@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a generator that computes the packets of another
+ * generator a window at a time.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_BATCHED_GEN_HH__
+#define __CPU_TRAFFIC_GEN_BATCHED_GEN_HH__
+
+#include <memory>
+#include <utility>
+
+#include "base/circular_queue.hh"
+#include "base_gen.hh"
+#include "mem/packet.hh"
+
+/**
+ * The batched generator wraps a generator whose next packet is due a
+ * wait after it is asked, such as the linear, random, strided and
+ * DRAM generators. Whenever its window of packets runs empty, it
+ * draws the next packets and their waits from the wrapped generator
+ * in one go. The whole window is issued at the tick its first packet
+ * is due, so that the traffic generator sends it from a single
+ * update, and the next window is due when its first packet would be
+ * without batching. The average rate is thus the same as without
+ * batching, but the packets go out in bursts of the window size, and
+ * their requests are stamped with the tick they are issued at. Back
+ * pressure shifts the windows as it would shift the packets generated
+ * one at a time. The packets of the window draw their random numbers
+ * from the global generator ahead of time, so the draws interleave
+ * differently with those of other objects, such as other traffic
+ * generators, and the packets generated ahead of a state transition
+ * are dropped along with their draws. Batching therefore changes the
+ * packet streams, unless the generator is the only user of the global
+ * random number generator.
+ */
+class BatchedGen : public BaseGen
+{
+
+  public:
+
+    /**
+     * Create a batched generator.
+     *
+     * @param obj SimObject owning this generator
+     * @param requestor_id RequestorID related to the memory requests
+     * @param _gen Generator to batch
+     * @param batch_size Number of packets in the window
+     */
+    BatchedGen(SimObject &obj, RequestorID requestor_id,
+               std::shared_ptr<BaseGen> _gen, unsigned batch_size);
+
+    ~BatchedGen();
+
+    void enter();
+
+    PacketPtr getNextPacket();
+
+    void exit();
+
+    Tick nextPacketTick(bool elastic, Tick delay) const;
+
+  private:
+
+    /**
+     * Fill the window from the wrapped generator, until it is full or
+     * the generator has no further packets.
+     */
+    void fill() const;
+
+    /** Delete the packets left in the window. */
+    void clear();
+
+    /** The generator that is batched */
+    const std::shared_ptr<BaseGen> gen;
+
+    /**
+     * Packets generated but not sent yet, along with the tick each
+     * is due at. This is mutable to fill it as part of
+     * nextPacketTick.
+     */
+    mutable CircularQueue<std::pair<Tick, PacketPtr>> window;
+
+    /** Tick the last packet of the window is due at */
+    mutable Tick lastTick;
+
+    /** Set when the wrapped generator has no further packets */
+    mutable bool genComplete;
+
+    /**
+     * Set once the first packet of the window is issued, as the rest
+     * of the window is due along with it.
+     */
+    bool windowIssued;
+};
+
+#endif
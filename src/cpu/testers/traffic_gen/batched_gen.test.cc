@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "base/random.hh"
+#include "cpu/testers/traffic_gen/batched_gen.hh"
+#include "cpu/testers/traffic_gen/linear_gen.hh"
+#include "cpu/testers/traffic_gen/random_gen.hh"
+#include "params/SimObject.hh"
+#include "sim/sim_object.hh"
+
+namespace {
+
+GTestTickHandler tickHandler;
+
+/** A packet as sent, along with the tick it was sent at */
+struct Sent
+{
+    Tick tick;
+    Addr addr;
+    MemCmd cmd;
+    unsigned size;
+    Tick time;
+};
+
+typedef std::function<std::shared_ptr<BaseGen>(SimObject &)> GenFactory;
+
+/**
+ * Send the packets of a generator as the traffic generator does when
+ * there is no back pressure, asking for the tick of the next packet
+ * once per packet sent, until it has no further packets.
+ */
+std::vector<Sent>
+send(BaseGen &gen)
+{
+    std::vector<Sent> sent;
+    tickHandler.setCurTick(0);
+    gen.enter();
+    for (Tick next = gen.nextPacketTick(false, 0); next != MaxTick;
+         next = gen.nextPacketTick(false, 0)) {
+        EXPECT_GE(next, curTick());
+        tickHandler.setCurTick(next);
+        PacketPtr pkt = gen.getNextPacket();
+        sent.push_back({curTick(), pkt->getAddr(), pkt->cmd,
+                        pkt->getSize(), pkt->req->time()});
+        delete pkt;
+    }
+    gen.exit();
+    return sent;
+}
+
+/**
+ * Send the packets of a generator with and without batching, from the
+ * same random seed, and check that the batched generator sends the
+ * same packets, a window at a time at the tick the first packet of the
+ * window is sent without batching.
+ */
+void
+checkBatched(const GenFactory &factory, unsigned batch_size)
+{
+    SimObjectParams params;
+    params.name = "owner";
+    params.eventq_index = 0;
+    SimObject owner(params);
+
+    auto unbatched = factory(owner);
+    random_mt.init(0x6a7e);
+    const std::vector<Sent> expected = send(*unbatched);
+
+    BatchedGen batched(owner, 0, factory(owner), batch_size);
+    random_mt.init(0x6a7e);
+    const std::vector<Sent> actual = send(batched);
+
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected.size(), actual.size());
+    unsigned num_ticks = 0;
+    for (size_t i = 0; i < actual.size(); i++) {
+        EXPECT_EQ(expected[i].addr, actual[i].addr) << "packet " << i;
+        EXPECT_EQ(expected[i].cmd, actual[i].cmd) << "packet " << i;
+        EXPECT_EQ(expected[i].size, actual[i].size) << "packet " << i;
+        EXPECT_EQ(expected[i - i % batch_size].tick, actual[i].tick)
+            << "packet " << i;
+        EXPECT_EQ(expected[i].tick, expected[i].time) << "packet " << i;
+        EXPECT_EQ(actual[i].tick, actual[i].time) << "packet " << i;
+        if (i == 0 || actual[i].tick != actual[i - 1].tick)
+            num_ticks++;
+    }
+
+    // one update for each window
+    EXPECT_EQ((actual.size() + batch_size - 1) / batch_size, num_ticks);
+}
+
+} // anonymous namespace
+
+TEST(BatchedGenTest, LinearMatchesUnbatched)
+{
+    // 1000 blocks of 64 bytes, with an incomplete last window
+    checkBatched([](SimObject &owner) {
+        return std::make_shared<LinearGen>(owner, 0, MaxTick, 0, 0xffff, 64,
+                                           64, 1000, 2000, 50, 64000);
+    }, 16);
+}
+
+TEST(BatchedGenTest, RandomMatchesUnbatched)
+{
+    checkBatched([](SimObject &owner) {
+        return std::make_shared<RandomGen>(owner, 0, MaxTick, 0, 0xffffff,
+                                           64, 64, 1000, 2000, 70, 64000);
+    }, 8);
+}
+
+TEST(BatchedGenTest, SinglePacketWindow)
+{
+    checkBatched([](SimObject &owner) {
+        return std::make_shared<RandomGen>(owner, 0, MaxTick, 0, 0xffffff,
+                                           64, 64, 1, 100, 30, 6400);
+    }, 1);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/binary_trace.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include "base/logging.hh"
+
+const uint32_t BinaryPacketTrace::magicNumber;
+const uint32_t BinaryPacketTrace::formatVersion;
+
+bool
+BinaryPacketTrace::isBinaryTrace(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    uint32_t magic = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    return file && letoh(magic) == magicNumber;
+}
+
+BinaryPacketTrace::BinaryPacketTrace(const std::string& filename)
+    : fileName(filename), mapping(MAP_FAILED), mappingSize(0),
+      header(nullptr), records(nullptr), numRecords(0)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Could not open %s: %s\n", fileName, strerror(errno));
+
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+        fatal("Could not stat %s: %s\n", fileName, strerror(errno));
+    mappingSize = st.st_size;
+    if (mappingSize < sizeof(Header))
+        fatal("%s is too small to be a binary packet trace\n", fileName);
+
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+        fatal("Could not mmap %s: %s\n", fileName, strerror(errno));
+    close(fd);
+
+    // The trace is read front to back, so have the kernel read ahead
+    // aggressively
+    madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+
+    header = static_cast<const Header*>(mapping);
+    if (letoh(header->magic) != magicNumber)
+        fatal("%s is not a binary packet trace\n", fileName);
+    if (letoh(header->version) != formatVersion) {
+        fatal("%s has binary trace version %d, expected %d\n", fileName,
+              letoh(header->version), formatVersion);
+    }
+    if (letoh(header->recordSize) != sizeof(Record)) {
+        fatal("%s has records of %d bytes, expected %d\n", fileName,
+              letoh(header->recordSize), sizeof(Record));
+    }
+
+    numRecords = letoh(header->numRecords);
+    if ((mappingSize - sizeof(Header)) / sizeof(Record) < numRecords) {
+        fatal("%s is truncated, it should hold %d records\n", fileName,
+              numRecords);
+    }
+    records = reinterpret_cast<const Record*>(header + 1);
+}
+
+BinaryPacketTrace::~BinaryPacketTrace()
+{
+    if (mapping != MAP_FAILED)
+        munmap(mapping, mappingSize);
+}
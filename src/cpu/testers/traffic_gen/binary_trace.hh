@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a packet trace with fixed-size binary records, which
+ * is mapped into memory rather than read and parsed.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_BINARY_TRACE_HH__
+#define __CPU_TRAFFIC_GEN_BINARY_TRACE_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "sim/byteswap.hh"
+
+/**
+ * A binary packet trace holds the same information as a protobuf
+ * packet trace, as fixed-size records. It is mapped into memory, so
+ * that reading a record is a matter of loading it, which lets a trace
+ * be replayed at a far higher rate than a compressed protobuf stream
+ * can be parsed. The traces are converted from the protobuf format by
+ * util/encode_binary_packet_trace.py.
+ *
+ * The file layout, with all fields in little endian, is:
+ *   - the header: the magic number, the format version, the tick
+ *     frequency, the number of records and the size of a record
+ *   - the records, each holding the tick, the address, the size, the
+ *     request flags and the command of a packet
+ */
+class BinaryPacketTrace
+{
+  public:
+
+    /** The header at the start of the file. */
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t tickFreq;
+        uint64_t numRecords;
+        uint32_t recordSize;
+        uint32_t reserved;
+    };
+
+    /** A packet of the trace. */
+    struct Record
+    {
+        uint64_t tick;
+        uint64_t addr;
+        uint32_t size;
+        uint32_t flags;
+        uint32_t cmd;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(Header) == 32, "Unexpected binary header size");
+    static_assert(sizeof(Record) == 32, "Unexpected binary record size");
+
+    /// Use the ASCII characters g5bp as our magic number
+    static const uint32_t magicNumber = 0x70623567;
+
+    /// Version of the file format
+    static const uint32_t formatVersion = 1;
+
+    /**
+     * Check whether a file is a binary packet trace.
+     *
+     * @param filename Path to the file to check
+     * @return True if the file starts with the binary magic number
+     */
+    static bool isBinaryTrace(const std::string& filename);
+
+    /**
+     * Map a trace into memory, and check its header.
+     *
+     * @param filename Path to the file to map
+     */
+    BinaryPacketTrace(const std::string& filename);
+
+    /** Unmap the trace. */
+    ~BinaryPacketTrace();
+
+    /** Tick frequency the trace was recorded with. */
+    uint64_t tickFreq() const { return letoh(header->tickFreq); }
+
+    /** Number of records in the trace. */
+    size_t size() const { return numRecords; }
+
+    /** Get a record of the trace. */
+    const Record& operator[](size_t idx) const { return records[idx]; }
+
+  private:
+
+    /**
+     * Hide the copy constructor and assignment operator.
+     * @{
+     */
+    BinaryPacketTrace(const BinaryPacketTrace&);
+    BinaryPacketTrace& operator=(const BinaryPacketTrace&);
+    /** @} */
+
+    /// Hold on to the file name for error messages
+    const std::string fileName;
+
+    /// Start and size of the mapping
+    void *mapping;
+    size_t mappingSize;
+
+    const Header *header;
+    const Record *records;
+    size_t numRecords;
+};
+
+#endif //__CPU_TRAFFIC_GEN_BINARY_TRACE_HH__
@@ -45,17 +45,29 @@
 #include "proto/packet.pb.h"
 
 TraceGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
+    : nextRecord(0)
 {
+    if (BinaryPacketTrace::isBinaryTrace(filename))
+        binaryTrace.reset(new BinaryPacketTrace(filename));
+    else
+        trace.reset(new ProtoInputStream(filename));
     init();
 }
 
 void
 TraceGen::InputStream::init()
 {
+    if (binaryTrace) {
+        if (binaryTrace->tickFreq() != SimClock::Frequency) {
+            panic("Trace was recorded with a different tick frequency %d\n",
+                  binaryTrace->tickFreq());
+        }
+        return;
+    }
+
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from trace\n");
     } else if (header_msg.tick_freq() != SimClock::Frequency) {
         panic("Trace was recorded with a different tick frequency %d\n",
@@ -66,15 +78,32 @@ TraceGen::InputStream::init()
 void
 TraceGen::InputStream::reset()
 {
-    trace.reset();
+    if (binaryTrace)
+        nextRecord = 0;
+    else
+        trace->reset();
     init();
 }
 
 bool
 TraceGen::InputStream::read(TraceElement& element)
 {
+    if (binaryTrace) {
+        if (nextRecord == binaryTrace->size())
+            return false;
+
+        const BinaryPacketTrace::Record &record =
+            (*binaryTrace)[nextRecord++];
+        element.cmd = MemCmd(letoh(record.cmd));
+        element.addr = letoh(record.addr);
+        element.blocksize = letoh(record.size);
+        element.tick = letoh(record.tick);
+        element.flags = letoh(record.flags);
+        return true;
+    }
+
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (trace->read(pkt_msg)) {
         element.cmd = pkt_msg.cmd();
         element.addr = pkt_msg.addr();
         element.blocksize = pkt_msg.size();
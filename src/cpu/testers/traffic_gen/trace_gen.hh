@@ -44,9 +44,12 @@
 #ifndef __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 #define __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 
+#include <memory>
+
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "base_gen.hh"
+#include "cpu/testers/traffic_gen/binary_trace.hh"
 #include "mem/packet.hh"
 #include "proto/protoio.hh"
 
@@ -100,15 +103,22 @@ class TraceGen : public BaseGen
     /**
      * The InputStream encapsulates a trace file and the
      * internal buffers and populates TraceElements based on
-     * the input.
+     * the input. The trace is either a protobuf packet trace or a
+     * binary one, told apart by the magic number of the file.
      */
     class InputStream
     {
 
       private:
 
-        /// Input file stream for the protobuf trace
-        ProtoInputStream trace;
+        /// Input file stream for a protobuf trace
+        std::unique_ptr<ProtoInputStream> trace;
+
+        /// Memory mapped binary trace
+        std::unique_ptr<BinaryPacketTrace> binaryTrace;
+
+        /// Index of the next record of the binary trace to read
+        size_t nextRecord;
 
       public:
 
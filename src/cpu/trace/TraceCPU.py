@@ -65,6 +65,23 @@ class TraceCPU(BaseCPU):
     sizeLoadBuffer = Param.Unsigned(16, "Number of entries in the load buffer")
     sizeROB =  Param.Unsigned(40, "Number of entries in the re-order buffer")
 
+    # The elastic data trace can be decoded ahead of the replay by a
+    # background thread, which overlaps reading and decompressing the trace
+    # with the simulation. It is off by default as the thread is not
+    # stopped around m5.fork(), which only carries the forking thread over.
+    decodeThread = Param.Bool(False, "Decode the elastic data trace in a "\
+        "background thread")
+    decodeQueueSize = Param.Unsigned(4096, "Number of nodes of the elastic "\
+        "data trace decoded ahead")
+
+    # The replay can start mid-trace when the traces are in the columnar
+    # format, using the block index to skip ahead. Dependencies on the
+    # skipped records of the data trace are considered complete.
+    instTraceStartTick = Param.Tick(0, "Tick of the instruction trace "\
+        "to start the replay from")
+    dataTraceStartSeqNum = Param.UInt64(0, "Sequence number of the data "\
+        "dependency trace to start the replay from")
+
     # Frequency multiplier used to effectively scale the Trace CPU frequency
     # either up or down. Note that the Trace CPU's clock domain must also be
     # changed when frequency is scaled. A default value of 1.0 means the same
@@ -37,6 +37,8 @@
 
 #include "cpu/trace/trace_cpu.hh"
 
+#include "base/hostinfo.hh"
+#include "sim/core.hh"
 #include "sim/sim_exit.hh"
 
 // Declare and initialize the static counter for number of trace CPUs.
@@ -50,7 +52,8 @@ TraceCPU::TraceCPU(const TraceCPUParams &params)
         dataRequestorID(params.system->getRequestorId(this, "data")),
         instTraceFile(params.instTraceFile),
         dataTraceFile(params.dataTraceFile),
-        icacheGen(*this, ".iside", icachePort, instRequestorID, instTraceFile),
+        icacheGen(*this, ".iside", icachePort, instRequestorID, instTraceFile,
+                  params.instTraceStartTick),
         dcacheGen(*this, ".dside", dcachePort, dataRequestorID, dataTraceFile,
                   params),
         icacheNextEvent([this]{ schedIcacheNext(); }, name()),
@@ -65,6 +68,9 @@ TraceCPU::TraceCPU(const TraceCPUParams &params)
     // Increment static counter for number of Trace CPUs.
     ++TraceCPU::numTraceCPUs;
 
+    // Don't leave the trace decode thread running while exiting
+    registerExitCallback([this]() { dcacheGen.stopDecoding(); });
+
     // Check that the python parameters for sizes of ROB, store buffer and
     // load buffer do not overflow the corresponding C++ variables.
     fatal_if(params.sizeROB > UINT16_MAX,
@@ -218,7 +224,8 @@ TraceCPU::checkAndSchedExitEvent()
 
 TraceCPU::ElasticDataGen::
 ElasticDataGenStatGroup::ElasticDataGenStatGroup(Stats::Group *parent,
-                                                 const std::string& _name) :
+                                                 const std::string& _name,
+                                                 ElasticDataGen &gen) :
     Stats::Group(parent, _name.c_str()),
     ADD_STAT(maxDependents, UNIT_COUNT,
              "Max number of dependents observed on a node"),
@@ -234,8 +241,20 @@ ElasticDataGenStatGroup::ElasticDataGenStatGroup(Stats::Group *parent,
     ADD_STAT(numSOLoads, UNIT_COUNT, "Number of strictly ordered loads"),
     ADD_STAT(numSOStores, UNIT_COUNT, "Number of strictly ordered stores"),
     ADD_STAT(dataLastTick, UNIT_TICK,
-             "Last tick simulated from the elastic data trace")
+             "Last tick simulated from the elastic data trace"),
+    ADD_STAT(numNodesReplayed, UNIT_COUNT,
+             "Number of nodes of the elastic data trace completed"),
+    ADD_STAT(hostNodeRate,
+             UNIT_RATE(Stats::Units::Count, Stats::Units::Second),
+             "Nodes replayed per second of host time"),
+    ADD_STAT(peakGraphNodes, UNIT_COUNT,
+             "Max number of nodes held by the node pool"),
+    ADD_STAT(peakNodePoolBytes, UNIT_BYTE,
+             "Max size of the node pool, excluding dependency arrays"),
+    ADD_STAT(peakHostMemory, UNIT_BYTE,
+             "Max host memory used, sampled when reading the trace")
 {
+    hostNodeRate.method(&gen, &ElasticDataGen::hostNodeRate);
 }
 
 Tick
@@ -244,37 +263,39 @@ TraceCPU::ElasticDataGen::init()
     DPRINTF(TraceCPUData, "Initializing data memory request generator "
             "DcacheGen: elastic issue with retry.\n");
 
+    hostStartTime = std::chrono::steady_clock::now();
+
     panic_if(!readNextWindow(),
             "Trace has %d elements. It must have at least %d elements.",
-            depGraph.size(), 2 * windowSize);
+            numNodes, 2 * windowSize);
     DPRINTF(TraceCPUData, "After 1st read, depGraph size:%d.\n",
-            depGraph.size());
+            numNodes);
 
     panic_if(!readNextWindow(),
             "Trace has %d elements. It must have at least %d elements.",
-            depGraph.size(), 2 * windowSize);
+            numNodes, 2 * windowSize);
     DPRINTF(TraceCPUData, "After 2st read, depGraph size:%d.\n",
-            depGraph.size());
+            numNodes);
 
     // Print readyList
     if (DTRACE(TraceCPUData)) {
         printReadyList();
     }
-    auto free_itr = readyList.begin();
+    const ReadyNode &free_node = readyHead();
     DPRINTF(TraceCPUData,
             "Execute tick of the first dependency free node %lli is %d.\n",
-            free_itr->seqNum, free_itr->execTick);
+            node(free_node.id).seqNum, free_node.execTick);
     // Return the execute tick of the earliest ready node so that an event
     // can be scheduled to call execute()
-    return (free_itr->execTick);
+    return (free_node.execTick);
 }
 
 void
 TraceCPU::ElasticDataGen::adjustInitTraceOffset(Tick& offset)
 {
-    for (auto& free_node : readyList) {
+    // Shifting all the nodes by the same offset keeps them in order
+    for (auto &free_node : readyList)
         free_node.execTick -= offset;
-    }
 }
 
 void
@@ -283,6 +304,78 @@ TraceCPU::ElasticDataGen::exit()
     trace.reset();
 }
 
+double
+TraceCPU::ElasticDataGen::hostNodeRate() const
+{
+    const auto end = execComplete ? hostEndTime :
+        std::chrono::steady_clock::now();
+    const std::chrono::duration<double> elapsed = end - hostStartTime;
+    return elapsed.count() > 0 ?
+        elasticStats.numNodesReplayed.value() / elapsed.count() : 0;
+}
+
+TraceCPU::ElasticDataGen::GraphNode &
+TraceCPU::ElasticDataGen::allocateNode()
+{
+    // If the ring is full, double it. Nodes are placed at the position
+    // given by their id in the new ring, swapping them so that their
+    // dependency arrays are moved rather than copied.
+    if (nextNode - oldestNode == nodePool.size()) {
+        std::vector<GraphNode> pool(2 * nodePool.size());
+        for (NodeId id = oldestNode; id != nextNode; ++id)
+            std::swap(pool[id & (pool.size() - 1)], node(id));
+        nodePool.swap(pool);
+        DPRINTF(TraceCPUData, "Node pool grown to %d nodes.\n",
+                nodePool.size());
+    }
+
+    elasticStats.peakGraphNodes = std::max<double>(
+        nextNode - oldestNode + 1, elasticStats.peakGraphNodes.value());
+    elasticStats.peakNodePoolBytes = std::max<double>(
+        nodePool.size() * sizeof(GraphNode),
+        elasticStats.peakNodePoolBytes.value());
+
+    GraphNode &new_node = node(nextNode);
+    new_node.id = nextNode++;
+    return new_node;
+}
+
+void
+TraceCPU::ElasticDataGen::releaseNode(GraphNode *node_ptr)
+{
+    assert(node_ptr->inGraph);
+    node_ptr->inGraph = false;
+    // clear the set of dependents, keeping its storage for reuse
+    node_ptr->dependents.clear();
+    --numNodes;
+    ++elasticStats.numNodesReplayed;
+
+    while (oldestNode != nextNode && !node(oldestNode).inGraph)
+        ++oldestNode;
+}
+
+TraceCPU::ElasticDataGen::GraphNode *
+TraceCPU::ElasticDataGen::findNode(NodeSeqNum seq_num)
+{
+    // The pool holds the nodes in trace order and the trace is sorted by
+    // sequence number, so the node can be found with a binary search. The
+    // completed nodes left in the ring keep their sequence number.
+    NodeId low = oldestNode;
+    NodeId high = nextNode;
+    while (low < high) {
+        const NodeId mid = low + (high - low) / 2;
+        if (node(mid).seqNum < seq_num)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low == nextNode)
+        return nullptr;
+    GraphNode &found = node(low);
+    return found.seqNum == seq_num && found.inGraph ? &found : nullptr;
+}
+
 bool
 TraceCPU::ElasticDataGen::readNextWindow()
 {
@@ -296,23 +389,31 @@ TraceCPU::ElasticDataGen::readNextWindow()
     }
 
     DPRINTF(TraceCPUData, "Start read: Size of depGraph is %d.\n",
-            depGraph.size());
+            numNodes);
 
     uint32_t num_read = 0;
     while (num_read != windowSize) {
 
-        // Create a new graph node
-        GraphNode* new_node = new GraphNode;
+        // Take a new graph node from the pool
+        GraphNode* new_node = &allocateNode();
 
         // Read the next line to get the next record. If that fails then end of
         // trace has been reached and traceComplete needs to be set in addition
         // to returning false.
         if (!trace.read(new_node)) {
             DPRINTF(TraceCPUData, "\tTrace complete!\n");
+            // Give the unused node back to the pool
+            --nextNode;
             traceComplete = true;
             return false;
         }
 
+        // Nodes are located with a binary search on their sequence number
+        fatal_if(nextNode > 1 && new_node->seqNum <= lastSeqNum,
+                 "Elastic trace is not sorted by sequence number (%lli "
+                 "after %lli).", new_node->seqNum, lastSeqNum);
+        lastSeqNum = new_node->seqNum;
+
         // Annotate the ROB dependencies of the new node onto the parent nodes.
         addDepsOnParent(new_node, new_node->robDep);
         // Annotate the register dependencies of the new node onto the parent
@@ -320,8 +421,9 @@ TraceCPU::ElasticDataGen::readNextWindow()
         addDepsOnParent(new_node, new_node->regDep);
 
         num_read++;
-        // Add to map
-        depGraph[new_node->seqNum] = new_node;
+        // Add to graph
+        new_node->inGraph = true;
+        ++numNodes;
         if (new_node->robDep.empty() && new_node->regDep.empty()) {
             // Source dependencies are already complete, check if resources
             // are available and issue. The execution time is approximated
@@ -330,8 +432,11 @@ TraceCPU::ElasticDataGen::readNextWindow()
         }
     }
 
+    elasticStats.peakHostMemory = std::max<double>(memUsage() * 1024,
+        elasticStats.peakHostMemory.value());
+
     DPRINTF(TraceCPUData, "End read: Size of depGraph is %d.\n",
-            depGraph.size());
+            numNodes);
     return true;
 }
 
@@ -342,13 +447,13 @@ TraceCPU::ElasticDataGen::addDepsOnParent(GraphNode *new_node, T& dep_list)
     auto dep_it = dep_list.begin();
     while (dep_it != dep_list.end()) {
         // We look up the valid dependency, i.e. the parent of this node
-        auto parent_itr = depGraph.find(*dep_it);
-        if (parent_itr != depGraph.end()) {
-            // If the parent is found, it is yet to be executed. Append a
-            // pointer to the new node to the dependents list of the parent
+        GraphNode *parent = findNode(*dep_it);
+        if (parent) {
+            // If the parent is found, it is yet to be executed. Append the
+            // id of the new node to the dependents list of the parent
             // node.
-            parent_itr->second->dependents.push_back(new_node);
-            auto num_depts = parent_itr->second->dependents.size();
+            parent->dependents.push_back(new_node->id);
+            auto num_depts = parent->dependents.size();
             elasticStats.maxDependents = std::max<double>(num_depts,
                                         elasticStats.maxDependents.value());
             dep_it++;
@@ -366,7 +471,7 @@ TraceCPU::ElasticDataGen::execute()
 {
     DPRINTF(TraceCPUData, "Execute start occupancy:\n");
     DPRINTFR(TraceCPUData, "\tdepGraph = %d, readyList = %d, "
-            "depFreeQueue = %d ,", depGraph.size(), readyList.size(),
+            "depFreeQueue = %d ,", numNodes, readyListSize(),
             depFreeQueue.size());
     hwResource.printOccupancy();
 
@@ -381,26 +486,25 @@ TraceCPU::ElasticDataGen::execute()
     // in depFreeQueue. If resources have become available for a node,
     // then issue it, i.e. add the node to readyList.
     while (!depFreeQueue.empty()) {
-        if (checkAndIssue(depFreeQueue.front(), false)) {
+        if (checkAndIssue(&node(depFreeQueue.front()), false)) {
             DPRINTF(TraceCPUData,
                     "Removing from depFreeQueue: seq. num %lli.\n",
-                    (depFreeQueue.front())->seqNum);
+                    node(depFreeQueue.front()).seqNum);
             depFreeQueue.pop();
         } else {
             break;
         }
     }
     // Proceed to execute from readyList
-    auto graph_itr = depGraph.begin();
-    auto free_itr = readyList.begin();
     // Iterate through readyList until the next free node has its execute
     // tick later than curTick or the end of readyList is reached
-    while (free_itr->execTick <= curTick() && free_itr != readyList.end()) {
+    while (readyListSize() != 0 && readyHead().execTick <= curTick()) {
 
-        // Get pointer to the node to be executed
-        graph_itr = depGraph.find(free_itr->seqNum);
-        assert(graph_itr != depGraph.end());
-        GraphNode* node_ptr = graph_itr->second;
+        // Get pointer to the node to be executed. Nodes in the readyList
+        // are always in the graph.
+        const ReadyNode free_node = readyHead();
+        GraphNode* node_ptr = &node(free_node.id);
+        assert(node_ptr->inGraph);
 
         // If there is a retryPkt send that else execute the load
         if (retryPkt) {
@@ -424,8 +528,14 @@ TraceCPU::ElasticDataGen::execute()
         }
         // If the retryPkt or a new load/store node failed, we exit from here
         // as a retry from cache will bring the control to execute(). The
-        // first node in readyList then, will be the failed node.
+        // first node in readyList then, will be the failed node. It is kept
+        // aside so that it stays first whatever nodes are added meanwhile.
         if (retryPkt) {
+            if (!retryNodeValid) {
+                popReadyList();
+                retryNode = free_node;
+                retryNodeValid = true;
+            }
             break;
         }
 
@@ -443,18 +553,18 @@ TraceCPU::ElasticDataGen::execute()
 
             auto child_itr = (node_ptr->dependents).begin();
             while (child_itr != (node_ptr->dependents).end()) {
+                GraphNode *child = &node(*child_itr);
                 // ROB dependency of a store on a load must not be removed
                 // after load is sent but after response is received
-                if (!(*child_itr)->isStore() &&
-                    (*child_itr)->removeRobDep(node_ptr->seqNum)) {
+                if (!child->isStore() &&
+                    child->removeRobDep(node_ptr->seqNum)) {
 
                     // Check if the child node has become dependency free
-                    if ((*child_itr)->robDep.empty() &&
-                        (*child_itr)->regDep.empty()) {
+                    if (child->robDep.empty() && child->regDep.empty()) {
 
                         // Source dependencies are complete, check if
                         // resources are available and issue
-                        checkAndIssue(*child_itr);
+                        checkAndIssue(child);
                     }
                     // Remove this child for the sent load and point to new
                     // location of the element following the erased element
@@ -472,7 +582,8 @@ TraceCPU::ElasticDataGen::execute()
             DPRINTF(TraceCPUData, "Node seq. num %lli done. Waking"
                     " up dependents..\n", node_ptr->seqNum);
 
-            for (auto child : node_ptr->dependents) {
+            for (auto child_id : node_ptr->dependents) {
+                GraphNode *child = &node(child_id);
                 // If the child node is dependency free removeDepOnInst()
                 // returns true.
                 if (child->removeDepOnInst(node_ptr->seqNum)) {
@@ -484,7 +595,14 @@ TraceCPU::ElasticDataGen::execute()
         }
 
         // After executing the node, remove from readyList and delete node.
-        readyList.erase(free_itr);
+        // The nodes added meanwhile are dependents of this node, later
+        // in program order, and execute no earlier, so it is still first.
+        if (retryNodeValid) {
+            retryNodeValid = false;
+        } else {
+            assert(readyList.front().id == free_node.id);
+            popReadyList();
+        }
         // If it is a cacheable load which was sent, don't delete
         // just yet.  Delete it in completeMemAccess() after the
         // response is received. If it is an strictly ordered
@@ -495,17 +613,11 @@ TraceCPU::ElasticDataGen::execute()
         if (!node_ptr->isLoad() || node_ptr->isStrictlyOrdered()) {
             // Release all resources occupied by the completed node
             hwResource.release(node_ptr);
-            // clear the dynamically allocated set of dependents
-            (node_ptr->dependents).clear();
             // Update the stat for numOps simulated
             owner.updateNumOps(node_ptr->robNum);
-            // delete node
-            delete node_ptr;
-            // remove from graph
-            depGraph.erase(graph_itr);
+            // remove from graph and recycle the node
+            releaseNode(node_ptr);
         }
-        // Point to first node to continue to next iteration of while loop
-        free_itr = readyList.begin();
     } // end of while loop
 
     // Print readyList, sizes of queues and resource status after updating
@@ -513,7 +625,7 @@ TraceCPU::ElasticDataGen::execute()
         printReadyList();
         DPRINTF(TraceCPUData, "Execute end occupancy:\n");
         DPRINTFR(TraceCPUData, "\tdepGraph = %d, readyList = %d, "
-                "depFreeQueue = %d ,", depGraph.size(), readyList.size(),
+                "depFreeQueue = %d ,", numNodes, readyListSize(),
                 depFreeQueue.size());
         hwResource.printOccupancy();
     }
@@ -527,7 +639,7 @@ TraceCPU::ElasticDataGen::execute()
     // If the size of the dependency graph is less than the dependency window
     // then read from the trace file to populate the graph next time we are in
     // execute.
-    if (depGraph.size() < windowSize && !traceComplete)
+    if (numNodes < windowSize && !traceComplete)
         nextRead = true;
 
     // If cache is not blocked, schedule an event for the first execTick in
@@ -535,13 +647,13 @@ TraceCPU::ElasticDataGen::execute()
     // list is empty then check if the next pending node has resources
     // available to issue. If yes, then schedule an event for the next cycle.
     if (!readyList.empty()) {
-        Tick next_event_tick = std::max(readyList.begin()->execTick,
+        Tick next_event_tick = std::max(readyList.front().execTick,
                                         curTick());
         DPRINTF(TraceCPUData, "Attempting to schedule @%lli.\n",
                 next_event_tick);
         owner.schedDcacheNextEvent(next_event_tick);
     } else if (readyList.empty() && !depFreeQueue.empty() &&
-                hwResource.isAvailable(depFreeQueue.front())) {
+                hwResource.isAvailable(&node(depFreeQueue.front()))) {
         DPRINTF(TraceCPUData, "Attempting to schedule @%lli.\n",
                 owner.clockEdge(Cycles(1)));
         owner.schedDcacheNextEvent(owner.clockEdge(Cycles(1)));
@@ -549,10 +661,11 @@ TraceCPU::ElasticDataGen::execute()
 
     // If trace is completely read, readyList is empty and depGraph is empty,
     // set execComplete to true
-    if (depGraph.empty() && readyList.empty() && traceComplete &&
+    if (numNodes == 0 && readyList.empty() && traceComplete &&
         !hwResource.awaitingResponse()) {
         DPRINTF(TraceCPUData, "\tExecution Complete!\n");
         execComplete = true;
+        hostEndTime = std::chrono::steady_clock::now();
         elasticStats.dataLastTick = curTick();
     }
 }
@@ -654,7 +767,7 @@ TraceCPU::ElasticDataGen::checkAndIssue(const GraphNode* node_ptr, bool first)
                 node_ptr->seqNum);
         // Compute the execute tick by adding the compute delay for the node
         // and add the ready node to the ready list
-        addToSortedReadyList(node_ptr->seqNum,
+        addToSortedReadyList(node_ptr->id,
                              owner.clockEdge() + node_ptr->compDelay);
         // Account for the resources taken up by this issued node.
         hwResource.occupy(node_ptr);
@@ -664,7 +777,7 @@ TraceCPU::ElasticDataGen::checkAndIssue(const GraphNode* node_ptr, bool first)
             // Although dependencies are complete, resources are not available.
             DPRINTFR(TraceCPUData, "\t\tResources unavailable for seq. num "
                     "%lli. Adding to depFreeQueue.\n", node_ptr->seqNum);
-            depFreeQueue.push(node_ptr);
+            depFreeQueue.push(node_ptr->id);
         } else {
             DPRINTFR(TraceCPUData, "\t\tResources unavailable for seq. num "
                     "%lli. Still pending issue.\n", node_ptr->seqNum);
@@ -687,9 +800,8 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
     } else {
         // If it is a load response then release the dependents waiting on it.
         // Get pointer to the completed load
-        auto graph_itr = depGraph.find(pkt->req->getReqInstSeqNum());
-        assert(graph_itr != depGraph.end());
-        GraphNode* node_ptr = graph_itr->second;
+        GraphNode* node_ptr = findNode(pkt->req->getReqInstSeqNum());
+        assert(node_ptr);
 
         // Release resources occupied by the load
         hwResource.release(node_ptr);
@@ -697,20 +809,17 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
         DPRINTF(TraceCPUData, "Load seq. num %lli response received. Waking up"
                 " dependents..\n", node_ptr->seqNum);
 
-        for (auto child : node_ptr->dependents) {
+        for (auto child_id : node_ptr->dependents) {
+            GraphNode *child = &node(child_id);
             if (child->removeDepOnInst(node_ptr->seqNum)) {
                 checkAndIssue(child);
             }
         }
 
-        // clear the dynamically allocated set of dependents
-        (node_ptr->dependents).clear();
         // Update the stat for numOps completed
         owner.updateNumOps(node_ptr->robNum);
-        // delete node
-        delete node_ptr;
-        // remove from graph
-        depGraph.erase(graph_itr);
+        // remove from graph and recycle the node
+        releaseNode(node_ptr);
     }
 
     if (DTRACE(TraceCPUData)) {
@@ -720,7 +829,7 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
     // If the size of the dependency graph is less than the dependency window
     // then read from the trace file to populate the graph next time we are in
     // execute.
-    if (depGraph.size() < windowSize && !traceComplete)
+    if (numNodes < windowSize && !traceComplete)
         nextRead = true;
 
     // If not waiting for retry, attempt to schedule next event
@@ -733,7 +842,7 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
         // are pending nodes in the depFreeQueue. The checking is done in the
         // execute() control flow, so schedule an event to go via that flow.
         Tick next_event_tick = readyList.empty() ? owner.clockEdge(Cycles(1)) :
-            std::max(readyList.begin()->execTick, owner.clockEdge(Cycles(1)));
+            std::max(readyHead().execTick, owner.clockEdge(Cycles(1)));
         DPRINTF(TraceCPUData, "Attempting to schedule @%lli.\n",
                 next_event_tick);
         owner.schedDcacheNextEvent(next_event_tick);
@@ -741,81 +850,40 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
 }
 
 void
-TraceCPU::ElasticDataGen::addToSortedReadyList(NodeSeqNum seq_num,
-                                               Tick exec_tick)
+TraceCPU::ElasticDataGen::addToSortedReadyList(NodeId id, Tick exec_tick)
 {
     ReadyNode ready_node;
-    ready_node.seqNum = seq_num;
+    ready_node.id = id;
     ready_node.execTick = exec_tick;
 
-    // Iterator to readyList
-    auto itr = readyList.begin();
-
-    // If the readyList is empty, simply insert the new node at the beginning
-    // and return
-    if (itr == readyList.end()) {
-        readyList.insert(itr, ready_node);
-        elasticStats.maxReadyListSize =
-            std::max<double>(readyList.size(),
-                             elasticStats.maxReadyListSize.value());
-        return;
-    }
-
-    // If the new node has its execution tick equal to the first node in the
-    // list then go to the next node. If the first node in the list failed
-    // to execute, its position as the first is thus maintained.
-    if (retryPkt) {
-        if (retryPkt->req->getReqInstSeqNum() == itr->seqNum)
-            itr++;
-    }
-
-    // Increment the iterator and compare the node pointed to by it to the new
-    // node till the position to insert the new node is found.
-    bool found = false;
-    while (!found && itr != readyList.end()) {
-        // If the execution tick of the new node is less than the node then
-        // this is the position to insert
-        if (exec_tick < itr->execTick) {
-            found = true;
-        // If the execution tick of the new node is equal to the node then
-        // sort in ascending order of sequence numbers
-        } else if (exec_tick == itr->execTick) {
-            // If the sequence number of the new node is less than the node
-            // then this is the position to insert
-            if (seq_num < itr->seqNum) {
-                found = true;
-            // Else go to next node
-            } else {
-                itr++;
-            }
-        } else {
-            // If the execution tick of the new node is greater than the node
-            // then go to the next node.
-            itr++;
-        }
-    }
-    readyList.insert(itr, ready_node);
+    // The node failed to be sent, if any, is not in the heap and thus
+    // keeps its position as the first node.
+    readyList.push_back(ready_node);
+    std::push_heap(readyList.begin(), readyList.end(), ReadyNode::later);
     // Update the stat for max size reached of the readyList
-    elasticStats.maxReadyListSize = std::max<double>(readyList.size(),
+    elasticStats.maxReadyListSize = std::max<double>(readyListSize(),
                                         elasticStats.maxReadyListSize.value());
 }
 
 void
 TraceCPU::ElasticDataGen::printReadyList()
 {
-    auto itr = readyList.begin();
-    if (itr == readyList.end()) {
+    if (readyListSize() == 0) {
         DPRINTF(TraceCPUData, "readyList is empty.\n");
         return;
     }
     DPRINTF(TraceCPUData, "Printing readyList:\n");
-    while (itr != readyList.end()) {
-        auto graph_itr = depGraph.find(itr->seqNum);
-        M5_VAR_USED GraphNode* node_ptr = graph_itr->second;
-        DPRINTFR(TraceCPUData, "\t%lld(%s), %lld\n", itr->seqNum,
-            node_ptr->typeToStr(), itr->execTick);
-        itr++;
-    }
+    auto print = [this](const ReadyNode &ready_node) {
+        M5_VAR_USED GraphNode* node_ptr = &node(ready_node.id);
+        DPRINTFR(TraceCPUData, "\t%lld(%s), %lld\n", node_ptr->seqNum,
+            node_ptr->typeToStr(), ready_node.execTick);
+    };
+    if (retryNodeValid)
+        print(retryNode);
+    std::vector<ReadyNode> sorted(readyList);
+    std::sort(sorted.begin(), sorted.end());
+    for (const auto &ready_node : sorted)
+        print(ready_node);
 }
 
 TraceCPU::ElasticDataGen::HardwareResource::HardwareResource(
@@ -1183,14 +1251,20 @@ TraceCPU::DcachePort::recvReqRetry()
 }
 
 TraceCPU::ElasticDataGen::InputStream::InputStream(
-        const std::string& filename, const double time_multiplier) :
-    trace(filename),
+        const std::string& filename, const double time_multiplier,
+        bool decode_thread, unsigned queue_size, uint64_t start_seq_num) :
+    trace(openTraceInputStream(filename)),
     timeMultiplier(time_multiplier),
-    microOpCount(0)
+    microOpCount(0),
+    readMicroOpCount(0),
+    useDecodeThread(decode_thread),
+    decodeQueue(decode_thread ? queue_size : 0),
+    decodeDone(false),
+    decodeStop(false)
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::InstDepRecordHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from %s\n", filename);
 
         if (header_msg.tick_freq() != SimClock::Frequency) {
@@ -1202,19 +1276,99 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
         // when the data dependency trace was captured in the o3cpu model
         windowSize = header_msg.window_size();
     }
+
+    // Replay from mid-trace, the dependencies on the skipped records are
+    // considered complete
+    fatal_if(start_seq_num && !trace->seek(start_seq_num),
+             "Starting the replay of %s mid-trace requires a columnar "
+             "trace.\n", filename);
+}
+
+TraceCPU::ElasticDataGen::InputStream::~InputStream()
+{
+    stopDecodeThread();
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::stopDecodeThread()
+{
+    if (decodeThread.joinable()) {
+        decodeStop = true;
+        decodeThread.join();
+        decodeStop = false;
+    }
+    decodeQueue.clear();
+    decodeDone = false;
 }
 
 void
 TraceCPU::ElasticDataGen::InputStream::reset()
 {
-    trace.reset();
+    stopDecodeThread();
+    trace->reset();
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::decodeLoop()
+{
+    while (!decodeStop) {
+        GraphNode *element = decodeQueue.back();
+        if (!element) {
+            // The replay is behind, wait for it to consume some nodes
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            continue;
+        }
+        if (!decode(element)) {
+            decodeDone = true;
+            return;
+        }
+        decodeQueue.push();
+    }
 }
 
 bool
 TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
 {
-    ProtoMessage::InstDepRecord pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (!useDecodeThread) {
+        if (!decode(element))
+            return false;
+        readMicroOpCount = element->robNum;
+        return true;
+    }
+
+    // Start decoding ahead on the first read
+    if (!decodeThread.joinable())
+        decodeThread = std::thread([this]() { decodeLoop(); });
+
+    GraphNode *decoded;
+    while (!(decoded = decodeQueue.front())) {
+        // The decode thread pushes its last node before flagging the end
+        // of the trace, so check the queue once more.
+        if (decodeDone) {
+            decoded = decodeQueue.front();
+            if (!decoded)
+                return false;
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    // Swap the decoded node in, which leaves the storage of the dependency
+    // arrays of the pool node to the queue for reuse.
+    const NodeId id = element->id;
+    std::swap(*element, *decoded);
+    element->id = id;
+    decodeQueue.pop();
+
+    readMicroOpCount = element->robNum;
+    return true;
+}
+
+bool
+TraceCPU::ElasticDataGen::InputStream::decode(GraphNode* element)
+{
+    ProtoMessage::InstDepRecord &pkt_msg = decodeMsg;
+    if (trace->read(pkt_msg)) {
         // Required fields
         element->seqNum = pkt_msg.seq_num();
         element->type = pkt_msg.type();
@@ -1285,8 +1439,11 @@ TraceCPU::ElasticDataGen::GraphNode::removeRegDep(NodeSeqNum reg_dep)
 {
     for (auto it = regDep.begin(); it != regDep.end(); it++) {
         if (*it == reg_dep) {
-            // If register dependency is found, erase it.
-            regDep.erase(it);
+            // If register dependency is found, erase it. The order of the
+            // dependencies does not matter, so move the last one in its
+            // place.
+            *it = regDep.back();
+            regDep.pop_back();
             DPRINTFR(TraceCPUData,
                     "\tFor %lli: Marking register dependency %lli done.\n",
                     seqNum, reg_dep);
@@ -1304,7 +1461,8 @@ TraceCPU::ElasticDataGen::GraphNode::removeRobDep(NodeSeqNum rob_dep)
     for (auto it = robDep.begin(); it != robDep.end(); it++) {
         if (*it == rob_dep) {
             // If the rob dependency is found, erase it.
-            robDep.erase(it);
+            *it = robDep.back();
+            robDep.pop_back();
             DPRINTFR(TraceCPUData,
                     "\tFor %lli: Marking ROB dependency %lli done.\n",
                     seqNum, rob_dep);
@@ -1350,9 +1508,9 @@ TraceCPU::ElasticDataGen::GraphNode::writeElementAsTrace() const
         DPRINTFR(TraceCPUData, ",%lli", dep);
     }
     auto child_itr = dependents.begin();
-    DPRINTFR(TraceCPUData, "dependents:");
+    DPRINTFR(TraceCPUData, "dependent ids:");
     while (child_itr != dependents.end()) {
-        DPRINTFR(TraceCPUData, ":%lli", (*child_itr)->seqNum);
+        DPRINTFR(TraceCPUData, ":%lli", *child_itr);
         child_itr++;
     }
 
@@ -1366,12 +1524,13 @@ TraceCPU::ElasticDataGen::GraphNode::typeToStr() const
     return Record::RecordType_Name(type);
 }
 
-TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
+TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename,
+                                                  Tick start_tick)
+    : trace(openTraceInputStream(filename))
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from %s\n", filename);
 
         if (header_msg.tick_freq() != SimClock::Frequency) {
@@ -1379,19 +1538,23 @@ TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
                   header_msg.tick_freq());
         }
     }
+
+    fatal_if(start_tick && !trace->seek(start_tick),
+             "Starting the replay of %s mid-trace requires a columnar "
+             "trace.\n", filename);
 }
 
 void
 TraceCPU::FixedRetryGen::InputStream::reset()
 {
-    trace.reset();
+    trace->reset();
 }
 
 bool
 TraceCPU::FixedRetryGen::InputStream::read(TraceElement* element)
 {
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (trace->read(pkt_msg)) {
         element->cmd = pkt_msg.cmd();
         element->addr = pkt_msg.addr();
         element->blocksize = pkt_msg.size();
@@ -38,21 +38,26 @@
 #ifndef __CPU_TRACE_TRACE_CPU_HH__
 #define __CPU_TRACE_TRACE_CPU_HH__
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
-#include <list>
+#include <memory>
 #include <queue>
-#include <set>
-#include <unordered_map>
+#include <thread>
+#include <vector>
 
 #include "arch/registers.hh"
+#include "base/intmath.hh"
+#include "base/spsc_queue.hh"
 #include "base/statistics.hh"
 #include "cpu/base.hh"
 #include "debug/TraceCPUData.hh"
 #include "debug/TraceCPUInst.hh"
 #include "params/TraceCPU.hh"
+#include "proto/columnar_io.hh"
 #include "proto/inst_dep_record.pb.h"
 #include "proto/packet.pb.h"
-#include "proto/protoio.hh"
 #include "sim/sim_events.hh"
 
 /**
@@ -132,6 +137,14 @@
  * Strictly-ordered requests are skipped and the dependencies on such requests
  * are handled by simply marking them complete immediately.
  *
+ * The nodes of the dependency graph are kept in a pool organised as a ring
+ * and indexed by the position of the node in the trace. As the trace is
+ * sorted by sequence number, a node is found from its sequence number with
+ * a binary search in the ring. Nodes and their dependency arrays are
+ * recycled, so that the replay does not allocate memory in steady state.
+ * The trace is decoded by a background thread feeding a lock-free queue, so
+ * that reading and decompressing the trace is overlapped with the replay.
+ *
  * A CountedExitEvent that contains a static int belonging to the Trace CPU
  * class as a down counter is used to implement multi Trace CPU simulation
  * exit.
@@ -372,16 +385,17 @@ class TraceCPU : public BaseCPU
         class InputStream
         {
           private:
-            // Input file stream for the protobuf trace
-            ProtoInputStream trace;
+            // Input file stream for the protobuf or columnar trace
+            std::unique_ptr<TraceInputStream> trace;
 
           public:
             /**
              * Create a trace input stream for a given file name.
              *
              * @param filename Path to the file to read from
+             * @param start_tick skip the packets before this tick
              */
-            InputStream(const std::string& filename);
+            InputStream(const std::string& filename, Tick start_tick);
 
             /**
              * Reset the stream such that it can be played once
@@ -404,11 +418,11 @@ class TraceCPU : public BaseCPU
         /* Constructor */
         FixedRetryGen(TraceCPU& _owner, const std::string& _name,
                    RequestPort& _port, RequestorID requestor_id,
-                   const std::string& trace_file) :
+                   const std::string& trace_file, Tick start_tick) :
             owner(_owner),
             port(_port),
             requestorId(requestor_id),
-            trace(trace_file),
+            trace(trace_file, start_tick),
             genName(owner.name() + ".fixedretry." + _name),
             retryPkt(nullptr),
             delta(0),
@@ -543,6 +557,12 @@ class TraceCPU : public BaseCPU
         /** Node ROB number type. */
         typedef uint64_t NodeRobNum;
 
+        /**
+         * Position of a node in the trace. Unlike sequence numbers, which
+         * have gaps, it is dense and is used to index the node pool.
+         */
+        typedef uint64_t NodeId;
+
         typedef ProtoMessage::InstDepRecord::RecordType RecordType;
         typedef ProtoMessage::InstDepRecord Record;
 
@@ -555,11 +575,17 @@ class TraceCPU : public BaseCPU
         class GraphNode
         {
           public:
-            /** Typedef for the list containing the ROB dependencies */
-            typedef std::list<NodeSeqNum> RobDepList;
+            /** Typedef for the array containing the ROB dependencies */
+            typedef std::vector<NodeSeqNum> RobDepList;
+
+            /** Typedef for the array containing the register dependencies */
+            typedef std::vector<NodeSeqNum> RegDepList;
 
-            /** Typedef for the list containing the register dependencies */
-            typedef std::list<NodeSeqNum> RegDepList;
+            /** Position of the node in the trace */
+            NodeId id;
+
+            /** Is the node in the dependency graph, i.e. not completed */
+            bool inGraph = false;
 
             /** Instruction sequence number */
             NodeSeqNum seqNum;
@@ -588,24 +614,24 @@ class TraceCPU : public BaseCPU
             /** Instruction PC */
             Addr pc;
 
-            /** List of order dependencies. */
+            /** Array of order dependencies. */
             RobDepList robDep;
 
             /** Computational delay */
             uint64_t compDelay;
 
             /**
-             * List of register dependencies (incoming) if any. Maximum number
+             * Array of register dependencies (incoming) if any. Maximum number
              * of source registers used to set maximum size of the array
              */
             RegDepList regDep;
 
             /**
-             * A vector of nodes dependent (outgoing) on this node. A
-             * sequential container is chosen because when dependents become
-             * free, they attempt to issue in program order.
+             * A vector of the ids of the nodes dependent (outgoing) on this
+             * node. A sequential container is chosen because when dependents
+             * become free, they attempt to issue in program order.
              */
-            std::vector<GraphNode *> dependents;
+            std::vector<NodeId> dependents;
 
             /** Is the node a load */
             bool isLoad() const { return (type == Record::LOAD); }
@@ -644,11 +670,30 @@ class TraceCPU : public BaseCPU
         /** Struct to store a ready-to-execute node and its execution tick. */
         struct ReadyNode
         {
-            /** The sequence number of the ready node */
-            NodeSeqNum seqNum;
+            /** The id of the ready node */
+            NodeId id;
 
             /** The tick at which the ready node must be executed */
             Tick execTick;
+
+            /**
+             * Ready nodes are executed in ascending order of their execute
+             * ticks, and in program order for the same tick.
+             */
+            bool
+            operator<(const ReadyNode &other) const
+            {
+                return execTick < other.execTick ||
+                    (execTick == other.execTick && id < other.id);
+            }
+
+            /** Order of the ready list heap, which keeps the first at the
+             * top */
+            static bool
+            later(const ReadyNode &a, const ReadyNode &b)
+            {
+                return b < a;
+            }
         };
 
         /**
@@ -754,13 +799,14 @@ class TraceCPU : public BaseCPU
         /**
          * The InputStream encapsulates a trace file and the
          * internal buffers and populates GraphNodes based on
-         * the input.
+         * the input. The records are optionally decoded ahead by a
+         * background thread.
          */
         class InputStream
         {
           private:
-            /** Input file stream for the protobuf trace */
-            ProtoInputStream trace;
+            /** Input file stream for the protobuf or columnar trace */
+            std::unique_ptr<TraceInputStream> trace;
 
             /**
              * A multiplier for the compute delays in the trace to modulate
@@ -770,24 +816,76 @@ class TraceCPU : public BaseCPU
              */
             const double timeMultiplier;
 
-            /** Count of committed ops read from trace plus the filtered ops */
+            /**
+             * Count of committed ops decoded from the trace plus the
+             * filtered ops
+             */
             uint64_t microOpCount;
 
+            /**
+             * Count of committed ops plus the filtered ops of the nodes
+             * read so far
+             */
+            uint64_t readMicroOpCount;
+
             /**
              * The window size that is read from the header of the protobuf
              * trace and used to process the dependency trace
              */
             uint32_t windowSize;
 
+            /** Decode the records with a background thread */
+            const bool useDecodeThread;
+
+            /** Nodes decoded by the decode thread, waiting to be read */
+            SPSCQueue<GraphNode> decodeQueue;
+
+            /** Background thread decoding the trace */
+            std::thread decodeThread;
+
+            /** Set by the decode thread when the end of trace is reached */
+            std::atomic<bool> decodeDone;
+
+            /** Set to ask the decode thread to stop */
+            std::atomic<bool> decodeStop;
+
+            /**
+             * Decode the next record of the trace.
+             *
+             * @param element Trace element to populate
+             * @return True if an element could be decoded successfully
+             */
+            bool decode(GraphNode* element);
+
+            /** Protobuf message reused to decode every record */
+            ProtoMessage::InstDepRecord decodeMsg;
+
+            /** Main loop of the decode thread */
+            void decodeLoop();
+
           public:
             /**
              * Create a trace input stream for a given file name.
              *
              * @param filename Path to the file to read from
              * @param time_multiplier used to scale the compute delays
+             * @param decode_thread decode the trace in a background thread
+             * @param queue_size number of nodes decoded ahead
+             * @param start_seq_num skip the records before this sequence
+             * number
              */
             InputStream(const std::string& filename,
-                        const double time_multiplier);
+                        const double time_multiplier,
+                        bool decode_thread, unsigned queue_size,
+                        uint64_t start_seq_num);
+
+            ~InputStream();
+
+            /**
+             * Stop and join the decode thread if it is running. The nodes
+             * decoded ahead are dropped.
+             */
+            void stopDecodeThread();
 
             /**
              * Reset the stream such that it can be played once
@@ -810,7 +908,7 @@ class TraceCPU : public BaseCPU
             uint32_t getWindowSize() const { return windowSize; }
 
             /** Get number of micro-ops modelled in the TraceCPU replay */
-            uint64_t getMicroOpCount() const { return microOpCount; }
+            uint64_t getMicroOpCount() const { return readMicroOpCount; }
         };
 
         public:
@@ -822,7 +920,9 @@ class TraceCPU : public BaseCPU
             owner(_owner),
             port(_port),
             requestorId(requestor_id),
-            trace(trace_file, 1.0 / params.freqMultiplier),
+            trace(trace_file, 1.0 / params.freqMultiplier,
+                  params.decodeThread, params.decodeQueueSize,
+                  params.dataTraceStartSeqNum),
             genName(owner.name() + ".elastic." + _name),
             retryPkt(nullptr),
             traceComplete(false),
@@ -830,10 +930,15 @@ class TraceCPU : public BaseCPU
             execComplete(false),
             windowSize(trace.getWindowSize()),
             hwResource(params.sizeROB, params.sizeStoreBuffer,
-                       params.sizeLoadBuffer), elasticStats(&_owner, _name)
+                       params.sizeLoadBuffer),
+            nodePool(size_t(1) << ceilLog2(std::max(2 * windowSize, 2U))),
+            oldestNode(0), nextNode(0), numNodes(0),
+            lastSeqNum(0), retryNodeValid(false),
+            elasticStats(&_owner, _name, *this)
         {
             DPRINTF(TraceCPUData, "Window size in the trace is %d.\n",
                     windowSize);
+            readyList.reserve(nodePool.size());
         }
 
         /**
@@ -858,6 +963,9 @@ class TraceCPU : public BaseCPU
         /** Exit the ElasticDataGen. */
         void exit();
 
+        /** Stop decoding the trace ahead, e.g., when gem5 exits. */
+        void stopDecoding() { trace.stopDecodeThread(); }
+
         /**
          * Reads a line of the trace file. Returns the tick when the next
          * request should be generated. If the end of the file has been
@@ -902,13 +1010,13 @@ class TraceCPU : public BaseCPU
         PacketPtr executeMemReq(GraphNode* node_ptr);
 
         /**
-         * Add a ready node to the readyList. When inserting, ensure the nodes
-         * are sorted in ascending order of their execute ticks.
+         * Add a ready node to the readyList. The nodes are sorted in
+         * ascending order of their execute ticks.
          *
-         * @param seq_num seq. num of ready node
+         * @param id id of ready node
          * @param exec_tick the execute tick of the ready node
          */
-        void addToSortedReadyList(NodeSeqNum seq_num, Tick exec_tick);
+        void addToSortedReadyList(NodeId id, Tick exec_tick);
 
         /** Print readyList for debugging using debug flag TraceCPUData. */
         void printReadyList();
@@ -943,7 +1051,65 @@ class TraceCPU : public BaseCPU
         /** Get number of micro-ops modelled in the TraceCPU replay */
         uint64_t getMicroOpCount() const { return trace.getMicroOpCount(); }
 
+        /** Replay throughput in nodes per second of host time */
+        double hostNodeRate() const;
+
       private:
+        /** Get a node of the pool from its id */
+        GraphNode &
+        node(NodeId id)
+        {
+            return nodePool[id & (nodePool.size() - 1)];
+        }
+
+        /**
+         * Take the next node of the pool, growing the pool if the ring is
+         * full. References to nodes are invalidated if it grows.
+         *
+         * @return Reference to the new node
+         */
+        GraphNode &allocateNode();
+
+        /**
+         * Remove a completed node from the graph and recycle the pool
+         * entries at the head of the ring that are not used any more.
+         *
+         * @param node_ptr pointer to the completed node
+         */
+        void releaseNode(GraphNode *node_ptr);
+
+        /**
+         * Find a node of the graph from its sequence number.
+         *
+         * @param seq_num sequence number of the node
+         * @return Pointer to the node, or nullptr if it is not in the graph
+         */
+        GraphNode *findNode(NodeSeqNum seq_num);
+
+        /** The node at the head of the readyList */
+        const ReadyNode &
+        readyHead() const
+        {
+            return retryNodeValid ? retryNode : readyList.front();
+        }
+
+        /** Take the first node off the readyList, not counting the node
+         * pending retry */
+        void
+        popReadyList()
+        {
+            std::pop_heap(readyList.begin(), readyList.end(),
+                          ReadyNode::later);
+            readyList.pop_back();
+        }
+
+        /** Size of the readyList including the node pending retry */
+        size_t
+        readyListSize() const
+        {
+            return readyList.size() + (retryNodeValid ? 1 : 0);
+        }
+
         /** Reference of the TraceCPU. */
         TraceCPU& owner;
 
@@ -988,8 +1154,25 @@ class TraceCPU : public BaseCPU
          */
         HardwareResource hwResource;
 
-        /** Store the depGraph of GraphNodes */
-        std::unordered_map<NodeSeqNum, GraphNode*> depGraph;
+        /**
+         * Pool of the GraphNodes forming the dependency graph. It is a ring
+         * whose size is a power of two, indexed by node id. It holds the
+         * nodes from the oldest node still in the graph to the newest node
+         * read.
+         */
+        std::vector<GraphNode> nodePool;
+
+        /** Id of the oldest node that may still be in the graph */
+        NodeId oldestNode;
+
+        /** Id of the next node read from the trace */
+        NodeId nextNode;
+
+        /** Number of nodes in the graph */
+        size_t numNodes;
+
+        /** Sequence number of the last node read from the trace */
+        NodeSeqNum lastSeqNum;
 
         /**
          * Queue of dependency-free nodes that are pending issue because
@@ -998,10 +1181,31 @@ class TraceCPU : public BaseCPU
          * into the queue in that order. Thus nodes are more likely to
          * issue in program order.
          */
-        std::queue<const GraphNode*> depFreeQueue;
+        std::queue<NodeId> depFreeQueue;
+
+        /**
+         * Nodes that are ready to execute, kept as a binary heap whose
+         * top is the first node to execute. Its storage is reserved for
+         * the size of the node pool, so it does not allocate in steady
+         * state.
+         */
+        std::vector<ReadyNode> readyList;
+
+        /**
+         * Node whose request failed to be sent. It stays at the head of
+         * the readyList, whatever the execute tick of the other nodes, until
+         * it is successfully retried.
+         */
+        ReadyNode retryNode;
+
+        /** True if retryNode holds a node */
+        bool retryNodeValid;
+
+        /** Host time when the replay started */
+        std::chrono::steady_clock::time_point hostStartTime;
 
-        /** List of nodes that are ready to execute */
-        std::list<ReadyNode> readyList;
+        /** Host time when the replay completed */
+        std::chrono::steady_clock::time_point hostEndTime;
 
       protected:
         // Defining the a stat group
@@ -1009,7 +1213,8 @@ class TraceCPU : public BaseCPU
         {
             /** name is the extension to the name for these stats */
             ElasticDataGenStatGroup(Stats::Group *parent,
-                                    const std::string& _name);
+                                    const std::string& _name,
+                                    ElasticDataGen &gen);
             /** Stats for data memory accesses replayed. */
             Stats::Scalar maxDependents;
             Stats::Scalar maxReadyListSize;
@@ -1022,6 +1227,12 @@ class TraceCPU : public BaseCPU
             Stats::Scalar numSOStores;
             /** Tick when ElasticDataGen completes execution */
             Stats::Scalar dataLastTick;
+            /** Replay throughput and memory footprint */
+            Stats::Scalar numNodesReplayed;
+            Stats::Value hostNodeRate;
+            Stats::Scalar peakGraphNodes;
+            Stats::Scalar peakNodePoolBytes;
+            Stats::Scalar peakHostMemory;
         } elasticStats;
     };
 
@@ -77,6 +77,12 @@ class CommMonitor(SimObject):
     latency_bins = Param.Unsigned('20', "# bins in latency histograms")
     disable_latency_hists = Param.Bool(False, "Disable latency histograms")
 
+    # track the latency of only one in N requests expecting a
+    # response, to save pushing and popping a sender state for all of
+    # them
+    latency_sample_interval = Param.Unsigned(1, "Track the latency of one "
+                                             "in this many requests")
+
     # inter transaction time (ITT) distributions in uniformly sized
     # bins up to the maximum, independently for read-to-read,
     # write-to-write and the combined request-to-request that does not
@@ -103,3 +109,12 @@ class CommMonitor(SimObject):
     read_addr_mask = Param.Addr(MaxAddr, "Address mask for read address")
     write_addr_mask = Param.Addr(MaxAddr, "Address mask for write address")
     disable_addr_dists = Param.Bool(True, "Disable address distributions")
+
+    # keep the burst length, latency and ITT histograms, which are
+    # sampled for every packet, in log-bucketed histograms of a fixed
+    # size, where each bucket is at most 2^-log_hist_precision of the
+    # values it holds wide, instead of the histograms above
+    log_hists = Param.Bool(False, "Use log-bucketed histograms for the "
+                           "per-packet histograms")
+    log_hist_precision = Param.Unsigned(4, "Sub-bucket bits of the "
+                                        "log-bucketed histograms")
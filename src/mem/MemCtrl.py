@@ -90,3 +90,11 @@ class MemCtrl(QoSMemCtrl):
     static_backend_latency = Param.Latency("10ns", "Static backend latency")
 
     command_window = Param.Latency("10ns", "Static backend latency")
+
+    # rather than scheduling the individual DRAM or NVM commands,
+    # determine the latency of each request analytically when it
+    # arrives, based on the open rows or buffers and the bandwidth
+    # limits of the memory, trading timing accuracy for simulation
+    # speed. This needs a single interface, DRAM or NVM.
+    analytical_timing = Param.Bool(False, "Compute the memory timing "
+                                   "analytically at request arrival")
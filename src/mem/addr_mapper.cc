@@ -213,17 +213,20 @@ RangeAddrMapper::RangeAddrMapper(const RangeAddrMapperParams &p) :
         if (originalRanges[x].size() != remappedRanges[x].size())
             fatal("AddrMapper: original and shadowed range list elements"
                   " aren't all of the same size\n");
+
+        fatal_if(!originalTable.insert(originalRanges[x], x),
+                 "AddrMapper: original range %s overlaps another one\n",
+                 originalRanges[x].to_string());
     }
 }
 
 Addr
 RangeAddrMapper::remapAddr(Addr addr) const
 {
-    for (int i = 0; i < originalRanges.size(); ++i) {
-        if (originalRanges[i].contains(addr)) {
-            Addr offset = addr - originalRanges[i].start();
-            return offset + remappedRanges[i].start();
-        }
+    const size_t *i = originalTable.contains(addr);
+    if (i) {
+        Addr offset = addr - originalRanges[*i].start();
+        return offset + remappedRanges[*i].start();
     }
 
     return addr;
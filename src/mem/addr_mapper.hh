@@ -38,6 +38,7 @@
 #ifndef __MEM_ADDR_MAPPER_HH__
 #define __MEM_ADDR_MAPPER_HH__
 
+#include "base/addr_decode_table.hh"
 #include "mem/port.hh"
 #include "params/AddrMapper.hh"
 #include "params/RangeAddrMapper.hh"
@@ -262,6 +263,9 @@ class RangeAddrMapper : public AddrMapper
      */
     std::vector<AddrRange> remappedRanges;
 
+    /** The original ranges, mapped to their index. */
+    AddrDecodeTable<size_t> originalTable;
+
     Addr remapAddr(Addr addr) const;
 
 };
@@ -148,6 +148,21 @@ class BaseCache(ClockedObject):
     # data cache.
     write_allocator = Param.WriteAllocator(NULL, "Write allocator")
 
+    # By default the cache contents are not checkpointed, and the cache
+    # starts cold after a restore. Saving the
+    # tag store allows warm caches to be restored, optionally into a cache
+    # with a different geometry. Block data is normally refetched from
+    # memory on restore, which is correct as checkpoints are taken after
+    # all dirty data has been written back; saving it is only needed for
+    # checkpoints of caches that still hold dirty data.
+    checkpoint_tags = Param.Bool(False, "Save the tag store in checkpoints")
+    checkpoint_data = Param.Bool(False, "Save block data in checkpoints "
+                                 "(requires checkpoint_tags)")
+    restore_tags = Param.Bool(True, "Restore the tag store if present in "
+                              "the checkpoint")
+    restore_data = Param.Bool(True, "Use block data saved in the checkpoint "
+                              "instead of refetching it from memory")
+
 class Cache(BaseCache):
     type = 'Cache'
     cxx_header = 'mem/cache/cache.hh'
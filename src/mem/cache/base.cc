@@ -45,6 +45,10 @@
 
 #include "mem/cache/base.hh"
 
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
 #include "base/compiler.hh"
 #include "base/logging.hh"
 #include "debug/Cache.hh"
@@ -58,6 +62,7 @@
 #include "mem/cache/queue_entry.hh"
 #include "mem/cache/tags/compressed_tags.hh"
 #include "mem/cache/tags/super_blk.hh"
+#include "mem/physical.hh"
 #include "params/BaseCache.hh"
 #include "params/WriteAllocator.hh"
 #include "sim/core.hh"
@@ -105,6 +110,11 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
       noTargetMSHR(nullptr),
       missCount(p.max_miss_count),
       addrRanges(p.addr_ranges.begin(), p.addr_ranges.end()),
+      checkpointTags(p.checkpoint_tags),
+      checkpointData(p.checkpoint_data),
+      restoreTags(p.restore_tags),
+      restoreData(p.restore_data),
+      restoredTags(false),
       system(p.system),
       stats(*this)
 {
@@ -130,6 +140,10 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
         "Compressed cache %s does not have a compression algorithm", name());
     if (compressor)
         compressor->setCache(this);
+
+    fatal_if(checkpointData && !checkpointTags,
+        "Cache %s cannot checkpoint data without checkpointing its tags",
+        name());
 }
 
 BaseCache::~BaseCache()
@@ -343,6 +357,9 @@ BaseCache::handleTimingReqMiss(PacketPtr pkt, MSHR *mshr, CacheBlk *blk,
 void
 BaseCache::recvTimingReq(PacketPtr pkt)
 {
+    if (ppPktRequestCPU->hasListeners())
+        ppPktRequestCPU->notify(ProbePoints::PacketInfo(pkt));
+
     // anything that is merely forwarded pays for the forward latency and
     // the delay provided by the crossbar
     Tick forward_time = clockEdge(forwardLatency) + pkt->headerDelay;
@@ -558,6 +575,9 @@ BaseCache::recvAtomic(PacketPtr pkt)
     // to access.
     Cycles lat = lookupLatency;
 
+    if (ppPktRequestCPU->hasListeners())
+        ppPktRequestCPU->notify(ProbePoints::PacketInfo(pkt));
+
     CacheBlk *blk = nullptr;
     PacketList writebacks;
     bool satisfied = access(pkt, blk, lat, writebacks);
@@ -635,6 +655,13 @@ BaseCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
     CacheBlk *blk = tags->findBlock(pkt->getAddr(), is_secure);
     MSHR *mshr = mshrQueue.findMatch(blk_addr, is_secure);
 
+    // an announcement of a block restored in a cache above is for the
+    // snoop filters below, so it passes by whatever this cache holds
+    if (from_cpu_side && pkt->isRestoredBlock()) {
+        memSidePort.sendFunctional(pkt);
+        return;
+    }
+
     pkt->pushLabel(name());
 
     CacheBlkPrintWrapper cbpw(blk);
@@ -1603,7 +1630,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 
     stats.writebacks[Request::wbRequestorId]++;
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure())
@@ -1646,7 +1673,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 PacketPtr
 BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
 {
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure()) {
@@ -1720,7 +1747,7 @@ BaseCache::writebackVisitor(CacheBlk &blk)
     if (blk.isSet(CacheBlk::DirtyBit)) {
         assert(blk.isValid());
 
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = makeRequest(
             regenerateBlkAddr(&blk), blkSize, 0, Request::funcRequestorId);
 
         request->taskId(blk.getTaskId());
@@ -1894,24 +1921,241 @@ BaseCache::sendWriteQueuePacket(WriteQueueEntry* wq_entry)
     }
 }
 
+void
+BaseCache::serializeTags(CheckpointOut &cp) const
+{
+    std::vector<Addr> blk_addr;
+    std::vector<uint8_t> blk_secure;
+    std::vector<unsigned> blk_coherence;
+    std::vector<uint8_t> blk_prefetched;
+    std::vector<RequestorID> blk_requestor;
+    std::vector<uint32_t> blk_task;
+    std::vector<Tick> blk_inserted;
+    std::vector<uint32_t> blk_set;
+    std::vector<uint32_t> blk_way;
+    std::vector<unsigned> repl_size;
+    std::vector<uint64_t> repl_state;
+    std::vector<uint8_t> blk_data;
+
+    std::vector<uint64_t> state;
+    tags->forEachBlk([&](CacheBlk &blk) {
+        if (!blk.isValid())
+            return;
+
+        unsigned coherence = 0;
+        for (const unsigned bit : {CacheBlk::WritableBit,
+                                   CacheBlk::ReadableBit,
+                                   CacheBlk::DirtyBit}) {
+            if (blk.isSet(bit))
+                coherence |= bit;
+        }
+
+        blk_addr.push_back(tags->regenerateBlkAddr(&blk));
+        blk_secure.push_back(blk.isSecure());
+        blk_coherence.push_back(coherence);
+        blk_prefetched.push_back(blk.wasPrefetched());
+        blk_requestor.push_back(blk.getSrcRequestorId());
+        blk_task.push_back(blk.getTaskId());
+        blk_inserted.push_back(curTick() - blk.getAge());
+        blk_set.push_back(blk.getSet());
+        blk_way.push_back(blk.getWay());
+
+        tags->saveReplacementState(blk, state);
+        repl_size.push_back(state.size());
+        repl_state.insert(repl_state.end(), state.begin(), state.end());
+
+        if (checkpointData)
+            blk_data.insert(blk_data.end(), blk.data, blk.data + blkSize);
+    });
+
+    ScopedCheckpointSection sec(cp, "tags");
+
+    paramOut(cp, "blk_size", blkSize);
+    SERIALIZE_CONTAINER(blk_addr);
+    SERIALIZE_CONTAINER(blk_secure);
+    SERIALIZE_CONTAINER(blk_coherence);
+    SERIALIZE_CONTAINER(blk_prefetched);
+    SERIALIZE_CONTAINER(blk_requestor);
+    SERIALIZE_CONTAINER(blk_task);
+    SERIALIZE_CONTAINER(blk_inserted);
+    SERIALIZE_CONTAINER(blk_set);
+    SERIALIZE_CONTAINER(blk_way);
+    SERIALIZE_CONTAINER(repl_size);
+    SERIALIZE_CONTAINER(repl_state);
+    if (checkpointData)
+        SERIALIZE_CONTAINER(blk_data);
+}
+
+void
+BaseCache::unserializeTags(CheckpointIn &cp)
+{
+    ScopedCheckpointSection sec(cp, "tags");
+
+    unsigned blk_size;
+    paramIn(cp, "blk_size", blk_size);
+    if (blk_size != blkSize) {
+        warn("Cache %s was checkpointed with %u byte blocks, but uses %u "
+             "byte blocks. Its tags will not be restored.\n", name(),
+             blk_size, blkSize);
+        return;
+    }
+
+    std::vector<Addr> blk_addr;
+    std::vector<uint8_t> blk_secure;
+    std::vector<unsigned> blk_coherence;
+    std::vector<uint8_t> blk_prefetched;
+    std::vector<RequestorID> blk_requestor;
+    std::vector<uint32_t> blk_task;
+    std::vector<Tick> blk_inserted;
+    std::vector<uint32_t> blk_set;
+    std::vector<uint32_t> blk_way;
+    std::vector<unsigned> repl_size;
+    std::vector<uint64_t> repl_state;
+    std::vector<uint8_t> blk_data;
+
+    UNSERIALIZE_CONTAINER(blk_addr);
+    UNSERIALIZE_CONTAINER(blk_secure);
+    UNSERIALIZE_CONTAINER(blk_coherence);
+    UNSERIALIZE_CONTAINER(blk_prefetched);
+    UNSERIALIZE_CONTAINER(blk_requestor);
+    UNSERIALIZE_CONTAINER(blk_task);
+    UNSERIALIZE_CONTAINER(blk_inserted);
+    UNSERIALIZE_CONTAINER(blk_set);
+    UNSERIALIZE_CONTAINER(blk_way);
+    UNSERIALIZE_CONTAINER(repl_size);
+    UNSERIALIZE_CONTAINER(repl_state);
+
+    const bool use_data = restoreData &&
+        cp.entryExists(Serializable::currentSection(), "blk_data");
+    if (use_data)
+        UNSERIALIZE_CONTAINER(blk_data);
+
+    const size_t num_blks = blk_addr.size();
+    fatal_if(blk_secure.size() != num_blks ||
+             blk_coherence.size() != num_blks ||
+             blk_prefetched.size() != num_blks ||
+             blk_requestor.size() != num_blks ||
+             blk_task.size() != num_blks ||
+             blk_inserted.size() != num_blks ||
+             blk_set.size() != num_blks ||
+             blk_way.size() != num_blks ||
+             repl_size.size() != num_blks ||
+             (use_data && blk_data.size() != num_blks * blkSize),
+             "Inconsistent tag checkpoint for cache %s\n", name());
+
+    // Locate the replacement state of each block
+    std::vector<size_t> repl_offset(num_blks);
+    size_t offset = 0;
+    for (size_t i = 0; i < num_blks; i++) {
+        repl_offset[i] = offset;
+        offset += repl_size[i];
+    }
+    fatal_if(offset != repl_state.size(),
+             "Inconsistent replacement state checkpoint for cache %s\n",
+             name());
+
+    // Insert the blocks in the order they were originally inserted, so
+    // that the most recent ones are kept if they do not all fit anymore
+    std::vector<size_t> order(num_blks);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&blk_inserted](size_t a, size_t b)
+        { return blk_inserted[a] < blk_inserted[b]; });
+
+    unsigned num_relocated = 0;
+    unsigned num_dropped = 0;
+    bool repl_mismatch = false;
+    std::vector<uint64_t> state;
+    for (const size_t i : order) {
+        const Addr addr = blk_addr[i];
+        const bool is_secure = blk_secure[i];
+
+        fatal_if((blk_coherence[i] & CacheBlk::DirtyBit) && !use_data,
+                 "Cache %s cannot restore dirty block %#llx without its "
+                 "data\n", name(), addr);
+
+        Request::Flags flags;
+        if (is_secure)
+            flags.set(Request::SECURE);
+        const RequestorID requestor =
+            blk_requestor[i] < system->maxRequestors() ?
+            blk_requestor[i] : RequestorID(Request::funcRequestorId);
+        RequestPtr req = makeRequest(
+            addr, blkSize, flags, requestor);
+        req->taskId(blk_task[i]);
+        Packet pkt(req, MemCmd::ReadReq);
+
+        // Prefer the block's original location; if the geometry of the
+        // cache has changed, let the replacement policy choose one
+        CacheBlk *blk = compressor ? nullptr :
+            tags->findRestoreEntry(addr, blk_set[i], blk_way[i]);
+        if (blk) {
+            tags->insertBlock(&pkt, blk);
+        } else {
+            PacketList writebacks;
+            blk = allocateBlock(&pkt, writebacks);
+            for (auto wb_pkt : writebacks) {
+                fatal_if(wb_pkt->cmd == MemCmd::WritebackDirty,
+                         "Cache %s cannot fit dirty block %#llx when "
+                         "restoring its tags\n", name(), wb_pkt->getAddr());
+                delete wb_pkt;
+            }
+            if (!blk) {
+                num_dropped++;
+                continue;
+            }
+            num_relocated++;
+        }
+
+        blk->setCoherenceBits(blk_coherence[i]);
+        if (blk_prefetched[i])
+            blk->setPrefetched();
+        blk->setWhenReady(curTick());
+
+        state.assign(repl_state.begin() + repl_offset[i],
+                     repl_state.begin() + repl_offset[i] + repl_size[i]);
+        if (!tags->restoreReplacementState(blk, state)) {
+            repl_mismatch = true;
+        }
+
+        if (use_data) {
+            std::memcpy(blk->data, &blk_data[i * blkSize], blkSize);
+        } else {
+            pendingFills.emplace_back(addr, is_secure);
+        }
+    }
+
+    restoredTags = true;
+
+    warn_if(repl_mismatch, "Cache %s uses a different replacement policy "
+            "than the checkpoint; replacement state was reset.\n", name());
+    warn_if(num_relocated || num_dropped, "Cache %s: %u blocks restored to "
+            "a different location and %u blocks dropped.\n", name(),
+            num_relocated, num_dropped);
+}
+
 void
 BaseCache::serialize(CheckpointOut &cp) const
 {
     bool dirty(isDirty());
+    const bool save_data = checkpointTags && checkpointData;
 
-    if (dirty) {
+    if (dirty && !save_data) {
         warn("*** The cache still contains dirty data. ***\n");
         warn("    Make sure to drain the system using the correct flags.\n");
         warn("    This checkpoint will not restore correctly " \
              "and dirty data in the cache will be lost!\n");
     }
 
-    // Since we don't checkpoint the data in the cache, any dirty data
-    // will be lost when restoring from a checkpoint of a system that
-    // wasn't drained properly. Flag the checkpoint as invalid if the
-    // cache contains dirty data.
-    bool bad_checkpoint(dirty);
+    // Unless we checkpoint the data in the cache, any dirty data will be
+    // lost when restoring from a checkpoint of a system that wasn't
+    // drained properly. Flag the checkpoint as invalid if the cache
+    // contains dirty data that is not saved.
+    bool bad_checkpoint(dirty && !save_data);
     SERIALIZE_SCALAR(bad_checkpoint);
+
+    if (checkpointTags)
+        serializeTags(cp);
 }
 
 void
@@ -1924,8 +2168,66 @@ BaseCache::unserialize(CheckpointIn &cp)
               "supported in the classic memory system. Please remove any "
               "caches or drain them properly before taking checkpoints.\n");
     }
+
+    if (restoreTags &&
+        cp.sectionExists(Serializable::currentSection() + ".tags")) {
+        unserializeTags(cp);
+    }
 }
 
+void
+BaseCache::startup()
+{
+    // Blocks restored without their data are clean, hence memory holds
+    // an up-to-date copy of their contents
+    for (const auto &fill : pendingFills) {
+        CacheBlk *blk = tags->findBlock(fill.first, fill.second);
+        if (!blk)
+            continue;
+
+        if (!system->isMemAddr(fill.first)) {
+            invalidateBlock(blk);
+            continue;
+        }
+
+        Request::Flags flags;
+        if (fill.second)
+            flags.set(Request::SECURE);
+        RequestPtr req = makeRequest(
+            fill.first, blkSize, flags, Request::funcRequestorId);
+        Packet pkt(req, MemCmd::ReadReq);
+        pkt.dataStatic(blk->data);
+        system->getPhysMem().functionalAccess(&pkt);
+    }
+    pendingFills.clear();
+
+    if (restoredTags) {
+        announceRestoredBlocks();
+        restoredTags = false;
+    }
+}
+
+void
+BaseCache::announceRestoredBlocks()
+{
+    std::vector<uint8_t> data(blkSize);
+    tags->forEachBlk([&](CacheBlk &blk) {
+        if (!blk.isValid())
+            return;
+
+        Request::Flags flags;
+        if (blk.isSecure())
+            flags.set(Request::SECURE);
+        RequestPtr req = makeRequest(tags->regenerateBlkAddr(&blk),
+                                     blkSize, flags,
+                                     Request::funcRequestorId);
+        Packet pkt(req, MemCmd::ReadReq);
+        pkt.dataStatic(data.data());
+        pkt.setRestoredBlock();
+        pkt.setSuppressFuncError();
+        memSidePort.sendFunctional(&pkt);
+    });
+}
 
 BaseCache::CacheCmdStats::CacheCmdStats(BaseCache &c,
                                         const std::string &name)
@@ -2376,6 +2678,8 @@ BaseCache::regProbePoints()
     ppFill = new ProbePointArg<PacketPtr>(this->getProbeManager(), "Fill");
     ppDataUpdate =
         new ProbePointArg<DataUpdate>(this->getProbeManager(), "Data Update");
+    ppPktRequestCPU.reset(
+        new ProbePoints::Packet(this->getProbeManager(), "PktRequestCPU"));
 }
 
 ///////////////
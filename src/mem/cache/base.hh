@@ -49,6 +49,8 @@
 #include <cassert>
 #include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/addr_range.hh"
 #include "base/statistics.hh"
@@ -60,6 +62,7 @@
 #include "mem/cache/cache_blk.hh"
 #include "mem/cache/compressors/base.hh"
 #include "mem/cache/mshr_queue.hh"
+#include "mem/cache/prefetch/cache_accessor.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/write_queue.hh"
 #include "mem/cache/write_queue_entry.hh"
@@ -70,6 +73,7 @@
 #include "params/WriteAllocator.hh"
 #include "sim/clocked_object.hh"
 #include "sim/eventq.hh"
+#include "sim/probe/mem.hh"
 #include "sim/probe/probe.hh"
 #include "sim/serialize.hh"
 #include "sim/sim_exit.hh"
@@ -86,7 +90,7 @@ struct BaseCacheParams;
 /**
  * A basic cache interface. Implements some common functions for speed.
  */
-class BaseCache : public ClockedObject
+class BaseCache : public ClockedObject, public Prefetcher::CacheAccessor
 {
   protected:
     /**
@@ -363,6 +367,12 @@ class BaseCache : public ClockedObject
      */
     ProbePointArg<DataUpdate> *ppDataUpdate;
 
+    /**
+     * To probe the requests accepted on the CPU side, e.g. to record
+     * the access stream of the cache with a MemTraceProbe.
+     */
+    ProbePoints::PacketUPtr ppPktRequestCPU;
+
     /**
      * The writeAllocator drive optimizations for streaming writes.
      * It first determines whether a WriteReq MSHR should be delayed,
@@ -973,6 +983,30 @@ class BaseCache : public ClockedObject
      * Normally this is all possible memory addresses. */
     const AddrRangeList addrRanges;
 
+    /** Save the tag store in checkpoints. */
+    const bool checkpointTags;
+
+    /** Save the block data in checkpoints. */
+    const bool checkpointData;
+
+    /** Restore the tag store from checkpoints that contain it. */
+    const bool restoreTags;
+
+    /** Use the block data saved in checkpoints that contain it. */
+    const bool restoreData;
+
+    /**
+     * Blocks restored from a checkpoint without their data, as (address,
+     * secure) pairs. Their data is read from memory in startup().
+     */
+    std::vector<std::pair<Addr, bool>> pendingFills;
+
+    /**
+     * Set if blocks were restored from a checkpoint, and are still to
+     * be announced to the snoop filters below in startup().
+     */
+    bool restoredTags;
+
   public:
     /** System we are currently operating in. */
     System *system;
@@ -1150,7 +1184,7 @@ class BaseCache : public ClockedObject
      * @return  The block size
      */
     unsigned
-    getBlockSize() const
+    getBlockSize() const override
     {
         return blkSize;
     }
@@ -1263,11 +1297,11 @@ class BaseCache : public ClockedObject
         memSidePort.schedSendEvent(time);
     }
 
-    bool inCache(Addr addr, bool is_secure) const {
+    bool inCache(Addr addr, bool is_secure) const override {
         return tags->findBlock(addr, is_secure);
     }
 
-    bool hasBeenPrefetched(Addr addr, bool is_secure) const {
+    bool hasBeenPrefetched(Addr addr, bool is_secure) const override {
         CacheBlk *block = tags->findBlock(addr, is_secure);
         if (block) {
             return block->wasPrefetched();
@@ -1276,7 +1310,7 @@ class BaseCache : public ClockedObject
         }
     }
 
-    bool inMissQueue(Addr addr, bool is_secure) const {
+    bool inMissQueue(Addr addr, bool is_secure) const override {
         return mshrQueue.findMatch(addr, is_secure);
     }
 
@@ -1302,7 +1336,13 @@ class BaseCache : public ClockedObject
      *
      * @return True if the cache is coalescing writes
      */
-    bool coalesce() const;
+    bool coalesce() const override;
+
+    ProbeManager *
+    getProbeManager() override
+    {
+        return ClockedObject::getProbeManager();
+    }
 
 
     /**
@@ -1338,13 +1378,46 @@ class BaseCache : public ClockedObject
      */
     bool sendWriteQueuePacket(WriteQueueEntry* wq_entry);
 
+    /**
+     * Save the valid blocks of the tag store (address, coherence state and
+     * replacement data, and optionally their data) in a checkpoint.
+     */
+    void serializeTags(CheckpointOut &cp) const;
+
+    /**
+     * Restore the blocks saved by serializeTags(). Blocks are placed at
+     * their original location when it is still a valid location for their
+     * address, and allocated through the replacement policy otherwise
+     * (e.g., when the cache geometry has changed). Blocks whose data was
+     * not restored are filled from memory in startup().
+     */
+    void unserializeTags(CheckpointIn &cp);
+
+    /**
+     * Announce the blocks restored from a checkpoint towards memory,
+     * so that the snoop filters on the way record this cache as a
+     * holder, as they would have if the blocks were fetched. The
+     * announcement is a functional read flagged as a restored block,
+     * which goes all the way to memory without being satisfied or
+     * snooped on the way.
+     */
+    void announceRestoredBlocks();
+
     /**
      * Serialize the state of the caches
      *
-     * We currently don't support checkpointing cache state, so this panics.
+     * The tag store is only saved if checkpoint_tags is set. A checkpoint
+     * of a cache holding dirty data is flagged as bad, unless the block
+     * data is saved as well.
      */
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
+
+    /**
+     * Fill the blocks restored without data from memory, and make the
+     * restored blocks known to the snoop filters.
+     */
+    void startup() override;
 };
 
 /**
@@ -33,6 +33,7 @@
 #include "mem/cache/compressors/base.hh"
 
 #include <algorithm>
+#include <array>
 #include <climits>
 #include <cmath>
 #include <cstdint>
@@ -49,6 +50,64 @@ namespace Compressor {
 // Uncomment this line if debugging compression
 //#define DEBUG_COMPRESSION
 
+namespace {
+
+/** Granularity of the sizes of the blocks kept in free lists, in bytes. */
+const std::size_t blockGranularity = 16;
+
+/** Largest block kept in a free list. Larger ones go to the heap. */
+const std::size_t maxPooledBlockSize = 512;
+
+/** A released block, linking to the next free block of the same size. */
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+/** Heads of the free lists, one per multiple of the granularity. */
+thread_local std::array<FreeBlock*, maxPooledBlockSize / blockGranularity>
+    freeBlocks;
+
+std::size_t
+blockSizeClass(std::size_t size)
+{
+    return size ? (size - 1) / blockGranularity : 0;
+}
+
+} // anonymous namespace
+
+void*
+allocateBlock(std::size_t size)
+{
+    if (size > maxPooledBlockSize) {
+        return ::operator new(size);
+    }
+
+    const std::size_t size_class = blockSizeClass(size);
+    FreeBlock* const block = freeBlocks[size_class];
+    if (block == nullptr) {
+        return ::operator new((size_class + 1) * blockGranularity);
+    }
+    freeBlocks[size_class] = block->next;
+    return block;
+}
+
+void
+releaseBlock(void* ptr, std::size_t size)
+{
+    if (ptr == nullptr) {
+        return;
+    } else if (size > maxPooledBlockSize) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    const std::size_t size_class = blockSizeClass(size);
+    FreeBlock* const block = static_cast<FreeBlock*>(ptr);
+    block->next = freeBlocks[size_class];
+    freeBlocks[size_class] = block;
+}
+
 Base::CompressionData::CompressionData()
     : _size(0)
 {
@@ -58,6 +117,18 @@ Base::CompressionData::~CompressionData()
 {
 }
 
+void*
+Base::CompressionData::operator new(std::size_t size)
+{
+    return allocateBlock(size);
+}
+
+void
+Base::CompressionData::operator delete(void* ptr, std::size_t size)
+{
+    releaseBlock(ptr, size);
+}
+
 void
 Base::CompressionData::setSizeBits(std::size_t size)
 {
@@ -113,9 +184,13 @@ Base::toChunks(const uint64_t* data) const
         (sizeof(uint64_t) * CHAR_BIT) / chunkSizeBits;
 
     // Turn a 64-bit array into a chunkSizeBits-array
-    std::vector<Chunk> chunks((blkSize * CHAR_BIT) / chunkSizeBits, 0);
-    for (int i = 0; i < chunks.size(); i++) {
-        const int index_64 = std::floor(i / (double)num_chunks_per_64);
+    std::vector<Chunk> chunks((blkSize * CHAR_BIT) / chunkSizeBits);
+    if (num_chunks_per_64 == 1) {
+        std::copy(data, data + chunks.size(), chunks.begin());
+        return chunks;
+    }
+    for (unsigned i = 0; i < chunks.size(); i++) {
+        const unsigned index_64 = i / num_chunks_per_64;
         const unsigned start = i % num_chunks_per_64;
         chunks[i] = bits(data[index_64],
             (start + 1) * chunkSizeBits - 1, start * chunkSizeBits);
@@ -133,8 +208,8 @@ Base::fromChunks(const std::vector<Chunk>& chunks, uint64_t* data) const
 
     // Turn a chunkSizeBits-array into a 64-bit array
     std::memset(data, 0, blkSize);
-    for (int i = 0; i < chunks.size(); i++) {
-        const int index_64 = std::floor(i / (double)num_chunks_per_64);
+    for (unsigned i = 0; i < chunks.size(); i++) {
+        const unsigned index_64 = i / num_chunks_per_64;
         const unsigned start = i % num_chunks_per_64;
         replaceBits(data[index_64], (start + 1) * chunkSizeBits - 1,
             start * chunkSizeBits, chunks[i]);
@@ -36,6 +36,7 @@
 #ifndef __MEM_CACHE_COMPRESSORS_BASE_HH__
 #define __MEM_CACHE_COMPRESSORS_BASE_HH__
 
+#include <cstddef>
 #include <cstdint>
 
 #include "base/statistics.hh"
@@ -48,6 +49,59 @@ struct BaseCacheCompressorParams;
 
 namespace Compressor {
 
+/**
+ * Allocate a block of memory for an object that only lives while a line
+ * is compressed or while its compression data is needed, such as the
+ * compression data itself and the patterns it is made of. Compressors
+ * create and destroy several of them for every line, so released blocks
+ * are kept in per-thread free lists, one per block size, and handed out
+ * again instead of going through the heap.
+ *
+ * @param size Size of the block, in bytes.
+ * @return The block.
+ */
+void* allocateBlock(std::size_t size);
+
+/**
+ * Release a block obtained from allocateBlock().
+ *
+ * @param ptr The block.
+ * @param size Size, in bytes, the block was allocated with.
+ */
+void releaseBlock(void* ptr, std::size_t size);
+
+/**
+ * Allocator for the containers of the objects described above, which
+ * takes its storage from allocateBlock().
+ *
+ * @tparam T The type of the elements.
+ */
+template <class T>
+struct BlockAllocator
+{
+    typedef T value_type;
+
+    BlockAllocator() = default;
+    template <class U> BlockAllocator(const BlockAllocator<U>&) {}
+
+    T*
+    allocate(std::size_t n)
+    {
+        return static_cast<T*>(allocateBlock(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T* ptr, std::size_t n)
+    {
+        releaseBlock(ptr, n * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const BlockAllocator<U>&) const { return true; }
+    template <class U>
+    bool operator!=(const BlockAllocator<U>&) const { return false; }
+};
+
 /**
  * Base cache compressor interface. Every cache compressor must implement a
  * compression and a decompression method.
@@ -256,6 +310,16 @@ class Base::CompressionData
      */
     virtual ~CompressionData();
 
+    /**
+     * Compression data is created for every line that is compressed, so
+     * it is allocated with allocateBlock(). As the destructor is virtual,
+     * the size given on deletion is the one of the derived class.
+     * @{
+     */
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size);
+    /** @} */
+
     /**
      * Set compression size (in bits).
      *
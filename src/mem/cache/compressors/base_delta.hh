@@ -37,6 +37,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "base/bitfield.hh"
 #include "mem/cache/compressors/dictionary_compressor.hh"
@@ -69,6 +70,7 @@ class BaseDelta : public DictionaryCompressor<BaseType>
 
     using DictionaryEntry =
         typename DictionaryCompressor<BaseType>::DictionaryEntry;
+    using CompData = typename DictionaryCompressor<BaseType>::CompData;
 
     // Forward declaration of all possible patterns
     class PatternX;
@@ -115,6 +117,9 @@ class BaseDelta : public DictionaryCompressor<BaseType>
 
     void addToDictionary(DictionaryEntry data) override;
 
+    bool compressLine(const std::vector<Base::Chunk>& chunks,
+        CompData& comp_data) override;
+
     std::unique_ptr<Base::CompressionData> compress(
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
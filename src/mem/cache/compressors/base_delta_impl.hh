@@ -33,9 +33,13 @@
 #ifndef __MEM_CACHE_COMPRESSORS_BASE_DELTA_IMPL_HH__
 #define __MEM_CACHE_COMPRESSORS_BASE_DELTA_IMPL_HH__
 
+#include <algorithm>
+#include <type_traits>
+
 #include "debug/CacheComp.hh"
 #include "mem/cache/compressors/base_delta.hh"
 #include "mem/cache/compressors/dictionary_compressor_impl.hh"
+#include "mem/cache/compressors/simd.hh"
 
 namespace Compressor {
 
@@ -65,6 +69,67 @@ BaseDelta<BaseType, DeltaSizeBits>::addToDictionary(DictionaryEntry data)
         DictionaryCompressor<BaseType>::numEntries++] = data;
 }
 
+template <class BaseType, std::size_t DeltaSizeBits>
+bool
+BaseDelta<BaseType, DeltaSizeBits>::compressLine(
+    const std::vector<Base::Chunk>& chunks, CompData& comp_data)
+{
+    // The bases found are numbered assuming that the dictionary only
+    // holds the zero base
+    const std::size_t num_values = chunks.size();
+    if ((num_values > Simd::MaxValues) ||
+        (DictionaryCompressor<BaseType>::numEntries != 1)) {
+        return false;
+    }
+
+    BaseType values[Simd::MaxValues];
+    std::copy(chunks.begin(), chunks.end(), values);
+
+    // A value is a delta to the first base, in dictionary order, that it
+    // fits. If it fits none, it becomes a base itself. Find the values
+    // that fit each base in turn, starting with the zero base. All the
+    // values preceding the first one that fits none of the bases found
+    // so far have already been assigned, so it is the next base
+    typedef typename std::make_signed<BaseType>::type Delta;
+    const Delta limit = DeltaSizeBits ? mask(DeltaSizeBits - 1) : 0;
+    const uint64_t all_values = mask(num_values);
+    int locations[Simd::MaxValues];
+    uint64_t assigned = 0;
+    BaseType base = 0;
+    for (int location = 0; ; location++) {
+        const uint64_t fits = Simd::rangeMask<BaseType>(values, num_values,
+            base, -limit, limit) & ~assigned;
+        for (uint64_t left = fits; left != 0; left &= left - 1) {
+            locations[findLsbSet(left)] = location;
+        }
+        assigned |= fits;
+
+        const uint64_t unassigned = all_values & ~assigned;
+        if (unassigned == 0) {
+            break;
+        }
+        const int next_base = findLsbSet(unassigned);
+        locations[next_base] = -1;
+        assigned |= uint64_t(1) << next_base;
+        base = values[next_base];
+    }
+
+    for (std::size_t i = 0; i < num_values; i++) {
+        const DictionaryEntry bytes =
+            DictionaryCompressor<BaseType>::toDictionaryEntry(values[i]);
+        if (locations[i] < 0) {
+            this->addPattern(comp_data, values[i],
+                std::unique_ptr<typename DictionaryCompressor<BaseType>::
+                Pattern>(new PatternX(bytes, -1)));
+        } else {
+            this->addPattern(comp_data, values[i],
+                std::unique_ptr<typename DictionaryCompressor<BaseType>::
+                Pattern>(new PatternM(bytes, locations[i])));
+        }
+    }
+    return true;
+}
+
 template <class BaseType, std::size_t DeltaSizeBits>
 std::unique_ptr<Base::CompressionData>
 BaseDelta<BaseType, DeltaSizeBits>::compress(
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mem/cache/compressors/base_delta.hh"
+#include "mem/cache/compressors/dictionary_compressor_impl.hh"
+#include "mem/cache/compressors/fpc.hh"
+#include "mem/cache/compressors/repeated_qwords.hh"
+#include "mem/cache/compressors/zero.hh"
+#include "params/Base16Delta8.hh"
+#include "params/Base32Delta16.hh"
+#include "params/Base32Delta8.hh"
+#include "params/Base64Delta16.hh"
+#include "params/Base64Delta32.hh"
+#include "params/Base64Delta8.hh"
+#include "params/FPC.hh"
+#include "params/RepeatedQwordsCompressor.hh"
+#include "params/ZeroCompressor.hh"
+
+namespace {
+
+/** The patterns a line was compressed to */
+struct Compressed
+{
+    std::vector<int> patterns;
+    std::vector<int> locations;
+    std::vector<std::size_t> sizes;
+    std::size_t sizeBits;
+};
+
+/**
+ * Compresses lines either with the line at a time hook, or value by
+ * value as the compressors did before it existed.
+ */
+template <class C>
+class LineCompressor : public C
+{
+  public:
+    using C::C;
+
+    /**
+     * Compress a line with compressLine().
+     * @return Whether the hook handled the line.
+     */
+    bool
+    byLine(const uint64_t *line, Compressed &out)
+    {
+        this->resetDictionary();
+        auto comp_data = this->instantiateDictionaryCompData();
+        if (!this->compressLine(this->toChunks(line), *comp_data))
+            return false;
+        summarize(*comp_data, out);
+        return true;
+    }
+
+    /** Compress a line with compressValue(), one value at a time. */
+    void
+    byValue(const uint64_t *line, Compressed &out)
+    {
+        this->resetDictionary();
+        auto comp_data = this->instantiateDictionaryCompData();
+        for (const auto &chunk : this->toChunks(line))
+            comp_data->addEntry(this->compressValue(chunk));
+        summarize(*comp_data, out);
+    }
+
+  private:
+    template <class CompData>
+    static void
+    summarize(const CompData &comp_data, Compressed &out)
+    {
+        out = Compressed();
+        for (const auto &entry : comp_data.entries) {
+            out.patterns.push_back(entry->getPatternNumber());
+            out.locations.push_back(entry->getMatchLocation());
+            out.sizes.push_back(entry->getSizeBits());
+        }
+        out.sizeBits = comp_data.getSizeBits();
+    }
+};
+
+/** Parameters of a dictionary compressor of 64-byte lines */
+template <class P>
+P
+makeParams(const std::string &name, unsigned chunk_size_bits,
+           int dictionary_size)
+{
+    P p;
+    p.name = name;
+    p.eventq_index = 0;
+    p.block_size = 64;
+    p.chunk_size_bits = chunk_size_bits;
+    p.size_threshold_percentage = 50;
+    p.comp_chunks_per_cycle = 1;
+    p.comp_extra_latency = Cycles(1);
+    p.decomp_chunks_per_cycle = 1;
+    p.decomp_extra_latency = Cycles(1);
+    p.dictionary_size = dictionary_size;
+    return p;
+}
+
+/**
+ * Fill a line with one of the kinds of data the compressors look for:
+ * zeros, repeated values, values close to a base, small integers, or
+ * sparse values, with the occasional odd value. Random lines are left
+ * as they are.
+ */
+void
+fillLine(std::mt19937_64 &rng, uint64_t *line, bool structured)
+{
+    for (int i = 0; i < 8; i++)
+        line[i] = rng();
+    if (!structured)
+        return;
+
+    const uint64_t base = rng();
+    switch (rng() % 5) {
+      case 0:
+        std::memset(line, 0, 64);
+        break;
+      case 1:
+        for (int i = 0; i < 8; i++)
+            line[i] = base;
+        break;
+      case 2:
+        for (int i = 0; i < 8; i++)
+            line[i] = base + (rng() % 512) - 256;
+        break;
+      case 3:
+        for (int i = 0; i < 8; i++) {
+            const uint32_t low = rng() % 300;
+            const uint32_t high = (rng() & 1) ? -(rng() % 200) :
+                rng() % 70000;
+            line[i] = low | (uint64_t(high) << 32);
+        }
+        break;
+      default:
+        for (int i = 0; i < 8; i++)
+            line[i] = (rng() % 3) ? 0 : rng() >> (rng() % 64);
+        break;
+    }
+    if (rng() % 4 == 0)
+        line[rng() % 8] = rng() >> (rng() % 64);
+    if (rng() % 8 == 0)
+        reinterpret_cast<uint16_t*>(line)[rng() % 32] = rng();
+}
+
+/**
+ * Compress random and structured lines both ways, and check that the
+ * line at a time path gives the same patterns, in the same order and
+ * with the same sizes, as compressing the values one by one.
+ */
+template <class C, class P>
+void
+checkLines(const P &params, bool expect_random_lines)
+{
+    LineCompressor<C> compressor(params);
+    // The pattern stats are sized when registered
+    compressor.regStats();
+    std::mt19937_64 rng(0xc0de);
+    unsigned by_line[2] = {0, 0};
+    for (int n = 0; n < 20000; n++) {
+        const bool structured = n % 2;
+        uint64_t line[8];
+        fillLine(rng, line, structured);
+
+        Compressed line_result, value_result;
+        compressor.byValue(line, value_result);
+        if (!compressor.byLine(line, line_result))
+            continue;
+        by_line[structured]++;
+
+        ASSERT_EQ(value_result.patterns, line_result.patterns)
+            << "line " << n;
+        ASSERT_EQ(value_result.locations, line_result.locations)
+            << "line " << n;
+        ASSERT_EQ(value_result.sizes, line_result.sizes) << "line " << n;
+        ASSERT_EQ(value_result.sizeBits, line_result.sizeBits)
+            << "line " << n;
+    }
+
+    // Make sure the comparison covered lines of both kinds
+    EXPECT_GT(by_line[1], 1000);
+    if (expect_random_lines) {
+        EXPECT_GT(by_line[0], 1000);
+    }
+}
+
+} // anonymous namespace
+
+TEST(CompressLineTest, Base64Delta8)
+{
+    checkLines<Compressor::Base64Delta8>(
+        makeParams<Base64Delta8Params>("b64d8", 64, 64), true);
+}
+
+TEST(CompressLineTest, Base64Delta16)
+{
+    checkLines<Compressor::Base64Delta16>(
+        makeParams<Base64Delta16Params>("b64d16", 64, 64), true);
+}
+
+TEST(CompressLineTest, Base64Delta32)
+{
+    checkLines<Compressor::Base64Delta32>(
+        makeParams<Base64Delta32Params>("b64d32", 64, 64), true);
+}
+
+TEST(CompressLineTest, Base32Delta8)
+{
+    checkLines<Compressor::Base32Delta8>(
+        makeParams<Base32Delta8Params>("b32d8", 32, 64), true);
+}
+
+TEST(CompressLineTest, Base32Delta16)
+{
+    checkLines<Compressor::Base32Delta16>(
+        makeParams<Base32Delta16Params>("b32d16", 32, 64), true);
+}
+
+TEST(CompressLineTest, Base16Delta8)
+{
+    checkLines<Compressor::Base16Delta8>(
+        makeParams<Base16Delta8Params>("b16d8", 16, 64), true);
+}
+
+TEST(CompressLineTest, Zero)
+{
+    checkLines<Compressor::Zero>(
+        makeParams<ZeroCompressorParams>("zero", 64, 64), true);
+}
+
+TEST(CompressLineTest, RepeatedQwords)
+{
+    checkLines<Compressor::RepeatedQwords>(
+        makeParams<RepeatedQwordsCompressorParams>("rq", 64, 64), true);
+}
+
+TEST(CompressLineTest, FPC)
+{
+    FPCParams params = makeParams<FPCParams>("fpc", 32, 1);
+    params.zero_run_bits = 3;
+    checkLines<Compressor::FPC>(params, true);
+}
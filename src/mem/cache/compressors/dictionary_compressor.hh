@@ -44,6 +44,7 @@
 #define __MEM_CACHE_COMPRESSORS_DICTIONARY_COMPRESSOR_HH__
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -206,6 +207,37 @@ class DictionaryCompressor : public BaseDictionaryCompressor
      */
     std::unique_ptr<Pattern> compressValue(const T data);
 
+    /**
+     * Account for a value that has been compressed to the given pattern,
+     * and append the pattern to the compression data.
+     *
+     * @param comp_data The compression data of the line.
+     * @param data The value that has been compressed.
+     * @param pattern The pattern the value matches.
+     */
+    void addPattern(CompData& comp_data, const T data,
+        std::unique_ptr<Pattern> pattern);
+
+    /**
+     * Compress all the values of a line at once. Compressors whose
+     * patterns can be told apart with a few comparisons can override
+     * this to classify the whole line with vector instructions, and then
+     * instantiate the patterns directly with addPattern(). The patterns
+     * must be the very same compressValue() would have chosen for each
+     * value, in order.
+     *
+     * @param chunks The cache line to be compressed.
+     * @param comp_data The compression data to be filled.
+     * @return Whether the line was compressed. If not, the compression
+     *         data must have been left untouched, and the values are
+     *         compressed one at a time.
+     */
+    virtual bool
+    compressLine(const std::vector<Chunk>& chunks, CompData& comp_data)
+    {
+        return false;
+    }
+
     /**
      * Decompress a pattern into a value that fits in a dictionary entry.
      *
@@ -321,6 +353,25 @@ class DictionaryCompressor<T>::Pattern
     /** Default destructor. */
     virtual ~Pattern() = default;
 
+    /**
+     * Patterns are created for every value that is compressed, and even
+     * more are tried along the way, so they are allocated with
+     * allocateBlock().
+     * @{
+     */
+    static void*
+    operator new(std::size_t size)
+    {
+        return allocateBlock(size);
+    }
+
+    static void
+    operator delete(void* ptr, std::size_t size)
+    {
+        releaseBlock(ptr, size);
+    }
+    /** @} */
+
     /**
      * Get enum number associated to this pattern.
      *
@@ -389,7 +440,8 @@ class DictionaryCompressor<T>::CompData : public CompressionData
 {
   public:
     /** The patterns matched in the original line. */
-    std::vector<std::unique_ptr<Pattern>> entries;
+    std::vector<std::unique_ptr<Pattern>,
+        BlockAllocator<std::unique_ptr<Pattern>>> entries;
 
     CompData();
     ~CompData() = default;
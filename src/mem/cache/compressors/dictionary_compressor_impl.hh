@@ -121,6 +121,23 @@ DictionaryCompressor<T>::compressValue(const T data)
     return pattern;
 }
 
+template <typename T>
+void
+DictionaryCompressor<T>::addPattern(CompData& comp_data, const T data,
+    std::unique_ptr<Pattern> pattern)
+{
+    // Update stats
+    dictionaryStats.patterns[pattern->getPatternNumber()]++;
+
+    // Push into dictionary
+    if (pattern->shouldAllocate()) {
+        addToDictionary(toDictionaryEntry(data));
+    }
+
+    DPRINTF(CacheComp, "Compressed %016x to %s\n", data, pattern->print());
+    comp_data.addEntry(std::move(pattern));
+}
+
 template <class T>
 std::unique_ptr<Base::CompressionData>
 DictionaryCompressor<T>::compress(const std::vector<Chunk>& chunks)
@@ -131,8 +148,14 @@ DictionaryCompressor<T>::compress(const std::vector<Chunk>& chunks)
     // Reset dictionary
     resetDictionary();
 
-    // Compress every value sequentially
+    // Try to compress the whole line at once
     CompData* const comp_data_ptr = static_cast<CompData*>(comp_data.get());
+    comp_data_ptr->entries.reserve(chunks.size());
+    if (compressLine(chunks, *comp_data_ptr)) {
+        return comp_data;
+    }
+
+    // Compress every value sequentially
     for (const auto& value : chunks) {
         std::unique_ptr<Pattern> pattern = compressValue(value);
         DPRINTF(CacheComp, "Compressed %016x to %s\n", value,
@@ -28,7 +28,10 @@
 
 #include "mem/cache/compressors/fpc.hh"
 
+#include <algorithm>
+
 #include "mem/cache/compressors/dictionary_compressor_impl.hh"
+#include "mem/cache/compressors/simd.hh"
 #include "params/FPC.hh"
 
 namespace Compressor {
@@ -87,6 +90,66 @@ FPC::addToDictionary(const DictionaryEntry data)
     // inserts by default
 }
 
+bool
+FPC::compressLine(const std::vector<Chunk>& chunks, CompData& comp_data)
+{
+    const std::size_t num_values = chunks.size();
+    if (num_values > Simd::MaxValues) {
+        return false;
+    }
+
+    uint32_t values[Simd::MaxValues];
+    std::copy(chunks.begin(), chunks.end(), values);
+
+    // The values matching an N-bit sign extended pattern lie within a
+    // range around zero. Its lower bound is probed from the pattern, so
+    // that the range follows the pattern's own definition of a match
+    const DictionaryEntry zero_bytes = toDictionaryEntry(0);
+    auto sign_extended = [&](bool (*is_pattern)(const DictionaryEntry&,
+        const DictionaryEntry&, const int), unsigned n)
+    {
+        const int32_t lo = -(int32_t(1) << (n - 1));
+        return Simd::rangeMask<uint32_t>(values, num_values, 0,
+            is_pattern(toDictionaryEntry(lo), zero_bytes, -1) ? lo : 0,
+            (int32_t(1) << (n - 1)) - 1);
+    };
+
+    // Since there is no dictionary, a value matches the first pattern of
+    // the factory that it fits. Match the whole line against the patterns
+    // that are simple comparisons at once, and leave the values that fit
+    // none of them to the factory
+    const uint64_t zero_run = Simd::maskedEqualMask<uint32_t>(values,
+        num_values, 0xFFFFFFFF, 0);
+    const uint64_t sign_extended_4_bits =
+        sign_extended(&SignExtended4Bits::isPattern, 4);
+    const uint64_t sign_extended_1_byte =
+        sign_extended(&SignExtended1Byte::isPattern, 8);
+    const uint64_t sign_extended_halfword =
+        sign_extended(&SignExtendedHalfword::isPattern, 16);
+    const uint64_t zero_padded_halfword = Simd::maskedEqualMask<uint32_t>(
+        values, num_values, 0x0000FFFF, 0);
+
+    for (std::size_t i = 0; i < num_values; i++) {
+        const DictionaryEntry bytes = toDictionaryEntry(values[i]);
+        std::unique_ptr<Pattern> pattern;
+        if (bits(zero_run, i)) {
+            pattern.reset(new ZeroRun(bytes, -1));
+        } else if (bits(sign_extended_4_bits, i)) {
+            pattern.reset(new SignExtended4Bits(bytes, -1));
+        } else if (bits(sign_extended_1_byte, i)) {
+            pattern.reset(new SignExtended1Byte(bytes, -1));
+        } else if (bits(sign_extended_halfword, i)) {
+            pattern.reset(new SignExtendedHalfword(bytes, -1));
+        } else if (bits(zero_padded_halfword, i)) {
+            pattern.reset(new ZeroPaddedHalfword(bytes, -1));
+        } else {
+            pattern = getPattern(bytes, zero_bytes, -1);
+        }
+        addPattern(comp_data, values[i], std::move(pattern));
+    }
+    return true;
+}
+
 std::unique_ptr<DictionaryCompressor<uint32_t>::CompData>
 FPC::instantiateDictionaryCompData() const
 {
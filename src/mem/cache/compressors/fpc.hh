@@ -120,6 +120,10 @@ class FPC : public DictionaryCompressor<uint32_t>
 
     void addToDictionary(const DictionaryEntry data) override;
 
+  protected:
+    bool compressLine(const std::vector<Chunk>& chunks,
+        CompData& comp_data) override;
+
     std::unique_ptr<DictionaryCompressor::CompData>
     instantiateDictionaryCompData() const override;
 
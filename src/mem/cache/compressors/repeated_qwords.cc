@@ -36,6 +36,7 @@
 #include "base/trace.hh"
 #include "debug/CacheComp.hh"
 #include "mem/cache/compressors/dictionary_compressor_impl.hh"
+#include "mem/cache/compressors/simd.hh"
 #include "params/RepeatedQwordsCompressor.hh"
 
 namespace Compressor {
@@ -52,6 +53,32 @@ RepeatedQwords::addToDictionary(DictionaryEntry data)
     dictionary[numEntries++] = data;
 }
 
+bool
+RepeatedQwords::compressLine(const std::vector<Chunk>& chunks,
+    CompData& comp_data)
+{
+    if (chunks.empty() || (chunks.size() > Simd::MaxValues)) {
+        return false;
+    }
+
+    // The first value is added to the dictionary, and only values equal
+    // to it match. Every other value is added to the dictionary too, but
+    // the pattern can only match the first entry
+    const uint64_t repeated = Simd::maskedEqualMask<uint64_t>(chunks.data(),
+        chunks.size(), ~uint64_t(0), chunks[0]);
+    for (std::size_t i = 0; i < chunks.size(); i++) {
+        const DictionaryEntry bytes = toDictionaryEntry(chunks[i]);
+        if ((i > 0) && bits(repeated, i)) {
+            addPattern(comp_data, chunks[i],
+                std::unique_ptr<Pattern>(new PatternM(bytes, 0)));
+        } else {
+            addPattern(comp_data, chunks[i],
+                std::unique_ptr<Pattern>(new PatternX(bytes, -1)));
+        }
+    }
+    return true;
+}
+
 std::unique_ptr<Base::CompressionData>
 RepeatedQwords::compress(const std::vector<Chunk>& chunks,
     Cycles& comp_lat, Cycles& decomp_lat)
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Vectorized helpers to match all the values of a cache line against a
+ * pattern at once. They are used by the compressors whose patterns are
+ * simple comparisons to classify a whole line before instantiating its
+ * patterns, rather than trying every pattern on every value.
+ *
+ * Each helper has an AVX2 and an SSE implementation for the value types
+ * compressors use, selected by the instruction sets the simulator is
+ * compiled for (e.g., with -march=native in CCFLAGS_EXTRA), and a scalar
+ * one that works everywhere and handles the values left over by the
+ * vector loops. All implementations give the same results.
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_SIMD_HH__
+#define __MEM_CACHE_COMPRESSORS_SIMD_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace Compressor {
+namespace Simd {
+
+/** Maximum number of values described by a mask. */
+const std::size_t MaxValues = 64;
+
+/**
+ * Scalar implementation of rangeMask(), starting at a given value.
+ */
+template <class T>
+inline uint64_t
+rangeMaskScalar(const T* values, std::size_t n, T base,
+    typename std::make_signed<T>::type lo,
+    typename std::make_signed<T>::type hi, std::size_t start = 0)
+{
+    uint64_t mask = 0;
+    for (std::size_t i = start; i < n; i++) {
+        const typename std::make_signed<T>::type delta = values[i] - base;
+        if ((delta >= lo) && (delta <= hi)) {
+            mask |= uint64_t(1) << i;
+        }
+    }
+    return mask;
+}
+
+/**
+ * Find the values whose difference to a base, taken as a signed number
+ * as wide as the values, lies within the given bounds.
+ *
+ * @param values The values to match.
+ * @param n The number of values, at most MaxValues.
+ * @param base The base the differences are taken to.
+ * @param lo The lower bound of the differences, inclusive.
+ * @param hi The upper bound of the differences, inclusive.
+ * @return A mask with the i-th bit set if the i-th value matches.
+ */
+template <class T>
+inline uint64_t
+rangeMask(const T* values, std::size_t n, T base,
+    typename std::make_signed<T>::type lo,
+    typename std::make_signed<T>::type hi)
+{
+    return rangeMaskScalar(values, n, base, lo, hi);
+}
+
+/**
+ * Scalar implementation of maskedEqualMask(), starting at a given value.
+ */
+template <class T>
+inline uint64_t
+maskedEqualMaskScalar(const T* values, std::size_t n, T mask, T value,
+    std::size_t start = 0)
+{
+    uint64_t matches = 0;
+    for (std::size_t i = start; i < n; i++) {
+        if ((values[i] & mask) == value) {
+            matches |= uint64_t(1) << i;
+        }
+    }
+    return matches;
+}
+
+/**
+ * Find the values whose masked bits are equal to the given value.
+ *
+ * @param values The values to match.
+ * @param n The number of values, at most MaxValues.
+ * @param mask The mask selecting the bits to compare.
+ * @param value The value the masked bits must be equal to.
+ * @return A mask with the i-th bit set if the i-th value matches.
+ */
+template <class T>
+inline uint64_t
+maskedEqualMask(const T* values, std::size_t n, T mask, T value)
+{
+    return maskedEqualMaskScalar(values, n, mask, value);
+}
+
+#if defined(__SSE2__)
+
+template <>
+inline uint64_t
+rangeMask<uint16_t>(const uint16_t* values, std::size_t n, uint16_t base,
+    int16_t lo, int16_t hi)
+{
+    uint64_t mask = 0;
+    std::size_t i = 0;
+    const __m128i v_base = _mm_set1_epi16(base);
+    const __m128i v_lo = _mm_set1_epi16(lo);
+    const __m128i v_hi = _mm_set1_epi16(hi);
+    for (; i + 8 <= n; i += 8) {
+        const __m128i delta = _mm_sub_epi16(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(values + i)), v_base);
+        const __m128i outside = _mm_or_si128(_mm_cmplt_epi16(delta, v_lo),
+            _mm_cmpgt_epi16(delta, v_hi));
+        const uint64_t lanes =
+            _mm_movemask_epi8(_mm_packs_epi16(outside, outside)) & 0xFF;
+        mask |= (~lanes & 0xFF) << i;
+    }
+    return mask | rangeMaskScalar(values, n, base, lo, hi, i);
+}
+
+template <>
+inline uint64_t
+rangeMask<uint32_t>(const uint32_t* values, std::size_t n, uint32_t base,
+    int32_t lo, int32_t hi)
+{
+    uint64_t mask = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i v8_base = _mm256_set1_epi32(base);
+    const __m256i v8_lo = _mm256_set1_epi32(lo);
+    const __m256i v8_hi = _mm256_set1_epi32(hi);
+    for (; i + 8 <= n; i += 8) {
+        const __m256i delta = _mm256_sub_epi32(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(values + i)), v8_base);
+        const __m256i outside = _mm256_or_si256(
+            _mm256_cmpgt_epi32(v8_lo, delta),
+            _mm256_cmpgt_epi32(delta, v8_hi));
+        const uint64_t lanes =
+            _mm256_movemask_ps(_mm256_castsi256_ps(outside));
+        mask |= (~lanes & 0xFF) << i;
+    }
+#endif
+    const __m128i v_base = _mm_set1_epi32(base);
+    const __m128i v_lo = _mm_set1_epi32(lo);
+    const __m128i v_hi = _mm_set1_epi32(hi);
+    for (; i + 4 <= n; i += 4) {
+        const __m128i delta = _mm_sub_epi32(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(values + i)), v_base);
+        const __m128i outside = _mm_or_si128(_mm_cmplt_epi32(delta, v_lo),
+            _mm_cmpgt_epi32(delta, v_hi));
+        const uint64_t lanes = _mm_movemask_ps(_mm_castsi128_ps(outside));
+        mask |= (~lanes & 0xF) << i;
+    }
+    return mask | rangeMaskScalar(values, n, base, lo, hi, i);
+}
+
+template <>
+inline uint64_t
+rangeMask<uint64_t>(const uint64_t* values, std::size_t n, uint64_t base,
+    int64_t lo, int64_t hi)
+{
+    uint64_t mask = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i v_base = _mm256_set1_epi64x(base);
+    const __m256i v_lo = _mm256_set1_epi64x(lo);
+    const __m256i v_hi = _mm256_set1_epi64x(hi);
+    for (; i + 4 <= n; i += 4) {
+        const __m256i delta = _mm256_sub_epi64(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(values + i)), v_base);
+        const __m256i outside = _mm256_or_si256(
+            _mm256_cmpgt_epi64(v_lo, delta),
+            _mm256_cmpgt_epi64(delta, v_hi));
+        const uint64_t lanes =
+            _mm256_movemask_pd(_mm256_castsi256_pd(outside));
+        mask |= (~lanes & 0xF) << i;
+    }
+#elif defined(__SSE4_2__)
+    const __m128i v_base = _mm_set1_epi64x(base);
+    const __m128i v_lo = _mm_set1_epi64x(lo);
+    const __m128i v_hi = _mm_set1_epi64x(hi);
+    for (; i + 2 <= n; i += 2) {
+        const __m128i delta = _mm_sub_epi64(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(values + i)), v_base);
+        const __m128i outside = _mm_or_si128(_mm_cmpgt_epi64(v_lo, delta),
+            _mm_cmpgt_epi64(delta, v_hi));
+        const uint64_t lanes = _mm_movemask_pd(_mm_castsi128_pd(outside));
+        mask |= (~lanes & 0x3) << i;
+    }
+#endif
+    return mask | rangeMaskScalar(values, n, base, lo, hi, i);
+}
+
+template <>
+inline uint64_t
+maskedEqualMask<uint32_t>(const uint32_t* values, std::size_t n,
+    uint32_t mask, uint32_t value)
+{
+    uint64_t matches = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i v8_mask = _mm256_set1_epi32(mask);
+    const __m256i v8_value = _mm256_set1_epi32(value);
+    for (; i + 8 <= n; i += 8) {
+        const __m256i equal = _mm256_cmpeq_epi32(_mm256_and_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+            v8_mask), v8_value);
+        const uint64_t lanes = _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+        matches |= lanes << i;
+    }
+#endif
+    const __m128i v_mask = _mm_set1_epi32(mask);
+    const __m128i v_value = _mm_set1_epi32(value);
+    for (; i + 4 <= n; i += 4) {
+        const __m128i equal = _mm_cmpeq_epi32(_mm_and_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+            v_mask), v_value);
+        const uint64_t lanes = _mm_movemask_ps(_mm_castsi128_ps(equal));
+        matches |= lanes << i;
+    }
+    return matches | maskedEqualMaskScalar(values, n, mask, value, i);
+}
+
+template <>
+inline uint64_t
+maskedEqualMask<uint64_t>(const uint64_t* values, std::size_t n,
+    uint64_t mask, uint64_t value)
+{
+    uint64_t matches = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i v_mask = _mm256_set1_epi64x(mask);
+    const __m256i v_value = _mm256_set1_epi64x(value);
+    for (; i + 4 <= n; i += 4) {
+        const __m256i equal = _mm256_cmpeq_epi64(_mm256_and_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+            v_mask), v_value);
+        const uint64_t lanes = _mm256_movemask_pd(_mm256_castsi256_pd(equal));
+        matches |= lanes << i;
+    }
+#else
+    // SSE2 has no 64-bit comparison, so compare the halves of the values
+    // and require both of them to be equal
+    const __m128i v_mask = _mm_set1_epi64x(mask);
+    const __m128i v_value = _mm_set1_epi64x(value);
+    for (; i + 2 <= n; i += 2) {
+        const __m128i equal = _mm_cmpeq_epi32(_mm_and_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+            v_mask), v_value);
+        const uint64_t halves = _mm_movemask_ps(_mm_castsi128_ps(equal));
+        const uint64_t lanes = halves & (halves >> 1);
+        matches |= ((lanes & 0x1) | ((lanes >> 1) & 0x2)) << i;
+    }
+#endif
+    return matches | maskedEqualMaskScalar(values, n, mask, value, i);
+}
+
+#endif // __SSE2__
+
+} // namespace Simd
+} // namespace Compressor
+
+#endif //__MEM_CACHE_COMPRESSORS_SIMD_HH__
@@ -36,6 +36,7 @@
 #include "base/trace.hh"
 #include "debug/CacheComp.hh"
 #include "mem/cache/compressors/dictionary_compressor_impl.hh"
+#include "mem/cache/compressors/simd.hh"
 #include "params/ZeroCompressor.hh"
 
 namespace Compressor {
@@ -52,6 +53,31 @@ Zero::addToDictionary(DictionaryEntry data)
     dictionary[numEntries++] = data;
 }
 
+bool
+Zero::compressLine(const std::vector<Chunk>& chunks, CompData& comp_data)
+{
+    if (chunks.size() > Simd::MaxValues) {
+        return false;
+    }
+
+    // A value either is zero, or matches no pattern and is added to the
+    // dictionary. The dictionary never provides a better match, so there
+    // is no need to search it
+    const uint64_t zeros = Simd::maskedEqualMask<uint64_t>(chunks.data(),
+        chunks.size(), ~uint64_t(0), 0);
+    for (std::size_t i = 0; i < chunks.size(); i++) {
+        const DictionaryEntry bytes = toDictionaryEntry(chunks[i]);
+        if (bits(zeros, i)) {
+            addPattern(comp_data, chunks[i],
+                std::unique_ptr<Pattern>(new PatternZ(bytes, -1)));
+        } else {
+            addPattern(comp_data, chunks[i],
+                std::unique_ptr<Pattern>(new PatternX(bytes, -1)));
+        }
+    }
+    return true;
+}
+
 std::unique_ptr<Base::CompressionData>
 Zero::compress(const std::vector<Chunk>& chunks, Cycles& comp_lat,
     Cycles& decomp_lat)
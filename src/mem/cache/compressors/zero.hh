@@ -91,6 +91,9 @@ class Zero : public DictionaryCompressor<uint64_t>
 
     void addToDictionary(DictionaryEntry data) override;
 
+    bool compressLine(const std::vector<Chunk>& chunks,
+        CompData& comp_data) override;
+
     std::unique_ptr<Base::CompressionData> compress(
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
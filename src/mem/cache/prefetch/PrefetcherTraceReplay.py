@@ -0,0 +1,49 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.SimObject import SimObject
+from m5.params import *
+from m5.proxy import *
+
+class PrefetcherTraceReplay(SimObject):
+    type = 'PrefetcherTraceReplay'
+    cxx_class = 'Prefetcher::TraceReplay'
+    cxx_header = "mem/cache/prefetch/trace_replay.hh"
+
+    prefetcher = Param.BasePrefetcher("Prefetcher to evaluate")
+    trace_file = Param.String("Packet trace of the requests to replay")
+    max_accesses = Param.UInt64(0,
+        "Maximum number of requests to replay, 0 to replay the whole trace")
+
+    size = Param.MemorySize("1MB", "Size of the modelled cache")
+    assoc = Param.Unsigned(16, "Associativity of the modelled cache")
+    block_size = Param.Int(Parent.cache_line_size, "Block size in bytes")
+    fill_latency = Param.Latency("50ns",
+        "Time from a miss or a prefetch until its block is filled")
+
+    # The prefetcher looks this up on its parent, as it would on a cache
+    prefetch_on_access = Param.Bool(False,
+        "Notify the hardware prefetcher on every access (not just misses)")
@@ -51,13 +51,14 @@
 #include "arch/generic/tlb.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
+#include "mem/cache/prefetch/cache_accessor.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 #include "sim/byteswap.hh"
 #include "sim/clocked_object.hh"
 #include "sim/probe/probe.hh"
 
-class BaseCache;
+class System;
 struct BasePrefetcherParams;
 
 namespace Prefetcher {
@@ -256,7 +257,10 @@ class Base : public ClockedObject
     // PARAMETERS
 
     /** Pointr to the parent cache. */
-    BaseCache* cache;
+    CacheAccessor* cache;
+
+    /** System the prefetcher belongs to */
+    System *const system;
 
     /** The block size of the parent cache. */
     unsigned blkSize;
@@ -335,7 +339,7 @@ class Base : public ClockedObject
     Base(const BasePrefetcherParams &p);
     virtual ~Base() = default;
 
-    virtual void setCache(BaseCache *_cache);
+    virtual void setCache(CacheAccessor *_cache);
 
     /**
      * Notify prefetcher of cache access (may be any access or just
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the interface a prefetcher uses to look into its cache.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_CACHE_ACCESSOR_HH__
+#define __MEM_CACHE_PREFETCH_CACHE_ACCESSOR_HH__
+
+#include "base/types.hh"
+
+class ProbeManager;
+
+namespace Prefetcher {
+
+/**
+ * The view a prefetcher has of the cache it prefetches for: which blocks
+ * it holds or is fetching, and the probe points the prefetcher trains
+ * on by default. Besides BaseCache, this is implemented by models that
+ * drive a prefetcher without simulating a full cache.
+ */
+class CacheAccessor
+{
+  public:
+    virtual ~CacheAccessor() = default;
+
+    /** Block size of the cache */
+    virtual unsigned getBlockSize() const = 0;
+
+    /** Determine if a block is in the cache */
+    virtual bool inCache(Addr addr, bool is_secure) const = 0;
+
+    /** Determine if a block is in the miss queue of the cache */
+    virtual bool inMissQueue(Addr addr, bool is_secure) const = 0;
+
+    /** Determine if a block in the cache was brought in by a prefetch */
+    virtual bool hasBeenPrefetched(Addr addr, bool is_secure) const = 0;
+
+    /** Determine if the cache is coalescing writes */
+    virtual bool coalesce() const = 0;
+
+    /**
+     * Probe manager holding the Hit, Miss and Fill probe points of the
+     * cache.
+     */
+    virtual ProbeManager *getProbeManager() = 0;
+};
+
+} // namespace Prefetcher
+
+#endif //__MEM_CACHE_PREFETCH_CACHE_ACCESSOR_HH__
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_DEFERRED_QUEUE_HH__
+#define __MEM_CACHE_PREFETCH_DEFERRED_QUEUE_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+#include "base/types.hh"
+
+namespace Prefetcher {
+
+/**
+ * A queue of deferred prefetches, ordered by decreasing priority and,
+ * within a priority, from the oldest entry to the youngest. Besides
+ * the ordered index, the entries are indexed by address, so that
+ * finding a queued prefetch takes constant time, and inserting or
+ * removing one logarithmic time, regardless of the queue size.
+ * The entries stay in place while queued, as a pending translation
+ * refers to its entry.
+ *
+ * @tparam Entry The queued type. It must be copy constructible and
+ *         provide the members priority (int32_t), seq (uint64_t) and
+ *         pfInfo, with getAddr() and isSecure().
+ */
+template <class Entry>
+class DeferredQueue
+{
+  private:
+    /** Position of an entry in the queue: its priority and sequence */
+    typedef std::pair<int32_t, uint64_t> Key;
+
+    struct KeyOrder
+    {
+        bool
+        operator()(const Key& a, const Key& b) const
+        {
+            return (a.first != b.first) ? (a.first > b.first) :
+                (a.second < b.second);
+        }
+    };
+
+    /** The queued entries, from the front of the queue to its back */
+    std::map<Key, Entry*, KeyOrder> entries;
+
+    /** The queued entries, indexed by block address */
+    std::unordered_multimap<Addr, Entry*> addrIndex;
+
+    /** Sequence number to give to the next entry */
+    uint64_t nextSeq;
+
+    static Key key(const Entry& e) { return Key(e.priority, e.seq); }
+
+  public:
+    typedef typename std::map<Key, Entry*, KeyOrder>::const_iterator
+        const_iterator;
+
+    DeferredQueue() : nextSeq(0) {}
+
+    ~DeferredQueue()
+    {
+        for (auto &entry : entries) {
+            delete entry.second;
+        }
+    }
+
+    DeferredQueue(const DeferredQueue&) = delete;
+    DeferredQueue& operator=(const DeferredQueue&) = delete;
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    /** Iterate over the entries, from the front of the queue */
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+
+    /** The next entry to leave the queue */
+    Entry& front() const { return *entries.begin()->second; }
+
+    /**
+     * The entry to drop when the queue is full: the oldest of the
+     * lowest priority.
+     */
+    Entry&
+    lowestPriority() const
+    {
+        assert(!entries.empty());
+        const int32_t lowest = entries.rbegin()->first.first;
+        return *entries.lower_bound(Key(lowest, 0))->second;
+    }
+
+    /**
+     * Add a copy of an entry, behind the entries of the same priority.
+     * @param e the entry to add
+     * @return the queued copy
+     */
+    Entry&
+    push(const Entry& e)
+    {
+        Entry* const copy = new Entry(e);
+        copy->seq = nextSeq++;
+        entries.emplace(key(*copy), copy);
+        addrIndex.emplace(copy->pfInfo.getAddr(), copy);
+        return *copy;
+    }
+
+    /**
+     * Remove an entry and free it. Any resource it refers to is left
+     * to the caller.
+     * @param e the entry to remove
+     */
+    void
+    erase(Entry& e)
+    {
+        auto range = addrIndex.equal_range(e.pfInfo.getAddr());
+        for (auto it = range.first; it != range.second; it++) {
+            if (it->second == &e) {
+                addrIndex.erase(it);
+                break;
+            }
+        }
+        entries.erase(key(e));
+        delete &e;
+    }
+
+    /**
+     * Find a queued prefetch to the given block.
+     * @param addr block address of the prefetch
+     * @param is_secure whether the prefetch is to the secure space
+     * @return the entry, or nullptr if there is none
+     */
+    Entry*
+    find(Addr addr, bool is_secure) const
+    {
+        auto range = addrIndex.equal_range(addr);
+        for (auto it = range.first; it != range.second; it++) {
+            if (it->second->pfInfo.isSecure() == is_secure) {
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Raise the priority of an entry, moving it behind the entries of
+     * its new priority.
+     * @param e the entry to update
+     * @param priority the new priority
+     */
+    void
+    raisePriority(Entry& e, int32_t priority)
+    {
+        assert(e.priority < priority);
+        entries.erase(key(e));
+        e.priority = priority;
+        e.seq = nextSeq++;
+        entries.emplace(key(e), &e);
+    }
+};
+
+} // namespace Prefetcher
+
+#endif // __MEM_CACHE_PREFETCH_DEFERRED_QUEUE_HH__
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "mem/cache/prefetch/deferred_queue.hh"
+
+namespace
+{
+
+/** The minimal prefetch information the queue relies on */
+class TestInfo
+{
+  private:
+    Addr addr;
+    bool secure;
+
+  public:
+    TestInfo(Addr addr, bool secure) : addr(addr), secure(secure) {}
+
+    Addr getAddr() const { return addr; }
+    bool isSecure() const { return secure; }
+};
+
+/** A queue entry, tagged with an identifier to follow its copies */
+struct TestEntry
+{
+    TestInfo pfInfo;
+    int32_t priority;
+    uint64_t seq;
+    int id;
+
+    TestEntry(int id, Addr addr, int32_t priority, bool secure = false)
+      : pfInfo(addr, secure), priority(priority), seq(0), id(id)
+    {}
+};
+
+typedef Prefetcher::DeferredQueue<TestEntry> TestQueue;
+
+/** The identifiers of the queued entries, from the front to the back */
+std::vector<int>
+order(const TestQueue &queue)
+{
+    std::vector<int> ids;
+    for (const auto &entry : queue) {
+        ids.push_back(entry.second->id);
+    }
+    return ids;
+}
+
+} // anonymous namespace
+
+/** Entries leave by decreasing priority, and by age within a priority */
+TEST(DeferredQueueTest, PriorityThenAge)
+{
+    TestQueue queue;
+    EXPECT_TRUE(queue.empty());
+
+    queue.push(TestEntry(0, 0x000, 1));
+    queue.push(TestEntry(1, 0x040, 3));
+    queue.push(TestEntry(2, 0x080, 1));
+    queue.push(TestEntry(3, 0x0c0, 3));
+    queue.push(TestEntry(4, 0x100, 2));
+
+    EXPECT_EQ(5, queue.size());
+    EXPECT_EQ(std::vector<int>({1, 3, 4, 0, 2}), order(queue));
+    EXPECT_EQ(1, queue.front().id);
+
+    queue.erase(queue.front());
+    EXPECT_EQ(std::vector<int>({3, 4, 0, 2}), order(queue));
+}
+
+/** The entry dropped when full is the oldest of the lowest priority */
+TEST(DeferredQueueTest, LowestPriorityDrop)
+{
+    TestQueue queue;
+    queue.push(TestEntry(0, 0x000, 2));
+    queue.push(TestEntry(1, 0x040, 0));
+    queue.push(TestEntry(2, 0x080, 0));
+    queue.push(TestEntry(3, 0x0c0, 1));
+
+    EXPECT_EQ(1, queue.lowestPriority().id);
+    queue.erase(queue.lowestPriority());
+    EXPECT_EQ(2, queue.lowestPriority().id);
+    queue.erase(queue.lowestPriority());
+    EXPECT_EQ(3, queue.lowestPriority().id);
+    queue.erase(queue.lowestPriority());
+    EXPECT_EQ(0, queue.lowestPriority().id);
+    EXPECT_EQ(1, queue.size());
+
+    // A single entry is both the front and the one to drop
+    EXPECT_EQ(&queue.front(), &queue.lowestPriority());
+}
+
+/** A queued prefetch is found by block address and security */
+TEST(DeferredQueueTest, FindDuplicates)
+{
+    TestQueue queue;
+    TestEntry &non_secure = queue.push(TestEntry(0, 0x040, 0, false));
+    TestEntry &secure = queue.push(TestEntry(1, 0x040, 0, true));
+    queue.push(TestEntry(2, 0x080, 0, false));
+
+    EXPECT_EQ(&non_secure, queue.find(0x040, false));
+    EXPECT_EQ(&secure, queue.find(0x040, true));
+    EXPECT_EQ(nullptr, queue.find(0x080, true));
+    EXPECT_EQ(nullptr, queue.find(0x0c0, false));
+
+    // Erasing one entry of an address keeps the others reachable
+    queue.erase(non_secure);
+    EXPECT_EQ(nullptr, queue.find(0x040, false));
+    EXPECT_EQ(&secure, queue.find(0x040, true));
+    EXPECT_EQ(2, queue.size());
+}
+
+/** Raising a priority moves the entry behind its new peers, in place */
+TEST(DeferredQueueTest, RaisePriority)
+{
+    TestQueue queue;
+    TestEntry &low = queue.push(TestEntry(0, 0x000, 0));
+    queue.push(TestEntry(1, 0x040, 2));
+    queue.push(TestEntry(2, 0x080, 2));
+    queue.push(TestEntry(3, 0x0c0, 1));
+
+    queue.raisePriority(low, 2);
+    EXPECT_EQ(2, low.priority);
+    EXPECT_EQ(std::vector<int>({1, 2, 0, 3}), order(queue));
+    EXPECT_EQ(&low, queue.find(0x000, false));
+    EXPECT_EQ(3, queue.lowestPriority().id);
+
+    queue.raisePriority(low, 5);
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), order(queue));
+    EXPECT_EQ(&low, &queue.front());
+}
+
+/** Pushing copies the entry and gives it a fresh sequence number */
+TEST(DeferredQueueTest, PushCopies)
+{
+    TestQueue queue;
+    TestEntry entry(0, 0x000, 0);
+    TestEntry &first = queue.push(entry);
+    TestEntry &second = queue.push(entry);
+
+    EXPECT_NE(&entry, &first);
+    EXPECT_NE(&first, &second);
+    EXPECT_LT(first.seq, second.seq);
+    EXPECT_EQ(&first, &queue.front());
+
+    const TestEntry *found = queue.find(0x000, false);
+    EXPECT_TRUE(found == &first || found == &second);
+}
@@ -39,12 +39,12 @@
 #define __MEM_CACHE_PREFETCH_QUEUED_HH__
 
 #include <cstdint>
-#include <list>
 #include <utility>
 
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/cache/prefetch/base.hh"
+#include "mem/cache/prefetch/deferred_queue.hh"
 #include "mem/packet.hh"
 
 struct QueuedPrefetcherParams;
@@ -65,6 +65,11 @@ class Queued : public Base
         PacketPtr pkt;
         /** The priority of this prefetch */
         int32_t priority;
+        /**
+         * Sequence number given when the packet entered its priority
+         * level, which orders the packets of the same priority
+         */
+        uint64_t seq;
         /** Request used when a translation is needed */
         RequestPtr translationRequest;
         ThreadContext *tc;
@@ -80,23 +85,10 @@ class Queued : public Base
          */
         DeferredPacket(Queued *o, PrefetchInfo const &pfi, Tick t,
             int32_t prio) : owner(o), pfInfo(pfi), tick(t), pkt(nullptr),
-            priority(prio), translationRequest(), tc(nullptr),
+            priority(prio), seq(0), translationRequest(), tc(nullptr),
             ongoingTranslation(false) {
         }
 
-        bool operator>(const DeferredPacket& that) const
-        {
-            return priority > that.priority;
-        }
-        bool operator<(const DeferredPacket& that) const
-        {
-            return priority < that.priority;
-        }
-        bool operator<=(const DeferredPacket& that) const
-        {
-            return !(*this > that);
-        }
-
         /**
          * Create the associated memory packet
          * @param paddr physical address of this packet
@@ -133,11 +125,8 @@ class Queued : public Base
         void startTranslation(BaseTLB *tlb);
     };
 
-    std::list<DeferredPacket> pfq;
-    std::list<DeferredPacket> pfqMissingTranslation;
-
-    using const_iterator = std::list<DeferredPacket>::const_iterator;
-    using iterator = std::list<DeferredPacket>::iterator;
+    DeferredQueue<DeferredPacket> pfq;
+    DeferredQueue<DeferredPacket> pfqMissingTranslation;
 
     // PARAMETERS
 
@@ -204,7 +193,8 @@ class Queued : public Base
      * @param queue selected queue to use
      * @param dpp DeferredPacket to add
      */
-    void addToQueue(std::list<DeferredPacket> &queue, DeferredPacket &dpp);
+    void addToQueue(DeferredQueue<DeferredPacket> &queue,
+                    DeferredPacket &dpp);
 
     /**
      * Starts the translations of the queued prefetches with a
@@ -232,7 +222,7 @@ class Queued : public Base
      * @param priority priority of the prefetch request to be added
      * @return True if the prefetch request was found in the queue
      */
-    bool alreadyInQueue(std::list<DeferredPacket> &queue,
+    bool alreadyInQueue(DeferredQueue<DeferredPacket> &queue,
                         const PrefetchInfo &pfi, int32_t priority);
 
     /**
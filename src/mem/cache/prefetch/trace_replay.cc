@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/trace_replay.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/request.hh"
+#include "params/PrefetcherTraceReplay.hh"
+#include "proto/columnar_io.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+namespace Prefetcher {
+
+namespace {
+
+typedef std::chrono::steady_clock HostClock;
+
+double
+secondsSince(HostClock::time_point start)
+{
+    const std::chrono::duration<double> elapsed = HostClock::now() - start;
+    return elapsed.count();
+}
+
+} // anonymous namespace
+
+TraceReplay::TraceReplay(const PrefetcherTraceReplayParams &p)
+    : SimObject(p),
+      prefetcher(p.prefetcher),
+      traceFile(p.trace_file),
+      blkSize(p.block_size),
+      assoc(p.assoc),
+      numSets(p.size / (p.block_size * p.assoc)),
+      fillLatency(p.fill_latency),
+      maxAccesses(p.max_accesses),
+      entries(),
+      touchCount(0),
+      haveRecord(false),
+      firstRecordTick(0),
+      startTick(0),
+      numRecords(0),
+      replayEvent([this]{ replay(); }, name()),
+      stats(this)
+{
+    fatal_if(!isPowerOf2(blkSize), "%s: block size must be a power of 2.",
+             name());
+    fatal_if(numSets == 0 || !isPowerOf2(numSets) ||
+             numSets * blkSize * assoc != p.size,
+             "%s: the cache must have a power of 2 number of sets.", name());
+
+    entries.resize(numSets * assoc, Entry{0, false, false, false, 0, 0});
+
+    prefetcher->setCache(this);
+}
+
+TraceReplay::~TraceReplay()
+{
+    for (auto &fill : pendingFills)
+        delete fill.pkt;
+}
+
+void
+TraceReplay::regProbePoints()
+{
+    ppHit.reset(new ProbePointArg<PacketPtr>(getProbeManager(), "Hit"));
+    ppMiss.reset(new ProbePointArg<PacketPtr>(getProbeManager(), "Miss"));
+    ppFill.reset(new ProbePointArg<PacketPtr>(getProbeManager(), "Fill"));
+}
+
+void
+TraceReplay::startup()
+{
+    trace.reset(openTraceInputStream(traceFile));
+
+    ProtoMessage::PacketHeader header_msg;
+    fatal_if(!trace->read(header_msg),
+             "Failed to read the header of packet trace %s.\n", traceFile);
+    fatal_if(header_msg.tick_freq() != SimClock::Frequency,
+             "Packet trace %s was recorded with a different tick "
+             "frequency %d.\n", traceFile, header_msg.tick_freq());
+
+    if (readRecord()) {
+        firstRecordTick = record.tick();
+        startTick = curTick();
+        schedule(replayEvent, curTick());
+    } else {
+        exitSimLoop("prefetcher trace replay complete");
+    }
+}
+
+TraceReplay::Entry *
+TraceReplay::findEntry(Addr blk_addr, bool is_secure) const
+{
+    const size_t set = (blk_addr / blkSize) & (numSets - 1);
+    const Entry *entry = &entries[set * assoc];
+    for (unsigned way = 0; way < assoc; ++way, ++entry) {
+        if (entry->valid && entry->blkAddr == blk_addr &&
+            entry->secure == is_secure) {
+            return const_cast<Entry *>(entry);
+        }
+    }
+    return nullptr;
+}
+
+TraceReplay::Entry &
+TraceReplay::allocate(Addr blk_addr, bool is_secure, bool prefetched)
+{
+    const size_t set = (blk_addr / blkSize) & (numSets - 1);
+    Entry *victim = nullptr;
+    for (unsigned way = 0; way < assoc; ++way) {
+        Entry &entry = entries[set * assoc + way];
+        if (!entry.valid) {
+            victim = &entry;
+            break;
+        }
+        if (!victim || entry.lastTouch < victim->lastTouch)
+            victim = &entry;
+    }
+
+    if (victim->valid && victim->prefetched)
+        ++stats.pfUnused;
+
+    victim->blkAddr = blk_addr;
+    victim->valid = true;
+    victim->secure = is_secure;
+    victim->prefetched = prefetched;
+    victim->fillTick = curTick() + fillLatency;
+    victim->lastTouch = ++touchCount;
+    return *victim;
+}
+
+bool
+TraceReplay::inCache(Addr addr, bool is_secure) const
+{
+    const Entry *entry = findEntry(addr & ~Addr(blkSize - 1), is_secure);
+    return entry && entry->fillTick <= curTick();
+}
+
+bool
+TraceReplay::inMissQueue(Addr addr, bool is_secure) const
+{
+    const Entry *entry = findEntry(addr & ~Addr(blkSize - 1), is_secure);
+    return entry && entry->fillTick > curTick();
+}
+
+bool
+TraceReplay::hasBeenPrefetched(Addr addr, bool is_secure) const
+{
+    const Entry *entry = findEntry(addr & ~Addr(blkSize - 1), is_secure);
+    return entry && entry->fillTick <= curTick() && entry->prefetched;
+}
+
+Tick
+TraceReplay::recordTick() const
+{
+    // Requests recorded out of order are replayed right away
+    return startTick + (record.tick() > firstRecordTick ?
+                        record.tick() - firstRecordTick : 0);
+}
+
+bool
+TraceReplay::readRecord()
+{
+    while (!maxAccesses || numRecords < maxAccesses) {
+        if (!trace->read(record)) {
+            haveRecord = false;
+            return false;
+        }
+
+        // Only replay the requests that look up and allocate blocks
+        const MemCmd cmd(record.cmd());
+        const Request::Flags flags(record.flags());
+        if (cmd.isRequest() && (cmd.isRead() || cmd.isWrite()) &&
+            !cmd.isEviction() && !flags.isSet(Request::UNCACHEABLE)) {
+            ++numRecords;
+            haveRecord = true;
+            return true;
+        }
+    }
+    haveRecord = false;
+    return false;
+}
+
+void
+TraceReplay::access()
+{
+    RequestPtr req = makeRequest(record.addr(), record.size(),
+                                 record.flags(), record.pkt_id());
+    if (record.has_pc())
+        req->setPC(record.pc());
+
+    PacketPtr pkt = new Packet(req, MemCmd(record.cmd()));
+    pkt->allocate();
+    std::memset(pkt->getPtr<uint8_t>(), 0, pkt->getSize());
+
+    const Addr blk_addr = pkt->getAddr() & ~Addr(blkSize - 1);
+    const bool is_secure = pkt->isSecure();
+    ++stats.accesses;
+
+    Entry *entry = findEntry(blk_addr, is_secure);
+    const auto start = HostClock::now();
+    if (entry && entry->fillTick <= curTick()) {
+        // Like the cache, notify a hit before clearing the prefetch
+        // mark, for the prefetcher to see the prefetch was useful
+        ppHit->notify(pkt);
+        stats.prefetcherSeconds += secondsSince(start);
+
+        if (entry->prefetched) {
+            ++stats.pfUseful;
+            entry->prefetched = false;
+        }
+        entry->lastTouch = ++touchCount;
+        delete pkt;
+    } else if (entry) {
+        // The block is in the miss queue
+        if (entry->prefetched) {
+            ++stats.pfLate;
+            entry->prefetched = false;
+        }
+        entry->lastTouch = ++touchCount;
+
+        ppMiss->notify(pkt);
+        stats.prefetcherSeconds += secondsSince(start);
+        delete pkt;
+    } else {
+        // Like the cache, allocate the miss before notifying it, so
+        // that the block is in the miss queue
+        ++stats.misses;
+        allocate(blk_addr, is_secure, false);
+        pendingFills.push_back({curTick() + fillLatency, pkt});
+
+        ppMiss->notify(pkt);
+        stats.prefetcherSeconds += secondsSince(start);
+    }
+}
+
+void
+TraceReplay::issuePrefetches()
+{
+    const auto start = HostClock::now();
+    while (prefetcher->nextPrefetchReadyTime() <= curTick()) {
+        PacketPtr pkt = prefetcher->getPacket();
+        if (!pkt)
+            break;
+
+        const Addr blk_addr = pkt->getAddr() & ~Addr(blkSize - 1);
+        if (findEntry(blk_addr, pkt->isSecure())) {
+            DPRINTF(HWPrefetch, "Replay dropping redundant prefetch "
+                    "addr:%#x\n", blk_addr);
+            ++stats.pfRedundant;
+            delete pkt;
+        } else {
+            ++stats.pfIssued;
+            allocate(blk_addr, pkt->isSecure(), true);
+            pendingFills.push_back({curTick() + fillLatency, pkt});
+        }
+    }
+    stats.prefetcherSeconds += secondsSince(start);
+}
+
+void
+TraceReplay::completeFills()
+{
+    while (!pendingFills.empty() && pendingFills.front().tick <= curTick()) {
+        PacketPtr pkt = pendingFills.front().pkt;
+        pendingFills.pop_front();
+
+        const auto start = HostClock::now();
+        ppFill->notify(pkt);
+        stats.prefetcherSeconds += secondsSince(start);
+        delete pkt;
+    }
+}
+
+void
+TraceReplay::replay()
+{
+    const auto start = HostClock::now();
+
+    completeFills();
+    while (haveRecord && recordTick() <= curTick()) {
+        access();
+        readRecord();
+    }
+    issuePrefetches();
+
+    if (!haveRecord) {
+        stats.hostSeconds += secondsSince(start);
+        exitSimLoop("prefetcher trace replay complete");
+        return;
+    }
+
+    // Replay again once the next request, fill or prefetch is due
+    Tick next = recordTick();
+    if (!pendingFills.empty())
+        next = std::min(next, pendingFills.front().tick);
+    next = std::min(next, prefetcher->nextPrefetchReadyTime());
+    schedule(replayEvent, std::max(next, curTick() + 1));
+
+    stats.hostSeconds += secondsSince(start);
+}
+
+TraceReplay::TraceReplayStats::TraceReplayStats(Stats::Group *parent)
+    : Stats::Group(parent),
+      ADD_STAT(accesses, UNIT_COUNT, "Number of requests replayed"),
+      ADD_STAT(misses, UNIT_COUNT,
+               "Number of requests to blocks neither cached nor being "
+               "filled"),
+      ADD_STAT(pfIssued, UNIT_COUNT,
+               "Number of prefetches that brought in a block"),
+      ADD_STAT(pfRedundant, UNIT_COUNT,
+               "Number of prefetches to blocks cached or being filled"),
+      ADD_STAT(pfUseful, UNIT_COUNT,
+               "Number of prefetched blocks first accessed after their "
+               "fill"),
+      ADD_STAT(pfLate, UNIT_COUNT,
+               "Number of prefetched blocks first accessed while being "
+               "filled"),
+      ADD_STAT(pfUnused, UNIT_COUNT,
+               "Number of prefetched blocks evicted without being "
+               "accessed"),
+      ADD_STAT(accuracy, UNIT_RATIO,
+               "Fraction of the prefetched blocks that were accessed",
+               (pfUseful + pfLate) / pfIssued),
+      ADD_STAT(coverage, UNIT_RATIO,
+               "Fraction of the misses started by a prefetch",
+               (pfUseful + pfLate) / (pfUseful + pfLate + misses)),
+      ADD_STAT(timeliness, UNIT_RATIO,
+               "Fraction of the accessed prefetches filled in time",
+               pfUseful / (pfUseful + pfLate)),
+      ADD_STAT(hostSeconds, UNIT_SECOND,
+               "Host time spent replaying the trace"),
+      ADD_STAT(prefetcherSeconds, UNIT_SECOND,
+               "Host time spent in the prefetcher"),
+      ADD_STAT(prefetcherSecondsPerAccess,
+               UNIT_RATE(Stats::Units::Second, Stats::Units::Count),
+               "Host time spent in the prefetcher per request",
+               prefetcherSeconds / accesses)
+{
+    accuracy.precision(4);
+    coverage.precision(4);
+    timeliness.precision(4);
+    prefetcherSecondsPerAccess.precision(12);
+}
+
+} // namespace Prefetcher
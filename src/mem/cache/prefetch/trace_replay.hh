@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a harness that evaluates a prefetcher on a trace of
+ * cache accesses, without simulating the cache or the memory system.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_TRACE_REPLAY_HH__
+#define __MEM_CACHE_PREFETCH_TRACE_REPLAY_HH__
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/base.hh"
+#include "mem/cache/prefetch/cache_accessor.hh"
+#include "mem/packet.hh"
+#include "proto/packet.pb.h"
+#include "proto/protoio.hh"
+#include "sim/eventq.hh"
+#include "sim/probe/probe.hh"
+#include "sim/sim_object.hh"
+
+struct PrefetcherTraceReplayParams;
+
+namespace Prefetcher {
+
+/**
+ * The TraceReplay feeds a trace of the requests a cache accepted, as
+ * recorded by a MemTraceProbe on the PktRequestCPU probe point of the
+ * cache, to a prefetcher. It stands in for the cache with a model that
+ * only keeps the tags of a set associative, LRU cache, and exposes the
+ * same Hit, Miss and Fill probe points, so that any prefetcher trains
+ * on the replay the way it would on a cache.
+ *
+ * The requests are replayed at the ticks they were recorded at. Every
+ * miss and every prefetch fills its block after a fixed latency, and
+ * until then the block is in the miss queue. Prefetches are issued as
+ * soon as the prefetcher has them ready, without modelling bandwidth.
+ * The replay exits the simulation loop once the trace is exhausted,
+ * reporting the accuracy, coverage and timeliness of the prefetches,
+ * and the host time the prefetcher took per access.
+ *
+ * The trace holds no data, so prefetchers that look at the values
+ * loaded, such as the IndirectMemory prefetcher, see zeroes.
+ */
+class TraceReplay : public SimObject, public CacheAccessor
+{
+  public:
+    TraceReplay(const PrefetcherTraceReplayParams &p);
+    ~TraceReplay();
+
+    void regProbePoints() override;
+
+    /** Open the trace and schedule the replay. */
+    void startup() override;
+
+    /** @{ */
+    /** The view the prefetcher has of the modelled cache */
+    unsigned getBlockSize() const override { return blkSize; }
+    bool inCache(Addr addr, bool is_secure) const override;
+    bool inMissQueue(Addr addr, bool is_secure) const override;
+    bool hasBeenPrefetched(Addr addr, bool is_secure) const override;
+    bool coalesce() const override { return false; }
+
+    ProbeManager *
+    getProbeManager() override
+    {
+        return SimObject::getProbeManager();
+    }
+    /** @} */
+
+  private:
+    /** Tag of a block of the modelled cache */
+    struct Entry
+    {
+        Addr blkAddr;
+        bool valid;
+        bool secure;
+        /** Brought in by a prefetch and not accessed since */
+        bool prefetched;
+        /** Tick at which the block is filled */
+        Tick fillTick;
+        /** Last access, for LRU replacement */
+        uint64_t lastTouch;
+    };
+
+    /** A block being filled */
+    struct PendingFill
+    {
+        Tick tick;
+        PacketPtr pkt;
+    };
+
+    /** Find the entry of a block, filled or not. */
+    Entry *findEntry(Addr blk_addr, bool is_secure) const;
+
+    /** Allocate an entry for a block, evicting the LRU block. */
+    Entry &allocate(Addr blk_addr, bool is_secure, bool prefetched);
+
+    /** Tick at which to replay the request read from the trace */
+    Tick recordTick() const;
+
+    /**
+     * Read the next request to replay from the trace.
+     * @return False if the trace is exhausted
+     */
+    bool readRecord();
+
+    /** Replay the request read from the trace. */
+    void access();
+
+    /** Issue the prefetches that are ready. */
+    void issuePrefetches();
+
+    /** Notify the fills that completed. */
+    void completeFills();
+
+    /**
+     * Replay the requests and fills that are due and schedule the next
+     * replay, or exit the simulation loop at the end of the trace.
+     */
+    void replay();
+
+    /** Prefetcher under evaluation */
+    Base *const prefetcher;
+
+    /** Path of the trace to replay */
+    const std::string traceFile;
+
+    /** Block size of the modelled cache */
+    const unsigned blkSize;
+
+    /** Associativity of the modelled cache */
+    const unsigned assoc;
+
+    /** Number of sets of the modelled cache */
+    const unsigned numSets;
+
+    /** Time from a miss or prefetch until its block is filled */
+    const Tick fillLatency;
+
+    /** Maximum number of requests to replay, or zero for all */
+    const uint64_t maxAccesses;
+
+    /** Tags of the modelled cache, set by set */
+    std::vector<Entry> entries;
+
+    /** Counter giving the order of the accesses to the blocks */
+    uint64_t touchCount;
+
+    /** Blocks being filled, in the order the fills complete */
+    std::deque<PendingFill> pendingFills;
+
+    /** Trace being replayed */
+    std::unique_ptr<TraceInputStream> trace;
+
+    /** Next request to replay */
+    ProtoMessage::Packet record;
+
+    /** Whether record holds a request yet to be replayed */
+    bool haveRecord;
+
+    /** Tick of the first request of the trace */
+    Tick firstRecordTick;
+
+    /** Tick the replay started at */
+    Tick startTick;
+
+    /** Number of requests read from the trace */
+    uint64_t numRecords;
+
+    /** @{ */
+    /** Probe points the prefetcher listens to */
+    std::unique_ptr<ProbePointArg<PacketPtr>> ppHit;
+    std::unique_ptr<ProbePointArg<PacketPtr>> ppMiss;
+    std::unique_ptr<ProbePointArg<PacketPtr>> ppFill;
+    /** @} */
+
+    /** Event running the replay */
+    EventFunctionWrapper replayEvent;
+
+    struct TraceReplayStats : public Stats::Group
+    {
+        TraceReplayStats(Stats::Group *parent);
+
+        /** Demand requests replayed */
+        Stats::Scalar accesses;
+        /** Demand requests to blocks neither cached nor being filled */
+        Stats::Scalar misses;
+        /** Prefetches that brought in a block */
+        Stats::Scalar pfIssued;
+        /** Prefetches to blocks that were cached or being filled */
+        Stats::Scalar pfRedundant;
+        /** Prefetched blocks first accessed after their fill */
+        Stats::Scalar pfUseful;
+        /** Prefetched blocks first accessed while being filled */
+        Stats::Scalar pfLate;
+        /** Prefetched blocks evicted without being accessed */
+        Stats::Scalar pfUnused;
+        /** Fraction of the prefetched blocks that were accessed */
+        Stats::Formula accuracy;
+        /** Fraction of the misses that a prefetch started */
+        Stats::Formula coverage;
+        /** Fraction of the accessed prefetches that were filled in time */
+        Stats::Formula timeliness;
+        /** Host time spent replaying the trace */
+        Stats::Scalar hostSeconds;
+        /** Host time spent in the prefetcher */
+        Stats::Scalar prefetcherSeconds;
+        /** Host time spent in the prefetcher per access */
+        Stats::Formula prefetcherSecondsPerAccess;
+    } stats;
+};
+
+} // namespace Prefetcher
+
+#endif //__MEM_CACHE_PREFETCH_TRACE_REPLAY_HH__
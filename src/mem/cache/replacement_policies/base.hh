@@ -29,8 +29,11 @@
 #ifndef __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 #define __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
+#include "base/logging.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "params/BaseReplacementPolicy.hh"
 #include "sim/sim_object.hh"
@@ -47,9 +50,30 @@ namespace ReplacementPolicy {
  */
 class Base : public SimObject
 {
+  protected:
+    /**
+     * Geometry of the table whose replacement data the policy keeps, if
+     * any. @sa instantiateTable()
+     */
+    uint32_t tableSets;
+    uint32_t tableWays;
+
+    /**
+     * Get the position of an entry of the table in the policy's arrays.
+     *
+     * @param set The set of the entry.
+     * @param way The way of the entry.
+     * @return The index of the entry's replacement data.
+     */
+    size_t
+    tableIndex(uint32_t set, uint32_t way) const
+    {
+        return size_t(set) * tableWays + way;
+    }
+
   public:
     typedef BaseReplacementPolicyParams Params;
-    Base(const Params &p) : SimObject(p) {}
+    Base(const Params &p) : SimObject(p), tableSets(0), tableWays(0) {}
     virtual ~Base() = default;
 
     /**
@@ -91,6 +115,124 @@ class Base : public SimObject
      * @return A shared pointer to the new replacement data.
      */
     virtual std::shared_ptr<ReplacementData> instantiateEntry() = 0;
+
+    /**
+     * Flatten the replacement data of an entry so that it can be stored in
+     * a checkpoint. Policies that keep no per-entry state, or whose state
+     * is shared between entries, leave the state empty; their entries are
+     * simply reset when restored.
+     *
+     * @param replacement_data Replacement data to be saved.
+     * @param state Flattened replacement data.
+     */
+    virtual void
+    saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+              std::vector<uint64_t> &state) const
+    {
+        state.clear();
+    }
+
+    /**
+     * Restore the replacement data of an entry from its flattened form.
+     *
+     * @param replacement_data Replacement data to be restored.
+     * @param state Flattened replacement data, as produced by saveState().
+     * @return True if the state could be applied to the entry.
+     */
+    virtual bool
+    restoreState(const std::shared_ptr<ReplacementData>& replacement_data,
+                 const std::vector<uint64_t> &state) const
+    {
+        return state.empty();
+    }
+
+    /**
+     * @name Replacement data kept by the policy
+     * Instead of instantiating a replacement data entry per replaceable
+     * entry, the owner of a table whose sets are contiguous may let the
+     * policy keep the replacement data of the whole table, in arrays
+     * indexed by set and way. The entries are then referred to by their
+     * position, which saves the pointer and the heap object of every
+     * entry, and lets the victim be chosen in a single pass over the
+     * replacement data of a set.
+     * @{
+     */
+
+    /**
+     * Whether the policy can keep the replacement data of a table.
+     */
+    virtual bool hasTableSupport() const { return false; }
+
+    /**
+     * Instantiate the replacement data of a table. A policy keeps the
+     * data of a single table, and all its entries are invalid at first.
+     *
+     * @param num_sets The number of sets of the table.
+     * @param num_ways The number of ways of each set.
+     */
+    virtual void
+    instantiateTable(uint32_t num_sets, uint32_t num_ways)
+    {
+        panic_if(!hasTableSupport(), "%s cannot keep the replacement data "
+                 "of a table", name());
+        fatal_if(tableWays, "%s already keeps the replacement data of a "
+                 "table", name());
+        tableSets = num_sets;
+        tableWays = num_ways;
+    }
+
+    /**
+     * Invalidate, touch or reset the replacement data of an entry of the
+     * table, as invalidate(), touch() and reset() do.
+     *
+     * @param set The set of the entry.
+     * @param way The way of the entry.
+     */
+    virtual void
+    invalidateWay(uint32_t set, uint32_t way)
+    {
+        panic("%s cannot keep the replacement data of a table", name());
+    }
+    virtual void
+    touchWay(uint32_t set, uint32_t way)
+    {
+        panic("%s cannot keep the replacement data of a table", name());
+    }
+    virtual void
+    resetWay(uint32_t set, uint32_t way)
+    {
+        panic("%s cannot keep the replacement data of a table", name());
+    }
+
+    /**
+     * Find the replacement victim among all ways of a set of the table.
+     *
+     * @param set The set to find a victim in.
+     * @return The way of the victim.
+     */
+    virtual uint32_t
+    getVictimWay(uint32_t set)
+    {
+        panic("%s cannot keep the replacement data of a table", name());
+    }
+
+    /**
+     * Flatten and restore the replacement data of an entry of the table,
+     * as saveState() and restoreState() do.
+     */
+    virtual void
+    saveWayState(uint32_t set, uint32_t way,
+                 std::vector<uint64_t> &state) const
+    {
+        state.clear();
+    }
+    virtual bool
+    restoreWayState(uint32_t set, uint32_t way,
+                    const std::vector<uint64_t> &state)
+    {
+        return state.empty();
+    }
+    /** @} */
 };
 
 } // namespace ReplacementPolicy
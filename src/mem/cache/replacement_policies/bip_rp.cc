@@ -56,4 +56,15 @@ BIP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
     }
 }
 
+void
+BIP::resetWay(uint32_t set, uint32_t way)
+{
+    // Entries are inserted as MRU if lower than btp, LRU otherwise
+    if (random_mt.random<unsigned>(1, 100) <= btp) {
+        lastTouchTicks[tableIndex(set, way)] = curTick();
+    } else {
+        lastTouchTicks[tableIndex(set, way)] = 1;
+    }
+}
+
 } // namespace ReplacementPolicy
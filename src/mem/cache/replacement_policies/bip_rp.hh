@@ -71,6 +71,9 @@ class BIP : public LRU
      */
     void reset(const std::shared_ptr<ReplacementData>& replacement_data) const
                                                                      override;
+
+    /** Same as reset(), for an entry whose data is kept by the policy. */
+    void resetWay(uint32_t set, uint32_t way) override;
 };
 
 } // namespace ReplacementPolicy
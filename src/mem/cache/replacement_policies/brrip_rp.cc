@@ -28,6 +28,7 @@
 
 #include "mem/cache/replacement_policies/brrip_rp.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
@@ -37,9 +38,11 @@
 
 namespace ReplacementPolicy {
 
+const uint8_t BRRIP::invalidRRPV;
+
 BRRIP::BRRIP(const Params &p)
   : Base(p), numRRPVBits(p.num_bits), hitPriority(p.hit_priority),
-    btp(p.btp)
+    btp(p.btp), maxRRPV((1 << numRRPVBits) - 1)
 {
     fatal_if(numRRPVBits <= 0, "There should be at least one bit per RRPV.\n");
 }
@@ -144,4 +147,117 @@ BRRIP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new BRRIPReplData(numRRPVBits));
 }
 
+void
+BRRIP::saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+                 std::vector<uint64_t> &state) const
+{
+    const auto data =
+        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    state = { uint64_t(uint8_t(data->rrpv)), uint64_t(data->valid) };
+}
+
+bool
+BRRIP::restoreState(const std::shared_ptr<ReplacementData>& replacement_data,
+                    const std::vector<uint64_t> &state) const
+{
+    if (state.size() != 2)
+        return false;
+    auto data = std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    data->rrpv.reset();
+    data->rrpv += state[0];
+    data->valid = state[1];
+    return true;
+}
+
+void
+BRRIP::instantiateTable(uint32_t num_sets, uint32_t num_ways)
+{
+    Base::instantiateTable(num_sets, num_ways);
+    rrpvs.assign(size_t(num_sets) * num_ways, invalidRRPV);
+}
+
+void
+BRRIP::invalidateWay(uint32_t set, uint32_t way)
+{
+    rrpvs[tableIndex(set, way)] = invalidRRPV;
+}
+
+void
+BRRIP::touchWay(uint32_t set, uint32_t way)
+{
+    uint8_t &rrpv = rrpvs[tableIndex(set, way)];
+    assert(rrpv != invalidRRPV);
+
+    // Update RRPV if not 0 yet
+    // Every hit in HP mode makes the entry the last to be evicted, while
+    // in FP mode a hit makes the entry less likely to be evicted
+    if (hitPriority) {
+        rrpv = 0;
+    } else if (rrpv > 0) {
+        rrpv--;
+    }
+}
+
+void
+BRRIP::resetWay(uint32_t set, uint32_t way)
+{
+    // Replacement data is inserted as "long re-reference" if lower than btp,
+    // "distant re-reference" otherwise
+    uint8_t &rrpv = rrpvs[tableIndex(set, way)];
+    rrpv = maxRRPV;
+    if (random_mt.random<unsigned>(1, 100) <= btp) {
+        rrpv--;
+    }
+}
+
+uint32_t
+BRRIP::getVictimWay(uint32_t set)
+{
+    uint8_t *set_rrpvs = &rrpvs[tableIndex(set, 0)];
+
+    // Visit all ways of the set to find victim
+    uint32_t victim = 0;
+    for (uint32_t way = 0; way < tableWays; way++) {
+        // Stop searching for victims if an invalid entry is found
+        if (set_rrpvs[way] == invalidRRPV) {
+            return way;
+        }
+        if (set_rrpvs[way] > set_rrpvs[victim]) {
+            victim = way;
+        }
+    }
+
+    // Age all entries of the set so that the victim has the highest
+    // possible RRPV; none of them can exceed it, as the victim has the
+    // highest RRPV of the set
+    const uint8_t diff = maxRRPV - set_rrpvs[victim];
+    if (diff > 0) {
+        for (uint32_t way = 0; way < tableWays; way++) {
+            set_rrpvs[way] += diff;
+        }
+    }
+
+    return victim;
+}
+
+void
+BRRIP::saveWayState(uint32_t set, uint32_t way,
+                    std::vector<uint64_t> &state) const
+{
+    const uint8_t rrpv = rrpvs[tableIndex(set, way)];
+    const bool valid = rrpv != invalidRRPV;
+    state = { uint64_t(valid ? rrpv : maxRRPV), uint64_t(valid) };
+}
+
+bool
+BRRIP::restoreWayState(uint32_t set, uint32_t way,
+                       const std::vector<uint64_t> &state)
+{
+    if (state.size() != 2)
+        return false;
+    rrpvs[tableIndex(set, way)] = state[1] ?
+        uint8_t(std::min<uint64_t>(state[0], maxRRPV)) : invalidRRPV;
+    return true;
+}
+
 } // namespace ReplacementPolicy
@@ -153,6 +153,44 @@ class BRRIP : public Base
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    /** Saves the re-reference prediction value and validity of the entry. */
+    void saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+                   std::vector<uint64_t> &state) const override;
+    bool restoreState(
+        const std::shared_ptr<ReplacementData>& replacement_data,
+        const std::vector<uint64_t> &state) const override;
+
+    /**
+     * @name Replacement data kept by the policy
+     * The RRPV and validity of every entry are kept in a single array,
+     * which leaves no room for RRPVs of 8 bits.
+     * @{
+     */
+    bool hasTableSupport() const override { return numRRPVBits < 8; }
+    void instantiateTable(uint32_t num_sets, uint32_t num_ways) override;
+    void invalidateWay(uint32_t set, uint32_t way) override;
+    void touchWay(uint32_t set, uint32_t way) override;
+    void resetWay(uint32_t set, uint32_t way) override;
+    uint32_t getVictimWay(uint32_t set) override;
+    void saveWayState(uint32_t set, uint32_t way,
+                      std::vector<uint64_t> &state) const override;
+    bool restoreWayState(uint32_t set, uint32_t way,
+                         const std::vector<uint64_t> &state) override;
+    /** @} */
+
+  protected:
+    /**
+     * Re-reference prediction value of each entry of the table, or
+     * invalidRRPV if the entry is invalid.
+     */
+    std::vector<uint8_t> rrpvs;
+
+    /** Marker of an invalid entry, above any valid RRPV. */
+    static const uint8_t invalidRRPV = 0xff;
+
+    /** The highest valid RRPV. */
+    const uint8_t maxRRPV;
 };
 
 } // namespace ReplacementPolicy
@@ -91,4 +91,79 @@ FIFO::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new FIFOReplData());
 }
 
+void
+FIFO::saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+                std::vector<uint64_t> &state) const
+{
+    const auto data = std::static_pointer_cast<FIFOReplData>(replacement_data);
+    state = { uint64_t(data->tickInserted) };
+}
+
+bool
+FIFO::restoreState(const std::shared_ptr<ReplacementData>& replacement_data,
+                   const std::vector<uint64_t> &state) const
+{
+    if (state.size() != 1)
+        return false;
+    auto data = std::static_pointer_cast<FIFOReplData>(replacement_data);
+    data->tickInserted = state[0];
+    return true;
+}
+
+void
+FIFO::instantiateTable(uint32_t num_sets, uint32_t num_ways)
+{
+    Base::instantiateTable(num_sets, num_ways);
+    insertionTicks.assign(size_t(num_sets) * num_ways, Tick(0));
+}
+
+void
+FIFO::invalidateWay(uint32_t set, uint32_t way)
+{
+    insertionTicks[tableIndex(set, way)] = Tick(0);
+}
+
+void
+FIFO::touchWay(uint32_t set, uint32_t way)
+{
+    // A touch does not modify the insertion tick
+}
+
+void
+FIFO::resetWay(uint32_t set, uint32_t way)
+{
+    insertionTicks[tableIndex(set, way)] = curTick();
+}
+
+uint32_t
+FIFO::getVictimWay(uint32_t set)
+{
+    // Visit all ways of the set to find victim, the first one on ties
+    const auto *ticks = &insertionTicks[tableIndex(set, 0)];
+    uint32_t victim = 0;
+    for (uint32_t way = 1; way < tableWays; way++) {
+        if (ticks[way] < ticks[victim]) {
+            victim = way;
+        }
+    }
+    return victim;
+}
+
+void
+FIFO::saveWayState(uint32_t set, uint32_t way,
+                   std::vector<uint64_t> &state) const
+{
+    state = { uint64_t(insertionTicks[tableIndex(set, way)]) };
+}
+
+bool
+FIFO::restoreWayState(uint32_t set, uint32_t way,
+                      const std::vector<uint64_t> &state)
+{
+    if (state.size() != 1)
+        return false;
+    insertionTicks[tableIndex(set, way)] = state[0];
+    return true;
+}
+
 } // namespace ReplacementPolicy
@@ -89,4 +89,79 @@ LFU::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new LFUReplData());
 }
 
+void
+LFU::saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+               std::vector<uint64_t> &state) const
+{
+    const auto data = std::static_pointer_cast<LFUReplData>(replacement_data);
+    state = { uint64_t(data->refCount) };
+}
+
+bool
+LFU::restoreState(const std::shared_ptr<ReplacementData>& replacement_data,
+                  const std::vector<uint64_t> &state) const
+{
+    if (state.size() != 1)
+        return false;
+    auto data = std::static_pointer_cast<LFUReplData>(replacement_data);
+    data->refCount = state[0];
+    return true;
+}
+
+void
+LFU::instantiateTable(uint32_t num_sets, uint32_t num_ways)
+{
+    Base::instantiateTable(num_sets, num_ways);
+    refCounts.assign(size_t(num_sets) * num_ways, 0);
+}
+
+void
+LFU::invalidateWay(uint32_t set, uint32_t way)
+{
+    refCounts[tableIndex(set, way)] = 0;
+}
+
+void
+LFU::touchWay(uint32_t set, uint32_t way)
+{
+    refCounts[tableIndex(set, way)]++;
+}
+
+void
+LFU::resetWay(uint32_t set, uint32_t way)
+{
+    refCounts[tableIndex(set, way)] = 1;
+}
+
+uint32_t
+LFU::getVictimWay(uint32_t set)
+{
+    // Visit all ways of the set to find victim, the first one on ties
+    const auto *counts = &refCounts[tableIndex(set, 0)];
+    uint32_t victim = 0;
+    for (uint32_t way = 1; way < tableWays; way++) {
+        if (counts[way] < counts[victim]) {
+            victim = way;
+        }
+    }
+    return victim;
+}
+
+void
+LFU::saveWayState(uint32_t set, uint32_t way,
+                  std::vector<uint64_t> &state) const
+{
+    state = { uint64_t(refCounts[tableIndex(set, way)]) };
+}
+
+bool
+LFU::restoreWayState(uint32_t set, uint32_t way,
+                     const std::vector<uint64_t> &state)
+{
+    if (state.size() != 1)
+        return false;
+    refCounts[tableIndex(set, way)] = state[0];
+    return true;
+}
+
 } // namespace ReplacementPolicy
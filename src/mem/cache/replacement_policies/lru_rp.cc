@@ -93,4 +93,79 @@ LRU::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new LRUReplData());
 }
 
+void
+LRU::saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+               std::vector<uint64_t> &state) const
+{
+    const auto data = std::static_pointer_cast<LRUReplData>(replacement_data);
+    state = { uint64_t(data->lastTouchTick) };
+}
+
+bool
+LRU::restoreState(const std::shared_ptr<ReplacementData>& replacement_data,
+                  const std::vector<uint64_t> &state) const
+{
+    if (state.size() != 1)
+        return false;
+    auto data = std::static_pointer_cast<LRUReplData>(replacement_data);
+    data->lastTouchTick = state[0];
+    return true;
+}
+
+void
+LRU::instantiateTable(uint32_t num_sets, uint32_t num_ways)
+{
+    Base::instantiateTable(num_sets, num_ways);
+    lastTouchTicks.assign(size_t(num_sets) * num_ways, Tick(0));
+}
+
+void
+LRU::invalidateWay(uint32_t set, uint32_t way)
+{
+    lastTouchTicks[tableIndex(set, way)] = Tick(0);
+}
+
+void
+LRU::touchWay(uint32_t set, uint32_t way)
+{
+    lastTouchTicks[tableIndex(set, way)] = curTick();
+}
+
+void
+LRU::resetWay(uint32_t set, uint32_t way)
+{
+    lastTouchTicks[tableIndex(set, way)] = curTick();
+}
+
+uint32_t
+LRU::getVictimWay(uint32_t set)
+{
+    // Visit all ways of the set to find victim, the first one on ties
+    const auto *ticks = &lastTouchTicks[tableIndex(set, 0)];
+    uint32_t victim = 0;
+    for (uint32_t way = 1; way < tableWays; way++) {
+        if (ticks[way] < ticks[victim]) {
+            victim = way;
+        }
+    }
+    return victim;
+}
+
+void
+LRU::saveWayState(uint32_t set, uint32_t way,
+                  std::vector<uint64_t> &state) const
+{
+    state = { uint64_t(lastTouchTicks[tableIndex(set, way)]) };
+}
+
+bool
+LRU::restoreWayState(uint32_t set, uint32_t way,
+                     const std::vector<uint64_t> &state)
+{
+    if (state.size() != 1)
+        return false;
+    lastTouchTicks[tableIndex(set, way)] = state[0];
+    return true;
+}
+
 } // namespace ReplacementPolicy
@@ -103,6 +103,34 @@ class LRU : public Base
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    /** Saves the last touch tick of the entry. */
+    void saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+                   std::vector<uint64_t> &state) const override;
+    bool restoreState(
+        const std::shared_ptr<ReplacementData>& replacement_data,
+        const std::vector<uint64_t> &state) const override;
+
+    /**
+     * @name Replacement data kept by the policy
+     * The last touch tick of every entry is kept in a single array.
+     * @{
+     */
+    bool hasTableSupport() const override { return true; }
+    void instantiateTable(uint32_t num_sets, uint32_t num_ways) override;
+    void invalidateWay(uint32_t set, uint32_t way) override;
+    void touchWay(uint32_t set, uint32_t way) override;
+    void resetWay(uint32_t set, uint32_t way) override;
+    uint32_t getVictimWay(uint32_t set) override;
+    void saveWayState(uint32_t set, uint32_t way,
+                      std::vector<uint64_t> &state) const override;
+    bool restoreWayState(uint32_t set, uint32_t way,
+                         const std::vector<uint64_t> &state) override;
+    /** @} */
+
+  protected:
+    /** Tick on which each entry of the table was last touched. */
+    std::vector<Tick> lastTouchTicks;
 };
 
 } // namespace ReplacementPolicy
@@ -98,4 +98,23 @@ MRU::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new MRUReplData());
 }
 
+void
+MRU::saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+               std::vector<uint64_t> &state) const
+{
+    const auto data = std::static_pointer_cast<MRUReplData>(replacement_data);
+    state = { uint64_t(data->lastTouchTick) };
+}
+
+bool
+MRU::restoreState(const std::shared_ptr<ReplacementData>& replacement_data,
+                  const std::vector<uint64_t> &state) const
+{
+    if (state.size() != 1)
+        return false;
+    auto data = std::static_pointer_cast<MRUReplData>(replacement_data);
+    data->lastTouchTick = state[0];
+    return true;
+}
+
 } // namespace ReplacementPolicy
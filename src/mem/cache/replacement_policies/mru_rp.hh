@@ -105,6 +105,13 @@ class MRU : public Base
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    /** Saves the last touch tick of the entry. */
+    void saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+                   std::vector<uint64_t> &state) const override;
+    bool restoreState(
+        const std::shared_ptr<ReplacementData>& replacement_data,
+        const std::vector<uint64_t> &state) const override;
 };
 
 } // namespace ReplacementPolicy
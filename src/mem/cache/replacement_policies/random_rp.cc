@@ -92,4 +92,24 @@ Random::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new RandomReplData());
 }
 
+void
+Random::saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+                  std::vector<uint64_t> &state) const
+{
+    const auto data =
+        std::static_pointer_cast<RandomReplData>(replacement_data);
+    state = { uint64_t(data->valid) };
+}
+
+bool
+Random::restoreState(const std::shared_ptr<ReplacementData>& replacement_data,
+                     const std::vector<uint64_t> &state) const
+{
+    if (state.size() != 1)
+        return false;
+    auto data = std::static_pointer_cast<RandomReplData>(replacement_data);
+    data->valid = state[0];
+    return true;
+}
+
 } // namespace ReplacementPolicy
@@ -133,4 +133,28 @@ SecondChance::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new SecondChanceReplData());
 }
 
+void
+SecondChance::saveState(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::vector<uint64_t> &state) const
+{
+    const auto data =
+        std::static_pointer_cast<SecondChanceReplData>(replacement_data);
+    state = { uint64_t(data->tickInserted), uint64_t(data->hasSecondChance) };
+}
+
+bool
+SecondChance::restoreState(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    const std::vector<uint64_t> &state) const
+{
+    if (state.size() != 2)
+        return false;
+    auto data =
+        std::static_pointer_cast<SecondChanceReplData>(replacement_data);
+    data->tickInserted = state[0];
+    data->hasSecondChance = state[1];
+    return true;
+}
+
 } // namespace ReplacementPolicy
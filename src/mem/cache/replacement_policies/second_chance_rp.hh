@@ -121,6 +121,16 @@ class SecondChance : public FIFO
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    /** Saves the insertion tick and second chance bit of the entry. */
+    void saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+                   std::vector<uint64_t> &state) const override;
+    bool restoreState(
+        const std::shared_ptr<ReplacementData>& replacement_data,
+        const std::vector<uint64_t> &state) const override;
+
+    /** The second chance bits are not kept along with the FIFO data. */
+    bool hasTableSupport() const override { return false; }
 };
 
 } // namespace ReplacementPolicy
@@ -211,4 +211,85 @@ TreePLRU::instantiateEntry()
     return std::shared_ptr<ReplacementData>(treePLRUReplData);
 }
 
+void
+TreePLRU::instantiateTable(uint32_t num_sets, uint32_t num_ways)
+{
+    fatal_if(num_ways != numLeaves, "%s has %d leaves, but the table has "
+             "%d ways", name(), numLeaves, num_ways);
+    Base::instantiateTable(num_sets, num_ways);
+    trees.assign(size_t(num_sets) * (numLeaves - 1), 0);
+}
+
+void
+TreePLRU::invalidateWay(uint32_t set, uint32_t way)
+{
+    uint8_t* tree = &trees[size_t(set) * (numLeaves - 1)];
+
+    // Index of the tree entry we are currently checking
+    // Make this entry the new LRU entry
+    uint64_t tree_index = way + numLeaves - 1;
+
+    // Parse and update tree to make it point to the new LRU
+    do {
+        // Store whether we are coming from a left or right node
+        const bool right = isRightSubtree(tree_index);
+
+        // Go to the parent tree node
+        tree_index = parentIndex(tree_index);
+
+        // Update parent node to make it point to the node we just came from
+        tree[tree_index] = right;
+    } while (tree_index != 0);
+}
+
+void
+TreePLRU::touchWay(uint32_t set, uint32_t way)
+{
+    uint8_t* tree = &trees[size_t(set) * (numLeaves - 1)];
+
+    // Index of the tree entry we are currently checking
+    // Make this entry the MRU entry
+    uint64_t tree_index = way + numLeaves - 1;
+
+    // Parse and update tree to make every bit point away from the new MRU
+    do {
+        // Store whether we are coming from a left or right node
+        const bool right = isRightSubtree(tree_index);
+
+        // Go to the parent tree node
+        tree_index = parentIndex(tree_index);
+
+        // Update node to not point to the touched leaf
+        tree[tree_index] = !right;
+    } while (tree_index != 0);
+}
+
+void
+TreePLRU::resetWay(uint32_t set, uint32_t way)
+{
+    // A reset has the same functionality of a touch
+    touchWay(set, way);
+}
+
+uint32_t
+TreePLRU::getVictimWay(uint32_t set)
+{
+    const uint8_t* tree = &trees[size_t(set) * (numLeaves - 1)];
+
+    // Parse tree, starting with the root
+    uint64_t tree_index = 0;
+    while (tree_index < numLeaves - 1) {
+        // Go to the next tree entry
+        if (tree[tree_index]) {
+            tree_index = rightSubtreeIndex(tree_index);
+        } else {
+            tree_index = leftSubtreeIndex(tree_index);
+        }
+    }
+
+    // The tree index is currently at the leaf of the victim displaced by the
+    // number of non-leaf nodes
+    return tree_index - (numLeaves - 1);
+}
+
 } // namespace ReplacementPolicy
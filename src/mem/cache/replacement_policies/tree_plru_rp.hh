@@ -203,6 +203,24 @@ class TreePLRU : public Base
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    /**
+     * @name Replacement data kept by the policy
+     * The trees of all sets are kept in a single array, one node per
+     * byte. The sets must have as many ways as the tree has leaves.
+     * @{
+     */
+    bool hasTableSupport() const override { return true; }
+    void instantiateTable(uint32_t num_sets, uint32_t num_ways) override;
+    void invalidateWay(uint32_t set, uint32_t way) override;
+    void touchWay(uint32_t set, uint32_t way) override;
+    void resetWay(uint32_t set, uint32_t way) override;
+    uint32_t getVictimWay(uint32_t set) override;
+    /** @} */
+
+  protected:
+    /** The non-leaf nodes of the tree of each set, set after set. */
+    std::vector<uint8_t> trees;
 };
 
 } // namespace ReplacementPolicy
@@ -121,4 +121,28 @@ WeightedLRU::invalidate(const std::shared_ptr<ReplacementData>&
         replacement_data)->last_touch_tick = Tick(0);
 }
 
+void
+WeightedLRU::saveState(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::vector<uint64_t> &state) const
+{
+    const auto data =
+        std::static_pointer_cast<WeightedLRUReplData>(replacement_data);
+    state = { uint64_t(data->last_touch_tick), uint64_t(data->last_occ_ptr) };
+}
+
+bool
+WeightedLRU::restoreState(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    const std::vector<uint64_t> &state) const
+{
+    if (state.size() != 2)
+        return false;
+    auto data =
+        std::static_pointer_cast<WeightedLRUReplData>(replacement_data);
+    data->last_touch_tick = state[0];
+    data->last_occ_ptr = state[1];
+    return true;
+}
+
 } // namespace ReplacementPolicy
@@ -101,6 +101,13 @@ class WeightedLRU : public Base
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
 
+    /** Saves the last touch tick and occupancy of the entry. */
+    void saveState(const std::shared_ptr<ReplacementData>& replacement_data,
+                   std::vector<uint64_t> &state) const override;
+    bool restoreState(
+        const std::shared_ptr<ReplacementData>& replacement_data,
+        const std::vector<uint64_t> &state) const override;
+
     /**
      * Find replacement victim using weight.
      *
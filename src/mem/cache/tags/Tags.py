@@ -82,6 +82,10 @@ class BaseSetAssoc(BaseTags):
     replacement_policy = Param.BaseReplacementPolicy(
         Parent.replacement_policy, "Replacement policy")
 
+class PackedSetAssoc(BaseSetAssoc):
+    type = 'PackedSetAssoc'
+    cxx_header = "mem/cache/tags/packed_set_assoc.hh"
+
 class SectorTags(BaseTags):
     type = 'SectorTags'
     cxx_header = "mem/cache/tags/sector_tags.hh"
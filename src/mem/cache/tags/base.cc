@@ -48,6 +48,7 @@
 #include <cassert>
 
 #include "base/types.hh"
+#include "mem/cache/replacement_policies/base.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
 #include "mem/request.hh"
@@ -95,6 +96,28 @@ BaseTags::findBlock(Addr addr, bool is_secure) const
     return nullptr;
 }
 
+void
+BaseTags::saveReplacementState(const CacheBlk &blk,
+                               std::vector<uint64_t> &state) const
+{
+    ReplacementPolicy::Base *repl = getReplacementPolicy();
+    if (repl && blk.replacementData) {
+        repl->saveState(blk.replacementData, state);
+    } else {
+        state.clear();
+    }
+}
+
+bool
+BaseTags::restoreReplacementState(CacheBlk *blk,
+                                  const std::vector<uint64_t> &state)
+{
+    ReplacementPolicy::Base *repl = getReplacementPolicy();
+    if (repl && blk->replacementData)
+        return repl->restoreState(blk->replacementData, state);
+    return true;
+}
+
 void
 BaseTags::insertBlock(const PacketPtr pkt, CacheBlk *blk)
 {
@@ -50,6 +50,7 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <vector>
 
 #include "base/callback.hh"
 #include "base/logging.hh"
@@ -63,6 +64,9 @@
 class System;
 class IndexingPolicy;
 class ReplaceableEntry;
+namespace ReplacementPolicy {
+class Base;
+}
 
 /**
  * A common base class of Cache tagstore objects.
@@ -204,6 +208,55 @@ class BaseTags : public ClockedObject
      */
     virtual ReplaceableEntry* findBlockBySetAndWay(int set, int way) const;
 
+    /**
+     * Find the entry at the given set and way if it is both a possible
+     * location for the address and free. Used to restore checkpointed
+     * blocks to their original location.
+     *
+     * @param addr The address of the block being restored.
+     * @param set The set the block was saved from.
+     * @param way The way the block was saved from.
+     * @return The entry, or nullptr if the block cannot be placed there.
+     */
+    virtual CacheBlk*
+    findRestoreEntry(Addr addr, uint32_t set, uint32_t way) const
+    {
+        return nullptr;
+    }
+
+    /**
+     * Get the replacement policy managing the replacement data of the
+     * blocks, if any.
+     *
+     * @return The replacement policy, or nullptr.
+     */
+    virtual ReplacementPolicy::Base*
+    getReplacementPolicy() const
+    {
+        return nullptr;
+    }
+
+    /**
+     * Flatten the replacement data of a block so that it can be stored in
+     * a checkpoint. @sa ReplacementPolicy::Base::saveState()
+     *
+     * @param blk The block whose replacement data is saved.
+     * @param state Flattened replacement data.
+     */
+    virtual void saveReplacementState(const CacheBlk &blk,
+                                      std::vector<uint64_t> &state) const;
+
+    /**
+     * Restore the replacement data of a block from its flattened form.
+     * @sa ReplacementPolicy::Base::restoreState()
+     *
+     * @param blk The block whose replacement data is restored.
+     * @param state Flattened replacement data.
+     * @return True if the state could be applied to the block.
+     */
+    virtual bool restoreReplacementState(CacheBlk *blk,
+                                         const std::vector<uint64_t> &state);
+
     /**
      * Align an address to the block size.
      * @param addr the address to align.
@@ -78,7 +78,7 @@ BaseSetAssoc::tagsInit()
         blk->data = &dataBlks[blkSize*blk_index];
 
         // Associate a replacement data entry to the block
-        blk->replacementData = replacementPolicy->instantiateEntry();
+        instantiateReplacementData(blk);
     }
 }
 
@@ -91,7 +91,7 @@ BaseSetAssoc::invalidate(CacheBlk *blk)
     stats.tagsInUse--;
 
     // Invalidate replacement data
-    replacementPolicy->invalidate(blk->replacementData);
+    invalidateReplacementData(blk);
 }
 
 void
@@ -102,6 +102,6 @@ BaseSetAssoc::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
     // Since the blocks were using different replacement data pointers,
     // we must touch the replacement data of the new entry, and invalidate
     // the one that is being moved.
-    replacementPolicy->invalidate(src_blk->replacementData);
-    replacementPolicy->reset(dest_blk->replacementData);
+    invalidateReplacementData(src_blk);
+    resetReplacementData(dest_blk);
 }
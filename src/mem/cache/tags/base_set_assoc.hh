@@ -84,6 +84,38 @@ class BaseSetAssoc : public BaseTags
     /** Replacement policy */
     ReplacementPolicy::Base *replacementPolicy;
 
+    /**
+     * Create, touch, reset and invalidate the replacement data of a
+     * block. The tag store only goes through these to update the
+     * replacement data, so that a derived tag store can keep it other
+     * than in the blocks.
+     * @{
+     */
+    virtual void
+    instantiateReplacementData(CacheBlk *blk)
+    {
+        blk->replacementData = replacementPolicy->instantiateEntry();
+    }
+
+    virtual void
+    touchReplacementData(CacheBlk *blk)
+    {
+        replacementPolicy->touch(blk->replacementData);
+    }
+
+    virtual void
+    resetReplacementData(CacheBlk *blk)
+    {
+        replacementPolicy->reset(blk->replacementData);
+    }
+
+    virtual void
+    invalidateReplacementData(CacheBlk *blk)
+    {
+        replacementPolicy->invalidate(blk->replacementData);
+    }
+    /** @} */
+
   public:
     /** Convenience typedef. */
      typedef BaseSetAssocParams Params;
@@ -144,7 +176,7 @@ class BaseSetAssoc : public BaseTags
             blk->increaseRefCount();
 
             // Update replacement data of accessed block
-            replacementPolicy->touch(blk->replacementData);
+            touchReplacementData(blk);
         }
 
         // The tag lookup latency is the same for a hit or a miss
@@ -196,11 +228,32 @@ class BaseSetAssoc : public BaseTags
         stats.tagsInUse++;
 
         // Update replacement policy
-        replacementPolicy->reset(blk->replacementData);
+        resetReplacementData(blk);
     }
 
     void moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk) override;
 
+    CacheBlk*
+    findRestoreEntry(Addr addr, uint32_t set, uint32_t way) const override
+    {
+        if (way >= allocAssoc)
+            return nullptr;
+
+        for (const auto& location : indexingPolicy->getPossibleEntries(addr)) {
+            if (location->getSet() == set && location->getWay() == way) {
+                CacheBlk* blk = static_cast<CacheBlk*>(location);
+                return blk->isValid() ? nullptr : blk;
+            }
+        }
+        return nullptr;
+    }
+
+    ReplacementPolicy::Base*
+    getReplacementPolicy() const override
+    {
+        return replacementPolicy;
+    }
+
     /**
      * Limit the allocation for the cache ways.
      * @param ways The maximum number of ways available for replacement.
@@ -115,6 +115,27 @@ class SetAssociative : public BaseIndexingPolicy
     std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
                                                                      override;
 
+    /**
+     * Get the set an address maps to.
+     *
+     * @param addr The address to calculate the set for.
+     * @return The set index.
+     */
+    uint32_t getSet(const Addr addr) const { return extractSet(addr); }
+
+    /**
+     * Get the entries of a set, without copying them as
+     * getPossibleEntries() does.
+     *
+     * @param set The set index.
+     * @return The entries in all ways of the set.
+     */
+    const std::vector<ReplaceableEntry*>&
+    getSetEntries(const uint32_t set) const
+    {
+        return sets[set];
+    }
+
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
      *
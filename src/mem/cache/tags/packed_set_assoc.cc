@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a set associative tag store keeping the tags of a set
+ * contiguous.
+ */
+
+#include "mem/cache/tags/packed_set_assoc.hh"
+
+#include "base/logging.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
+#include "mem/cache/tags/way_match.hh"
+
+PackedSetAssoc::PackedSetAssoc(const Params &p)
+    : BaseSetAssoc(p),
+      setIndexing(dynamic_cast<const SetAssociative*>(p.indexing_policy)),
+      assoc(p.assoc), wayKeys(numBlocks, InvalidWayKey),
+      wayBlks(numBlocks, nullptr),
+      tableReplacement(replacementPolicy->hasTableSupport())
+{
+    fatal_if(!setIndexing, "%s requires a SetAssociative indexing policy",
+             name());
+}
+
+void
+PackedSetAssoc::tagsInit()
+{
+    if (tableReplacement)
+        replacementPolicy->instantiateTable(numBlocks / assoc, assoc);
+
+    BaseSetAssoc::tagsInit();
+
+    for (CacheBlk &blk : blks)
+        wayBlks[blk.getSet() * assoc + blk.getWay()] = &blk;
+}
+
+void
+PackedSetAssoc::updateKey(const CacheBlk *blk)
+{
+    wayKeys[blk->getSet() * assoc + blk->getWay()] = blk->isValid() ?
+        wayKey(blk->getTag(), blk->isSecure()) : InvalidWayKey;
+}
+
+CacheBlk*
+PackedSetAssoc::findBlock(Addr addr, bool is_secure) const
+{
+    const unsigned first = setIndexing->getSet(addr) * assoc;
+    const int way = findMatchingWay(&wayKeys[first], assoc,
+                                    wayKey(extractTag(addr), is_secure));
+    return way < 0 ? nullptr : wayBlks[first + way];
+}
+
+CacheBlk*
+PackedSetAssoc::findVictim(Addr addr, const bool is_secure,
+                           const std::size_t size,
+                           std::vector<CacheBlk*>& evict_blks)
+{
+    // Choose replacement victim among the ways of the set, in place
+    const uint32_t set = setIndexing->getSet(addr);
+    CacheBlk* victim;
+    if (tableReplacement) {
+        victim = wayBlks[set * assoc + replacementPolicy->getVictimWay(set)];
+    } else {
+        victim = static_cast<CacheBlk*>(replacementPolicy->getVictim(
+            setIndexing->getSetEntries(set)));
+    }
+
+    // There is only one eviction for this replacement
+    evict_blks.push_back(victim);
+
+    return victim;
+}
+
+CacheBlk*
+PackedSetAssoc::findRestoreEntry(Addr addr, uint32_t set, uint32_t way) const
+{
+    if (way >= allocAssoc || setIndexing->getSet(addr) != set)
+        return nullptr;
+
+    CacheBlk* blk = wayBlks[set * assoc + way];
+    return blk->isValid() ? nullptr : blk;
+}
+
+void
+PackedSetAssoc::instantiateReplacementData(CacheBlk *blk)
+{
+    if (!tableReplacement)
+        BaseSetAssoc::instantiateReplacementData(blk);
+}
+
+void
+PackedSetAssoc::touchReplacementData(CacheBlk *blk)
+{
+    if (tableReplacement) {
+        replacementPolicy->touchWay(blk->getSet(), blk->getWay());
+    } else {
+        BaseSetAssoc::touchReplacementData(blk);
+    }
+}
+
+void
+PackedSetAssoc::resetReplacementData(CacheBlk *blk)
+{
+    if (tableReplacement) {
+        replacementPolicy->resetWay(blk->getSet(), blk->getWay());
+    } else {
+        BaseSetAssoc::resetReplacementData(blk);
+    }
+}
+
+void
+PackedSetAssoc::invalidateReplacementData(CacheBlk *blk)
+{
+    if (tableReplacement) {
+        replacementPolicy->invalidateWay(blk->getSet(), blk->getWay());
+    } else {
+        BaseSetAssoc::invalidateReplacementData(blk);
+    }
+}
+
+void
+PackedSetAssoc::invalidate(CacheBlk *blk)
+{
+    BaseSetAssoc::invalidate(blk);
+    updateKey(blk);
+}
+
+void
+PackedSetAssoc::insertBlock(const PacketPtr pkt, CacheBlk *blk)
+{
+    BaseSetAssoc::insertBlock(pkt, blk);
+    updateKey(blk);
+}
+
+void
+PackedSetAssoc::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
+{
+    BaseSetAssoc::moveBlock(src_blk, dest_blk);
+    updateKey(src_blk);
+    updateKey(dest_blk);
+}
+
+void
+PackedSetAssoc::saveReplacementState(const CacheBlk &blk,
+                                     std::vector<uint64_t> &state) const
+{
+    if (tableReplacement) {
+        replacementPolicy->saveWayState(blk.getSet(), blk.getWay(), state);
+    } else {
+        BaseSetAssoc::saveReplacementState(blk, state);
+    }
+}
+
+bool
+PackedSetAssoc::restoreReplacementState(CacheBlk *blk,
+                                        const std::vector<uint64_t> &state)
+{
+    if (tableReplacement) {
+        return replacementPolicy->restoreWayState(blk->getSet(),
+                                                  blk->getWay(), state);
+    }
+    return BaseSetAssoc::restoreReplacementState(blk, state);
+}
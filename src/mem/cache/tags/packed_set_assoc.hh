@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a set associative tag store keeping the tags of a set
+ * contiguous.
+ */
+
+#ifndef __MEM_CACHE_TAGS_PACKED_SET_ASSOC_HH__
+#define __MEM_CACHE_TAGS_PACKED_SET_ASSOC_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/cache/cache_blk.hh"
+#include "mem/cache/tags/base_set_assoc.hh"
+#include "mem/packet.hh"
+#include "params/PackedSetAssoc.hh"
+
+class SetAssociative;
+
+/**
+ * A set associative tag store that keeps a copy of the tag, secure bit
+ * and valid bit of every block in a structure of arrays, the ways of a
+ * set being adjacent. A lookup compares the tags of all ways of a set
+ * in a single pass over this array, rather than following a pointer to
+ * each block, and neither the lookup nor the choice of a victim copy
+ * the entries of the set.
+ *
+ * The copy is updated whenever the tag store inserts, invalidates or
+ * moves a block, which are the only ways for the cache to change the
+ * tag or validity of a block. It requires the sets to be contiguous,
+ * and hence a SetAssociative indexing policy.
+ *
+ * For the same reason, the replacement data of the blocks can be kept by
+ * the replacement policy, in arrays indexed by set and way, if the policy
+ * supports it. The blocks then have no replacement data of their own.
+ */
+class PackedSetAssoc : public BaseSetAssoc
+{
+  protected:
+    /** The indexing policy, as a set associative one. */
+    const SetAssociative *setIndexing;
+
+    /** The associativity of the cache. */
+    const unsigned assoc;
+
+    /** The key of each way, set after set. @sa wayKey() */
+    std::vector<uint64_t> wayKeys;
+
+    /** The block in each way, in the same order as the keys. */
+    std::vector<CacheBlk*> wayBlks;
+
+    /** Whether the replacement policy keeps the replacement data. */
+    bool tableReplacement;
+
+    /**
+     * Update the key of the way holding a block.
+     *
+     * @param blk The block whose tag or validity changed.
+     */
+    void updateKey(const CacheBlk *blk);
+
+    /**
+     * Keep the replacement data in the tables of the replacement
+     * policy, if it supports it.
+     * @{
+     */
+    void instantiateReplacementData(CacheBlk *blk) override;
+    void touchReplacementData(CacheBlk *blk) override;
+    void resetReplacementData(CacheBlk *blk) override;
+    void invalidateReplacementData(CacheBlk *blk) override;
+    /** @} */
+
+  public:
+    /** Convenience typedef. */
+    typedef PackedSetAssocParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    PackedSetAssoc(const Params &p);
+
+    /**
+     * Initialize the blocks, the block of each way, and the replacement
+     * data.
+     */
+    void tagsInit() override;
+
+    /**
+     * Find a block by comparing the keys of all ways of its set.
+     *
+     * @param addr The address to find.
+     * @param is_secure True if the target memory space is secure.
+     * @return Pointer to the cache block if found.
+     */
+    CacheBlk *findBlock(Addr addr, bool is_secure) const override;
+
+    CacheBlk* findVictim(Addr addr, const bool is_secure,
+                         const std::size_t size,
+                         std::vector<CacheBlk*>& evict_blks) override;
+
+    CacheBlk* findRestoreEntry(Addr addr, uint32_t set,
+                               uint32_t way) const override;
+
+    void invalidate(CacheBlk *blk) override;
+
+    void insertBlock(const PacketPtr pkt, CacheBlk *blk) override;
+
+    void moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk) override;
+
+    void saveReplacementState(const CacheBlk &blk,
+                              std::vector<uint64_t> &state) const override;
+
+    bool restoreReplacementState(
+        CacheBlk *blk, const std::vector<uint64_t> &state) override;
+};
+
+#endif //__MEM_CACHE_TAGS_PACKED_SET_ASSOC_HH__
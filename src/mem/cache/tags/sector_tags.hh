@@ -174,6 +174,12 @@ class SectorTags : public BaseTags
                          const std::size_t size,
                          std::vector<CacheBlk*>& evict_blks) override;
 
+    ReplacementPolicy::Base*
+    getReplacementPolicy() const override
+    {
+        return replacementPolicy;
+    }
+
     /**
      * Calculate a block's offset in a sector from the address.
      *
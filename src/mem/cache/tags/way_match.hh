@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Helpers for comparing the tags of all ways of a set at once.
+ *
+ * The tag, secure bit and valid bit of a way are packed into a single
+ * 64-bit key, so that a lookup is a search for one key in an array of
+ * keys. The ways are compared in groups without branching on the
+ * individual results, which allows the compiler to vectorize the
+ * comparison.
+ */
+
+#ifndef __MEM_CACHE_TAGS_WAY_MATCH_HH__
+#define __MEM_CACHE_TAGS_WAY_MATCH_HH__
+
+#include <algorithm>
+#include <cstdint>
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+
+/** Key of a way that does not hold a valid block. */
+static const uint64_t InvalidWayKey = 0;
+
+/**
+ * Pack a tag and its secure bit into the key of a valid way. The tag
+ * must leave the two lowest bits of the key free, which holds for any
+ * block size of at least 4 bytes.
+ *
+ * @param tag The tag of the block.
+ * @param is_secure Whether the block is in secure space.
+ * @return The key of a valid way holding the block.
+ */
+inline uint64_t
+wayKey(Addr tag, bool is_secure)
+{
+    return (uint64_t(tag) << 2) | (uint64_t(is_secure) << 1) | 1;
+}
+
+/**
+ * Find the way of a set holding a given key.
+ *
+ * @param keys The keys of the ways of the set.
+ * @param num_ways The number of ways of the set.
+ * @param key The key to look for.
+ * @return The first way holding the key, or -1 if there is none.
+ */
+inline int
+findMatchingWay(const uint64_t *keys, unsigned num_ways, uint64_t key)
+{
+    for (unsigned base = 0; base < num_ways; base += 64) {
+        const unsigned n = std::min(num_ways - base, 64u);
+        const uint64_t *group = keys + base;
+
+        uint64_t matches = 0;
+        for (unsigned way = 0; way < n; way++) {
+            matches |= uint64_t(group[way] == key) << way;
+        }
+        if (matches) {
+            return base + findLsbSet(matches);
+        }
+    }
+    return -1;
+}
+
+#endif //__MEM_CACHE_TAGS_WAY_MATCH_HH__
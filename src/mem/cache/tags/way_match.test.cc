@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "mem/cache/tags/way_match.hh"
+
+/** The key of a way tells apart the tag, security and validity. */
+TEST(WayMatchTest, KeyEncoding)
+{
+    EXPECT_NE(wayKey(0x12, false), wayKey(0x12, true));
+    EXPECT_NE(wayKey(0x12, false), wayKey(0x13, false));
+    EXPECT_NE(wayKey(0, false), InvalidWayKey);
+    EXPECT_NE(wayKey(0, true), InvalidWayKey);
+}
+
+/** An invalid way never matches, whatever the tag looked for. */
+TEST(WayMatchTest, InvalidWaysDoNotMatch)
+{
+    std::vector<uint64_t> keys(8, InvalidWayKey);
+    EXPECT_EQ(-1, findMatchingWay(keys.data(), keys.size(),
+                                  wayKey(0, false)));
+}
+
+/** The first matching way is found, in every group of ways. */
+TEST(WayMatchTest, FindsFirstMatch)
+{
+    for (unsigned num_ways : {1u, 4u, 16u, 63u, 64u, 65u, 200u}) {
+        std::vector<uint64_t> keys(num_ways);
+        for (unsigned way = 0; way < num_ways; way++) {
+            keys[way] = wayKey(way, way % 2);
+        }
+        for (unsigned way = 0; way < num_ways; way++) {
+            EXPECT_EQ(way, findMatchingWay(keys.data(), num_ways,
+                                           wayKey(way, way % 2)));
+            EXPECT_EQ(-1, findMatchingWay(keys.data(), num_ways,
+                                          wayKey(way, !(way % 2))));
+        }
+        EXPECT_EQ(-1, findMatchingWay(keys.data(), num_ways,
+                                      wayKey(num_ways, false)));
+
+        // Duplicates resolve to the lowest way
+        keys[num_ways - 1] = keys[0];
+        EXPECT_EQ(0, findMatchingWay(keys.data(), num_ways, keys[0]));
+    }
+}
@@ -1001,6 +1001,19 @@ CoherentXBar::recvFunctional(PacketPtr pkt, PortID cpu_side_port_id)
                 cpuSidePorts[cpu_side_port_id]->name(), pkt->print());
     }
 
+    if (pkt->isRestoredBlock()) {
+        // a cache above announces a block it restored from a
+        // checkpoint, so record it as held through the source port
+        // and pass the announcement on towards memory, without
+        // snooping
+        if (snoopFilter) {
+            snoopFilter->addHolder(pkt, *cpuSidePorts[cpu_side_port_id]);
+        }
+        PortID dest_id = findPort(pkt->getAddrRange());
+        memSidePorts[dest_id]->sendFunctional(pkt);
+        return;
+    }
+
     if (!system->bypassCaches()) {
         // forward to all snoopers but the source
         forwardFunctional(pkt, cpu_side_port_id);
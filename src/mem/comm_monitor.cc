@@ -39,6 +39,8 @@
 
 #include "mem/comm_monitor.hh"
 
+#include <climits>
+
 #include "base/trace.hh"
 #include "debug/CommMonitor.hh"
 #include "sim/stats.hh"
@@ -50,8 +52,13 @@ CommMonitor::CommMonitor(const Params &params)
       samplePeriodicEvent([this]{ samplePeriodic(); }, name()),
       samplePeriodTicks(params.sample_period),
       samplePeriod(params.sample_period / SimClock::Float::s),
+      latencySampleInterval(params.latency_sample_interval),
+      latencySampleCount(0),
       stats(this, params)
 {
+    fatal_if(latencySampleInterval == 0,
+             "The latency sample interval must be at least one.");
+
     DPRINTF(CommMonitor,
             "Created monitor %s with sample period %d ticks (%f ms)\n",
             name(), samplePeriodTicks, samplePeriod * 1E3);
@@ -96,10 +103,101 @@ CommMonitor::recvFunctionalSnoop(PacketPtr pkt)
     cpuSidePort.sendFunctionalSnoop(pkt);
 }
 
+void *
+CommMonitor::CommMonitorSenderState::operator new(size_t size)
+{
+    FreeBlock *&head = freeList();
+    if (size != sizeof(CommMonitorSenderState) || !head)
+        return ::operator new(size);
+    FreeBlock *block = head;
+    head = block->next;
+    return block;
+}
+
+void
+CommMonitor::CommMonitorSenderState::operator delete(void *p, size_t size)
+{
+    if (size != sizeof(CommMonitorSenderState)) {
+        ::operator delete(p);
+        return;
+    }
+    FreeBlock *&head = freeList();
+    FreeBlock *block = static_cast<FreeBlock *>(p);
+    block->next = head;
+    head = block;
+}
+
+CommMonitor::LogHistStats::LogHistStats(Stats::Group *parent,
+                                        const char *name,
+                                        const Stats::Units::Base *unit,
+                                        unsigned sub_bits)
+    : Stats::Group(parent, name),
+      hist(sub_bits),
+      ADD_STAT(buckets, unit,
+               "Number of samples by the smallest value of their bucket"),
+      ADD_STAT(mean, unit, "Mean of the samples"),
+      ADD_STAT(max, unit, "Largest sample"),
+      ADD_STAT(quantiles, unit, "Quantiles of the samples")
+{
+    using namespace Stats;
+
+    buckets
+        .init(0)
+        .flags(pdf | nozero);
+
+    mean
+        .flags(nozero);
+
+    max
+        .flags(nozero);
+
+    quantiles
+        .init(4)
+        .subname(0, "p50")
+        .subname(1, "p90")
+        .subname(2, "p99")
+        .subname(3, "p99_9")
+        .flags(nozero);
+}
+
+void
+CommMonitor::LogHistStats::preDumpStats()
+{
+    Stats::Group::preDumpStats();
+
+    // The stats are only filled in from the histogram when they are
+    // dumped, so that sampling does not touch them
+    buckets.reset();
+    for (size_t idx = hist.bucketIndex(hist.min());
+         idx <= hist.bucketIndex(hist.max()); ++idx) {
+        uint64_t count = hist.bucketCount(idx);
+        for (; count > INT_MAX; count -= INT_MAX)
+            buckets.sample(hist.bucketLow(idx), INT_MAX);
+        if (count)
+            buckets.sample(hist.bucketLow(idx), count);
+    }
+
+    mean = hist.mean();
+    max = hist.max();
+    quantiles[0] = hist.quantile(0.5);
+    quantiles[1] = hist.quantile(0.9);
+    quantiles[2] = hist.quantile(0.99);
+    quantiles[3] = hist.quantile(0.999);
+}
+
+void
+CommMonitor::LogHistStats::resetStats()
+{
+    Stats::Group::resetStats();
+    hist.reset();
+}
+
 CommMonitor::MonitorStats::MonitorStats(Stats::Group *parent,
                                         const CommMonitorParams &params)
     : Stats::Group(parent),
 
+      logHists(params.log_hists),
+
       disableBurstLengthHists(params.disable_burst_length_hists),
       ADD_STAT(readBurstLengthHist, UNIT_BYTE,
                "Histogram of burst lengths of transmitted packets"),
@@ -242,6 +340,39 @@ CommMonitor::MonitorStats::MonitorStats(Stats::Group *parent,
     writeAddrDist
         .init(0)
         .flags(disableAddrDists ? nozero : pdf);
+
+    if (logHists) {
+        const unsigned sub_bits = params.log_hist_precision;
+        if (!disableBurstLengthHists) {
+            readBurstLengthLog.reset(new LogHistStats(
+                    this, "readBurstLengthLog", UNIT_BYTE, sub_bits));
+            writeBurstLengthLog.reset(new LogHistStats(
+                    this, "writeBurstLengthLog", UNIT_BYTE, sub_bits));
+        }
+        if (!disableLatencyHists) {
+            readLatencyLog.reset(new LogHistStats(
+                    this, "readLatencyLog", UNIT_TICK, sub_bits));
+            writeLatencyLog.reset(new LogHistStats(
+                    this, "writeLatencyLog", UNIT_TICK, sub_bits));
+        }
+        if (!disableITTDists) {
+            ittReadReadLog.reset(new LogHistStats(
+                    this, "ittReadReadLog", UNIT_TICK, sub_bits));
+            ittWriteWriteLog.reset(new LogHistStats(
+                    this, "ittWriteWriteLog", UNIT_TICK, sub_bits));
+            ittReqReqLog.reset(new LogHistStats(
+                    this, "ittReqReqLog", UNIT_TICK, sub_bits));
+        }
+
+        // The histograms replaced by the log-bucketed ones stay empty
+        readBurstLengthHist.flags(nozero);
+        writeBurstLengthHist.flags(nozero);
+        readLatencyHist.flags(nozero);
+        writeLatencyHist.flags(nozero);
+        ittReadRead.flags(nozero);
+        ittWriteWrite.flags(nozero);
+        ittReqReq.flags(nozero);
+    }
 }
 
 void
@@ -255,8 +386,12 @@ CommMonitor::MonitorStats::updateReqStats(
             ++readTrans;
 
         // Get sample of burst length
-        if (!disableBurstLengthHists)
-            readBurstLengthHist.sample(pkt_info.size);
+        if (!disableBurstLengthHists) {
+            if (logHists)
+                readBurstLengthLog->hist.sample(pkt_info.size);
+            else
+                readBurstLengthHist.sample(pkt_info.size);
+        }
 
         // Sample the masked address
         if (!disableAddrDists)
@@ -264,13 +399,21 @@ CommMonitor::MonitorStats::updateReqStats(
 
         if (!disableITTDists) {
             // Sample value of read-read inter transaction time
-            if (timeOfLastRead != 0)
-                ittReadRead.sample(curTick() - timeOfLastRead);
+            if (timeOfLastRead != 0) {
+                if (logHists)
+                    ittReadReadLog->hist.sample(curTick() - timeOfLastRead);
+                else
+                    ittReadRead.sample(curTick() - timeOfLastRead);
+            }
             timeOfLastRead = curTick();
 
             // Sample value of req-req inter transaction time
-            if (timeOfLastReq != 0)
-                ittReqReq.sample(curTick() - timeOfLastReq);
+            if (timeOfLastReq != 0) {
+                if (logHists)
+                    ittReqReqLog->hist.sample(curTick() - timeOfLastReq);
+                else
+                    ittReqReq.sample(curTick() - timeOfLastReq);
+            }
             timeOfLastReq = curTick();
         }
         if (!is_atomic && !disableOutstandingHists && expects_response)
@@ -281,8 +424,12 @@ CommMonitor::MonitorStats::updateReqStats(
         if (!disableTransactionHists)
             ++writeTrans;
 
-        if (!disableBurstLengthHists)
-            writeBurstLengthHist.sample(pkt_info.size);
+        if (!disableBurstLengthHists) {
+            if (logHists)
+                writeBurstLengthLog->hist.sample(pkt_info.size);
+            else
+                writeBurstLengthHist.sample(pkt_info.size);
+        }
 
         // Update the bandwidth stats on the request
         if (!disableBandwidthHists) {
@@ -296,13 +443,21 @@ CommMonitor::MonitorStats::updateReqStats(
 
         if (!disableITTDists) {
             // Sample value of write-to-write inter transaction time
-            if (timeOfLastWrite != 0)
-                ittWriteWrite.sample(curTick() - timeOfLastWrite);
+            if (timeOfLastWrite != 0) {
+                if (logHists)
+                    ittWriteWriteLog->hist.sample(curTick() - timeOfLastWrite);
+                else
+                    ittWriteWrite.sample(curTick() - timeOfLastWrite);
+            }
             timeOfLastWrite = curTick();
 
             // Sample value of req-to-req inter transaction time
-            if (timeOfLastReq != 0)
-                ittReqReq.sample(curTick() - timeOfLastReq);
+            if (timeOfLastReq != 0) {
+                if (logHists)
+                    ittReqReqLog->hist.sample(curTick() - timeOfLastReq);
+                else
+                    ittReqReq.sample(curTick() - timeOfLastReq);
+            }
             timeOfLastReq = curTick();
         }
 
@@ -313,7 +468,8 @@ CommMonitor::MonitorStats::updateReqStats(
 
 void
 CommMonitor::MonitorStats::updateRespStats(
-    const ProbePoints::PacketInfo& pkt_info, Tick latency, bool is_atomic)
+    const ProbePoints::PacketInfo& pkt_info, Tick latency, bool is_atomic,
+    bool has_latency)
 {
     if (pkt_info.cmd.isRead()) {
         // Decrement number of outstanding read requests
@@ -322,8 +478,12 @@ CommMonitor::MonitorStats::updateRespStats(
             --outstandingReadReqs;
         }
 
-        if (!disableLatencyHists)
-            readLatencyHist.sample(latency);
+        if (!disableLatencyHists && has_latency) {
+            if (logHists)
+                readLatencyLog->hist.sample(latency);
+            else
+                readLatencyHist.sample(latency);
+        }
 
         // Update the bandwidth stats based on responses for reads
         if (!disableBandwidthHists) {
@@ -338,8 +498,12 @@ CommMonitor::MonitorStats::updateRespStats(
             --outstandingWriteReqs;
         }
 
-        if (!disableLatencyHists)
-            writeLatencyHist.sample(latency);
+        if (!disableLatencyHists && has_latency) {
+            if (logHists)
+                writeLatencyLog->hist.sample(latency);
+            else
+                writeLatencyHist.sample(latency);
+        }
     }
 }
 
@@ -386,19 +550,28 @@ CommMonitor::recvTimingReq(PacketPtr pkt)
     // If a cache miss is served by a cache, a monitor near the memory
     // would see a request which needs a response, but this response
     // would not come back from the memory. Therefore we additionally
-    // have to check the cacheResponding flag
-    if (expects_response && !stats.disableLatencyHists) {
-        pkt->pushSenderState(new CommMonitorSenderState(curTick()));
+    // have to check the cacheResponding flag. Only one in every
+    // latencySampleInterval of these requests has its latency tracked.
+    const bool sample_latency(expects_response &&
+                              !stats.disableLatencyHists);
+    const bool track_latency(sample_latency &&
+                             latencySampleCount + 1 >= latencySampleInterval);
+    if (track_latency) {
+        pkt->pushSenderState(new CommMonitorSenderState(this, curTick()));
     }
 
     // Attempt to send the packet
     bool successful = memSidePort.sendTimingReq(pkt);
 
     // If not successful, restore the sender state
-    if (!successful && expects_response && !stats.disableLatencyHists) {
+    if (!successful && track_latency) {
         delete pkt->popSenderState();
     }
 
+    if (successful && sample_latency) {
+        latencySampleCount = track_latency ? 0 : latencySampleCount + 1;
+    }
+
     if (successful) {
         ppPktReq->notify(pkt_info);
     }
@@ -422,22 +595,29 @@ CommMonitor::recvTimingResp(PacketPtr pkt)
     const ProbePoints::PacketInfo pkt_info(pkt);
 
     Tick latency = 0;
-    CommMonitorSenderState* received_state =
-        dynamic_cast<CommMonitorSenderState*>(pkt->senderState);
+    CommMonitorSenderState* received_state = nullptr;
 
     if (!stats.disableLatencyHists) {
-        // Restore initial sender state
-        if (received_state == NULL)
+        received_state =
+            dynamic_cast<CommMonitorSenderState*>(pkt->senderState);
+        if (received_state && received_state->monitor != this)
+            received_state = nullptr;
+
+        // Restore initial sender state, unless the latency of the
+        // request was not tracked
+        if (received_state == NULL && latencySampleInterval == 1)
             panic("Monitor got a response without monitor sender state\n");
 
         // Restore the sate
-        pkt->senderState = received_state->predecessor;
+        if (received_state)
+            pkt->senderState = received_state->predecessor;
     }
+    const bool has_latency(received_state != nullptr);
 
     // Attempt to send the packet
     bool successful = cpuSidePort.sendTimingResp(pkt);
 
-    if (!stats.disableLatencyHists) {
+    if (has_latency) {
         // If packet successfully send, sample value of latency,
         // afterwards delete sender state, otherwise restore state
         if (successful) {
@@ -455,7 +635,7 @@ CommMonitor::recvTimingResp(PacketPtr pkt)
         ppPktResp->notify(pkt_info);
         DPRINTF(CommMonitor, "Received %s response\n", pkt->isRead() ? "read" :
                 pkt->isWrite() ?  "write" : "non read/write");
-        stats.updateRespStats(pkt_info, latency, false);
+        stats.updateRespStats(pkt_info, latency, false, has_latency);
     }
     return successful;
 }
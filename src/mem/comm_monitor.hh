@@ -40,6 +40,9 @@
 #ifndef __MEM_COMM_MONITOR_HH__
 #define __MEM_COMM_MONITOR_HH__
 
+#include <memory>
+
+#include "base/log_histogram.hh"
 #include "base/statistics.hh"
 #include "mem/port.hh"
 #include "params/CommMonitor.hh"
@@ -56,6 +59,12 @@
  * (read-read, write-write, read/write-read/write). Furthermore it allows
  * to capture the number of accesses to an address over time ("heat map").
  * All stats can be disabled from Python.
+ *
+ * The histograms sampled for every packet, i.e. the burst length,
+ * latency and ITT ones, can instead be kept in log-bucketed histograms
+ * of a fixed size, and the latency can be tracked for only one in N
+ * requests, which makes the monitor cheap enough to leave on every
+ * link of a system.
  */
 class CommMonitor : public SimObject
 {
@@ -95,18 +104,53 @@ class CommMonitor : public SimObject
          * Construct a new sender state and store the time so we can
          * calculate round-trip latency.
          *
+         * @param _monitor Monitor the state belongs to
          * @param _transmitTime Time of packet transmission
          */
-        CommMonitorSenderState(Tick _transmitTime)
-            : transmitTime(_transmitTime)
+        CommMonitorSenderState(const CommMonitor *_monitor,
+                               Tick _transmitTime)
+            : monitor(_monitor), transmitTime(_transmitTime)
         { }
 
         /** Destructor */
         ~CommMonitorSenderState() { }
 
+        /**
+         * Sender states are allocated from and released to a free
+         * list of the calling thread, as one is pushed for every
+         * request that expects a response.
+         * @{
+         */
+        static void *operator new(size_t size);
+        static void operator delete(void *p, size_t size);
+        /** @} */
+
+        /**
+         * Monitor the state belongs to, as a monitor that only tracks
+         * some of the requests may find the state of another monitor
+         * on top of a response
+         */
+        const CommMonitor *const monitor;
+
         /** Tick when request is transmitted */
         Tick transmitTime;
 
+      private:
+
+        /** Block of the free list of recycled sender states. */
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        };
+
+        /** Free list of the calling thread. */
+        static FreeBlock *&
+        freeList()
+        {
+            static thread_local FreeBlock *head = nullptr;
+            return head;
+        }
+
     };
 
     /**
@@ -266,9 +310,44 @@ class CommMonitor : public SimObject
 
     bool tryTiming(PacketPtr pkt);
 
+    /**
+     * Log-bucketed histogram of a value sampled for every packet, and
+     * the stats it is reported as when the stats are dumped.
+     */
+    struct LogHistStats : public Stats::Group
+    {
+        LogHistStats(Stats::Group *parent, const char *name,
+                     const Stats::Units::Base *unit, unsigned sub_bits);
+
+        void preDumpStats() override;
+        void resetStats() override;
+
+        /** Histogram of the samples since the last reset */
+        LogHistogram hist;
+
+        /** Number of samples in each bucket, by its smallest value */
+        Stats::SparseHistogram buckets;
+
+        /** Mean of the samples */
+        Stats::Scalar mean;
+
+        /** Largest sample */
+        Stats::Scalar max;
+
+        /** Quantiles of the samples, to the precision of a bucket */
+        Stats::Vector quantiles;
+    };
+
     /** Stats declarations, all in a struct for convenience. */
     struct MonitorStats : public Stats::Group
     {
+        /**
+         * Keep the burst length, latency and ITT histograms in
+         * log-bucketed histograms rather than in the histograms and
+         * distributions below.
+         */
+        const bool logHists;
+
         /** Disable flag for burst length histograms **/
         bool disableBurstLengthHists;
 
@@ -278,6 +357,10 @@ class CommMonitor : public SimObject
         /** Histogram of write burst lengths */
         Stats::Histogram writeBurstLengthHist;
 
+        /** Log-bucketed burst length histograms */
+        std::unique_ptr<LogHistStats> readBurstLengthLog;
+        std::unique_ptr<LogHistStats> writeBurstLengthLog;
+
         /** Disable flag for the bandwidth histograms */
         bool disableBandwidthHists;
 
@@ -308,6 +391,10 @@ class CommMonitor : public SimObject
         /** Histogram of write request-to-response latencies */
         Stats::Histogram writeLatencyHist;
 
+        /** Log-bucketed latency histograms */
+        std::unique_ptr<LogHistStats> readLatencyLog;
+        std::unique_ptr<LogHistStats> writeLatencyLog;
+
         /** Disable flag for ITT distributions. */
         bool disableITTDists;
 
@@ -320,6 +407,9 @@ class CommMonitor : public SimObject
         Stats::Distribution ittReadRead;
         Stats::Distribution ittWriteWrite;
         Stats::Distribution ittReqReq;
+        std::unique_ptr<LogHistStats> ittReadReadLog;
+        std::unique_ptr<LogHistStats> ittWriteWriteLog;
+        std::unique_ptr<LogHistStats> ittReqReqLog;
         Tick timeOfLastRead;
         Tick timeOfLastWrite;
         Tick timeOfLastReq;
@@ -385,7 +475,7 @@ class CommMonitor : public SimObject
         void updateReqStats(const ProbePoints::PacketInfo& pkt, bool is_atomic,
                             bool expects_response);
         void updateRespStats(const ProbePoints::PacketInfo& pkt, Tick latency,
-                             bool is_atomic);
+                             bool is_atomic, bool has_latency = true);
     };
 
     /** This function is called periodically at the end of each time bin */
@@ -404,6 +494,15 @@ class CommMonitor : public SimObject
     /** Sample period in seconds */
     const double samplePeriod;
 
+    /** Track the latency of one in this many requests */
+    const unsigned latencySampleInterval;
+
+    /**
+     * Requests expecting a response forwarded since the last one
+     * whose latency was tracked
+     */
+    unsigned latencySampleCount;
+
     /** @} */
 
     /** Instantiate stats */
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * The FR-FCFS choice of the next DRAM packet of a queue.
+ */
+
+#ifndef __MEM_FRFCFS_HH__
+#define __MEM_FRFCFS_HH__
+
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+#include "mem/mem_ctrl.hh"
+#include "mem/mem_packet_queue.hh"
+
+/**
+ * Choose the next DRAM packet of a queue following FR-FCFS. The choice
+ * follows the FCFS order of the queue: first pick the oldest seamless
+ * row hit. If there is none, pick the oldest packet to one of the
+ * earliest available banks if the bank can be prepped without impacting
+ * utilization, as this selects closed rows first and enables more open
+ * row possibilities in future selections. Otherwise go for the oldest
+ * row hit, which is bank prepped and ready but not seamless, and if
+ * there is no row hit either just go for the earliest possible.
+ *
+ * The bank state is kept apart from the choice so that the choice can
+ * be tested on its own. It provides, as DRAMInterface does:
+ *   bool burstReady(MemPacket* pkt) const;
+ *   uint32_t openRow(const MemPacket* pkt) const;
+ *   Tick colAllowedAt(const MemPacket* pkt) const;
+ *   std::pair<std::vector<uint32_t>, bool>
+ *   minBankPrep(const MemPacketQueue& queue, Tick min_col_at) const;
+ *
+ * @param queue Queued requests to consider
+ * @param min_col_at Minimum tick for 'seamless' issue
+ * @param banks State of the banks
+ * @return an iterator to the selected packet, else queue.end()
+ * @return the tick when the packet selected will issue
+ */
+template <class Banks>
+std::pair<MemPacketQueue::iterator, Tick>
+chooseFRFCFS(MemPacketQueue& queue, Tick min_col_at, const Banks& banks)
+{
+    typedef MemPacketQueue::BankEntry BankEntry;
+
+    // A bank can only contribute its oldest row hit and its oldest row
+    // miss, so rather than looking at every packet in the queue, look
+    // at those of every bank with packets.
+
+    // oldest packet of a bank that is (or is not) a row hit
+    auto oldest = [&banks](const MemPacketQueue::BankPackets& pkts,
+                           bool row_hit) -> const BankEntry* {
+        const uint32_t open_row = banks.openRow(*pkts.front().pos);
+        for (const auto& e : pkts) {
+            if (((*e.pos)->row == open_row) == row_hit)
+                return &e;
+        }
+        return nullptr;
+    };
+
+    const BankEntry* seamless_pkt = nullptr;
+    const BankEntry* prepped_pkt = nullptr;
+    bool got_row_miss = false;
+
+    for (uint16_t bank_id = 0; bank_id < queue.numBanks(); ++bank_id) {
+        const auto& pkts = queue.bankPackets(bank_id);
+        // skip the banks without packets, and the banks of a rank doing
+        // a refresh and thus not available
+        if (pkts.empty() || !banks.burstReady(*pkts.front().pos))
+            continue;
+
+        // the queue holds either reads or writes, so all the row hits
+        // of a bank are seamless or none of them are
+        const BankEntry* hit = oldest(pkts, true);
+        if (hit) {
+            if (banks.colAllowedAt(*hit->pos) <= min_col_at) {
+                if (!seamless_pkt || hit->seq < seamless_pkt->seq)
+                    seamless_pkt = hit;
+            } else if (!prepped_pkt || hit->seq < prepped_pkt->seq) {
+                prepped_pkt = hit;
+            }
+        }
+
+        got_row_miss |= oldest(pkts, false) != nullptr;
+    }
+
+    if (seamless_pkt) {
+        return std::make_pair(seamless_pkt->pos,
+                              banks.colAllowedAt(*seamless_pkt->pos));
+    }
+
+    // oldest packet to one of the first available banks, minBankPrep
+    // will give priority to banks that can issue seamlessly
+    const BankEntry* earliest_pkt = nullptr;
+    // can the PRE/ACT sequence be done without impacting utlization?
+    bool hidden_bank_prep = false;
+
+    if (got_row_miss) {
+        std::vector<uint32_t> earliest_banks;
+        std::tie(earliest_banks, hidden_bank_prep) =
+            banks.minBankPrep(queue, min_col_at);
+
+        for (uint16_t bank_id = 0; bank_id < queue.numBanks(); ++bank_id) {
+            const auto& pkts = queue.bankPackets(bank_id);
+            if (pkts.empty())
+                continue;
+
+            MemPacket* first = *pkts.front().pos;
+            if (!banks.burstReady(first) ||
+                !bits(earliest_banks[first->rank], first->bank, first->bank))
+                continue;
+
+            const BankEntry* miss = oldest(pkts, false);
+            if (miss && (!earliest_pkt || miss->seq < earliest_pkt->seq))
+                earliest_pkt = miss;
+        }
+    }
+
+    // give priority to packets that can issue bank commands 'behind
+    // the scenes', any additional delay if any will be due to
+    // col-to-col command requirements
+    const BankEntry* selected_pkt =
+        earliest_pkt && (hidden_bank_prep || !prepped_pkt) ?
+        earliest_pkt : prepped_pkt;
+
+    if (!selected_pkt)
+        return std::make_pair(queue.end(), MaxTick);
+
+    return std::make_pair(selected_pkt->pos,
+                          banks.colAllowedAt(*selected_pkt->pos));
+}
+
+#endif //__MEM_FRFCFS_HH__
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/gtest/cur_tick_fake.hh"
+#include "base/types.hh"
+#include "mem/frfcfs.hh"
+#include "mem/mem_ctrl.hh"
+#include "mem/mem_packet_queue.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+
+// Instantiate the fake class to have a valid curTick of 0
+GTestTickHandler tickHandler;
+
+static_assert(!std::is_copy_constructible<MemPacketQueue>::value,
+              "MemPacketQueue holds iterators into itself");
+
+namespace
+{
+
+const unsigned numRanks = 2;
+const unsigned banksPerRank = 4;
+
+/** Randomly drawn bank state, with the interface chooseFRFCFS uses. */
+struct TestBanks
+{
+    std::vector<bool> refIdle;
+    std::vector<uint32_t> openRows;
+    std::vector<Tick> rdAllowedAt;
+    std::vector<Tick> wrAllowedAt;
+    std::vector<uint32_t> earliestBanks;
+    bool hiddenBankPrep;
+
+    bool burstReady(MemPacket* pkt) const { return refIdle[pkt->rank]; }
+
+    uint32_t
+    openRow(const MemPacket* pkt) const
+    {
+        return openRows[pkt->bankId];
+    }
+
+    Tick
+    colAllowedAt(const MemPacket* pkt) const
+    {
+        return pkt->isRead() ? rdAllowedAt[pkt->bankId] :
+                               wrAllowedAt[pkt->bankId];
+    }
+
+    std::pair<std::vector<uint32_t>, bool>
+    minBankPrep(const MemPacketQueue& queue, Tick min_col_at) const
+    {
+        return std::make_pair(earliestBanks, hiddenBankPrep);
+    }
+};
+
+/**
+ * The scan through every packet of the queue DRAMInterface used before
+ * the per-bank index, which chooseFRFCFS has to agree with.
+ */
+std::pair<MemPacketQueue::iterator, Tick>
+scanFRFCFS(MemPacketQueue& queue, Tick min_col_at, const TestBanks& banks)
+{
+    std::vector<uint32_t> earliest_banks(numRanks, 0);
+    bool filled_earliest_banks = false;
+    bool hidden_bank_prep = false;
+    bool found_hidden_bank = false;
+    bool found_prepped_pkt = false;
+    bool found_earliest_pkt = false;
+
+    Tick selected_col_at = MaxTick;
+    auto selected_pkt_it = queue.end();
+
+    for (auto i = queue.begin(); i != queue.end() ; ++i) {
+        MemPacket* pkt = *i;
+        if (!pkt->isDram() || !banks.burstReady(pkt))
+            continue;
+
+        const Tick col_allowed_at = banks.colAllowedAt(pkt);
+        if (banks.openRow(pkt) == pkt->row) {
+            if (col_allowed_at <= min_col_at) {
+                selected_pkt_it = i;
+                selected_col_at = col_allowed_at;
+                break;
+            } else if (!found_hidden_bank && !found_prepped_pkt) {
+                selected_pkt_it = i;
+                selected_col_at = col_allowed_at;
+                found_prepped_pkt = true;
+            }
+        } else if (!found_earliest_pkt) {
+            if (!filled_earliest_banks) {
+                std::tie(earliest_banks, hidden_bank_prep) =
+                    banks.minBankPrep(queue, min_col_at);
+                filled_earliest_banks = true;
+            }
+
+            if (bits(earliest_banks[pkt->rank], pkt->bank, pkt->bank)) {
+                found_earliest_pkt = true;
+                found_hidden_bank = hidden_bank_prep;
+                if (hidden_bank_prep || !found_prepped_pkt) {
+                    selected_pkt_it = i;
+                    selected_col_at = col_allowed_at;
+                }
+            }
+        }
+    }
+
+    return std::make_pair(selected_pkt_it, selected_col_at);
+}
+
+} // anonymous namespace
+
+/** The per-bank index follows the packets added and removed. */
+TEST(MemPacketQueueTest, BankIndex)
+{
+    Packet pkt(std::make_shared<Request>(0, 64, 0, 0), MemCmd::ReadReq);
+    MemPacket a(&pkt, true, true, 0, 1, 7, 1, 0x0, 64);
+    MemPacket b(&pkt, true, true, 0, 1, 8, 1, 0x40, 64);
+    MemPacket c(&pkt, true, false, 0, 1, 7, 1, 0x80, 64);
+    MemPacket d(&pkt, true, true, 1, 0, 7, 4, 0xc0, 64);
+
+    MemPacketQueue queue;
+    queue.push_back(&a);
+    queue.push_back(&b);
+    queue.push_back(&c);
+    queue.push_back(&d);
+    EXPECT_EQ(4, queue.size());
+    EXPECT_TRUE(queue.hasNvmPackets());
+    EXPECT_EQ(5, queue.numBanks());
+
+    // The NVM packet is not part of the index
+    ASSERT_EQ(2, queue.bankPackets(1).size());
+    EXPECT_EQ(&a, *queue.bankPackets(1)[0].pos);
+    EXPECT_EQ(&b, *queue.bankPackets(1)[1].pos);
+    EXPECT_LT(queue.bankPackets(1)[0].seq, queue.bankPackets(1)[1].seq);
+    EXPECT_TRUE(queue.bankPackets(0).empty());
+    EXPECT_TRUE(queue.bankPackets(100).empty());
+
+    auto next = queue.erase(queue.begin());
+    EXPECT_EQ(&b, *next);
+    ASSERT_EQ(1, queue.bankPackets(1).size());
+    EXPECT_EQ(&b, *queue.bankPackets(1)[0].pos);
+
+    next = queue.erase(std::next(next));
+    EXPECT_EQ(&d, *next);
+    EXPECT_FALSE(queue.hasNvmPackets());
+
+    // Moving the queue keeps the index valid
+    MemPacketQueue moved(std::move(queue));
+    ASSERT_EQ(1, moved.bankPackets(4).size());
+    EXPECT_EQ(&d, *moved.bankPackets(4)[0].pos);
+    moved.erase(moved.bankPackets(4)[0].pos);
+    EXPECT_EQ(1, moved.size());
+    EXPECT_EQ(&b, *moved.begin());
+}
+
+/**
+ * The bank walk picks the same packet as the full scan of the queue,
+ * for random queues and bank states.
+ */
+TEST(FRFCFSTest, MatchesQueueScan)
+{
+    std::mt19937 rng(0x5eed);
+    auto draw = [&rng](unsigned n) {
+        return std::uniform_int_distribution<unsigned>(0, n - 1)(rng);
+    };
+
+    Packet pkt(std::make_shared<Request>(0, 64, 0, 0), MemCmd::ReadReq);
+    const unsigned num_banks = numRanks * banksPerRank;
+
+    for (int iter = 0; iter < 20000; ++iter) {
+        // a queue holds either reads or writes, with a few NVM packets
+        const bool is_read = draw(2);
+        std::vector<MemPacket> pkts;
+        const unsigned num_pkts = draw(24);
+        pkts.reserve(num_pkts);
+        for (unsigned i = 0; i < num_pkts; ++i) {
+            const uint8_t rank = draw(numRanks);
+            const uint8_t bank = draw(banksPerRank);
+            pkts.emplace_back(&pkt, is_read, draw(8) != 0, rank, bank,
+                              draw(3), rank * banksPerRank + bank,
+                              i * 64, 64);
+        }
+
+        MemPacketQueue queue;
+        for (auto& p : pkts)
+            queue.push_back(&p);
+
+        // take some packets out, as the controller does
+        for (unsigned n = draw(4); n > 0 && !queue.empty(); --n)
+            queue.erase(std::next(queue.begin(), draw(queue.size())));
+
+        TestBanks banks;
+        for (unsigned r = 0; r < numRanks; ++r)
+            banks.refIdle.push_back(draw(4) != 0);
+        for (unsigned b = 0; b < num_banks; ++b) {
+            banks.openRows.push_back(draw(3));
+            banks.rdAllowedAt.push_back(draw(4) * 10);
+            banks.wrAllowedAt.push_back(draw(4) * 10);
+        }
+
+        // like minBankPrep, only pick banks with packets in ranks that
+        // are available
+        banks.earliestBanks.assign(numRanks, 0);
+        for (const MemPacket* p : queue) {
+            if (p->isDram() && banks.refIdle[p->rank] && draw(2))
+                banks.earliestBanks[p->rank] |= 1 << p->bank;
+        }
+        banks.hiddenBankPrep = draw(2);
+
+        const Tick min_col_at = draw(4) * 10;
+        auto expected = scanFRFCFS(queue, min_col_at, banks);
+        auto chosen = chooseFRFCFS(queue, min_col_at, banks);
+        ASSERT_TRUE(expected.first == chosen.first) << "iteration " << iter;
+        EXPECT_EQ(expected.second, chosen.second) << "iteration " << iter;
+    }
+}
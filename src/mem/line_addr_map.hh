@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration and implementation of an open-addressing hash map keyed
+ * on cache line addresses.
+ */
+
+#ifndef __MEM_LINE_ADDR_MAP_HH__
+#define __MEM_LINE_ADDR_MAP_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+/**
+ * A hash map from line addresses to values, built from two flat
+ * arrays. The entries, i.e. the addresses and their values, are kept
+ * densely packed in one array, and an open-addressing table of small
+ * slots maps each address to the position of its entry. Collisions
+ * in the table are resolved by linear probing with Robin Hood
+ * hashing: a slot being inserted displaces any slot it meets that is
+ * closer to its home position, which bounds the probe lengths and
+ * lets a lookup stop as soon as it meets a slot closer to home than
+ * the address it is looking for. Each slot keeps a few bits of the
+ * hash of its address, so that a probe rarely needs to look at an
+ * entry other than the one it is after. Erasing shifts the following
+ * slots back rather than leaving tombstones, and moves the last entry
+ * into the place of the erased one.
+ *
+ * Compared with an std::unordered_map this avoids an allocation per
+ * entry, and a lookup only touches the table and the entry it finds.
+ * On the other hand, inserting and erasing entries moves other
+ * entries around, so an iterator is only valid until the map is next
+ * modified.
+ *
+ * The addresses are hashed multiplicatively, which spreads the upper
+ * bits of line addresses over the table irrespective of the line size
+ * and of any flags kept in the low bits.
+ */
+template <typename T>
+class LineAddrMap
+{
+  public:
+    typedef std::pair<Addr, T> value_type;
+    typedef value_type *iterator;
+    typedef const value_type *const_iterator;
+
+    LineAddrMap() : shift(0) {}
+
+    /** Number of entries in the map. */
+    size_t size() const { return entries.size(); }
+
+    bool empty() const { return entries.empty(); }
+
+    /** Number of slots in the table. */
+    size_t capacity() const { return slots.size(); }
+
+    /** Host memory used by the entries and the table. */
+    size_t
+    memoryUsage() const
+    {
+        return entries.capacity() * sizeof(value_type) +
+            slots.capacity() * sizeof(Slot);
+    }
+
+    /**
+     * Iterate over the entries, in no particular order.
+     * @{
+     */
+    iterator begin() { return entries.data(); }
+    iterator end() { return entries.data() + entries.size(); }
+    const_iterator begin() const { return entries.data(); }
+    const_iterator
+    end() const
+    {
+        return entries.data() + entries.size();
+    }
+    /** @} */
+
+    /**
+     * Look up an address.
+     *
+     * @param addr The line address to look for.
+     * @return The entry of the address, or end() if there is none.
+     */
+    iterator
+    find(Addr addr)
+    {
+        const size_t idx = findSlot(addr);
+        return idx == NoSlot ? end() : &entries[slots[idx].entry];
+    }
+
+    /**
+     * Insert an entry unless the address is already in the map.
+     *
+     * @param addr The line address of the entry.
+     * @param value The value of the entry.
+     * @return The entry of the address, and whether it was inserted.
+     */
+    std::pair<iterator, bool>
+    emplace(Addr addr, const T &value)
+    {
+        // Probe as findSlot() does, and on a miss insert the slot
+        // where the lookup stopped
+        const uint64_t hash = hashAddr(addr);
+        Slot slot{0, fingerprint(hash), 1};
+        size_t idx = 0;
+        if (!slots.empty()) {
+            for (idx = hash >> shift; slots[idx].dist >= slot.dist;
+                 ++slot.dist) {
+                if (matches(slots[idx], slot.fingerprint, addr)) {
+                    return std::make_pair(&entries[slots[idx].entry],
+                                          false);
+                }
+                idx = next(idx);
+            }
+        }
+
+        // Keep the load factor of the table at or below 7/8
+        if ((entries.size() + 1) * 8 > slots.size() * 7) {
+            resize(slots.empty() ? initialCapacity : slots.size() * 2);
+            idx = hash >> shift;
+            slot.dist = 1;
+        }
+
+        // Grow the entries by half rather than letting the vector
+        // double them, as they make up most of the memory
+        const size_t num_entries = entries.size();
+        assert(num_entries < NoSlot);
+        if (num_entries == entries.capacity()) {
+            entries.reserve(num_entries < initialCapacity ? initialCapacity :
+                            num_entries + num_entries / 2);
+        }
+        entries.emplace_back(addr, value);
+        slot.entry = num_entries;
+        insertSlot(slot, idx);
+        return std::make_pair(&entries.back(), true);
+    }
+
+    /**
+     * Get the value of an address, inserting a default constructed
+     * value if the address is not in the map.
+     */
+    T &
+    operator[](Addr addr)
+    {
+        return emplace(addr, T()).first->second;
+    }
+
+    /**
+     * Erase an entry. This moves the last entry into its place.
+     *
+     * @param it The entry to erase, which must be in the map.
+     */
+    void
+    erase(iterator it)
+    {
+        assert(it >= begin() && it < end());
+        const uint32_t erased = it - begin();
+        eraseSlot(findSlot(it->first));
+
+        const uint32_t last = entries.size() - 1;
+        if (erased != last) {
+            const size_t last_idx = findSlot(entries[last].first);
+            assert(last_idx != NoSlot);
+            slots[last_idx].entry = erased;
+            entries[erased] = std::move(entries[last]);
+        }
+        entries.pop_back();
+    }
+
+    /**
+     * Erase the entry of an address, if any.
+     *
+     * @return The number of entries erased.
+     */
+    size_t
+    erase(Addr addr)
+    {
+        iterator it = find(addr);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    /** Erase all entries and release their memory. */
+    void
+    clear()
+    {
+        std::vector<value_type>().swap(entries);
+        std::vector<Slot>().swap(slots);
+        shift = 0;
+    }
+
+  private:
+    /** Slot of the table, referring to an entry. */
+    struct Slot
+    {
+        /** Position of the entry in the array of entries. */
+        uint32_t entry;
+        /** Bits of the hash of the address not used for indexing. */
+        uint16_t fingerprint;
+        /** Probe distance plus one, with zero marking an empty slot. */
+        uint16_t dist;
+    };
+
+    /** Returned by findSlot() if the address is not in the map. */
+    static const size_t NoSlot = UINT32_MAX;
+
+    /** Number of slots allocated by the first insertion. */
+    static const size_t initialCapacity = 64;
+
+    /**
+     * Fibonacci hashing. The upper bits of the hash index the table
+     * and the fingerprint is taken from the bits below.
+     */
+    static uint64_t
+    hashAddr(Addr addr)
+    {
+        return uint64_t(addr) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    static uint16_t fingerprint(uint64_t hash) { return hash >> 16; }
+
+    bool
+    matches(const Slot &slot, uint16_t fp, Addr addr) const
+    {
+        return slot.fingerprint == fp && entries[slot.entry].first == addr;
+    }
+
+    size_t next(size_t idx) const { return (idx + 1) & (slots.size() - 1); }
+
+    /** Find the slot of an address, or NoSlot if there is none. */
+    size_t
+    findSlot(Addr addr) const
+    {
+        if (entries.empty())
+            return NoSlot;
+        const uint64_t hash = hashAddr(addr);
+        const uint16_t fp = fingerprint(hash);
+        size_t idx = hash >> shift;
+        for (uint16_t dist = 1; slots[idx].dist >= dist; ++dist) {
+            if (matches(slots[idx], fp, addr))
+                return idx;
+            idx = next(idx);
+        }
+        return NoSlot;
+    }
+
+    /**
+     * Add a slot for an address that is not in the table.
+     *
+     * @param slot The slot to add, with its distance set for idx.
+     * @param idx The index to start probing from.
+     */
+    void
+    insertSlot(Slot slot, size_t idx)
+    {
+        while (slots[idx].dist != 0) {
+            // Take the place of a slot that is closer to home and
+            // carry on inserting the displaced slot
+            if (slots[idx].dist < slot.dist)
+                std::swap(slot, slots[idx]);
+            idx = next(idx);
+            ++slot.dist;
+        }
+        slots[idx] = slot;
+    }
+
+    /** Remove a slot, shifting back the slots following it. */
+    void
+    eraseSlot(size_t idx)
+    {
+        assert(idx != NoSlot && slots[idx].dist != 0);
+        for (size_t n = next(idx); slots[n].dist > 1; n = next(n)) {
+            slots[idx] = slots[n];
+            --slots[idx].dist;
+            idx = n;
+        }
+        slots[idx].dist = 0;
+    }
+
+    /** Rebuild the table with the given number of slots. */
+    void
+    resize(size_t num_slots)
+    {
+        assert(isPowerOf2(num_slots) && num_slots <= NoSlot);
+        slots.assign(num_slots, Slot{0, 0, 0});
+        shift = 64 - floorLog2(num_slots);
+        for (uint32_t i = 0; i < entries.size(); ++i) {
+            const uint64_t hash = hashAddr(entries[i].first);
+            insertSlot(Slot{i, fingerprint(hash), 1}, hash >> shift);
+        }
+    }
+
+    /** Densely packed entries. */
+    std::vector<value_type> entries;
+
+    /** Table mapping the addresses to their entries. */
+    std::vector<Slot> slots;
+
+    /** Right shift turning a hash into a slot index. */
+    unsigned shift;
+};
+
+#endif //__MEM_LINE_ADDR_MAP_HH__
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+
+#include "mem/line_addr_map.hh"
+
+/** Entries can be inserted, found and erased. */
+TEST(LineAddrMapTest, InsertFindErase)
+{
+    LineAddrMap<int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.end(), map.find(0x40));
+
+    auto res = map.emplace(0x40, 1);
+    EXPECT_TRUE(res.second);
+    EXPECT_EQ(0x40, res.first->first);
+    EXPECT_EQ(1, res.first->second);
+
+    // A second insertion keeps the existing value
+    res = map.emplace(0x40, 2);
+    EXPECT_FALSE(res.second);
+    EXPECT_EQ(1, res.first->second);
+
+    map[0x81] = 3;
+    EXPECT_EQ(2, map.size());
+    EXPECT_EQ(3, map.find(0x81)->second);
+    EXPECT_EQ(map.end(), map.find(0x80));
+
+    map.erase(map.find(0x40));
+    EXPECT_EQ(map.end(), map.find(0x40));
+    EXPECT_EQ(1, map.erase(Addr(0x81)));
+    EXPECT_EQ(0, map.erase(Addr(0x81)));
+    EXPECT_TRUE(map.empty());
+}
+
+/** The map grows as needed and keeps the load factor bounded. */
+TEST(LineAddrMapTest, Grows)
+{
+    LineAddrMap<Addr> map;
+    const Addr num_lines = 100000;
+    for (Addr i = 0; i < num_lines; i++) {
+        map[i * 64] = i;
+    }
+    EXPECT_EQ(num_lines, map.size());
+    EXPECT_LE(map.size() * 8, map.capacity() * 7);
+    for (Addr i = 0; i < num_lines; i++) {
+        ASSERT_NE(map.end(), map.find(i * 64));
+        EXPECT_EQ(i, map.find(i * 64)->second);
+    }
+    EXPECT_GE(map.memoryUsage(), map.capacity() * sizeof(Addr));
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(0, map.capacity());
+    EXPECT_EQ(map.end(), map.find(0));
+}
+
+/** A random mix of operations behaves as an std::unordered_map. */
+TEST(LineAddrMapTest, MatchesUnorderedMap)
+{
+    std::mt19937_64 rng(1);
+    LineAddrMap<uint64_t> map;
+    std::unordered_map<Addr, uint64_t> ref;
+    for (int i = 0; i < 200000; i++) {
+        // Line addresses with the lowest bit used as a flag, from a
+        // range small enough for frequent hits
+        const Addr addr = ((rng() % 4096) << 6) | (rng() & 1);
+        auto it = map.find(addr);
+        auto ref_it = ref.find(addr);
+        ASSERT_EQ(ref_it == ref.end(), it == map.end());
+        if (it == map.end()) {
+            map.emplace(addr, i);
+            ref.emplace(addr, i);
+        } else {
+            ASSERT_EQ(ref_it->second, it->second);
+            if (rng() % 2) {
+                map.erase(it);
+                ref.erase(ref_it);
+            } else {
+                it->second = ref_it->second = i;
+            }
+        }
+        ASSERT_EQ(ref.size(), map.size());
+    }
+    for (const auto &entry : ref) {
+        ASSERT_NE(map.end(), map.find(entry.first));
+        EXPECT_EQ(entry.second, map.find(entry.first)->second);
+    }
+}
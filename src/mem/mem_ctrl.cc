@@ -55,6 +55,7 @@ MemCtrl::MemCtrl(const MemCtrlParams &p) :
     retryRdReq(false), retryWrReq(false),
     nextReqEvent([this]{ processNextReqEvent(); }, name()),
     respondEvent([this]{ processRespondEvent(); }, name()),
+    analyticalRetryEvent([this]{ processAnalyticalRetryEvent(); }, name()),
     dram(p.dram), nvm(p.nvm),
     readBufferSize((dram ? dram->readBufferSize : 0) +
                    (nvm ? nvm->readBufferSize : 0)),
@@ -67,7 +68,7 @@ MemCtrl::MemCtrl(const MemCtrlParams &p) :
     memSchedPolicy(p.mem_sched_policy),
     frontendLatency(p.static_frontend_latency),
     backendLatency(p.static_backend_latency),
-    commandWindow(p.command_window),
+    commandWindow(p.command_window), analytical(p.analytical_timing),
     nextBurstAt(0), prevArrival(0),
     nextReqTime(0),
     stats(*this)
@@ -84,6 +85,9 @@ MemCtrl::MemCtrl(const MemCtrlParams &p) :
 
     fatal_if(!dram && !nvm, "Memory controller must have an interface");
 
+    fatal_if(analytical && dram && nvm, "Analytical timing of %s is "
+             "only supported with a single interface\n", name());
+
     // perform a basic check of the write thresholds
     if (p.write_low_thresh_perc >= p.write_high_thresh_perc)
         fatal("Write buffer low threshold %d must be smaller than the "
@@ -431,6 +435,11 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
     }
     prevArrival = curTick();
 
+    // in the analytical timing mode the request is serviced as it
+    // arrives, without going through the queues
+    if (analytical)
+        return recvTimingReqAnalytical(pkt);
+
     // What type of media does this packet access?
     bool is_dram;
     if (dram && dram->getAddrRange().contains(pkt->getAddr())) {
@@ -489,6 +498,98 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
     return true;
 }
 
+bool
+MemCtrl::recvTimingReqAnalytical(PacketPtr pkt)
+{
+    const bool is_read = pkt->isRead();
+    const unsigned size = pkt->getSize();
+    assert(size != 0);
+
+    // there is either a DRAM or an NVM interface in this mode
+    MemInterface* mem = dram ? static_cast<MemInterface*>(dram) : nvm;
+
+    // the bursts booked on the data bus ahead of time are the ones
+    // that would otherwise be waiting in the queues
+    const Tick backlog = mem->analyticalBacklog(is_read ? readBufferSize :
+                                                          writeBufferSize);
+    if (backlog > 0) {
+        DPRINTF(MemCtrl, "%s queue full, not accepting\n",
+                is_read ? "Read" : "Write");
+        // remember that we have to retry this port
+        if (is_read) {
+            retryRdReq = true;
+            stats.numRdRetry++;
+        } else {
+            retryWrReq = true;
+            stats.numWrRetry++;
+        }
+        if (!analyticalRetryEvent.scheduled())
+            schedule(analyticalRetryEvent, curTick() + backlog);
+        return false;
+    }
+
+    // split the pkt in bursts like addToReadQueue and addToWriteQueue
+    const Addr base_addr = pkt->getAddr();
+    const uint32_t burst_size = mem->bytesPerBurst();
+    const unsigned int pkt_count =
+        divCeil((base_addr & (burst_size - 1)) + size, burst_size);
+    Addr addr = base_addr;
+    Tick ready_at = curTick();
+
+    for (int cnt = 0; cnt < pkt_count; ++cnt) {
+        const unsigned burst_bytes = std::min((addr | (burst_size - 1)) + 1,
+                                              base_addr + size) - addr;
+        MemPacket* mem_pkt = mem->decodePacket(pkt, addr, burst_bytes,
+                                               is_read, dram != nullptr);
+        mem_pkt->readyTime = mem->analyticalAccess(mem_pkt);
+        ready_at = std::max(ready_at, mem_pkt->readyTime);
+
+        if (is_read) {
+            stats.readPktSize[ceilLog2(burst_bytes)]++;
+            stats.readBursts++;
+            stats.requestorReadAccesses[pkt->requestorId()]++;
+            stats.requestorReadTotalLat[pkt->requestorId()] +=
+                mem_pkt->readyTime - mem_pkt->entryTime;
+            stats.requestorReadBytes[pkt->requestorId()] += burst_bytes;
+        } else {
+            stats.writePktSize[ceilLog2(burst_bytes)]++;
+            stats.writeBursts++;
+            stats.requestorWriteAccesses[pkt->requestorId()]++;
+            stats.requestorWriteTotalLat[pkt->requestorId()] +=
+                mem_pkt->readyTime - mem_pkt->entryTime;
+            stats.requestorWriteBytes[pkt->requestorId()] += burst_bytes;
+        }
+
+        delete mem_pkt;
+        addr = (addr | (burst_size - 1)) + 1;
+    }
+
+    if (is_read) {
+        stats.readReqs++;
+        stats.bytesReadSys += size;
+        accessAndRespond(pkt, frontendLatency + backendLatency +
+                         ready_at - curTick());
+    } else {
+        // writes are acknowledged once accepted, as they are when
+        // added to the write queue
+        stats.writeReqs++;
+        stats.bytesWrittenSys += size;
+        accessAndRespond(pkt, frontendLatency);
+    }
+
+    return true;
+}
+
+void
+MemCtrl::processAnalyticalRetryEvent()
+{
+    if (retryRdReq || retryWrReq) {
+        retryRdReq = false;
+        retryWrReq = false;
+        port.sendRetryReq();
+    }
+}
+
 void
 MemCtrl::processRespondEvent()
 {
@@ -1437,11 +1538,12 @@ MemCtrl::drainResume()
         // if we switched to timing mode, kick things into action,
         // and behave as if we restored from a checkpoint
         startup();
-        dram->startup();
+        if (dram)
+            dram->startup();
     } else if (isTimingMode && !system()->isTimingMode()) {
         // if we switch from timing mode, stop the refresh events to
         // not cause issues with KVM
-        if (dram)
+        if (dram && !analytical)
             dram->suspend();
     }
 
@@ -55,6 +55,7 @@
 #include "base/callback.hh"
 #include "base/statistics.hh"
 #include "enums/MemSched.hh"
+#include "mem/mem_packet_queue.hh"
 #include "mem/qos/mem_ctrl.hh"
 #include "mem/qport.hh"
 #include "params/MemCtrl.hh"
@@ -205,11 +206,6 @@ class MemPacket
 
 };
 
-// The memory packets are store in a multiple dequeue structure,
-// based on their QoS priority
-typedef std::deque<MemPacket*> MemPacketQueue;
-
-
 /**
  * The memory controller is a single-channel memory controller capturing
  * the most important timing constraints associated with a
@@ -292,6 +288,9 @@ class MemCtrl : public QoS::MemCtrl
     void processRespondEvent();
     EventFunctionWrapper respondEvent;
 
+    void processAnalyticalRetryEvent();
+    EventFunctionWrapper analyticalRetryEvent;
+
     /**
      * Check if the read queue has room for more entries
      *
@@ -339,6 +338,19 @@ class MemCtrl : public QoS::MemCtrl
      */
     void addToWriteQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram);
 
+    /**
+     * Service a request in the analytical timing mode. The pkt is
+     * split in bursts as it would be for the queues, but the memory
+     * interface determines when each of them completes right away,
+     * and the response is scheduled accordingly. Requests are not
+     * accepted while the bursts booked ahead of time would not fit in
+     * the buffers.
+     *
+     * @param pkt The request packet from the outside world
+     * @return true if the request is accepted
+     */
+    bool recvTimingReqAnalytical(PacketPtr pkt);
+
     /**
      * Actually do the burst based on media specific access function.
      * Update bus statistics when complete.
@@ -510,6 +522,12 @@ class MemCtrl : public QoS::MemCtrl
      */
     const Tick commandWindow;
 
+    /**
+     * Compute the timing of the DRAM or NVM analytically at the
+     * arrival of the requests, rather than scheduling their commands
+     */
+    const bool analytical;
+
     /**
      * Till when must we wait before issuing next RD/WR burst?
      */
@@ -693,6 +711,11 @@ class MemCtrl : public QoS::MemCtrl
      */
     bool inWriteBusState(bool next_state) const;
 
+    /**
+     * Is the controller using the analytical timing mode?
+     */
+    bool analyticalTiming() const { return analytical; }
+
     Port &getPort(const std::string &if_name,
                   PortID idx=InvalidPortID) override;
 
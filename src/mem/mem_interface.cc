@@ -47,6 +47,7 @@
 #include "debug/DRAMPower.hh"
 #include "debug/DRAMState.hh"
 #include "debug/NVM.hh"
+#include "mem/frfcfs.hh"
 #include "sim/system.hh"
 
 using namespace Data;
@@ -68,10 +69,22 @@ MemInterface::MemInterface(const MemInterfaceParams &_p)
       tCK(_p.tCK), tCS(_p.tCS), tBURST(_p.tBURST),
       tRTW(_p.tRTW),
       tWTR(_p.tWTR),
+      analyticalCmdAt(0), analyticalCmdRead(true), analyticalCmdRank(0),
       readBufferSize(_p.read_buffer_size),
       writeBufferSize(_p.write_buffer_size)
 {}
 
+Tick
+MemInterface::analyticalBusAt(bool is_read, uint8_t rank) const
+{
+    Tick burst_gap = tBURST;
+    if (analyticalCmdRead != is_read)
+        burst_gap = is_read ? writeToReadDelay() : readToWriteDelay();
+    if (analyticalCmdRank != rank)
+        burst_gap = std::max(burst_gap, rankToRankDelay());
+    return analyticalCmdAt + burst_gap;
+}
+
 void
 MemInterface::setCtrl(MemCtrl* _ctrl, unsigned int command_window)
 {
@@ -168,116 +181,138 @@ MemInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
 std::pair<MemPacketQueue::iterator, Tick>
 DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
 {
-    std::vector<uint32_t> earliest_banks(ranksPerChannel, 0);
+    auto selected = chooseFRFCFS(queue, min_col_at, FRFCFSBanks{*this});
 
-    // Has minBankPrep been called to populate earliest_banks?
-    bool filled_earliest_banks = false;
-    // can the PRE/ACT sequence be done without impacting utlization?
-    bool hidden_bank_prep = false;
-
-    // search for seamless row hits first, if no seamless row hit is
-    // found then determine if there are other packets that can be issued
-    // without incurring additional bus delay due to bank timing
-    // Will select closed rows first to enable more open row possibilies
-    // in future selections
-    bool found_hidden_bank = false;
+    if (selected.first == queue.end()) {
+        DPRINTF(DRAM, "%s no available DRAM ranks found\n", __func__);
+    } else {
+        M5_VAR_USED const MemPacket* pkt = *selected.first;
+        DPRINTF(DRAM, "%s %s in bank %d, rank %d\n", __func__,
+                pkt->row != ranks[pkt->rank]->banks[pkt->bank].openRow ?
+                "Earliest bank packet" :
+                selected.second <= min_col_at ? "Seamless buffer hit" :
+                "Prepped row buffer hit", pkt->bank, pkt->rank);
+    }
 
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
+    return selected;
+}
 
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
+Tick
+DRAMInterface::analyticalAccess(const MemPacket* mem_pkt)
+{
+    Rank& rank_ref = *ranks[mem_pkt->rank];
+    Bank& bank_ref = rank_ref.banks[mem_pkt->bank];
+    const bool is_read = mem_pkt->isRead();
 
-    Tick selected_col_at = MaxTick;
-    auto selected_pkt_it = queue.end();
+    // a refresh precharges all the banks of the rank, and as the
+    // refreshes are not scheduled, assume a row got closed if a
+    // refresh interval ended since the bank was last accessed
+    if (bank_ref.openRow != Bank::NO_ROW &&
+        bank_ref.preAllowedAt / tREFI < curTick() / tREFI) {
+        bank_ref.openRow = Bank::NO_ROW;
+        bank_ref.actAllowedAt = std::max(bank_ref.actAllowedAt,
+                                         bank_ref.preAllowedAt + tRP);
+    }
 
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        MemPacket* pkt = *i;
+    const bool row_hit = bank_ref.openRow == mem_pkt->row;
 
-        // select optimal DRAM packet in Q
-        if (pkt->isDram()) {
-            const Bank& bank = ranks[pkt->rank]->banks[pkt->bank];
-            const Tick col_allowed_at = pkt->isRead() ? bank.rdAllowedAt :
-                                                        bank.wrAllowedAt;
+    if (!row_hit) {
+        // precharge the open row, if any, and activate the new one
+        Tick act_at = std::max(bank_ref.actAllowedAt, curTick());
+        if (bank_ref.openRow != Bank::NO_ROW) {
+            act_at = std::max(act_at, std::max(bank_ref.preAllowedAt,
+                                               curTick()) + tRP);
+        }
 
-            DPRINTF(DRAM, "%s checking DRAM packet in bank %d, row %d\n",
-                    __func__, pkt->bank, pkt->row);
+        // cannot activate more than X times in time window tXAW
+        if (!rank_ref.actTicks.empty()) {
+            if (rank_ref.actTicks.back())
+                act_at = std::max(act_at, rank_ref.actTicks.back() + tXAW);
+            rank_ref.actTicks.pop_back();
+            rank_ref.actTicks.push_front(act_at);
+        }
 
-            // check if rank is not doing a refresh and thus is available,
-            // if not, jump to the next packet
-            if (burstReady(pkt)) {
+        // next activate to any bank in this rank must not happen
+        // before tRRD, or tRRD_L within the same bank group
+        for (auto& b : rank_ref.banks) {
+            const Tick rrd = bankGroupArch && b.bankgr == bank_ref.bankgr ?
+                tRRD_L : tRRD;
+            b.actAllowedAt = std::max(act_at + rrd, b.actAllowedAt);
+        }
 
-                DPRINTF(DRAM,
-                        "%s bank %d - Rank %d available\n", __func__,
-                        pkt->bank, pkt->rank);
+        bank_ref.openRow = mem_pkt->row;
+        bank_ref.bytesAccessed = 0;
+        bank_ref.rowAccesses = 0;
+        bank_ref.preAllowedAt = act_at + tRAS;
+        bank_ref.rdAllowedAt = std::max(act_at + tRCD, bank_ref.rdAllowedAt);
+        bank_ref.wrAllowedAt = std::max(act_at + tRCD, bank_ref.wrAllowedAt);
+    }
 
-                // check if it is a row hit
-                if (bank.openRow == pkt->row) {
-                    // no additional rank-to-rank or same bank-group
-                    // delays, or we switched read/write and might as well
-                    // go for the row hit
-                    if (col_allowed_at <= min_col_at) {
-                        // FCFS within the hits, giving priority to
-                        // commands that can issue seamlessly, without
-                        // additional delay, such as same rank accesses
-                        // and/or different bank-group accesses
-                        DPRINTF(DRAM, "%s Seamless buffer hit\n", __func__);
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        // no need to look through the remaining queue entries
-                        break;
-                    } else if (!found_hidden_bank && !found_prepped_pkt) {
-                        // if we did not find a packet to a closed row that can
-                        // issue the bank commands without incurring delay, and
-                        // did not yet find a packet to a prepped row, remember
-                        // the current one
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        found_prepped_pkt = true;
-                        DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
-                    }
-                } else if (!found_earliest_pkt) {
-                    // if we have not initialised the bank status, do it
-                    // now, and only once per scheduling decisions
-                    if (!filled_earliest_banks) {
-                        // determine entries with earliest bank delay
-                        std::tie(earliest_banks, hidden_bank_prep) =
-                            minBankPrep(queue, min_col_at);
-                        filled_earliest_banks = true;
-                    }
+    // the burst follows the previous one on the data bus
+    const Tick col_allowed_at = is_read ? bank_ref.rdAllowedAt :
+                                          bank_ref.wrAllowedAt;
+    const Tick cmd_at = std::max({col_allowed_at, curTick(),
+                                  analyticalBusAt(is_read, mem_pkt->rank)});
+    const Tick ready_at = cmd_at + tCL + tBURST;
 
-                    // bank is amongst first available banks
-                    // minBankPrep will give priority to packets that can
-                    // issue seamlessly
-                    if (bits(earliest_banks[pkt->rank],
-                             pkt->bank, pkt->bank)) {
-                        found_earliest_pkt = true;
-                        found_hidden_bank = hidden_bank_prep;
-
-                        // give priority to packets that can issue
-                        // bank commands 'behind the scenes'
-                        // any additional delay if any will be due to
-                        // col-to-col command requirements
-                        if (hidden_bank_prep || !found_prepped_pkt) {
-                            selected_pkt_it = i;
-                            selected_col_at = col_allowed_at;
-                        }
-                    }
-                }
-            } else {
-                DPRINTF(DRAM, "%s bank %d - Rank %d not available\n", __func__,
-                        pkt->bank, pkt->rank);
+    // bank group architecture requires longer delays between RD/WR
+    // burst commands to the same bank group
+    if (bankGroupArch) {
+        for (auto& b : rank_ref.banks) {
+            if (b.bankgr == bank_ref.bankgr) {
+                b.rdAllowedAt = std::max(cmd_at + tCCD_L, b.rdAllowedAt);
+                b.wrAllowedAt = std::max(cmd_at + tCCD_L, b.wrAllowedAt);
             }
         }
     }
 
-    if (selected_pkt_it == queue.end()) {
-        DPRINTF(DRAM, "%s no available DRAM ranks found\n", __func__);
+    bank_ref.preAllowedAt = std::max(bank_ref.preAllowedAt,
+                                     is_read ? cmd_at + tRTP :
+                                     ready_at + tWR);
+    bank_ref.bytesAccessed += burstSize;
+    ++bank_ref.rowAccesses;
+
+    // without the queues to look at, the adaptive page policies are
+    // taken as their plain counterparts
+    if (pageMgmt == Enums::close || pageMgmt == Enums::close_adaptive ||
+        bank_ref.rowAccesses == maxAccessesPerRow) {
+        bank_ref.openRow = Bank::NO_ROW;
+        bank_ref.actAllowedAt = std::max(bank_ref.actAllowedAt,
+                                         bank_ref.preAllowedAt + tRP);
     }
 
-    return std::make_pair(selected_pkt_it, selected_col_at);
+    // refresh takes the bus away for tRFC out of every tREFI, so
+    // stretch the bus time of each burst accordingly, and a burst that
+    // runs into a refresh, which is a fraction tRFC / tREFI of them,
+    // waits for half of tRFC on average
+    analyticalCmdAt = cmd_at + tBURST * tRFC / (tREFI - tRFC);
+    analyticalCmdRead = is_read;
+    analyticalCmdRank = mem_pkt->rank;
+    const Tick done_at = ready_at + tRFC * tRFC / (2 * tREFI);
+
+    DPRINTF(DRAM, "Analytical access to addr %lld, rank/bank/row %d %d %d, "
+            "row %s, done at %lld\n", mem_pkt->addr, mem_pkt->rank,
+            mem_pkt->bank, mem_pkt->row, row_hit ? "hit" : "miss", done_at);
+
+    if (is_read) {
+        stats.readBursts++;
+        if (row_hit)
+            stats.readRowHits++;
+        stats.bytesRead += burstSize;
+        stats.perBankRdBursts[mem_pkt->bankId]++;
+
+        stats.totMemAccLat += done_at - mem_pkt->entryTime;
+        stats.totQLat += cmd_at - mem_pkt->entryTime;
+        stats.totBusLat += tBURST;
+    } else {
+        stats.writeBursts++;
+        if (row_hit)
+            stats.writeRowHits++;
+        stats.bytesWritten += burstSize;
+        stats.perBankWrBursts[mem_pkt->bankId]++;
+    }
+
+    return done_at;
 }
 
 void
@@ -612,6 +647,27 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
         bool got_bank_conflict = false;
 
         for (uint8_t i = 0; i < ctrl->numPriorities(); ++i) {
+            // the DRAM packets to the same rank and bank are all amongst
+            // those queued for the bank, NVM packets however carry rank
+            // and bank numbers of their own, and are only found by
+            // looking through the whole queue
+            if (!queue[i].hasNvmPackets()) {
+                for (const auto& e : queue[i].bankPackets(mem_pkt->bankId)) {
+                    if (mem_pkt != (*e.pos)) {
+                        bool same_row = mem_pkt->row == (*e.pos)->row;
+                        got_more_hits |= same_row;
+                        got_bank_conflict |= !same_row;
+                        if (got_more_hits)
+                            break;
+                    }
+                }
+
+                if (got_more_hits)
+                    break;
+
+                continue;
+            }
+
             auto p = queue[i].begin();
             // keep on looking until we find a hit or reach the end of the
             // queue
@@ -882,6 +938,11 @@ DRAMInterface::startup()
         // timestamp offset should be in clock cycles for DRAMPower
         timeStampOffset = divCeil(curTick(), tCK);
 
+        // the analytical timing mode does without the refresh and
+        // power state machines of the ranks
+        if (ctrl->analyticalTiming())
+            return;
+
         for (auto r : ranks) {
             r->startup(curTick() + tREFI - tRP);
         }
@@ -1054,9 +1115,11 @@ DRAMInterface::minBankPrep(const MemPacketQueue& queue,
     // determine if we have queued transactions targetting the
     // bank in question
     std::vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->isDram() && ranks[p->rank]->inRefIdleState())
-            got_waiting[p->bankId] = true;
+    for (uint16_t bank_id = 0; bank_id < queue.numBanks(); ++bank_id) {
+        const auto& pkts = queue.bankPackets(bank_id);
+        if (!pkts.empty() &&
+            ranks[(*pkts.front().pos)->rank]->inRefIdleState())
+            got_waiting[bank_id] = true;
     }
 
     // Find command with optimal bank timing
@@ -2426,6 +2489,77 @@ NVMInterface::doBurstAccess(MemPacket* pkt, Tick next_burst_at)
     return std::make_pair(cmd_at, cmd_at + tBURST);
 }
 
+Tick
+NVMInterface::analyticalAccess(const MemPacket* mem_pkt)
+{
+    Bank& bank_ref = ranks[mem_pkt->rank]->banks[mem_pkt->bank];
+    const bool is_read = mem_pkt->isRead();
+
+    // increment the bytes accessed, and sample them when accessing a
+    // new location in this bank, as the detailed model does
+    bank_ref.bytesAccessed += burstSize;
+    const bool new_row = bank_ref.openRow != mem_pkt->row;
+    if (new_row) {
+        bank_ref.openRow = mem_pkt->row;
+        stats.bytesPerBank.sample(bank_ref.bytesAccessed);
+        bank_ref.bytesAccessed = 0;
+    }
+
+    Tick cmd_at = analyticalBusAt(is_read, mem_pkt->rank);
+    if (is_read) {
+        // the read command issues straight away, one per cycle, and
+        // a read from a new location holds off the bank until its data
+        // is buffered, after which the data can be sent
+        const Tick rd_at = std::max(curTick(), nextReadAt);
+        nextReadAt = rd_at + tCK;
+        if (new_row)
+            bank_ref.actAllowedAt = std::max(rd_at, bank_ref.actAllowedAt) +
+                tREAD;
+        cmd_at = std::max({cmd_at, rd_at, bank_ref.actAllowedAt});
+    } else {
+        // the write waits for room in the buffer of the media
+        // controller, which holds it until it completes
+        cmd_at = std::max(cmd_at, curTick());
+        while (!analyticalWrites.empty() && analyticalWrites.top() <= cmd_at)
+            analyticalWrites.pop();
+        if (analyticalWrites.size() >= maxPendingWrites) {
+            cmd_at = analyticalWrites.top();
+            analyticalWrites.pop();
+        }
+    }
+
+    const Tick ready_at = cmd_at + tSEND + tBURST;
+    analyticalCmdAt = cmd_at;
+    analyticalCmdRead = is_read;
+    analyticalCmdRank = mem_pkt->rank;
+
+    DPRINTF(NVM, "Analytical access to addr %lld, rank/bank/row %d %d %d, "
+            "ready at %lld\n", mem_pkt->addr, mem_pkt->rank, mem_pkt->bank,
+            mem_pkt->row, ready_at);
+
+    if (is_read) {
+        stats.readBursts++;
+        stats.bytesRead += burstSize;
+        stats.perBankRdBursts[mem_pkt->bankId]++;
+
+        stats.totMemAccLat += ready_at - mem_pkt->entryTime;
+        stats.totBusLat += tBURST;
+        stats.totQLat += cmd_at - mem_pkt->entryTime;
+    } else {
+        // the write occupies the bank until it completes, and accesses
+        // to the same bank are serialised behind it
+        bank_ref.actAllowedAt = std::max(ready_at, bank_ref.actAllowedAt) +
+            tWRITE;
+        analyticalWrites.push(bank_ref.actAllowedAt);
+
+        stats.writeBursts++;
+        stats.bytesWritten += burstSize;
+        stats.perBankWrBursts[mem_pkt->bankId]++;
+    }
+
+    return ready_at;
+}
+
 void
 NVMInterface::processWriteRespondEvent()
 {
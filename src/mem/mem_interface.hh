@@ -47,6 +47,8 @@
 #define __MEM_INTERFACE_HH__
 
 #include <deque>
+#include <functional>
+#include <queue>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -161,6 +163,31 @@ class MemInterface : public AbstractMemory
      */
     Tick rankToRankDelay() const { return tBURST + tCS; }
 
+    /*
+     * @return time to send a burst of data without gaps
+     */
+    virtual Tick burstDelay() const { return tBURST; }
+
+    /**
+     * Last burst command of the analytical timing mode, along with its
+     * direction and rank, which the next burst is serialised against
+     * on the data bus.
+     */
+    Tick analyticalCmdAt;
+    bool analyticalCmdRead;
+    uint8_t analyticalCmdRank;
+
+    /**
+     * Determine when a burst can follow the last one on the data bus
+     * in the analytical timing mode, taking the read/write turnaround
+     * and rank switching into account.
+     *
+     * @param is_read Is the burst a read
+     * @param rank Rank of the burst
+     * @return Tick from which the burst command can issue
+     */
+    Tick analyticalBusAt(bool is_read, uint8_t rank) const;
+
 
   public:
 
@@ -288,6 +315,33 @@ class MemInterface : public AbstractMemory
      */
     virtual void addRankToRankDelay(Tick cmd_at) = 0;
 
+    /**
+     * Access a burst in the analytical timing mode. Rather than
+     * scheduling the individual commands, determine when the burst
+     * completes as soon as it arrives, and update the timing of the
+     * interface to account for it.
+     *
+     * @param mem_pkt The burst to access
+     * @return Tick when the data of the burst is transferred
+     */
+    virtual Tick analyticalAccess(const MemPacket* mem_pkt) = 0;
+
+    /**
+     * Determine how long until no more than a given number of bursts
+     * are booked on the data bus ahead of time in the analytical
+     * timing mode.
+     *
+     * @param max_bursts Number of bursts that may be booked ahead
+     * @return Time to wait, zero if there is room for another burst
+     */
+    Tick
+    analyticalBacklog(unsigned int max_bursts) const
+    {
+        const Tick max_cmd_at = curTick() + max_bursts * burstDelay();
+        return analyticalCmdAt > max_cmd_at ? analyticalCmdAt - max_cmd_at :
+                                              0;
+    }
+
     typedef MemInterfaceParams Params;
     MemInterface(const Params &_p);
 };
@@ -872,11 +926,40 @@ class DRAMInterface : public MemInterface
     std::pair<std::vector<uint32_t>, bool>
     minBankPrep(const MemPacketQueue& queue, Tick min_col_at) const;
 
+    /**
+     * The bank state the FR-FCFS choice of chooseFRFCFS() depends on.
+     */
+    struct FRFCFSBanks
+    {
+        const DRAMInterface& dram;
+
+        bool burstReady(MemPacket* pkt) const { return dram.burstReady(pkt); }
+
+        uint32_t
+        openRow(const MemPacket* pkt) const
+        {
+            return dram.ranks[pkt->rank]->banks[pkt->bank].openRow;
+        }
+
+        Tick
+        colAllowedAt(const MemPacket* pkt) const
+        {
+            const Bank& bank = dram.ranks[pkt->rank]->banks[pkt->bank];
+            return pkt->isRead() ? bank.rdAllowedAt : bank.wrAllowedAt;
+        }
+
+        std::pair<std::vector<uint32_t>, bool>
+        minBankPrep(const MemPacketQueue& queue, Tick min_col_at) const
+        {
+            return dram.minBankPrep(queue, min_col_at);
+        }
+    };
+
     /*
      * @return time to send a burst of data without gaps
      */
     Tick
-    burstDelay() const
+    burstDelay() const override
     {
         return (burstInterleave ? tBURST_MAX / 2 : tBURST);
     }
@@ -960,6 +1043,18 @@ class DRAMInterface : public MemInterface
     doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
                   const std::vector<MemPacketQueue>& queue);
 
+    /**
+     * Access a burst in the analytical timing mode, based on the open
+     * row and the timing of its bank, the activation limits of its
+     * rank, and the bursts already booked on the data bus. Refresh is
+     * not scheduled either, but accounted for as the bandwidth it takes
+     * away and the average delay it adds.
+     *
+     * @param mem_pkt The burst to access
+     * @return Tick when the data of the burst is transferred
+     */
+    Tick analyticalAccess(const MemPacket* mem_pkt) override;
+
     /**
      * Check if a burst operation can be issued to the DRAM
      *
@@ -1123,6 +1218,13 @@ class NVMInterface : public MemInterface
 
     std::deque<Tick> readReadyQueue;
 
+    /**
+     * Completion ticks of the writes held in the buffer of the media
+     * controller in the analytical timing mode, earliest first.
+     */
+    std::priority_queue<Tick, std::vector<Tick>, std::greater<Tick>>
+        analyticalWrites;
+
     /**
      * Check if the write response queue is empty
      *
@@ -1256,6 +1358,17 @@ class NVMInterface : public MemInterface
     std::pair<Tick, Tick>
     doBurstAccess(MemPacket* pkt, Tick next_burst_at);
 
+    /**
+     * Access a burst in the analytical timing mode. A read is issued
+     * as it arrives and its data sent once buffered in the bank, and
+     * a write is sent as soon as the buffer of the media controller
+     * has room for it. Both are serialised on the data bus.
+     *
+     * @param mem_pkt The burst to access
+     * @return Tick when the data of the burst is transferred
+     */
+    Tick analyticalAccess(const MemPacket* mem_pkt) override;
+
     NVMInterface(const NVMInterfaceParams &_p);
 };
 
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/mem_packet_queue.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "mem/mem_ctrl.hh"
+
+const MemPacketQueue::BankPackets MemPacketQueue::noPackets;
+
+void
+MemPacketQueue::push_back(MemPacket* pkt)
+{
+    iterator pos = packets.insert(packets.end(), pkt);
+
+    if (pkt->isDram()) {
+        if (pkt->bankId >= banks.size())
+            banks.resize(pkt->bankId + 1);
+        banks[pkt->bankId].push_back({nextSeq, pos});
+    } else {
+        ++nvmPackets;
+    }
+
+    ++nextSeq;
+}
+
+MemPacketQueue::iterator
+MemPacketQueue::erase(iterator pos)
+{
+    MemPacket* pkt = *pos;
+
+    if (pkt->isDram()) {
+        // the packets leaving the queue are mostly amongst the oldest
+        // of their bank, so search from the front
+        BankPackets& bank = banks[pkt->bankId];
+        auto it = std::find_if(bank.begin(), bank.end(),
+                               [pos](const BankEntry& e)
+                               { return e.pos == pos; });
+        assert(it != bank.end());
+        bank.erase(it);
+    } else {
+        assert(nvmPackets > 0);
+        --nvmPackets;
+    }
+
+    return packets.erase(pos);
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * MemPacketQueue declaration
+ */
+
+#ifndef __MEM_MEM_PACKET_QUEUE_HH__
+#define __MEM_MEM_PACKET_QUEUE_HH__
+
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <vector>
+
+class MemPacket;
+
+/**
+ * A queue of memory packets, kept in arrival order for FCFS
+ * arbitration. Next to the arrival order, the DRAM packets are indexed
+ * per bank, so that the FR-FCFS scheduler can find the oldest row hit
+ * and the oldest row miss of every bank by visiting the banks rather
+ * than every packet in the queue. The controller holds one of these
+ * queues per QoS priority for both reads and writes.
+ */
+class MemPacketQueue
+{
+  private:
+
+    typedef std::list<MemPacket*> Container;
+
+  public:
+
+    typedef Container::iterator iterator;
+    typedef Container::const_iterator const_iterator;
+
+    /**
+     * Position of a DRAM packet in the queue, along with its arrival
+     * order, which lets the scheduler compare packets across banks.
+     */
+    struct BankEntry
+    {
+        uint64_t seq;
+        iterator pos;
+    };
+
+    typedef std::deque<BankEntry> BankPackets;
+
+    MemPacketQueue() : nextSeq(0), nvmPackets(0) {}
+
+    /**
+     * The per-bank index points into the packet list. Moving the list
+     * keeps these iterators valid, copying it would not.
+     */
+    MemPacketQueue(const MemPacketQueue&) = delete;
+    MemPacketQueue& operator=(const MemPacketQueue&) = delete;
+    MemPacketQueue(MemPacketQueue&&) = default;
+    MemPacketQueue& operator=(MemPacketQueue&&) = default;
+
+    iterator begin() { return packets.begin(); }
+    iterator end() { return packets.end(); }
+    const_iterator begin() const { return packets.begin(); }
+    const_iterator end() const { return packets.end(); }
+
+    size_t size() const { return packets.size(); }
+    bool empty() const { return packets.empty(); }
+
+    /**
+     * Add a packet to the back of the queue.
+     */
+    void push_back(MemPacket* pkt);
+
+    /**
+     * Remove a packet from the queue.
+     *
+     * @param pos Position of the packet to remove
+     * @return Position of the packet following the removed one
+     */
+    iterator erase(iterator pos);
+
+    /**
+     * Number of banks the per-bank index covers. Banks with an id
+     * beyond this have no packets in the queue.
+     */
+    size_t numBanks() const { return banks.size(); }
+
+    /**
+     * Get the DRAM packets queued for a bank, in arrival order.
+     *
+     * @param bank_id Bank id across all ranks, as in MemPacket::bankId
+     */
+    const BankPackets&
+    bankPackets(uint16_t bank_id) const
+    {
+        return bank_id < banks.size() ? banks[bank_id] : noPackets;
+    }
+
+    /**
+     * Does the queue hold any NVM packets? These are not part of the
+     * per-bank index.
+     */
+    bool hasNvmPackets() const { return nvmPackets != 0; }
+
+  private:
+
+    /** All packets in arrival order */
+    Container packets;
+
+    /** DRAM packets per bank id, in arrival order */
+    std::vector<BankPackets> banks;
+
+    /** Arrival order of the next packet added */
+    uint64_t nextSeq;
+
+    /** Number of NVM packets in the queue */
+    size_t nvmPackets;
+
+    /** Packets of the banks outside the index */
+    static const BankPackets noPackets;
+};
+
+#endif //__MEM_MEM_PACKET_QUEUE_HH__
@@ -317,6 +317,10 @@ class Packet : public Printable
         /// the packet is destroyed. The pointer is assumed to be pointing
         /// to an array, and delete [] is consequently called
         DYNAMIC_DATA           = 0x00002000,
+        /// The dynamic data is held in the buffer embedded in the
+        /// packet rather than in a separate allocation, and must not
+        /// be deleted
+        INLINE_DATA            = 0x00004000,
 
         /// suppress the error if this packet encounters a functional
         /// access failure.
@@ -324,7 +328,11 @@ class Packet : public Printable
 
         // Signal block present to squash prefetch and cache evict packets
         // through express snoop flag
-        BLOCK_CACHED          = 0x00010000
+        BLOCK_CACHED          = 0x00010000,
+
+        // Functional announcement of a block that a cache restored from
+        // a checkpoint, for the snoop filters below it
+        RESTORED_BLOCK         = 0x00020000
     };
 
     Flags flags;
@@ -350,6 +358,41 @@ class Packet : public Printable
     */
     PacketDataPtr data;
 
+    /**
+     * Buffer for the data of packets whose payload is no larger than
+     * a typical cache line, saving the allocation otherwise done by
+     * allocate(). The data is accessed through dataPtr() rather than
+     * by pointing the data pointer at the buffer, so that a copy of
+     * the packet refers to its own buffer.
+     */
+    alignas(uint64_t) uint8_t inlineData[64];
+
+    /** Block of the free list of recycled packets. */
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    /**
+     * Free list of the calling thread. As for requests, the blocks
+     * still on the list when the thread exits are left to the
+     * operating system.
+     */
+    static FreeBlock *&
+    freeList()
+    {
+        static thread_local FreeBlock *head = nullptr;
+        return head;
+    }
+
+    /** Pointer to the data, wherever it is held. */
+    PacketDataPtr
+    dataPtr() const
+    {
+        return flags.isSet(INLINE_DATA) ?
+            const_cast<PacketDataPtr>(inlineData) : data;
+    }
+
     /// The address of the request.  This address could be virtual or
     /// physical, depending on the system configuration.
     Addr addr;
@@ -721,6 +764,20 @@ class Packet : public Printable
     bool isBlockCached() const     { return flags.isSet(BLOCK_CACHED); }
     void clearBlockCached()        { flags.clear(BLOCK_CACHED); }
 
+    /**
+     * Set on the functional reads with which a cache announces the
+     * blocks it restored from a checkpoint. The crossbars on the way
+     * to memory record the cache as a holder in their snoop filters,
+     * and neither they nor the caches below satisfy or snoop the read.
+     */
+    void
+    setRestoredBlock()
+    {
+        assert(isRead());
+        flags.set(RESTORED_BLOCK);
+    }
+    bool isRestoredBlock() const { return flags.isSet(RESTORED_BLOCK); }
+
     /**
      * QoS Value getter
      * Returns 0 if QoS value was never set (constructor default).
@@ -997,6 +1054,37 @@ class Packet : public Printable
         deleteData();
     }
 
+    /**
+     * Packets are allocated from and released to a free list of the
+     * calling thread, as they are created and destroyed at a high
+     * rate throughout the memory system.
+     * @{
+     */
+    static void *
+    operator new(size_t size)
+    {
+        FreeBlock *&head = freeList();
+        if (size != sizeof(Packet) || !head)
+            return ::operator new(size);
+        FreeBlock *block = head;
+        head = block->next;
+        return block;
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        if (size != sizeof(Packet)) {
+            ::operator delete(p);
+            return;
+        }
+        FreeBlock *&head = freeList();
+        FreeBlock *block = static_cast<FreeBlock *>(p);
+        block->next = head;
+        head = block;
+    }
+    /** @} */
+
     /**
      * Take a request packet and modify it in place to be suitable for
      * returning as a response to that request.
@@ -1159,7 +1247,7 @@ class Packet : public Printable
     {
         assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
         assert(!isMaskedWrite());
-        return (T*)data;
+        return (T*)dataPtr();
     }
 
     template <typename T>
@@ -1167,7 +1255,7 @@ class Packet : public Printable
     getConstPtr() const
     {
         assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
-        return (const T*)data;
+        return (const T*)dataPtr();
     }
 
     /**
@@ -1288,14 +1376,17 @@ class Packet : public Printable
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
+        if (flags.isSet(DYNAMIC_DATA) && flags.noneSet(INLINE_DATA))
             delete [] data;
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(STATIC_DATA|DYNAMIC_DATA|INLINE_DATA);
         data = NULL;
     }
 
-    /** Allocate memory for the packet. */
+    /**
+     * Allocate memory for the packet. Payloads that fit are held in
+     * the buffer embedded in the packet.
+     */
     void
     allocate()
     {
@@ -1304,7 +1395,10 @@ class Packet : public Printable
         if (hasData() || hasRespData()) {
             assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
             flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            if (getSize() <= sizeof(inlineData))
+                flags.set(INLINE_DATA);
+            else
+                data = new uint8_t[getSize()];
         }
     }
 
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+
+// Instantiate the fake class to have a valid curTick of 0
+GTestTickHandler tickHandler;
+
+namespace
+{
+
+/** Make a request for size bytes at addr with a physical address. */
+RequestPtr
+makeReq(Addr addr, unsigned size)
+{
+    return std::make_shared<Request>(addr, size, 0, 0);
+}
+
+/** Check if the data of pkt is held in the packet itself. */
+bool
+dataInPacket(Packet *pkt)
+{
+    const uint8_t *p = pkt->getConstPtr<uint8_t>();
+    const uint8_t *start = reinterpret_cast<const uint8_t *>(pkt);
+    return p >= start && p < start + sizeof(Packet);
+}
+
+/** Fill the data of pkt with a pattern starting at seed. */
+void
+fill(Packet *pkt, uint8_t seed)
+{
+    uint8_t *p = pkt->getPtr<uint8_t>();
+    for (unsigned i = 0; i < pkt->getSize(); i++)
+        p[i] = seed + i;
+}
+
+/** Check that the data of pkt holds the pattern starting at seed. */
+void
+expectFilled(Packet *pkt, uint8_t seed)
+{
+    const uint8_t *p = pkt->getConstPtr<uint8_t>();
+    for (unsigned i = 0; i < pkt->getSize(); i++)
+        ASSERT_EQ(uint8_t(seed + i), p[i]) << "byte " << i;
+}
+
+} // anonymous namespace
+
+/** Payloads of up to 64 bytes are held in the packet. */
+TEST(PacketDataTest, InlineData)
+{
+    for (unsigned size : {1, 8, 64}) {
+        PacketPtr pkt = new Packet(makeReq(0x1000, size), MemCmd::WriteReq);
+        pkt->allocate();
+        EXPECT_TRUE(dataInPacket(pkt)) << size;
+        fill(pkt, size);
+        expectFilled(pkt, size);
+        delete pkt;
+    }
+}
+
+/** Larger payloads are allocated separately. */
+TEST(PacketDataTest, HeapData)
+{
+    PacketPtr pkt = new Packet(makeReq(0x1000, 128), MemCmd::WriteReq);
+    pkt->allocate();
+    EXPECT_FALSE(dataInPacket(pkt));
+    fill(pkt, 3);
+    expectFilled(pkt, 3);
+    delete pkt;
+}
+
+/** Static and dynamic data are used where they are. */
+TEST(PacketDataTest, StaticAndDynamicData)
+{
+    std::vector<uint8_t> buf(16, 0xa5);
+    PacketPtr pkt = new Packet(makeReq(0x1000, 16), MemCmd::ReadReq);
+    pkt->dataStatic(buf.data());
+    EXPECT_EQ(buf.data(), pkt->getConstPtr<uint8_t>());
+    pkt->makeResponse();
+    fill(pkt, 7);
+    expectFilled(pkt, 7);
+    EXPECT_EQ(uint8_t(7), buf[0]);
+    delete pkt;
+    EXPECT_EQ(uint8_t(7 + 15), buf[15]);
+
+    const uint8_t cbuf[4] = {1, 2, 3, 4};
+    pkt = new Packet(makeReq(0x1000, 4), MemCmd::WriteReq);
+    pkt->dataStaticConst(cbuf);
+    EXPECT_EQ(cbuf, pkt->getConstPtr<uint8_t>());
+    delete pkt;
+
+    uint8_t *dyn = new uint8_t[8];
+    pkt = new Packet(makeReq(0x1000, 8), MemCmd::WriteReq);
+    pkt->dataDynamic(dyn);
+    EXPECT_EQ(dyn, pkt->getConstPtr<uint8_t>());
+    // The packet deletes the data
+    delete pkt;
+}
+
+/** deleteData() releases any kind of data and allows new data. */
+TEST(PacketDataTest, DeleteData)
+{
+    std::vector<uint8_t> buf(32);
+    for (unsigned size : {32, 256}) {
+        PacketPtr pkt = new Packet(makeReq(0x1000, size), MemCmd::WriteReq);
+        pkt->allocate();
+        fill(pkt, 1);
+        pkt->deleteData();
+
+        // Inline data is replaced by heap data and the other way round
+        if (size == 32) {
+            pkt->dataDynamic(new uint8_t[size]);
+            EXPECT_FALSE(dataInPacket(pkt));
+        } else {
+            pkt->dataStatic(buf.data());
+            EXPECT_EQ(buf.data(), pkt->getConstPtr<uint8_t>());
+        }
+        pkt->deleteData();
+        pkt->allocate();
+        EXPECT_EQ(size == 32, dataInPacket(pkt));
+        fill(pkt, 9);
+        expectFilled(pkt, 9);
+        delete pkt;
+    }
+}
+
+/** Copies of a packet get their own data unless it is static. */
+TEST(PacketDataTest, CopyingConstructor)
+{
+    for (unsigned size : {64, 128}) {
+        PacketPtr pkt = new Packet(makeReq(0x2000, size), MemCmd::WriteReq);
+        pkt->allocate();
+        fill(pkt, 5);
+
+        PacketPtr copy = new Packet(pkt, false, true);
+        EXPECT_NE(pkt->getConstPtr<uint8_t>(), copy->getConstPtr<uint8_t>());
+        EXPECT_EQ(size <= 64, dataInPacket(copy));
+        copy->setData(pkt->getConstPtr<uint8_t>());
+        fill(pkt, 50);
+        expectFilled(copy, 5);
+
+        // Without data the copy only carries the header
+        PacketPtr snoop = new Packet(pkt, true, false);
+        EXPECT_EQ(pkt->getAddr(), snoop->getAddr());
+        EXPECT_EQ(size, snoop->getSize());
+
+        delete pkt;
+        expectFilled(copy, 5);
+        delete copy;
+        delete snoop;
+    }
+
+    std::vector<uint8_t> buf(8);
+    PacketPtr pkt = new Packet(makeReq(0x2000, 8), MemCmd::ReadReq);
+    pkt->dataStatic(buf.data());
+    PacketPtr copy = new Packet(pkt, false, true);
+    EXPECT_EQ(buf.data(), copy->getConstPtr<uint8_t>());
+    delete copy;
+    delete pkt;
+}
+
+/** An implicit copy of a packet refers to its own inline data. */
+TEST(PacketDataTest, ImplicitCopy)
+{
+    PacketPtr pkt = new Packet(makeReq(0x3000, 8), MemCmd::WriteReq);
+    pkt->allocate();
+    fill(pkt, 11);
+    {
+        Packet copy = *pkt;
+        EXPECT_TRUE(dataInPacket(&copy));
+        expectFilled(&copy, 11);
+        fill(pkt, 22);
+        expectFilled(&copy, 11);
+        // The destructor of the copy must not free anything
+    }
+    expectFilled(pkt, 22);
+    delete pkt;
+}
+
+/** The storage of deleted packets is reused for new ones. */
+TEST(PacketDataTest, FreeListReuse)
+{
+    RequestPtr req = makeReq(0x4000, 64);
+    PacketPtr a = new Packet(req, MemCmd::ReadReq);
+    PacketPtr b = new Packet(req, MemCmd::ReadReq);
+    EXPECT_NE(a, b);
+    delete a;
+    delete b;
+
+    // The list is last in first out
+    PacketPtr c = new Packet(req, MemCmd::ReadReq);
+    PacketPtr d = new Packet(req, MemCmd::ReadReq);
+    EXPECT_EQ(b, c);
+    EXPECT_EQ(a, d);
+
+    // A recycled packet starts out without data
+    c->allocate();
+    fill(c, 0);
+    delete c;
+    PacketPtr e = new Packet(req, MemCmd::WriteReq);
+    EXPECT_EQ(c, e);
+    e->allocate();
+    EXPECT_TRUE(dataInPacket(e));
+    fill(e, 1);
+    expectFilled(e, 1);
+    delete e;
+    delete d;
+}
@@ -50,7 +50,7 @@ Packet::getRaw() const
 {
     assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
     assert(sizeof(T) <= size);
-    return *(T*)data;
+    return *(T*)dataPtr();
 }
 
 template <typename T>
@@ -59,7 +59,7 @@ Packet::setRaw(T v)
 {
     assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
     assert(sizeof(T) <= size);
-    *(T*)data = v;
+    *(T*)dataPtr() = v;
 }
 
 
@@ -128,10 +128,20 @@ PacketQueue::schedSendTiming(PacketPtr pkt, Tick when)
     // ourselves again before we had a chance to update waitingOnRetry
     // assert(waitingOnRetry || sendEvent.scheduled());
 
-    // this belongs in the middle somewhere, so search from the end to
-    // order by tick; however, if forceOrder is set, also make sure
-    // not to re-order in front of some existing packet with the same
-    // address
+    // in the common case the packet goes at the end, either as it is
+    // due no earlier than the last packet, or as the last packet has
+    // the same address and forceOrder is set
+    if (!transmitList.empty() &&
+        (transmitList.back().tick <= when ||
+         (forceOrder && transmitList.back().pkt->matchAddr(pkt)))) {
+        transmitList.emplace_back(when, pkt);
+        return;
+    }
+
+    // otherwise, this belongs in the middle somewhere, so search from
+    // the end to order by tick; however, if forceOrder is set, also
+    // make sure not to re-order in front of some existing packet with
+    // the same address
     auto it = transmitList.end();
     while (it != transmitList.begin()) {
         --it;
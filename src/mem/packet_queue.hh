@@ -49,7 +49,7 @@
  * for the flow control of the port.
  */
 
-#include <list>
+#include <deque>
 
 #include "mem/port.hh"
 #include "sim/drain.hh"
@@ -72,7 +72,14 @@ class PacketQueue : public Drainable
         {}
     };
 
-    typedef std::list<DeferredPacket> DeferredPacketList;
+    /**
+     * The outgoing packets are kept in a deque rather than a list, as
+     * packets are almost always added at the back and taken off the
+     * front, which a deque does without allocating a node for each
+     * packet. Packets that have to go in the middle are inserted by
+     * moving the packets after them, of which there are few.
+     */
+    typedef std::deque<DeferredPacket> DeferredPacketList;
 
     /** A list of outgoing packets. */
     DeferredPacketList transmitList;
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/probes/sampled_stack_dist.hh"
+
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
+#include "params/SampledStackDistProbe.hh"
+#include "sim/system.hh"
+
+SampledStackDistProbe::SampledStackDistProbe(
+        const SampledStackDistProbeParams &p)
+    : BaseMemProbe(p),
+      system(p.system),
+      lineSize(p.line_size),
+      perRequestor(p.per_requestor),
+      sampleRate(p.sample_rate),
+      maxSamples(p.max_samples),
+      numSizes(p.num_sizes),
+      hashSeed(p.hash_seed),
+      totalCalc(sampleRate, maxSamples, numSizes, hashSeed),
+      stats(this)
+{
+    fatal_if(system->cacheLineSize() > lineSize,
+             "The sampled stack distance probe must use a cache line size "
+             "that is larger or equal to the system's cache line size.");
+    fatal_if(!isPowerOf2(lineSize), "The line size must be a power of 2.");
+    fatal_if(sampleRate <= 0 || sampleRate > 1,
+             "The sample rate must be in (0, 1].");
+    fatal_if(maxSamples == 0, "At least one line must be sampled.");
+    fatal_if(numSizes == 0 || numSizes > 48,
+             "The number of cache sizes must be in [1, 48].");
+}
+
+SampledStackDistCalc &
+SampledStackDistProbe::requestorCalc(RequestorID id)
+{
+    if (id >= requestorCalcs.size())
+        requestorCalcs.resize(id + 1);
+
+    auto &calc = requestorCalcs[id];
+    if (!calc) {
+        calc.reset(new SampledStackDistCalc(sampleRate, maxSamples,
+                                            numSizes, hashSeed));
+    }
+    return *calc;
+}
+
+void
+SampledStackDistProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
+{
+    // only capturing read and write requests (which allocate in the
+    // cache)
+    if (!pkt_info.cmd.isRead() && !pkt_info.cmd.isWrite())
+        return;
+
+    // Align the address to a cache line size
+    const Addr aligned_addr(roundDown(pkt_info.addr, lineSize));
+
+    totalCalc.access(aligned_addr);
+    if (perRequestor)
+        requestorCalc(pkt_info.id).access(aligned_addr);
+}
+
+SampledStackDistProbe::
+SampledStackDistProbeStats::SampledStackDistProbeStats(
+        SampledStackDistProbe *parent)
+    : Stats::Group(parent),
+      probe(*parent),
+      ADD_STAT(missRatio, UNIT_RATIO,
+               "Estimated miss ratio of a fully associative LRU cache"),
+      ADD_STAT(missRatioError, UNIT_RATIO,
+               "Standard error of the estimated miss ratio"),
+      ADD_STAT(sampleRate, UNIT_RATIO, "Fraction of the lines sampled"),
+      ADD_STAT(references, UNIT_COUNT, "Number of references")
+{
+}
+
+void
+SampledStackDistProbe::SampledStackDistProbeStats::regStats()
+{
+    using namespace Stats;
+
+    Stats::Group::regStats();
+
+    // One row for each requestor, if enabled, and a last one for all
+    // the requests
+    System *sys = probe.system;
+    const auto max_requestors = probe.perRequestor ?
+        sys->maxRequestors() : 0;
+    const unsigned num_sizes = probe.numSizes;
+
+    missRatio
+        .init(max_requestors + 1, num_sizes)
+        .flags(nozero | nonan)
+        ;
+    missRatioError
+        .init(max_requestors + 1, num_sizes)
+        .flags(nozero | nonan)
+        ;
+    sampleRate
+        .init(max_requestors + 1)
+        .flags(nozero | nonan)
+        ;
+    references
+        .init(max_requestors + 1)
+        .flags(nozero)
+        ;
+
+    for (int i = 0; i < max_requestors; i++) {
+        const std::string name = sys->getRequestorName(i);
+        missRatio.subname(i, name);
+        missRatioError.subname(i, name);
+        sampleRate.subname(i, name);
+        references.subname(i, name);
+    }
+    missRatio.subname(max_requestors, "total");
+    missRatioError.subname(max_requestors, "total");
+    sampleRate.subname(max_requestors, "total");
+    references.subname(max_requestors, "total");
+
+    // Name the columns after the size of the cache
+    for (unsigned j = 0; j < num_sizes; j++) {
+        const uint64_t bytes = uint64_t(probe.lineSize) << j;
+        std::string size;
+        if (bytes >= (1ULL << 30))
+            size = csprintf("%dGiB", bytes >> 30);
+        else if (bytes >= (1ULL << 20))
+            size = csprintf("%dMiB", bytes >> 20);
+        else if (bytes >= (1ULL << 10))
+            size = csprintf("%dKiB", bytes >> 10);
+        else
+            size = csprintf("%dB", bytes);
+        missRatio.ysubname(j, size);
+        missRatioError.ysubname(j, size);
+    }
+}
+
+void
+SampledStackDistProbe::SampledStackDistProbeStats::preDumpStats()
+{
+    Stats::Group::preDumpStats();
+
+    // The curves are only computed from the histograms of the
+    // calculators when the stats are dumped
+    auto fill = [this](size_t row, const SampledStackDistCalc &calc) {
+        for (unsigned j = 0; j < probe.numSizes; j++) {
+            missRatio[row][j] = calc.missRatio(j);
+            missRatioError[row][j] = calc.missRatioError(j);
+        }
+        sampleRate[row] = calc.rate();
+        references[row] = calc.references();
+    };
+
+    const size_t total_row = sampleRate.size() - 1;
+    for (size_t i = 0; i < total_row && i < probe.requestorCalcs.size();
+         i++) {
+        if (probe.requestorCalcs[i])
+            fill(i, *probe.requestorCalcs[i]);
+    }
+    fill(total_row, probe.totalCalc);
+}
+
+void
+SampledStackDistProbe::SampledStackDistProbeStats::resetStats()
+{
+    Stats::Group::resetStats();
+
+    probe.totalCalc.reset();
+    for (auto &calc : probe.requestorCalcs) {
+        if (calc)
+            calc->reset();
+    }
+}
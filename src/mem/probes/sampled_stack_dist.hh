@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_PROBES_SAMPLED_STACK_DIST_HH__
+#define __MEM_PROBES_SAMPLED_STACK_DIST_HH__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mem/probes/base.hh"
+#include "mem/sampled_stack_dist_calc.hh"
+#include "sim/stats.hh"
+
+struct SampledStackDistProbeParams;
+class System;
+
+/**
+ * Probe that builds miss ratio curves of fully associative LRU caches
+ * from a spatially hashed sample of the lines referenced (SHARDS). In
+ * contrast to the StackDistProbe, the number of lines tracked is
+ * bounded, as is the cost of a reference, so that the probe can be
+ * left attached in every simulation. A curve is built for all the
+ * requests seen, and optionally one for each requestor.
+ */
+class SampledStackDistProbe : public BaseMemProbe
+{
+  public:
+    SampledStackDistProbe(const SampledStackDistProbeParams &params);
+
+  protected:
+    void handleRequest(const ProbePoints::PacketInfo &pkt_info) override;
+
+    /** Get the curve of a requestor, creating it on first use. */
+    SampledStackDistCalc &requestorCalc(RequestorID id);
+
+  protected:
+    System *const system;
+
+    // Cache line size to simulate
+    const unsigned lineSize;
+
+    // Build a curve for each requestor
+    const bool perRequestor;
+
+    // Parameters of the curves, kept to create the requestor curves
+    const double sampleRate;
+    const size_t maxSamples;
+    const unsigned numSizes;
+    const uint64_t hashSeed;
+
+    // Curve of all requests
+    SampledStackDistCalc totalCalc;
+
+    // Curves of the requestors, indexed by requestor id
+    std::vector<std::unique_ptr<SampledStackDistCalc>> requestorCalcs;
+
+    struct SampledStackDistProbeStats : public Stats::Group
+    {
+        SampledStackDistProbeStats(SampledStackDistProbe *parent);
+
+        void regStats() override;
+        void preDumpStats() override;
+        void resetStats() override;
+
+        SampledStackDistProbe &probe;
+
+        // Miss ratio for each requestor and cache size
+        Stats::Vector2d missRatio;
+
+        // Standard error of the miss ratio
+        Stats::Vector2d missRatioError;
+
+        // Fraction of the lines sampled for each requestor
+        Stats::Vector sampleRate;
+
+        // Number of references for each requestor
+        Stats::Vector references;
+    } stats;
+};
+
+#endif //__MEM_PROBES_SAMPLED_STACK_DIST_HH__
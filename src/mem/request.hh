@@ -50,10 +50,13 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <ostream>
+#include <utility>
 #include <vector>
 
 #include "base/amo.hh"
@@ -85,7 +88,130 @@ class Packet;
 class Request;
 class ThreadContext;
 
-typedef std::shared_ptr<Request> RequestPtr;
+/**
+ * Reference counting pointer to a request. Requests are reference counted
+ * intrusively and without atomic operations, like the other reference
+ * counted objects of the simulator (@sa RefCountingPtr), and requests
+ * created with makeRequest() are recycled through a free list of the
+ * thread releasing them.
+ *
+ * For compatibility, a RequestPtr can also be made from a request owned
+ * by a std::shared_ptr, e.g. one created with std::make_shared. Such a
+ * request holds on to a shared pointer to itself for as long as it is
+ * referenced by a RequestPtr, and is released through it, so call sites
+ * can be moved over to makeRequest() one at a time.
+ */
+class RequestPtr
+{
+  private:
+    /** The stored pointer. */
+    Request *data;
+
+    /** Store a pointer and add a reference to it, if valid. */
+    inline void copy(Request *d);
+
+    /**
+     * Drop the reference to the stored request, if any, releasing the
+     * request if it was the last one. The pointer is not cleared.
+     */
+    inline void del();
+
+  public:
+    RequestPtr() : data(nullptr) {}
+    RequestPtr(std::nullptr_t) : data(nullptr) {}
+
+    /**
+     * Take a reference to a request created with new. This is a template,
+     * as for std::shared_ptr, so that NULL is taken as a null pointer
+     * rather than as a request.
+     */
+    template <typename T>
+    explicit RequestPtr(T *d) { copy(d); }
+
+    /** Take a reference to a request owned by a std::shared_ptr. */
+    inline RequestPtr(const std::shared_ptr<Request> &r);
+
+    RequestPtr(const RequestPtr &r) { copy(r.data); }
+    RequestPtr(RequestPtr &&r) : data(r.data) { r.data = nullptr; }
+    ~RequestPtr() { del(); }
+
+    RequestPtr &
+    operator=(const RequestPtr &r)
+    {
+        // Take the new reference before dropping the old one, in case
+        // both are to the same request
+        RequestPtr tmp(r);
+        std::swap(data, tmp.data);
+        return *this;
+    }
+
+    RequestPtr &
+    operator=(RequestPtr &&r)
+    {
+        if (this != &r) {
+            del();
+            data = r.data;
+            r.data = nullptr;
+        }
+        return *this;
+    }
+
+    RequestPtr &operator=(std::nullptr_t) { reset(); return *this; }
+
+    Request *operator->() const { return data; }
+    Request &operator*() const { return *data; }
+    Request *get() const { return data; }
+
+    /** Drop the reference to the stored request. */
+    void reset() { del(); data = nullptr; }
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+inline bool
+operator==(const RequestPtr &l, const RequestPtr &r)
+{
+    return l.get() == r.get();
+}
+
+inline bool
+operator!=(const RequestPtr &l, const RequestPtr &r)
+{
+    return l.get() != r.get();
+}
+
+inline bool
+operator<(const RequestPtr &l, const RequestPtr &r)
+{
+    return std::less<Request *>()(l.get(), r.get());
+}
+
+inline bool operator==(const RequestPtr &l, std::nullptr_t) { return !l; }
+inline bool operator==(std::nullptr_t, const RequestPtr &r) { return !r; }
+inline bool operator!=(const RequestPtr &l, std::nullptr_t) { return !!l; }
+inline bool operator!=(std::nullptr_t, const RequestPtr &r) { return !!r; }
+
+inline std::ostream &
+operator<<(std::ostream &os, const RequestPtr &r)
+{
+    return os << r.get();
+}
+
+namespace std {
+template <>
+struct hash<RequestPtr>
+{
+    size_t
+    operator()(const RequestPtr &r) const
+    {
+        return hash<Request *>()(r.get());
+    }
+};
+} // namespace std
+
+template <typename... Args>
+inline RequestPtr makeRequest(Args&&... args);
+
 typedef uint16_t RequestorID;
 
 class Request
@@ -423,8 +549,71 @@ class Request
     /** The cause for HTM transaction abort */
     HtmFailureFaultCause _htmAbortCause = HtmFailureFaultCause::INVALID;
 
+    /**
+     * Number of RequestPtrs referencing this request. It is not copied
+     * along with the request.
+     */
+    int refCount = 0;
+
+    /**
+     * Shared pointer owning this request, if it was created as one,
+     * held while the request is referenced by a RequestPtr.
+     */
+    std::shared_ptr<Request> sharedOwner;
+
+    friend class RequestPtr;
+
+    /** Block of the free list of recycled requests. */
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    /**
+     * Free list of the calling thread. It is only a pointer, so that it
+     * remains valid while the thread exits; the blocks it still holds
+     * then are left to the operating system.
+     */
+    static FreeBlock *&
+    freeList()
+    {
+        static thread_local FreeBlock *head = nullptr;
+        return head;
+    }
+
   public:
 
+    /**
+     * Requests created with new, and in particular by makeRequest(), are
+     * allocated from and released to the free list of the calling
+     * thread.
+     * @{
+     */
+    static void *
+    operator new(size_t size)
+    {
+        FreeBlock *&head = freeList();
+        if (size != sizeof(Request) || !head)
+            return ::operator new(size);
+        FreeBlock *block = head;
+        head = block->next;
+        return block;
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        if (size != sizeof(Request)) {
+            ::operator delete(p);
+            return;
+        }
+        FreeBlock *&head = freeList();
+        FreeBlock *block = static_cast<FreeBlock *>(p);
+        block->next = head;
+        head = block;
+    }
+    /** @} */
+
     /**
      * Minimal constructor. No fields are initialized. (Note that
      *  _flags and privateFlags are cleared by Flags default
@@ -548,8 +737,8 @@ class Request
         assert(hasVaddr());
         assert(!hasPaddr());
         assert(split_addr > _vaddr && split_addr < _vaddr + _size);
-        req1 = std::make_shared<Request>(*this);
-        req2 = std::make_shared<Request>(*this);
+        req1 = makeRequest(*this);
+        req2 = makeRequest(*this);
         req1->_size = split_addr - _vaddr;
         req2->_vaddr = split_addr;
         req2->_size = _size - req1->_size;
@@ -666,6 +855,12 @@ class Request
         return _time;
     }
 
+    /**
+     * Set the time of a request that was created ahead of the tick
+     * it is issued at.
+     */
+    void setTime(Tick when) { _time = when; }
+
     /** Is this request for a local memory mapped resource/register? */
     bool isLocalAccess() { return (bool)_localAccessor; }
     /** Set the function which will enact that access. */
@@ -994,4 +1189,46 @@ class Request
     /** @} */
 };
 
+void
+RequestPtr::copy(Request *d)
+{
+    data = d;
+    if (data)
+        data->refCount++;
+}
+
+void
+RequestPtr::del()
+{
+    if (data && --data->refCount == 0) {
+        if (data->sharedOwner) {
+            // Let go of the shared pointer, which releases the request
+            // unless it is still referenced by other shared pointers
+            std::shared_ptr<Request> owner = std::move(data->sharedOwner);
+        } else {
+            delete data;
+        }
+    }
+}
+
+RequestPtr::RequestPtr(const std::shared_ptr<Request> &r)
+    : data(r.get())
+{
+    if (data && data->refCount++ == 0)
+        data->sharedOwner = r;
+}
+
+/**
+ * Create a request, recycling the storage of a released one if possible.
+ *
+ * @param args Arguments of the constructor of the request.
+ * @return Pointer to the new request.
+ */
+template <typename... Args>
+RequestPtr
+makeRequest(Args&&... args)
+{
+    return RequestPtr(new Request(std::forward<Args>(args)...));
+}
+
 #endif // __MEM_REQUEST_HH__
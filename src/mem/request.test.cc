@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <unordered_set>
+
+#include "mem/request.hh"
+
+/** Requests made with makeRequest are released with their last pointer. */
+TEST(RequestPtrTest, ReferenceCounting)
+{
+    RequestPtr a = makeRequest();
+    Request *raw = a.get();
+    ASSERT_NE(nullptr, raw);
+
+    RequestPtr b = a;
+    EXPECT_EQ(a, b);
+    a.reset();
+    EXPECT_FALSE(a);
+    EXPECT_EQ(raw, b.get());
+
+    RequestPtr c = std::move(b);
+    EXPECT_EQ(nullptr, b);
+    EXPECT_EQ(raw, c.get());
+
+    // Self-assignment keeps the request alive
+    RequestPtr &alias = c;
+    c = alias;
+    EXPECT_EQ(raw, c.get());
+
+    // The storage of a released request is recycled
+    c = nullptr;
+    RequestPtr d = makeRequest();
+    EXPECT_EQ(raw, d.get());
+}
+
+/** A copy of a request is a new request with references of its own. */
+TEST(RequestPtrTest, CopyRequest)
+{
+    RequestPtr a = makeRequest();
+    a->setPaddr(0x1000);
+    RequestPtr b = makeRequest(*a);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(0x1000, b->getPaddr());
+    a.reset();
+    EXPECT_EQ(0x1000, b->getPaddr());
+}
+
+/** Requests owned by a std::shared_ptr can be referenced as well. */
+TEST(RequestPtrTest, SharedOwner)
+{
+    std::weak_ptr<Request> weak;
+    RequestPtr a;
+    {
+        auto shared = std::make_shared<Request>();
+        weak = shared;
+        a = shared;
+        EXPECT_EQ(shared.get(), a.get());
+    }
+    // The RequestPtr keeps the request alive
+    EXPECT_FALSE(weak.expired());
+    RequestPtr b = a;
+    a.reset();
+    EXPECT_FALSE(weak.expired());
+    b.reset();
+    EXPECT_TRUE(weak.expired());
+
+    // The shared pointers keep the request alive as well
+    auto shared = std::make_shared<Request>();
+    weak = shared;
+    a = shared;
+    a.reset();
+    EXPECT_FALSE(weak.expired());
+    a = shared;
+    shared.reset();
+    EXPECT_FALSE(weak.expired());
+    a.reset();
+    EXPECT_TRUE(weak.expired());
+}
+
+/** RequestPtrs can be hashed and compared to null. */
+TEST(RequestPtrTest, Containers)
+{
+    RequestPtr a = makeRequest();
+    RequestPtr b = makeRequest();
+    RequestPtr null = NULL;
+    EXPECT_TRUE(null == nullptr);
+    EXPECT_TRUE(a != nullptr);
+
+    std::unordered_set<RequestPtr> set;
+    set.insert(a);
+    set.insert(b);
+    set.insert(a);
+    EXPECT_EQ(2, set.size());
+    EXPECT_EQ(1, set.count(b));
+}
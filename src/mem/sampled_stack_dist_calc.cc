@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/sampled_stack_dist_calc.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+SampledStackDistCalc::SampledStackDistCalc(double rate, size_t max_samples,
+                                           unsigned num_sizes, uint64_t seed)
+    : maxSamples(max_samples), numSizes(num_sizes), seed(seed),
+      threshold(std::min<double>(rate, 1.0) * HashRange),
+      lastRefs(std::max<size_t>(4 * max_samples, 64) + 1, 0),
+      now(0), distances(NumGroups * (num_sizes + 1), 0.0),
+      coldMisses(NumGroups, 0.0), numReferences(0), numSampled(0)
+{
+    fatal_if(rate <= 0, "The sampling rate must be positive.");
+    fatal_if(max_samples == 0, "At least one line must be sampled.");
+    fatal_if(num_sizes == 0, "The curve must have at least one size.");
+}
+
+uint32_t
+SampledStackDistCalc::hashAddr(Addr line_addr) const
+{
+    // The finalizer of MurmurHash3, which mixes all the bits of the
+    // address into the upper bits kept
+    uint64_t h = line_addr ^ seed;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h >> (64 - 24);
+}
+
+void
+SampledStackDistCalc::addAt(uint32_t time, int delta)
+{
+    for (size_t i = time + 1; i < lastRefs.size(); i += i & -i)
+        lastRefs[i] += delta;
+}
+
+uint32_t
+SampledStackDistCalc::countBefore(uint32_t time) const
+{
+    uint32_t count = 0;
+    for (size_t i = time; i > 0; i -= i & -i)
+        count += lastRefs[i];
+    return count;
+}
+
+void
+SampledStackDistCalc::compactTimes()
+{
+    std::vector<std::pair<uint32_t, Addr>> by_time;
+    by_time.reserve(samples.size());
+    for (const auto &sample : samples)
+        by_time.emplace_back(sample.second.time, sample.first);
+    std::sort(by_time.begin(), by_time.end());
+
+    std::fill(lastRefs.begin(), lastRefs.end(), 0);
+    now = 0;
+    for (const auto &entry : by_time) {
+        samples.find(entry.second)->second.time = now;
+        addAt(now, 1);
+        ++now;
+    }
+}
+
+void
+SampledStackDistCalc::shrinkSample()
+{
+    while (samples.size() > maxSamples) {
+        const uint32_t largest = byHash.top().first;
+        while (!byHash.empty() && byHash.top().first == largest) {
+            auto it = samples.find(byHash.top().second);
+            assert(it != samples.end());
+            addAt(it->second.time, -1);
+            samples.erase(it);
+            byHash.pop();
+        }
+
+        // Rescale the references gathered so far to the new rate
+        const double scale = double(largest) / threshold;
+        for (auto &count : distances)
+            count *= scale;
+        for (auto &count : coldMisses)
+            count *= scale;
+        threshold = largest;
+    }
+}
+
+void
+SampledStackDistCalc::access(Addr line_addr)
+{
+    ++numReferences;
+
+    const uint32_t hash = hashAddr(line_addr);
+    if (hash >= threshold)
+        return;
+
+    ++numSampled;
+    if (now == lastRefs.size() - 1)
+        compactTimes();
+
+    const unsigned group = hash % NumGroups;
+    auto res = samples.emplace(line_addr, Sample{hash, now});
+    if (res.second) {
+        coldMisses[group] += 1;
+        byHash.emplace(hash, line_addr);
+    } else {
+        // The distinct lines referenced since the last reference to
+        // this one, scaled up by the sampling rate
+        Sample &sample = res.first->second;
+        const uint64_t sampled_dist =
+            countBefore(now) - countBefore(sample.time + 1);
+        const uint64_t dist = sampled_dist * HashRange / threshold;
+        const unsigned bucket = dist == 0 ? 0 :
+            std::min<unsigned>(floorLog2(dist) + 1, numSizes);
+        distances[group * (numSizes + 1) + bucket] += 1;
+
+        addAt(sample.time, -1);
+        sample.time = now;
+    }
+    addAt(now, 1);
+    ++now;
+
+    shrinkSample();
+}
+
+double
+SampledStackDistCalc::groupMisses(unsigned group, unsigned size_idx) const
+{
+    double misses = coldMisses[group];
+    const double *group_distances = &distances[group * (numSizes + 1)];
+    for (unsigned bucket = size_idx + 1; bucket <= numSizes; ++bucket)
+        misses += group_distances[bucket];
+    return misses;
+}
+
+double
+SampledStackDistCalc::missRatio(unsigned size_idx) const
+{
+    assert(size_idx < numSizes);
+
+    // The sample is expected to hold a rate-sized share of the
+    // references. Any shortfall or excess is put down to references at
+    // the shortest distances, which hit in all caches.
+    const double expected = numReferences * rate();
+    if (expected <= 0)
+        return 0.0;
+
+    double misses = 0;
+    for (unsigned group = 0; group < NumGroups; ++group)
+        misses += groupMisses(group, size_idx);
+    return std::min(std::max(misses / expected, 0.0), 1.0);
+}
+
+double
+SampledStackDistCalc::missRatioError(unsigned size_idx) const
+{
+    assert(size_idx < numSizes);
+
+    const double expected = numReferences * rate() / NumGroups;
+    if (expected <= 0)
+        return 0.0;
+
+    // Each group is a sample of its own, at a fraction of the rate, so
+    // the spread of their miss ratios gives the error of their mean
+    double ratios[NumGroups];
+    double mean = 0;
+    for (unsigned group = 0; group < NumGroups; ++group) {
+        ratios[group] = groupMisses(group, size_idx) / expected;
+        mean += ratios[group] / NumGroups;
+    }
+    double sum_sq = 0;
+    for (unsigned group = 0; group < NumGroups; ++group)
+        sum_sq += (ratios[group] - mean) * (ratios[group] - mean);
+    return std::sqrt(sum_sq / (NumGroups * (NumGroups - 1)));
+}
+
+void
+SampledStackDistCalc::reset()
+{
+    std::fill(distances.begin(), distances.end(), 0.0);
+    std::fill(coldMisses.begin(), coldMisses.end(), 0.0);
+    numReferences = 0;
+    numSampled = 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a stack distance calculator that samples the addresses
+ * it observes, to build miss ratio curves with a fixed memory budget.
+ */
+
+#ifndef __MEM_SAMPLED_STACK_DIST_CALC_HH__
+#define __MEM_SAMPLED_STACK_DIST_CALC_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/line_addr_map.hh"
+
+/**
+ * The sampled stack distance calculator builds the miss ratio curve of
+ * an LRU cache from a stream of line addresses, using the fixed-size
+ * variant of SHARDS described by Waldspurger et al., "Efficient MRC
+ * Construction with SHARDS", FAST 2015.
+ *
+ * An address is sampled if a hash of it falls below a threshold, so
+ * that either all or none of the references to a line are sampled. The
+ * stack distances of the sampled references are measured among the
+ * sampled lines, and scaled up by the sampling rate. At most a given
+ * number of lines are tracked: once there are more, the lines with the
+ * largest hash are dropped and the threshold is lowered to their hash,
+ * which rescales the distances gathered so far.
+ *
+ * The distances of the tracked lines are measured on a Fenwick tree
+ * over the time of their last reference, which is periodically
+ * compacted, so both the time and the memory spent are bounded by the
+ * number of tracked lines rather than by the footprint of the stream.
+ *
+ * The curve is kept for caches of a power of two number of lines. The
+ * shortfall between the expected and the actual number of sampled
+ * references is added to the shortest distances, as in SHARDS_adj,
+ * which corrects most of the bias of a sample dominated by a few
+ * lines.
+ */
+class SampledStackDistCalc
+{
+  public:
+    /** Range of the hash deciding whether an address is sampled */
+    static const uint32_t HashRange = 1 << 24;
+
+    /** Number of groups the sampled lines are split in */
+    static const unsigned NumGroups = 16;
+
+    /**
+     * @param rate Initial fraction of the lines to sample
+     * @param max_samples Maximum number of lines to track
+     * @param num_sizes Number of cache sizes of the curve, from one
+     *        line to 2^(num_sizes - 1) lines
+     * @param seed Seed of the hash deciding which lines are sampled
+     */
+    SampledStackDistCalc(double rate, size_t max_samples,
+                         unsigned num_sizes, uint64_t seed = 0);
+
+    /**
+     * Account for a reference to a line.
+     *
+     * @param line_addr Address of the line, aligned to the line size
+     */
+    void access(Addr line_addr);
+
+    /**
+     * Estimated miss ratio of the references since the last reset.
+     *
+     * @param size_idx The cache holds 2^size_idx lines
+     * @return Miss ratio, or zero if there were no references
+     */
+    double missRatio(unsigned size_idx) const;
+
+    /**
+     * Standard error of the estimated miss ratio. The sampled lines
+     * are split in groups by their hash, each group being a sample of
+     * its own at a fraction of the rate, and the error is estimated
+     * from the spread of the miss ratios of the groups.
+     *
+     * @param size_idx The cache holds 2^size_idx lines
+     */
+    double missRatioError(unsigned size_idx) const;
+
+    /** Current fraction of the lines sampled. */
+    double rate() const { return double(threshold) / HashRange; }
+
+    /** Number of references since the last reset. */
+    uint64_t references() const { return numReferences; }
+
+    /** Number of sampled references since the last reset. */
+    uint64_t sampledReferences() const { return numSampled; }
+
+    /** Number of lines currently tracked. */
+    size_t trackedLines() const { return samples.size(); }
+
+    /**
+     * Forget the references seen so far, but keep tracking the lines
+     * sampled, so that their next references are not cold misses.
+     */
+    void reset();
+
+  private:
+    /** A tracked line */
+    struct Sample
+    {
+        uint32_t hash;
+        /** Time of the last reference to the line */
+        uint32_t time;
+    };
+
+    /** Hash an address to decide whether it is sampled. */
+    uint32_t hashAddr(Addr line_addr) const;
+
+    /**
+     * Drop the lines of the largest hash and lower the threshold to
+     * that hash, until no more than the maximum number of lines are
+     * tracked.
+     */
+    void shrinkSample();
+
+    /** Renumber the times of the tracked lines from zero. */
+    void compactTimes();
+
+    /** Add to the count of references at a time. */
+    void addAt(uint32_t time, int delta);
+
+    /** Count the last references up to, but excluding, a time. */
+    uint32_t countBefore(uint32_t time) const;
+
+    /** Sampled misses of a group of lines in a cache of a size. */
+    double groupMisses(unsigned group, unsigned size_idx) const;
+
+    const size_t maxSamples;
+    const unsigned numSizes;
+    const uint64_t seed;
+
+    /** Lines whose hash is below the threshold are sampled */
+    uint32_t threshold;
+
+    /** The tracked lines */
+    LineAddrMap<Sample> samples;
+
+    /** The tracked lines by hash, largest first */
+    std::priority_queue<std::pair<uint32_t, Addr>> byHash;
+
+    /**
+     * Fenwick tree counting the last reference to each tracked line by
+     * time. Its size bounds the time before the times are compacted.
+     */
+    std::vector<uint32_t> lastRefs;
+
+    /** Time of the next sampled reference */
+    uint32_t now;
+
+    /**
+     * Sampled references by group and scaled stack distance: the first
+     * bucket of a group holds distance zero, and bucket i distances in
+     * [2^(i-1), 2^i). The last bucket also holds all longer distances.
+     * The counts are rescaled to the current sampling rate.
+     */
+    std::vector<double> distances;
+
+    /** Sampled references to lines not seen before, by group */
+    std::vector<double> coldMisses;
+
+    uint64_t numReferences;
+    uint64_t numSampled;
+};
+
+#endif //__MEM_SAMPLED_STACK_DIST_CALC_HH__
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "mem/sampled_stack_dist_calc.hh"
+
+namespace {
+
+/**
+ * Exact miss ratios of LRU caches of a power of two number of lines,
+ * by simulating an LRU stack.
+ */
+class ExactMissRatios
+{
+  public:
+    ExactMissRatios(unsigned num_sizes)
+        : misses(num_sizes, 0), references(0)
+    {}
+
+    void
+    access(Addr line_addr)
+    {
+        ++references;
+        uint64_t dist = 0;
+        auto it = stack.begin();
+        for (; it != stack.end() && *it != line_addr; ++it)
+            ++dist;
+        const bool cold = it == stack.end();
+        if (!cold)
+            stack.erase(it);
+        stack.push_front(line_addr);
+
+        for (unsigned size_idx = 0; size_idx < misses.size(); ++size_idx) {
+            if (cold || dist >= (uint64_t(1) << size_idx))
+                ++misses[size_idx];
+        }
+    }
+
+    double
+    missRatio(unsigned size_idx) const
+    {
+        return double(misses[size_idx]) / references;
+    }
+
+  private:
+    std::list<Addr> stack;
+    std::vector<uint64_t> misses;
+    uint64_t references;
+};
+
+} // anonymous namespace
+
+/** Without sampling, the miss ratios are exact. */
+TEST(SampledStackDistCalcTest, ExactWithoutSampling)
+{
+    const unsigned num_sizes = 10;
+    SampledStackDistCalc calc(1.0, 1 << 12, num_sizes);
+    ExactMissRatios exact(num_sizes);
+
+    std::mt19937_64 rng(1);
+    std::geometric_distribution<unsigned> line_dist(0.01);
+    for (int i = 0; i < 20000; ++i) {
+        const Addr line_addr = (line_dist(rng) % 1024) * 64;
+        calc.access(line_addr);
+        exact.access(line_addr);
+    }
+
+    EXPECT_EQ(1.0, calc.rate());
+    EXPECT_EQ(20000, calc.references());
+    EXPECT_EQ(20000, calc.sampledReferences());
+    for (unsigned size_idx = 0; size_idx < num_sizes; ++size_idx) {
+        EXPECT_DOUBLE_EQ(exact.missRatio(size_idx),
+                         calc.missRatio(size_idx));
+    }
+}
+
+/** A loop over a footprint hits in the caches holding all of it. */
+TEST(SampledStackDistCalcTest, Loop)
+{
+    SampledStackDistCalc calc(1.0, 1 << 12, 12);
+    for (int iter = 0; iter < 10; ++iter) {
+        for (Addr line = 0; line < 100; ++line)
+            calc.access(line * 64);
+    }
+
+    // Caches of up to 64 lines miss on every reference, those of 128
+    // lines and more only on the first reference to each line
+    EXPECT_DOUBLE_EQ(1.0, calc.missRatio(6));
+    EXPECT_DOUBLE_EQ(0.1, calc.missRatio(7));
+    EXPECT_DOUBLE_EQ(0.1, calc.missRatio(11));
+}
+
+/**
+ * With a footprint much larger than the budget, the rate is lowered to
+ * keep to the budget, and the miss ratios stay close to the exact ones.
+ */
+TEST(SampledStackDistCalcTest, FixedBudget)
+{
+    const unsigned num_sizes = 16;
+    const size_t max_samples = 2048;
+    SampledStackDistCalc calc(0.5, max_samples, num_sizes);
+    ExactMissRatios exact(num_sizes);
+
+    std::mt19937_64 rng(2);
+    std::geometric_distribution<Addr> line_dist(0.0005);
+    for (int i = 0; i < 100000; ++i) {
+        const Addr line_addr = line_dist(rng) * 64;
+        calc.access(line_addr);
+        exact.access(line_addr);
+        ASSERT_LE(calc.trackedLines(), max_samples);
+    }
+
+    EXPECT_LT(calc.rate(), 0.5);
+    for (unsigned size_idx = 0; size_idx < num_sizes; ++size_idx) {
+        const double error = calc.missRatioError(size_idx);
+        EXPECT_NEAR(exact.missRatio(size_idx), calc.missRatio(size_idx),
+                    0.05) << "cache of " << (1 << size_idx) << " lines";
+        EXPECT_LT(error, 0.05);
+    }
+}
+
+/** A reset forgets the references, but not the lines seen. */
+TEST(SampledStackDistCalcTest, Reset)
+{
+    SampledStackDistCalc calc(1.0, 1 << 12, 8);
+    for (Addr line = 0; line < 16; ++line)
+        calc.access(line * 64);
+    EXPECT_DOUBLE_EQ(1.0, calc.missRatio(7));
+
+    calc.reset();
+    EXPECT_EQ(0, calc.references());
+    EXPECT_DOUBLE_EQ(0.0, calc.missRatio(7));
+
+    for (Addr line = 0; line < 16; ++line)
+        calc.access(line * 64);
+    EXPECT_EQ(16, calc.references());
+    EXPECT_DOUBLE_EQ(1.0, calc.missRatio(3));
+    EXPECT_DOUBLE_EQ(0.0, calc.missRatio(4));
+}
@@ -60,6 +60,20 @@ SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
     }
 }
 
+void
+SnoopFilter::reportHostMemory()
+{
+    if (!DTRACE(SnoopFilter))
+        return;
+
+    size_t host_memory = cachedLocations.memoryUsage();
+    if (host_memory != reportedHostMemory) {
+        reportedHostMemory = host_memory;
+        DPRINTF(SnoopFilter, "%s: %d lines use %d bytes of host memory\n",
+                __func__, cachedLocations.size(), host_memory);
+    }
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
                            cpu_side_port)
@@ -75,21 +89,23 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(cpu_side_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    auto sf_it = cachedLocations.find(line_addr);
+    bool is_hit = (sf_it != cachedLocations.end());
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
     // portlist.
-    if (!is_hit && !allocate)
+    reqLookupResult.hasEntry = is_hit || allocate;
+    if (!reqLookupResult.hasEntry)
         return snoopDown(lookupLatency);
 
     // If no hit in snoop filter create a new element and update iterator
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        sf_it = cachedLocations.emplace(line_addr, SnoopItem()).first;
+        reportHostMemory();
     }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    reqLookupResult.lineAddr = line_addr;
+    SnoopItem& sf_item = sf_it->second;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -156,29 +172,67 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.hasEntry) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.lineAddr == line_addr);
+        reqLookupResult.hasEntry = false;
+
+        auto sf_it = cachedLocations.find(line_addr);
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            if (sf_it == cachedLocations.end()) {
+                sf_it = cachedLocations.emplace(line_addr, retry_item).first;
+                reportHostMemory();
+            } else {
+                sf_it->second = retry_item;
+            }
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        if (sf_it != cachedLocations.end())
+            eraseIfNullEntry(sf_it);
     }
 }
 
+void
+SnoopFilter::addHolder(const Packet *cpkt, const ResponsePort& cpu_side_port)
+{
+    DPRINTF(SnoopFilter, "%s: src %s packet %s\n", __func__,
+            cpu_side_port.name(), cpkt->print());
+
+    SnoopMask holder = portToMask(cpu_side_port);
+    if (holder.none())
+        return;
+
+    Addr line_addr = cpkt->getBlockAddr(linesize);
+    if (cpkt->isSecure()) {
+        line_addr |= LineSecure;
+    }
+
+    auto sf_it = cachedLocations.find(line_addr);
+    if (sf_it == cachedLocations.end()) {
+        panic_if(cachedLocations.size() >= maxEntryCount,
+                 "snoop filter exceeded capacity of %d cache blocks\n",
+                 maxEntryCount);
+        sf_it = cachedLocations.emplace(line_addr, SnoopItem()).first;
+        reportHostMemory();
+    }
+    sf_it->second.holder |= holder;
+
+    DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n", __func__,
+            sf_it->second.requested, sf_it->second.holder);
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupSnoop(const Packet* cpkt)
 {
@@ -387,8 +441,8 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
             __func__, sf_item.requested, sf_item.holder);
 }
 
-SnoopFilter::SnoopFilterStats::SnoopFilterStats(Stats::Group *parent)
-    : Stats::Group(parent),
+SnoopFilter::SnoopFilterStats::SnoopFilterStats(SnoopFilter &sf)
+    : Stats::Group(&sf),
       ADD_STAT(totRequests, UNIT_COUNT,
                "Total number of requests made to the snoop filter."),
       ADD_STAT(hitSingleRequests, UNIT_COUNT,
@@ -404,8 +458,24 @@ SnoopFilter::SnoopFilterStats::SnoopFilterStats(Stats::Group *parent)
                "holder of the requested data."),
       ADD_STAT(hitMultiSnoops, UNIT_COUNT,
                "Number of snoops hitting in the snoop filter with multiple "
-               "(>1) holders of the requested data.")
-{}
+               "(>1) holders of the requested data."),
+      ADD_STAT(trackedLines, UNIT_COUNT,
+               "Number of lines tracked by the snoop filter."),
+      ADD_STAT(hostBytesPerLine,
+               UNIT_RATE(Stats::Units::Byte, Stats::Units::Count),
+               "Host memory used per tracked line."),
+      ADD_STAT(hostMemory, UNIT_BYTE,
+               "Host memory used to track the lines.",
+               trackedLines * hostBytesPerLine)
+{
+    trackedLines.functor([&sf]() { return sf.cachedLocations.size(); });
+    hostBytesPerLine.functor([&sf]() {
+        const size_t lines = sf.cachedLocations.size();
+        return lines ? double(sf.cachedLocations.memoryUsage()) / lines : 0;
+    });
+    hostBytesPerLine.precision(2);
+    hostMemory.precision(0);
+}
 
 void
 SnoopFilter::regStats()
@@ -44,9 +44,9 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
-#include <unordered_map>
 #include <utility>
 
+#include "mem/line_addr_map.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
@@ -92,10 +92,10 @@ class SnoopFilter : public SimObject {
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
     SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
+        SimObject(p),
         linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
         maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
-        stats(this)
+        stats(*this)
     {
     }
 
@@ -196,6 +196,16 @@ class SnoopFilter : public SimObject {
      */
     void updateResponse(const Packet *cpkt, const ResponsePort& cpu_side_port);
 
+    /**
+     * Record a CPU-side port as a holder of a line, for blocks that a
+     * cache above restores from a checkpoint rather than fetching
+     * them through the filter.
+     *
+     * @param cpkt          Pointer to const Packet of the restored block.
+     * @param cpu_side_port ResponsePort the cache holding it is above.
+     */
+    void addHolder(const Packet *cpkt, const ResponsePort& cpu_side_port);
+
     virtual void regStats();
 
   protected:
@@ -216,9 +226,10 @@ class SnoopFilter : public SimObject {
         SnoopMask holder;
     };
     /**
-     * HashMap of SnoopItems indexed by line address
+     * Flat hash map of SnoopItems indexed by line address. Note that
+     * entries move when other entries are inserted or erased.
      */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+    typedef LineAddrMap<SnoopItem> SnoopFilterCache;
 
     /**
      * Simple factory methods for standard return values.
@@ -258,9 +269,20 @@ class SnoopFilter : public SimObject {
      */
     void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
 
+    /**
+     * Reports the host memory used to track the lines through the
+     * SnoopFilter debug flag whenever it changed, so that it can be
+     * followed over time rather than only at stat dumps. Called after
+     * adding a line.
+     */
+    void reportHostMemory();
+
     /** Simple hash set of cached addresses. */
     SnoopFilterCache cachedLocations;
 
+    /** Host memory used by cachedLocations when last reported. */
+    size_t reportedHostMemory = 0;
+
     /**
      * A request lookup must be followed by a call to finishRequest to inform
      * the operation's success. If a retry is needed, however, all changes
@@ -268,8 +290,15 @@ class SnoopFilter : public SimObject {
      * This structure keeps track of the state previous to such changes.
      */
     struct ReqLookupResult {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /**
+         * Whether lookupRequest found or created an entry. The entry
+         * is looked up again by finishRequest, as it may have moved
+         * in between.
+         */
+        bool hasEntry;
+
+        /** Line address of the entry, for sanity checking. */
+        Addr lineAddr;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
@@ -278,17 +307,10 @@ class SnoopFilter : public SimObject {
          */
         SnoopItem retryItem;
 
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
+        ReqLookupResult()
+            : hasEntry(false), lineAddr(0), retryItem{0, 0}
         {
         }
-        ReqLookupResult() = delete;
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
@@ -312,7 +334,7 @@ class SnoopFilter : public SimObject {
 
     /** Statistics */
     struct SnoopFilterStats : public Stats::Group {
-        SnoopFilterStats(Stats::Group *parent);
+        SnoopFilterStats(SnoopFilter &sf);
 
         Stats::Scalar totRequests;
         Stats::Scalar hitSingleRequests;
@@ -321,6 +343,13 @@ class SnoopFilter : public SimObject {
         Stats::Scalar totSnoops;
         Stats::Scalar hitSingleSnoops;
         Stats::Scalar hitMultiSnoops;
+
+        /** Number of lines tracked. */
+        Stats::Value trackedLines;
+        /** Host memory used per tracked line, including free space. */
+        Stats::Value hostBytesPerLine;
+        /** Host memory used to track the lines. */
+        Stats::Formula hostMemory;
     } stats;
 };
 
@@ -330,10 +330,10 @@ BaseXBar::findPort(AddrRange addr_range)
     // ranges of all connected CPU-side-port modules
     assert(gotAllAddrRanges);
 
-    // Check the address map interval tree
-    auto i = portMap.contains(addr_range);
-    if (i != portMap.end()) {
-        return i->second;
+    // Check the routing table
+    const PortID *port_id = routeTable.contains(addr_range);
+    if (port_id) {
+        return *port_id;
     }
 
     // Check if this matches the default range
@@ -427,6 +427,14 @@ BaseXBar::recvRangeChange(PortID mem_side_port_id)
                       memSidePorts[conflict_id]->getPeer());
             }
         }
+
+        // compile the ranges for routing
+        routeTable.clear();
+        for (const auto& r: portMap) {
+            panic_if(!routeTable.insert(r.first, r.second),
+                     "%s cannot route range %s\n", name(),
+                     r.first.to_string());
+        }
     }
 
     // if we have received ranges from all our neighbouring CPU-side-port
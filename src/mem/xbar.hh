@@ -49,6 +49,7 @@
 #include <deque>
 #include <unordered_map>
 
+#include "base/addr_decode_table.hh"
 #include "base/addr_range_map.hh"
 #include "base/types.hh"
 #include "mem/qport.hh"
@@ -313,7 +314,13 @@ class BaseXBar : public ClockedObject
     /** the width of the xbar in bytes */
     const uint32_t width;
 
-    AddrRangeMap<PortID, 3> portMap;
+    AddrRangeMap<PortID> portMap;
+
+    /**
+     * The ranges of portMap compiled for routing packets, rebuilt
+     * whenever the ranges change.
+     */
+    AddrDecodeTable<PortID> routeTable;
 
     /**
      * Remember where request packets came from so that we can route
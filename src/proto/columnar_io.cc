@@ -0,0 +1,615 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "proto/columnar_io.hh"
+
+#include <google/protobuf/descriptor.h>
+#include <zlib.h>
+
+#include <algorithm>
+
+#include "base/logging.hh"
+
+using namespace google::protobuf;
+
+namespace
+{
+
+void
+putFixed32(std::string &buf, uint32_t val)
+{
+    for (int i = 0; i < 4; ++i)
+        buf.push_back(char(val >> (8 * i)));
+}
+
+void
+putFixed64(std::string &buf, uint64_t val)
+{
+    for (int i = 0; i < 8; ++i)
+        buf.push_back(char(val >> (8 * i)));
+}
+
+uint32_t
+getFixed32(const char *buf)
+{
+    uint32_t val = 0;
+    for (int i = 0; i < 4; ++i)
+        val |= uint32_t(uint8_t(buf[i])) << (8 * i);
+    return val;
+}
+
+uint64_t
+getFixed64(const char *buf)
+{
+    uint64_t val = 0;
+    for (int i = 0; i < 8; ++i)
+        val |= uint64_t(uint8_t(buf[i])) << (8 * i);
+    return val;
+}
+
+void
+putVarint(std::string &buf, uint64_t val)
+{
+    while (val >= 0x80) {
+        buf.push_back(char(val | 0x80));
+        val >>= 7;
+    }
+    buf.push_back(char(val));
+}
+
+uint64_t
+getVarint(const char *&pos, const char *end)
+{
+    uint64_t val = 0;
+    for (int shift = 0; pos < end && shift < 64; shift += 7) {
+        const uint8_t byte = *pos++;
+        val |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return val;
+    }
+    panic("Corrupt column in columnar trace\n");
+}
+
+/**
+ * Get the encoding of the column of a field, which follows from the
+ * wire type of the field.
+ */
+ColumnarStream::ColumnKind
+columnKind(const FieldDescriptor *field)
+{
+    if (field->is_packed())
+        return ColumnarStream::Bytes;
+    switch (field->type()) {
+      case FieldDescriptor::TYPE_FIXED32:
+      case FieldDescriptor::TYPE_SFIXED32:
+      case FieldDescriptor::TYPE_FLOAT:
+        return ColumnarStream::Fixed32;
+      case FieldDescriptor::TYPE_FIXED64:
+      case FieldDescriptor::TYPE_SFIXED64:
+      case FieldDescriptor::TYPE_DOUBLE:
+        return ColumnarStream::Fixed64;
+      case FieldDescriptor::TYPE_STRING:
+      case FieldDescriptor::TYPE_BYTES:
+      case FieldDescriptor::TYPE_MESSAGE:
+        return ColumnarStream::Bytes;
+      case FieldDescriptor::TYPE_GROUP:
+        panic("Groups are not supported in columnar traces\n");
+      default:
+        return ColumnarStream::Varint;
+    }
+}
+
+/**
+ * Get the protobuf wire type of the values of a column.
+ */
+uint32_t
+wireType(ColumnarStream::ColumnKind kind)
+{
+    switch (kind) {
+      case ColumnarStream::Varint:
+        return 0;
+      case ColumnarStream::Fixed64:
+        return 1;
+      case ColumnarStream::Bytes:
+        return 2;
+      case ColumnarStream::Fixed32:
+        return 5;
+      default:
+        panic("Unknown column kind %d\n", kind);
+    }
+}
+
+} // anonymous namespace
+
+bool
+ColumnarStream::isColumnarTrace(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    char magic[sizeof(uint32_t)];
+    file.read(magic, sizeof(magic));
+    return file.good() && getFixed32(magic) == magicNumber;
+}
+
+ColumnarOutputStream::ColumnarOutputStream(const std::string& filename,
+                                           uint32_t block_records) :
+    fileStream(filename.c_str(),
+            std::ios::out | std::ios::binary | std::ios::trunc),
+    blockRecords(block_records), headerWritten(false), recordType(nullptr),
+    numBlockRecords(0), numRecords(0), blockKey(0)
+{
+    if (!fileStream.good())
+        panic("Could not open %s for writing\n", filename);
+    fatal_if(blockRecords == 0, "Blocks of %s must hold records\n",
+             filename);
+
+    std::string preamble;
+    putFixed32(preamble, magicNumber);
+    putFixed32(preamble, formatVersion);
+    fileStream.write(preamble.data(), preamble.size());
+}
+
+ColumnarOutputStream::~ColumnarOutputStream()
+{
+    flushBlock();
+
+    // Mark the end of the blocks, then append the index and the
+    // trailer that locates it
+    std::string tail(blockHeaderSize, '\0');
+    const uint64_t index_offset = uint64_t(fileStream.tellp()) +
+        blockHeaderSize;
+    for (const auto &entry : index) {
+        putFixed64(tail, entry.offset);
+        putFixed64(tail, entry.firstRecord);
+        putFixed64(tail, entry.firstKey);
+    }
+    putFixed64(tail, index_offset);
+    putFixed64(tail, index.size());
+    putFixed32(tail, magicNumber);
+    fileStream.write(tail.data(), tail.size());
+    fileStream.close();
+}
+
+void
+ColumnarOutputStream::createColumns(const Message& msg)
+{
+    recordType = msg.GetDescriptor();
+    columns.resize(recordType->field_count());
+    recordCounts.resize(columns.size());
+    for (int i = 0; i < recordType->field_count(); ++i) {
+        const FieldDescriptor *field = recordType->field(i);
+        Column &col = columns[i];
+        col.number = field->number();
+        col.kind = columnKind(field);
+        col.last = 0;
+        if (columnOfField.size() <= col.number)
+            columnOfField.resize(col.number + 1, -1);
+        columnOfField[col.number] = i;
+    }
+}
+
+void
+ColumnarOutputStream::write(const Message& msg)
+{
+    if (!headerWritten) {
+        std::string header;
+        msg.SerializeToString(&header);
+        std::string size;
+        putFixed32(size, header.size());
+        fileStream.write(size.data(), size.size());
+        fileStream.write(header.data(), header.size());
+        headerWritten = true;
+        return;
+    }
+
+    if (!recordType)
+        createColumns(msg);
+    panic_if(msg.GetDescriptor() != recordType,
+             "Cannot write a %s to a trace of %s records\n",
+             msg.GetDescriptor()->full_name(), recordType->full_name());
+
+    // Serialize the record and split its fields over the columns
+    wireRecord.clear();
+    msg.AppendToString(&wireRecord);
+    std::fill(recordCounts.begin(), recordCounts.end(), 0);
+    const char *pos = wireRecord.data();
+    const char *end = pos + wireRecord.size();
+    while (pos < end) {
+        const uint64_t tag = getVarint(pos, end);
+        const uint64_t number = tag >> 3;
+        panic_if(number >= columnOfField.size() ||
+                 columnOfField[number] < 0,
+                 "Unknown field %d in %s record\n", number,
+                 recordType->full_name());
+        const int idx = columnOfField[number];
+        Column &col = columns[idx];
+        panic_if((tag & 0x7) != wireType(col.kind),
+                 "Unexpected wire type of field %d in %s record\n",
+                 number, recordType->full_name());
+        ++recordCounts[idx];
+
+        uint64_t val;
+        switch (col.kind) {
+          case Bytes: {
+            const uint64_t size = getVarint(pos, end);
+            panic_if(end - pos < size, "Corrupt %s record\n",
+                     recordType->full_name());
+            putVarint(col.values, size);
+            col.values.append(pos, size);
+            pos += size;
+            continue;
+          }
+          case Fixed32:
+            panic_if(end - pos < 4, "Corrupt %s record\n",
+                     recordType->full_name());
+            val = getFixed32(pos);
+            pos += 4;
+            break;
+          case Fixed64:
+            panic_if(end - pos < 8, "Corrupt %s record\n",
+                     recordType->full_name());
+            val = getFixed64(pos);
+            pos += 8;
+            break;
+          default:
+            val = getVarint(pos, end);
+            break;
+        }
+
+        // Store the difference to the last value zigzag encoded,
+        // which keeps increasing sequence numbers, ticks and nearby
+        // addresses to a byte or two
+        const int64_t delta = int64_t(val - col.last);
+        putVarint(col.values, (uint64_t(delta) << 1) ^
+                  uint64_t(delta >> 63));
+        col.last = val;
+    }
+    for (size_t i = 0; i < columns.size(); ++i)
+        putVarint(columns[i].counts, recordCounts[i]);
+
+    // The leading field of the first record of a block is its key in
+    // the index
+    if (numBlockRecords == 0) {
+        const Column &lead = columns.front();
+        blockKey = lead.kind != Bytes ? lead.last : 0;
+    }
+
+    if (++numBlockRecords == blockRecords)
+        flushBlock();
+}
+
+void
+ColumnarOutputStream::flushBlock()
+{
+    if (numBlockRecords == 0)
+        return;
+
+    // The block starts with a table of its columns, followed by the
+    // counts and values of each column in turn
+    rawBlock.clear();
+    putVarint(rawBlock, columns.size());
+    for (const auto &col : columns) {
+        putVarint(rawBlock, col.number);
+        rawBlock.push_back(char(col.kind));
+        putVarint(rawBlock, col.counts.size());
+        putVarint(rawBlock, col.values.size());
+    }
+    for (auto &col : columns) {
+        rawBlock.append(col.counts);
+        rawBlock.append(col.values);
+        col.counts.clear();
+        col.values.clear();
+        col.last = 0;
+    }
+
+    uLongf compressed_size = compressBound(rawBlock.size());
+    compressedBlock.resize(compressed_size);
+    const int ret = compress2((Bytef *)&compressedBlock[0], &compressed_size,
+                              (const Bytef *)rawBlock.data(),
+                              rawBlock.size(), Z_BEST_SPEED);
+    panic_if(ret != Z_OK, "Failed to compress trace block (%d)\n", ret);
+
+    index.push_back({ uint64_t(fileStream.tellp()), numRecords, blockKey });
+
+    std::string header;
+    putFixed32(header, numBlockRecords);
+    putFixed32(header, rawBlock.size());
+    putFixed32(header, compressed_size);
+    fileStream.write(header.data(), header.size());
+    fileStream.write(compressedBlock.data(), compressed_size);
+
+    numRecords += numBlockRecords;
+    numBlockRecords = 0;
+}
+
+ColumnarInputStream::ColumnarInputStream(const std::string& filename) :
+    fileStream(filename.c_str(), std::ios::in | std::ios::binary),
+    fileName(filename), firstBlockOffset(0), headerRead(false),
+    indexLoaded(false), nextBlockOffset(0), remainingRecords(0)
+{
+    if (!fileStream.good())
+        panic("Could not open %s for reading\n", filename);
+
+    char preamble[3 * sizeof(uint32_t)];
+    fileStream.read(preamble, sizeof(preamble));
+    if (!fileStream.good() || getFixed32(preamble) != magicNumber)
+        panic("Input file %s is not a valid gem5 columnar trace.\n",
+              fileName);
+    if (getFixed32(preamble + 4) != formatVersion)
+        panic("Columnar trace %s has unsupported version %d\n", fileName,
+              getFixed32(preamble + 4));
+
+    // The blocks follow the header message
+    firstBlockOffset = sizeof(preamble) + getFixed32(preamble + 8);
+    nextBlockOffset = firstBlockOffset;
+}
+
+ColumnarInputStream::~ColumnarInputStream()
+{
+    fileStream.close();
+}
+
+void
+ColumnarInputStream::reset()
+{
+    fileStream.clear();
+    headerRead = false;
+    nextBlockOffset = firstBlockOffset;
+    remainingRecords = 0;
+}
+
+bool
+ColumnarInputStream::read(Message& msg)
+{
+    if (!headerRead) {
+        const size_t header_offset = 3 * sizeof(uint32_t);
+        std::string header(firstBlockOffset - header_offset, '\0');
+        fileStream.clear();
+        fileStream.seekg(header_offset);
+        fileStream.read(&header[0], header.size());
+        if (!fileStream.good() || !msg.ParseFromString(header))
+            panic("Unable to read header from columnar trace %s\n",
+                  fileName);
+        headerRead = true;
+        return true;
+    }
+
+    while (remainingRecords == 0) {
+        if (!loadBlock(nextBlockOffset))
+            return false;
+    }
+
+    decodeRecord(&msg);
+    return true;
+}
+
+bool
+ColumnarInputStream::loadBlock(uint64_t offset)
+{
+    remainingRecords = 0;
+
+    char header[blockHeaderSize];
+    fileStream.clear();
+    fileStream.seekg(offset);
+    fileStream.read(header, sizeof(header));
+    const uint32_t num_records = getFixed32(header);
+    if (!fileStream.good() || num_records == 0)
+        return false;
+
+    const uint32_t raw_size = getFixed32(header + 4);
+    const uint32_t compressed_size = getFixed32(header + 8);
+    compressedBlock.resize(compressed_size);
+    fileStream.read(&compressedBlock[0], compressed_size);
+    if (!fileStream.good()) {
+        // The simulation writing the trace did not finish the block
+        warn("Columnar trace %s ends in a truncated block\n", fileName);
+        return false;
+    }
+
+    rawBlock.resize(raw_size);
+    uLongf size = raw_size;
+    const int ret = uncompress((Bytef *)&rawBlock[0], &size,
+                               (const Bytef *)compressedBlock.data(),
+                               compressed_size);
+    panic_if(ret != Z_OK || size != raw_size,
+             "Failed to decompress block at %d of %s\n", offset, fileName);
+
+    // Walk the column table, the data of the columns follows it in the
+    // same order
+    const char *pos = rawBlock.data();
+    const char *end = pos + rawBlock.size();
+    cursors.resize(getVarint(pos, end));
+    std::vector<std::pair<uint64_t, uint64_t>> sizes(cursors.size());
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        Cursor &cursor = cursors[i];
+        cursor.number = getVarint(pos, end);
+        panic_if(pos == end, "Corrupt column table in %s\n", fileName);
+        cursor.kind = ColumnKind(*pos++);
+        sizes[i].first = getVarint(pos, end);
+        sizes[i].second = getVarint(pos, end);
+    }
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        Cursor &cursor = cursors[i];
+        panic_if(end - pos < sizes[i].first + sizes[i].second,
+                 "Corrupt column data in %s\n", fileName);
+        cursor.counts = pos;
+        cursor.countsEnd = pos += sizes[i].first;
+        cursor.values = pos;
+        cursor.valuesEnd = pos += sizes[i].second;
+        cursor.last = 0;
+    }
+
+    remainingRecords = num_records;
+    nextBlockOffset = offset + blockHeaderSize + compressed_size;
+    return true;
+}
+
+uint64_t
+ColumnarInputStream::decodeRecord(Message* msg)
+{
+    assert(remainingRecords > 0);
+    --remainingRecords;
+
+    wireRecord.clear();
+    for (auto &cursor : cursors) {
+        const uint64_t count = getVarint(cursor.counts, cursor.countsEnd);
+        const uint64_t tag = (uint64_t(cursor.number) << 3) |
+            wireType(cursor.kind);
+        for (uint64_t i = 0; i < count; ++i) {
+            if (cursor.kind == Bytes) {
+                const uint64_t size = getVarint(cursor.values,
+                                                cursor.valuesEnd);
+                panic_if(cursor.valuesEnd - cursor.values < size,
+                         "Corrupt column %d in %s\n", cursor.number,
+                         fileName);
+                if (msg) {
+                    putVarint(wireRecord, tag);
+                    putVarint(wireRecord, size);
+                    wireRecord.append(cursor.values, size);
+                }
+                cursor.values += size;
+                continue;
+            }
+
+            const uint64_t zigzag = getVarint(cursor.values,
+                                              cursor.valuesEnd);
+            cursor.last += (zigzag >> 1) ^ -(zigzag & 1);
+            if (!msg)
+                continue;
+            putVarint(wireRecord, tag);
+            if (cursor.kind == Fixed32)
+                putFixed32(wireRecord, cursor.last);
+            else if (cursor.kind == Fixed64)
+                putFixed64(wireRecord, cursor.last);
+            else
+                putVarint(wireRecord, cursor.last);
+        }
+    }
+
+    if (msg && !msg->ParseFromString(wireRecord))
+        panic("Unable to read record from columnar trace %s\n", fileName);
+
+    // The leading column is written first and is the key of the record
+    if (!cursors.empty() && cursors.front().kind != Bytes)
+        return cursors.front().last;
+    return 0;
+}
+
+void
+ColumnarInputStream::loadIndex()
+{
+    if (indexLoaded)
+        return;
+    indexLoaded = true;
+
+    fileStream.clear();
+    fileStream.seekg(0, std::ios::end);
+    const uint64_t file_size = fileStream.tellg();
+
+    if (file_size >= firstBlockOffset + blockHeaderSize + trailerSize) {
+        char trailer[trailerSize];
+        fileStream.seekg(file_size - trailerSize);
+        fileStream.read(trailer, trailerSize);
+        const uint64_t index_offset = getFixed64(trailer);
+        const uint64_t num_blocks = getFixed64(trailer + 8);
+        const size_t entry_size = 3 * sizeof(uint64_t);
+        if (fileStream.good() && getFixed32(trailer + 16) == magicNumber &&
+            index_offset + num_blocks * entry_size + trailerSize ==
+            file_size) {
+            std::string entries(num_blocks * entry_size, '\0');
+            fileStream.seekg(index_offset);
+            fileStream.read(&entries[0], entries.size());
+            if (fileStream.good()) {
+                index.resize(num_blocks);
+                for (uint64_t i = 0; i < num_blocks; ++i) {
+                    const char *entry = entries.data() + i * entry_size;
+                    index[i].offset = getFixed64(entry);
+                    index[i].firstRecord = getFixed64(entry + 8);
+                    index[i].firstKey = getFixed64(entry + 16);
+                }
+                return;
+            }
+        }
+    }
+
+    // Without an index, walk the blocks and decode the first record of
+    // each to rebuild it
+    warn("Columnar trace %s has no index, rebuilding it\n", fileName);
+    uint64_t offset = firstBlockOffset;
+    uint64_t records = 0;
+    while (loadBlock(offset)) {
+        const uint64_t num_records = remainingRecords;
+        index.push_back({ offset, records, decodeRecord(nullptr) });
+        records += num_records;
+        offset = nextBlockOffset;
+    }
+    remainingRecords = 0;
+}
+
+bool
+ColumnarInputStream::seek(uint64_t key)
+{
+    loadIndex();
+    headerRead = true;
+    remainingRecords = 0;
+
+    // Start from the last block whose first record is not past the key
+    auto block = std::upper_bound(index.begin(), index.end(), key,
+        [](uint64_t key, const BlockIndexEntry &entry) {
+            return key < entry.firstKey;
+        });
+    if (block != index.begin())
+        --block;
+    nextBlockOffset = block == index.end() ? firstBlockOffset :
+        block->offset;
+
+    // Skip the records of the block preceding the key, keeping the
+    // cursors of the block from before the record that reaches it
+    while (true) {
+        while (remainingRecords == 0) {
+            if (!loadBlock(nextBlockOffset))
+                return true;
+        }
+        const std::vector<Cursor> saved(cursors);
+        const uint32_t remaining = remainingRecords;
+        if (decodeRecord(nullptr) >= key) {
+            cursors = saved;
+            remainingRecords = remaining;
+            return true;
+        }
+    }
+}
+
+TraceInputStream*
+openTraceInputStream(const std::string& filename)
+{
+    // The magic number sets the formats apart, as protobuf traces start
+    // with either their own magic number or that of gzip
+    if (ColumnarStream::isColumnarTrace(filename))
+        return new ColumnarInputStream(filename);
+    return new ProtoInputStream(filename);
+}
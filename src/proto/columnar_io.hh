@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the streams for the columnar, block-compressed trace
+ * format.
+ *
+ * A columnar trace holds the same header and record messages as a
+ * protobuf trace, but groups the records in blocks. Within a block
+ * each field of the record is stored as a column of its own, numeric
+ * columns are delta encoded, and the block is compressed as a whole,
+ * which makes writing considerably cheaper than coding every message
+ * on its own, and the trace a fraction of the size. The streams work
+ * on the wire format of the messages, so that records are still
+ * serialized and parsed by the generated protobuf code. An index of
+ * the blocks, keyed on the leading field of the records, lets a reader
+ * start mid-trace.
+ *
+ * The file layout, with all fixed-width integers in little endian, is:
+ *   - magic number and format version, 32 bits each
+ *   - the header message, preceded by its 32-bit size
+ *   - the blocks, each starting with its number of records, its raw
+ *     size and its compressed size, 32 bits each, followed by the
+ *     zlib compressed column data
+ *   - an empty block header marking the end of the blocks
+ *   - the block index, as the 64-bit file offset, first record and
+ *     first key of every block
+ *   - the 64-bit offset of the index, the 64-bit number of blocks,
+ *     and the magic number again
+ * A trace that misses its index, e.g. because the simulation did not
+ * exit cleanly, can still be read and the index is then rebuilt from
+ * the block headers.
+ */
+
+#ifndef __PROTO_COLUMNAR_IO_HH__
+#define __PROTO_COLUMNAR_IO_HH__
+
+#include <google/protobuf/message.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "proto/protoio.hh"
+
+/**
+ * A ColumnarStream provides the shared functionality of the columnar
+ * input and output streams, that is the magic number and the layout
+ * of the block index.
+ */
+class ColumnarStream
+{
+
+  public:
+
+    /**
+     * Check whether a file is a columnar trace.
+     *
+     * @param filename Path to the file to check
+     * @return True if the file starts with the columnar magic number
+     */
+    static bool isColumnarTrace(const std::string& filename);
+
+    /// Encoding of the values of a column, after the wire type of the
+    /// field. The values of the numeric kinds are stored as zigzag
+    /// encoded deltas to the preceding value of the column.
+    enum ColumnKind : uint8_t {
+        Varint = 0,
+        Bytes = 1,
+        Fixed32 = 2,
+        Fixed64 = 3
+    };
+
+  protected:
+
+    /// Use the ASCII characters g5ct as our magic number
+    static const uint32_t magicNumber = 0x74633567;
+
+    /// Version of the file format
+    static const uint32_t formatVersion = 1;
+
+    /// Size of the header of a block
+    static const size_t blockHeaderSize = 3 * sizeof(uint32_t);
+
+    /// Size of the trailer following the block index
+    static const size_t trailerSize =
+        2 * sizeof(uint64_t) + sizeof(uint32_t);
+
+    /**
+     * Entry of the block index.
+     */
+    struct BlockIndexEntry
+    {
+        /// Offset of the block header in the file
+        uint64_t offset;
+        /// Number of records preceding the block
+        uint64_t firstRecord;
+        /// Leading field of the first record of the block
+        uint64_t firstKey;
+    };
+
+    /**
+     * Create a ColumnarStream.
+     */
+    ColumnarStream() {}
+
+  private:
+
+    /**
+     * Hide the copy constructor and assignment operator.
+     * @{
+     */
+    ColumnarStream(const ColumnarStream&);
+    ColumnarStream& operator=(const ColumnarStream&);
+    /** @} */
+};
+
+/**
+ * A ColumnarOutputStream collects the records written to it in
+ * blocks and writes each block out once it is full. The first message
+ * written to the stream is taken to be the header of the trace, and
+ * all following messages must be of the same record type. The index
+ * is written when the stream is destructed.
+ */
+class ColumnarOutputStream : public ColumnarStream, public TraceOutputStream
+{
+
+  public:
+
+    /**
+     * Create an output stream for a given file name.
+     *
+     * @param filename Path to the file to create or truncate
+     * @param block_records Number of records in a block
+     */
+    ColumnarOutputStream(const std::string& filename,
+                         uint32_t block_records = 4096);
+
+    /**
+     * Destruct the output stream, writing out the last block and the
+     * block index before closing the underlying file stream.
+     */
+    ~ColumnarOutputStream();
+
+    /**
+     * Write a message to the stream, the header if it is the first
+     * message and a record otherwise.
+     *
+     * @param msg Message to write to the stream
+     */
+    void write(const google::protobuf::Message& msg) override;
+
+  private:
+
+    /**
+     * Column of a block, holding the number of values each record has
+     * for the field, and the values themselves.
+     */
+    struct Column
+    {
+        int number;
+        ColumnKind kind;
+        std::string counts;
+        std::string values;
+        /// Last value appended, the base of the next delta
+        uint64_t last;
+    };
+
+    /**
+     * Set up the columns for the record type of the given message.
+     */
+    void createColumns(const google::protobuf::Message& msg);
+
+    /**
+     * Compress the current block, write it to the file, and add it to
+     * the index.
+     */
+    void flushBlock();
+
+    /// Underlying file output stream
+    std::ofstream fileStream;
+
+    /// Number of records in a block
+    const uint32_t blockRecords;
+
+    /// Whether the header message has been written
+    bool headerWritten;
+
+    /// Record type of the trace, set by the first record written
+    const google::protobuf::Descriptor* recordType;
+
+    /// Columns of the current block, one per field of the record type
+    std::vector<Column> columns;
+
+    /// Column of each field number, or -1 for unused numbers
+    std::vector<int> columnOfField;
+
+    /// Values each column has in the record being written
+    std::vector<uint32_t> recordCounts;
+
+    /// Serialized record, reused across records
+    std::string wireRecord;
+
+    /// Number of records in the current block
+    uint32_t numBlockRecords;
+
+    /// Number of records in the preceding blocks
+    uint64_t numRecords;
+
+    /// Leading field of the first record of the current block
+    uint64_t blockKey;
+
+    /// Index of the blocks written so far
+    std::vector<BlockIndexEntry> index;
+
+    /// Buffers for the raw and compressed block, reused across blocks
+    std::string rawBlock;
+    std::string compressedBlock;
+};
+
+/**
+ * A ColumnarInputStream reads the header and records of a columnar
+ * trace. Blocks are decompressed one at a time, and a record is
+ * decoded by taking the next values off each of the columns.
+ */
+class ColumnarInputStream : public ColumnarStream, public TraceInputStream
+{
+
+  public:
+
+    /**
+     * Create an input stream for a given file name.
+     *
+     * @param filename Path to the file to read from
+     */
+    ColumnarInputStream(const std::string& filename);
+
+    /**
+     * Destruct the input stream, and close the underlying file stream.
+     */
+    ~ColumnarInputStream();
+
+    /**
+     * Read a message from the stream, the header if it is the first
+     * message read and a record otherwise.
+     *
+     * @param msg Message read from the stream
+     * @param return True if a message was read, false if reading fails
+     */
+    bool read(google::protobuf::Message& msg) override;
+
+    /**
+     * Reset the input stream and seek to the beginning of the file.
+     */
+    void reset() override;
+
+    /**
+     * Skip ahead to the first record whose leading field is not
+     * smaller than the given key, using the block index to find the
+     * block to start from. This assumes that the records are sorted
+     * on their leading field, such as the sequence numbers of a data
+     * dependency trace or the ticks of a packet trace. The header is
+     * skipped if it has not been read yet.
+     *
+     * @param key Value of the leading field to seek to
+     * @return True, as the format supports seeking
+     */
+    bool seek(uint64_t key) override;
+
+  private:
+
+    /**
+     * Position within a column of the current block.
+     */
+    struct Cursor
+    {
+        int number;
+        ColumnKind kind;
+        const char* counts;
+        const char* countsEnd;
+        const char* values;
+        const char* valuesEnd;
+        /// Last value decoded, the base of the next delta
+        uint64_t last;
+    };
+
+    /**
+     * Load the block index, either from the end of the file or, if
+     * the trace has no index, by walking the block headers.
+     */
+    void loadIndex();
+
+    /**
+     * Read and decompress the block starting at the given offset and
+     * set up the column cursors.
+     *
+     * @return False if there is no block at the offset
+     */
+    bool loadBlock(uint64_t offset);
+
+    /**
+     * Decode the next record of the current block, by putting the
+     * record back together in wire format and parsing it.
+     *
+     * @param msg Message to decode into, or nullptr to skip the record
+     * @return Leading field of the record
+     */
+    uint64_t decodeRecord(google::protobuf::Message* msg);
+
+    /// Underlying file input stream
+    std::ifstream fileStream;
+
+    /// Hold on to the file name for debug messages
+    const std::string fileName;
+
+    /// Offset of the first block
+    uint64_t firstBlockOffset;
+
+    /// Whether the header message has been read
+    bool headerRead;
+
+    /// Block index, loaded on the first seek
+    std::vector<BlockIndexEntry> index;
+    bool indexLoaded;
+
+    /// Offset of the block following the current one
+    uint64_t nextBlockOffset;
+
+    /// Records of the current block still to be read
+    uint32_t remainingRecords;
+
+    /// Column cursors of the current block
+    std::vector<Cursor> cursors;
+
+    /// Serialized record, reused across records
+    std::string wireRecord;
+
+    /// Buffers for the compressed and raw block, reused across blocks
+    std::string compressedBlock;
+    std::string rawBlock;
+};
+
+/**
+ * Open a trace for reading, creating a stream for the columnar format
+ * or for the protobuf format depending on the magic number of the
+ * file.
+ *
+ * @param filename Path to the file to read from
+ * @return Input stream owned by the caller
+ */
+TraceInputStream* openTraceInputStream(const std::string& filename);
+
+#endif //__PROTO_COLUMNAR_IO_HH__
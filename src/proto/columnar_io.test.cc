@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2021 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "proto/columnar_io.hh"
+#include "proto/inst_dep_record.pb.h"
+#include "proto/packet.pb.h"
+
+namespace
+{
+
+/**
+ * Temporary trace file, removed when going out of scope.
+ */
+class TempFile
+{
+  public:
+    TempFile()
+    {
+        char name[] = "trace-XXXXXX";
+        const int fd = mkstemp(name);
+        EXPECT_NE(-1, fd);
+        close(fd);
+        filename = name;
+    }
+
+    ~TempFile() { unlink(filename.c_str()); }
+
+    std::string filename;
+};
+
+ProtoMessage::InstDepRecord
+makeRecord(uint64_t seq_num)
+{
+    ProtoMessage::InstDepRecord rec;
+    rec.set_seq_num(seq_num);
+    rec.set_type(seq_num % 3 ? ProtoMessage::InstDepRecord::COMP :
+                 ProtoMessage::InstDepRecord::LOAD);
+    rec.set_comp_delay(seq_num % 7);
+    if (seq_num % 3 == 0) {
+        rec.set_p_addr(0x80000000 + seq_num * 64);
+        rec.set_size(8);
+        rec.set_flags(seq_num % 5);
+    }
+    for (uint64_t dep = 1; dep <= seq_num % 4 && dep < seq_num; ++dep)
+        rec.add_reg_dep(seq_num - dep);
+    if (seq_num > 10)
+        rec.add_rob_dep(seq_num - 10);
+    if (seq_num % 11 == 0)
+        rec.set_weight(2);
+    rec.set_pc(0x400000 + seq_num * 4);
+    return rec;
+}
+
+/**
+ * Write a data dependency trace with records of every other sequence
+ * number, starting from 2.
+ */
+void
+writeTrace(const std::string &filename, uint64_t num_records,
+           uint32_t block_records)
+{
+    ColumnarOutputStream out(filename, block_records);
+    ProtoMessage::InstDepRecordHeader header;
+    header.set_obj_id("test");
+    header.set_tick_freq(1000000000000);
+    header.set_window_size(750);
+    out.write(header);
+    for (uint64_t i = 1; i <= num_records; ++i)
+        out.write(makeRecord(2 * i));
+}
+
+} // anonymous namespace
+
+TEST(ColumnarIOTest, RoundTrip)
+{
+    TempFile file;
+    writeTrace(file.filename, 1000, 64);
+
+    ColumnarInputStream in(file.filename);
+    ProtoMessage::InstDepRecordHeader header;
+    ASSERT_TRUE(in.read(header));
+    EXPECT_EQ("test", header.obj_id());
+    EXPECT_EQ(750, header.window_size());
+
+    ProtoMessage::InstDepRecord rec;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        ASSERT_TRUE(in.read(rec));
+        EXPECT_EQ(makeRecord(2 * i).SerializeAsString(),
+                  rec.SerializeAsString());
+    }
+    EXPECT_FALSE(in.read(rec));
+}
+
+TEST(ColumnarIOTest, PacketRoundTrip)
+{
+    TempFile file;
+    {
+        ColumnarOutputStream out(file.filename, 3);
+        ProtoMessage::PacketHeader header;
+        header.set_obj_id("packets");
+        header.set_tick_freq(1000);
+        auto *entry = header.add_id_strings();
+        entry->set_key(1);
+        entry->set_value("cpu");
+        out.write(header);
+        for (int i = 0; i < 10; ++i) {
+            ProtoMessage::Packet pkt;
+            // Go backwards as well to cover negative deltas
+            pkt.set_tick(i % 2 ? 100 * i : 50 * i);
+            pkt.set_cmd(i % 2);
+            pkt.set_addr(0x1000 - 64 * i);
+            pkt.set_size(64);
+            out.write(pkt);
+        }
+    }
+
+    ColumnarInputStream in(file.filename);
+    ProtoMessage::PacketHeader header;
+    ASSERT_TRUE(in.read(header));
+    ASSERT_EQ(1, header.id_strings_size());
+    EXPECT_EQ("cpu", header.id_strings(0).value());
+
+    ProtoMessage::Packet pkt;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(in.read(pkt));
+        EXPECT_EQ(i % 2 ? 100 * i : 50 * i, pkt.tick());
+        EXPECT_EQ(0x1000 - 64 * i, pkt.addr());
+        EXPECT_FALSE(pkt.has_flags());
+    }
+    EXPECT_FALSE(in.read(pkt));
+}
+
+TEST(ColumnarIOTest, Seek)
+{
+    TempFile file;
+    writeTrace(file.filename, 1000, 64);
+
+    ColumnarInputStream in(file.filename);
+    ProtoMessage::InstDepRecord rec;
+
+    // Keys in the middle of a block, between records, and at the start
+    // of a block
+    for (uint64_t key : { 1001, 1002, 2 * 64 * 5 + 2, 1 }) {
+        ASSERT_TRUE(in.seek(key));
+        ASSERT_TRUE(in.read(rec));
+        EXPECT_EQ((key + 1) & ~uint64_t(1), rec.seq_num());
+        ASSERT_TRUE(in.read(rec));
+        EXPECT_EQ(makeRecord(((key + 1) & ~uint64_t(1)) + 2)
+                  .SerializeAsString(), rec.SerializeAsString());
+    }
+
+    // Beyond the end of the trace
+    ASSERT_TRUE(in.seek(5000));
+    EXPECT_FALSE(in.read(rec));
+
+    // A reset goes back to the header
+    in.reset();
+    ProtoMessage::InstDepRecordHeader header;
+    ASSERT_TRUE(in.read(header));
+    ASSERT_TRUE(in.read(rec));
+    EXPECT_EQ(2, rec.seq_num());
+}
+
+TEST(ColumnarIOTest, MissingIndex)
+{
+    TempFile file;
+    writeTrace(file.filename, 200, 16);
+
+    // Drop the index and the end of the last block
+    std::ifstream src(file.filename, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(src)),
+                         std::istreambuf_iterator<char>());
+    src.close();
+    std::ofstream dst(file.filename, std::ios::binary | std::ios::trunc);
+    const size_t index_size = 3 * 8 * (200 / 16 + 1) + 2 * 8 + 4 + 12;
+    dst.write(contents.data(), contents.size() - index_size - 5);
+    dst.close();
+
+    ColumnarInputStream in(file.filename);
+    ProtoMessage::InstDepRecord rec;
+    ASSERT_TRUE(in.seek(300));
+    ASSERT_TRUE(in.read(rec));
+    EXPECT_EQ(300, rec.seq_num());
+
+    // Records up to the truncated block are readable
+    uint64_t last = 0;
+    while (in.read(rec))
+        last = rec.seq_num();
+    EXPECT_EQ(2 * 192, last);
+}
+
+TEST(ColumnarIOTest, OpenEitherFormat)
+{
+    TempFile columnar;
+    writeTrace(columnar.filename, 10, 4);
+
+    TempFile proto;
+    {
+        ProtoOutputStream out(proto.filename);
+        ProtoMessage::InstDepRecordHeader header;
+        header.set_obj_id("test");
+        header.set_tick_freq(1000);
+        header.set_window_size(10);
+        out.write(header);
+        for (uint64_t i = 1; i <= 10; ++i)
+            out.write(makeRecord(2 * i));
+    }
+
+    for (const auto &filename : { columnar.filename, proto.filename }) {
+        std::unique_ptr<TraceInputStream> in(
+            openTraceInputStream(filename));
+        EXPECT_EQ(filename == columnar.filename,
+                  ColumnarStream::isColumnarTrace(filename));
+        ProtoMessage::InstDepRecordHeader header;
+        ASSERT_TRUE(in->read(header));
+        ProtoMessage::InstDepRecord rec;
+        for (uint64_t i = 1; i <= 10; ++i) {
+            ASSERT_TRUE(in->read(rec));
+            EXPECT_EQ(2 * i, rec.seq_num());
+        }
+        EXPECT_FALSE(in->read(rec));
+    }
+}
@@ -49,8 +49,63 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
 
+#include <cstdint>
 #include <fstream>
 
+/**
+ * Interface of the streams that trace messages are written to. A
+ * trace is a header message followed by any number of records, and
+ * the producers of traces only rely on this interface so that they
+ * can write either of the supported trace formats.
+ */
+class TraceOutputStream
+{
+  public:
+
+    virtual ~TraceOutputStream() {}
+
+    /**
+     * Write a message to the stream.
+     *
+     * @param msg Message to write to the stream
+     */
+    virtual void write(const google::protobuf::Message& msg) = 0;
+};
+
+/**
+ * Interface of the streams that trace messages are read from, the
+ * counterpart of TraceOutputStream.
+ */
+class TraceInputStream
+{
+  public:
+
+    virtual ~TraceInputStream() {}
+
+    /**
+     * Read a message from the stream.
+     *
+     * @param msg Message read from the stream
+     * @param return True if a message was read, false if reading fails
+     */
+    virtual bool read(google::protobuf::Message& msg) = 0;
+
+    /**
+     * Reset the input stream and seek to the beginning of the file.
+     */
+    virtual void reset() = 0;
+
+    /**
+     * Skip ahead to the first record whose leading field, e.g. the
+     * sequence number or the tick, is not smaller than the given
+     * key. Only formats with an index support seeking.
+     *
+     * @param key Value of the leading field to seek to
+     * @return True if the stream supports seeking
+     */
+    virtual bool seek(uint64_t key) { return false; }
+};
+
 /**
  * A ProtoStream provides the shared functionality of the input and
  * output streams. At the moment this is limited to magic number.
@@ -87,7 +142,7 @@ class ProtoStream
  * is made possible by encoding the length of each message in the
  * stream.
  */
-class ProtoOutputStream : public ProtoStream
+class ProtoOutputStream : public ProtoStream, public TraceOutputStream
 {
 
   public:
@@ -112,7 +167,7 @@ class ProtoOutputStream : public ProtoStream
      *
      * @param msg Message to write to the stream
      */
-    void write(const google::protobuf::Message& msg);
+    void write(const google::protobuf::Message& msg) override;
 
   private:
 
@@ -137,7 +192,7 @@ class ProtoOutputStream : public ProtoStream
  * huge data structures. The latter assumes the length of each message
  * is encoded in the stream when it is written.
  */
-class ProtoInputStream : public ProtoStream
+class ProtoInputStream : public ProtoStream, public TraceInputStream
 {
 
   public:
@@ -162,12 +217,12 @@ class ProtoInputStream : public ProtoStream
      * @param msg Message read from the stream
      * @param return True if a message was read, false if reading fails
      */
-    bool read(google::protobuf::Message& msg);
+    bool read(google::protobuf::Message& msg) override;
 
     /**
      * Reset the input stream and seek to the beginning of the file.
      */
-    void reset();
+    void reset() override;
 
   private:
 
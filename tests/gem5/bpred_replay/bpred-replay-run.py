@@ -0,0 +1,130 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replay a hand-written branch trace on a LocalBP and check the branch
+# counts and the mispredictions per thousand instructions. The trace is
+# a loop closed by a conditional branch, taken nine times out of ten,
+# followed by an unconditional jump back to the loop. A local predictor
+# mispredicts each loop exit once it is warm, so there is about one
+# misprediction per outer iteration.
+
+import os
+import struct
+import sys
+
+import m5
+from m5.objects import *
+
+outer_iterations = 100
+inner_iterations = 10
+
+loop_pc = 0x1000
+cond_pc = 0x1010
+jump_pc = 0x1020
+
+# Type bits of the records, as in src/proto/branch.proto
+type_cond = 1
+type_uncond = 0
+
+def encodeVarint(value):
+    out = bytearray()
+    while True:
+        bits = value & 0x7f
+        value >>= 7
+        if value:
+            out.append(bits | 0x80)
+        else:
+            out.append(bits)
+            return bytes(out)
+
+def encodeField(field, value):
+    if isinstance(value, bytes):
+        return encodeVarint(field << 3 | 2) + encodeVarint(len(value)) + \
+            value
+    return encodeVarint(field << 3) + encodeVarint(value)
+
+def encodeMessage(fields):
+    body = b''.join(encodeField(f, v) for f, v in fields)
+    return encodeVarint(len(body)) + body
+
+def writeTrace(filename):
+    insts = 0
+    with open(filename, 'wb') as trace:
+        # Magic number of the gem5 protobuf streams
+        trace.write(struct.pack('<I', 0x356d6567))
+        trace.write(encodeMessage([(1, b'handwritten'), (3, 10**12)]))
+        for outer in range(outer_iterations):
+            for inner in range(inner_iterations):
+                taken = inner != inner_iterations - 1
+                insts += (cond_pc - loop_pc) // 4 + 1
+                target = loop_pc if taken else cond_pc + 4
+                trace.write(encodeMessage([(1, insts), (2, cond_pc),
+                    (3, target), (4, int(taken)), (5, type_cond)]))
+            insts += (jump_pc - cond_pc) // 4
+            trace.write(encodeMessage([(1, insts), (2, jump_pc),
+                (3, loop_pc), (4, 1), (5, type_uncond)]))
+    return insts
+
+trace_file = os.path.join(m5.options.outdir, 'handwritten.trc')
+total_insts = writeTrace(trace_file)
+
+root = Root(full_system=False)
+root.replay = BranchTraceReplay(branchPred=LocalBP(),
+                                traceFile=trace_file)
+
+m5.instantiate()
+exit_event = m5.simulate()
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
+
+m5.stats.dump()
+stats = {}
+with open(os.path.join(m5.options.outdir, 'stats.txt')) as stats_file:
+    for line in stats_file:
+        fields = line.split()
+        if len(fields) > 1 and fields[0].startswith('replay.'):
+            stats[fields[0][len('replay.'):]] = float(fields[1])
+
+# The warmup of the counters and of the BTB adds a few mispredictions
+# to the one of every loop exit
+expected = {
+    'insts' : (total_insts, total_insts),
+    'branches' : (outer_iterations * (inner_iterations + 1),) * 2,
+    'condBranches' : (outer_iterations * inner_iterations,) * 2,
+    'condMispredicts' : (outer_iterations, outer_iterations + 5),
+    'mispredicts' : (outer_iterations, outer_iterations + 6),
+    'mpki' : (outer_iterations * 1000.0 / total_insts,
+              (outer_iterations + 6) * 1000.0 / total_insts),
+}
+
+failed = False
+for name, (low, high) in sorted(expected.items()):
+    value = stats.get(name)
+    if value is None or not (low <= value <= high):
+        print("replay.%s is %s, expected between %s and %s" %
+              (name, value, low, high))
+        failed = True
+sys.exit(1 if failed else 0)
@@ -0,0 +1,162 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Checkpoint the tags of a two level cache hierarchy warmed up by a
+# traffic generator, and restore them in separate processes:
+#  - into the same hierarchy, where every block is found where it was;
+#  - into caches of a different associativity, where blocks have to be
+#    relocated;
+#  - into an L1 with a different replacement policy, whose state cannot
+#    be restored.
+# Each restored hierarchy must hit on every block of the warm range, and
+# warn about relocated blocks and replacement state only when expected.
+# Traffic over a larger range then evicts the restored blocks, which
+# fails if the snoop filters do not know they are held. The config exits
+# with a non-zero status on failure.
+
+from multiprocessing import Process
+import os
+import sys
+
+import m5
+from m5.objects import *
+
+warm_size = 16 * 1024
+period = 1000
+
+system = System(membus=SystemXBar(), l2bus=L2XBar())
+system.clk_domain = SrcClockDomain(clock='1GHz',
+                                   voltage_domain=VoltageDomain())
+system.mem_ranges = [AddrRange('256MB')]
+system.mem_mode = 'timing'
+
+system.tgen = PyTrafficGen()
+system.l1 = Cache(size='32kB', assoc=4, tag_latency=1, data_latency=1,
+                  response_latency=1, mshrs=16, tgts_per_mshr=8,
+                  checkpoint_tags=True, checkpoint_data=True)
+system.l2 = Cache(size='256kB', assoc=8, tag_latency=4, data_latency=4,
+                  response_latency=4, mshrs=16, tgts_per_mshr=8,
+                  checkpoint_tags=True, checkpoint_data=True)
+
+system.tgen.port = system.l1.cpu_side
+system.l1.mem_side = system.l2bus.cpu_side_ports
+system.l2.cpu_side = system.l2bus.mem_side_ports
+system.l2.mem_side = system.membus.cpu_side_ports
+
+system.mem = SimpleMemory(range=system.mem_ranges[0], latency='50ns')
+system.mem.port = system.membus.mem_side_ports
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system=False, system=system)
+
+cpt_dir = os.path.join(m5.options.outdir, 'warm.cpt')
+block_size = 64
+
+def simulate(generators):
+    def traffic():
+        for gen in generators:
+            yield gen
+        yield system.tgen.createExit(0)
+    system.tgen.start(traffic())
+    exit_event = m5.simulate()
+    if 'exit state' not in exit_event.getCause():
+        print("Unexpected exit: %s" % exit_event.getCause())
+        sys.exit(1)
+
+def warmPass(read_percent):
+    return system.tgen.createLinear(warm_size // block_size * period,
+                                    0, warm_size - 1, block_size,
+                                    period, period, read_percent, 0)
+
+def save():
+    m5.instantiate()
+    simulate([ warmPass(70) ])
+    m5.checkpoint(cpt_dir)
+    sys.exit(0)
+
+def restore(log, relocated, mismatch):
+    # Capture the warnings printed while restoring
+    fd = os.open(log, os.O_WRONLY | os.O_CREAT | os.O_TRUNC)
+    os.dup2(fd, sys.stderr.fileno())
+
+    m5.instantiate(cpt_dir)
+    with open(log) as log_file:
+        warnings = log_file.read()
+
+    failed = False
+    for expected, text in ((relocated, 'restored to a different location'),
+                           (mismatch, 'different replacement policy')):
+        if (text in warnings) != expected:
+            print("Expected %s warning about '%s'" %
+                  ('a' if expected else 'no', text))
+            failed = True
+
+    # The whole warm range is in the restored L1
+    m5.stats.reset()
+    simulate([ warmPass(100) ])
+    misses = system.l1.resolveStat('demandMisses').total
+    hits = system.l1.resolveStat('demandHits').total
+    if misses != 0 or hits == 0:
+        print("Restored L1 had %d misses and %d hits on the warm range" %
+              (misses, hits))
+        failed = True
+
+    # Evict the restored blocks from both levels
+    simulate([ system.tgen.createRandom(100000 * period, 0,
+                                        system.mem_ranges[0].end,
+                                        block_size, period, period, 70,
+                                        0) ])
+    sys.exit(1 if failed else 0)
+
+def relocate(log):
+    system.l1.assoc = 2
+    system.l2.assoc = 4
+    restore(log, relocated=True, mismatch=False)
+
+def mismatch(log):
+    system.l1.replacement_policy = BRRIPRP()
+    restore(log, relocated=False, mismatch=True)
+
+steps = [ (save, ()) ]
+for name, step, args in (
+        ('same', restore, dict(relocated=False, mismatch=False)),
+        ('relocate', relocate, {}),
+        ('mismatch', mismatch, {})):
+    log = os.path.join(m5.options.outdir, 'restore_%s.log' % name)
+    steps.append((step, dict(args, log=log)))
+
+for step, kwargs in steps:
+    # Run every step in its own process, as a process can only
+    # instantiate the simulated system once
+    p = Process(target=step, kwargs=dict(kwargs))
+    p.start()
+    p.join()
+    if p.exitcode != 0:
+        print("Step %s failed" % step.__name__, file=sys.stderr)
+        sys.exit(1)
+
+print("Test done.", file=sys.stderr)
+sys.exit(0)
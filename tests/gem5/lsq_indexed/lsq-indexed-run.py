@@ -0,0 +1,130 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Run the same binary on two identical systems whose O3 CPUs differ only
+# in LSQIndexedSearch, one searching the LQ and SQ through the address
+# indices and the other scanning them. The searches must find the same
+# stores to forward from and the same violations, so every statistic of
+# the two systems has to match exactly. The config exits with a non-zero
+# status if they do not, or if no load was forwarded at all.
+
+import argparse
+import os
+import sys
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser()
+parser.add_argument('binary', type=str)
+args = parser.parse_args()
+
+def makeSystem(indexed):
+    system = System()
+    system.workload = SEWorkload.init_compatible(args.binary)
+
+    system.clk_domain = SrcClockDomain()
+    system.clk_domain.clock = '1GHz'
+    system.clk_domain.voltage_domain = VoltageDomain()
+    system.mem_mode = 'timing'
+    system.mem_ranges = [AddrRange('512MB')]
+
+    system.cpu = DerivO3CPU(LSQIndexedSearch=indexed)
+    system.cpu.icache = Cache(size='32kB', assoc=8, tag_latency=1,
+                              data_latency=1, response_latency=1,
+                              mshrs=16, tgts_per_mshr=20)
+    system.cpu.dcache = Cache(size='32kB', assoc=8, tag_latency=1,
+                              data_latency=1, response_latency=1,
+                              mshrs=16, tgts_per_mshr=20)
+    system.l2cache = Cache(size='512kB', assoc=16, tag_latency=10,
+                           data_latency=10, response_latency=1,
+                           mshrs=20, tgts_per_mshr=12)
+    system.l2bus = L2XBar()
+    system.membus = SystemXBar()
+
+    system.cpu.icache_port = system.cpu.icache.cpu_side
+    system.cpu.dcache_port = system.cpu.dcache.cpu_side
+    system.cpu.icache.mem_side = system.l2bus.cpu_side_ports
+    system.cpu.dcache.mem_side = system.l2bus.cpu_side_ports
+    system.l2cache.cpu_side = system.l2bus.mem_side_ports
+    system.l2cache.mem_side = system.membus.cpu_side_ports
+
+    system.cpu.createInterruptController()
+    if buildEnv['TARGET_ISA'] == 'x86':
+        system.cpu.interrupts[0].pio = system.membus.mem_side_ports
+        system.cpu.interrupts[0].int_requestor = \
+            system.membus.cpu_side_ports
+        system.cpu.interrupts[0].int_responder = \
+            system.membus.mem_side_ports
+
+    system.mem_ctrl = MemCtrl(dram=DDR3_1600_8x8(range=system.mem_ranges[0]))
+    system.mem_ctrl.port = system.membus.mem_side_ports
+    system.system_port = system.membus.cpu_side_ports
+
+    process = Process()
+    process.cmd = [args.binary]
+    system.cpu.workload = process
+    system.cpu.createThreads()
+    return system
+
+root = Root(full_system=False)
+root.indexed = makeSystem(True)
+root.linear = makeSystem(False)
+
+m5.instantiate()
+exit_event = m5.simulate()
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
+if exit_event.getCause() != 'exiting with last active thread context':
+    sys.exit(1)
+
+m5.stats.dump()
+stats = { 'indexed' : {}, 'linear' : {} }
+with open(os.path.join(m5.options.outdir, 'stats.txt')) as stats_file:
+    for line in stats_file:
+        # Keep the name and the values, without the description
+        fields = line.split('#')[0].split()
+        if len(fields) < 2:
+            continue
+        system, _, name = fields[0].partition('.')
+        if system in stats:
+            stats[system][name] = fields[1:]
+
+failed = False
+for name in sorted(set(stats['indexed']) | set(stats['linear'])):
+    indexed = stats['indexed'].get(name)
+    linear = stats['linear'].get(name)
+    if indexed != linear:
+        print("%s is %s with the indices but %s with the scan" %
+              (name, indexed, linear))
+        failed = True
+
+forwarded = [ float(value[0]) for name, value in stats['indexed'].items()
+              if name.startswith('cpu.lsq') and name.endswith('.forwLoads') ]
+if not forwarded or sum(forwarded) == 0:
+    print("No load was forwarded, the test does not cover the SQ search")
+    failed = True
+sys.exit(1 if failed else 0)
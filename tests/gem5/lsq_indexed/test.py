@@ -0,0 +1,65 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+'''
+Run the CPU test workloads on two O3 CPUs that differ only in whether
+the LSQ searches use the address indices, and check that the two runs
+agree on every statistic, in particular on the forwarded loads and the
+memory order violations.
+'''
+
+from testlib import *
+
+workloads = ('Bubblesort', 'FloatMM')
+
+valid_isas = (constants.gcn3_x86_tag, constants.arm_tag, constants.riscv_tag)
+
+base_path = joinpath(config.bin_path, 'cpu_tests')
+
+base_url = config.resource_url + '/gem5/cpu_tests/benchmarks/bin/'
+
+isa_url = {
+    constants.gcn3_x86_tag : base_url + "x86",
+    constants.arm_tag : base_url + "arm",
+    constants.riscv_tag : base_url + "riscv",
+}
+
+for isa in valid_isas:
+    path = joinpath(base_path, isa.lower())
+    for workload in workloads:
+        url = isa_url[isa] + '/' + workload
+        workload_binary = DownloadedProgram(url, path, workload)
+        binary = joinpath(workload_binary.path, workload)
+
+        gem5_verify_config(
+              name='lsq_indexed_{}'.format(workload),
+              verifiers=(), # No need for verifiers, this returns non-zero
+                            # on fail
+              config=joinpath(getcwd(), 'lsq-indexed-run.py'),
+              config_args=[binary],
+              valid_isas=(isa,),
+              fixtures=[workload_binary]
+        )
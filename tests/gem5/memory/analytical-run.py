@@ -0,0 +1,179 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Drive two identical systems with the same DRAM or NVM traffic
+# generator states, one memory controller scheduling the commands and
+# the other computing the timing analytically. For every state, compare
+# the read and write bandwidth, the read latency and, for DRAM, the row
+# hit rate of the two, and exit with a non-zero status if the mean
+# error of any of them is beyond its bound.
+
+import argparse
+import math
+import sys
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--mem', choices=['dram', 'nvm'], default='dram')
+parser.add_argument('--period', type=int, default=50000000,
+                    help="Ticks spent in each state, 50 us by default, long "
+                    "enough to include a few refreshes")
+parser.add_argument('--bw-tol', type=float, default=0.1,
+                    help="Bound on the mean relative bandwidth error")
+parser.add_argument('--lat-tol', type=float, default=0.2,
+                    help="Bound on the mean relative read latency error")
+parser.add_argument('--hit-tol', type=float, default=0.1,
+                    help="Bound on the mean absolute row hit rate error")
+args = parser.parse_args()
+
+mem_range = AddrRange('512MB')
+period = args.period
+
+def makeInterface():
+    if args.mem == 'dram':
+        return DDR3_1600_8x8(range=mem_range, null=True)
+    else:
+        return NVM_2400_1x64(range=mem_range, null=True)
+
+def makeSystem(analytical):
+    system = System(membus=IOXBar(width=32))
+    system.clk_domain = SrcClockDomain(clock='2.0GHz',
+                                       voltage_domain=VoltageDomain())
+    system.mem_ranges = [mem_range]
+    system.mmap_using_noreserve = True
+    system.mem_mode = 'timing'
+
+    if args.mem == 'dram':
+        system.mem_ctrl = MemCtrl(dram=makeInterface())
+    else:
+        system.mem_ctrl = MemCtrl(nvm=makeInterface())
+    system.mem_ctrl.analytical_timing = analytical
+    system.mem_ctrl.port = system.membus.mem_side_ports
+
+    system.tgen = PyTrafficGen()
+    system.tgen.port = system.membus.cpu_side_ports
+    system.system_port = system.membus.cpu_side_ports
+    return system
+
+root = Root(full_system=False)
+root.detailed = makeSystem(False)
+root.analytical = makeSystem(True)
+
+# The states of configs/dram/sweep.py and configs/nvm/sweep.py, for a
+# few strides and numbers of banks, at the peak bandwidth of the memory
+intf = getattr(root.detailed.mem_ctrl, args.mem)
+nbr_banks = intf.banks_per_rank.value
+burst_size = int((intf.devices_per_rank.value *
+                  intf.device_bus_width.value *
+                  intf.burst_length.value) / 8)
+page_size = intf.devices_per_rank.value * intf.device_rowbuffer_size.value
+itt = int(intf.tBURST.value * 1e12)
+max_addr = mem_range.end
+addr_map = m5.internal.params.enum_AddrMap.RoRaBaCoCh
+
+states = [ (rd_perc, stride, banks)
+           for rd_perc in (100, 70)
+           for stride in (burst_size, min(256, page_size))
+           for banks in sorted(set((1, nbr_banks // 2, nbr_banks))) ]
+
+def trace(tgen):
+    create = tgen.createDram if args.mem == 'dram' else tgen.createNvm
+    for rd_perc, stride, banks in states:
+        num_seq_pkts = int(math.ceil(float(stride) / burst_size))
+        yield create(period, 0, max_addr, burst_size, itt, itt, rd_perc, 0,
+                     num_seq_pkts, page_size, nbr_banks, banks, addr_map, 1)
+    yield tgen.createIdle(0)
+
+m5.instantiate()
+
+root.detailed.tgen.start(trace(root.detailed.tgen))
+root.analytical.tgen.start(trace(root.analytical.tgen))
+
+def sample(system):
+    """Return the compared metrics of a system for the last state."""
+    mem = getattr(system.mem_ctrl, args.mem)
+    stat = lambda name: mem.resolveStat(name).value
+    seconds = period / float(m5.ticks.fromSeconds(1.0))
+    metrics = {
+        'read bandwidth' : stat('bytesRead') / seconds,
+        'write bandwidth' : stat('bytesWritten') / seconds,
+    }
+    if stat('readBursts'):
+        metrics['read latency'] = stat('totMemAccLat') / stat('readBursts')
+    if args.mem == 'dram':
+        bursts = stat('readBursts') + stat('writeBursts')
+        if bursts:
+            metrics['row hit rate'] = \
+                (stat('readRowHits') + stat('writeRowHits')) / bursts
+    return metrics
+
+errors = {}
+for rd_perc, stride, banks in states:
+    m5.stats.reset()
+    exit_event = m5.simulate(period)
+    if exit_event.getCause() != 'simulate() limit reached':
+        print("Unexpected exit at tick %i because %s" %
+              (m5.curTick(), exit_event.getCause()))
+        sys.exit(1)
+
+    detailed = sample(root.detailed)
+    analytical = sample(root.analytical)
+    print("%d%% reads, stride %d, %d banks:" % (rd_perc, stride, banks))
+    for name in sorted(detailed):
+        ref = detailed[name]
+        val = analytical.get(name)
+        if val is None:
+            continue
+        print("  %-16s detailed %14.2f analytical %14.2f" %
+              (name, ref, val))
+        if name == 'row hit rate':
+            errors.setdefault(name, []).append(abs(val - ref))
+        elif ref != 0:
+            errors.setdefault(name, []).append(abs(val - ref) / ref)
+
+bounds = {
+    'read bandwidth' : args.bw_tol,
+    'write bandwidth' : args.bw_tol,
+    'read latency' : args.lat_tol,
+    'row hit rate' : args.hit_tol,
+}
+
+failed = False
+for name, errs in sorted(errors.items()):
+    mean = sum(errs) / len(errs)
+    ok = mean <= bounds[name]
+    failed = failed or not ok
+    print("%-16s mean error %6.2f%%, max %6.2f%% over %d states "
+          "(bound %.1f%%) %s" % (name, 100 * mean, 100 * max(errs),
+                                 len(errs), 100 * bounds[name],
+                                 'ok' if ok else 'FAIL'))
+
+if not errors:
+    print("No traffic reached the memory")
+    failed = True
+sys.exit(1 if failed else 0)
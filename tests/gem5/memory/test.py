@@ -87,3 +87,14 @@ for basename_noext, args in null_tests:
         valid_isas=(constants.null_tag,),
         valid_hosts=constants.supported_hosts,
     )
+
+# Compare the analytical timing of the memory controller against the
+# detailed one on the DRAM and NVM traffic generators
+for mem in ('dram', 'nvm'):
+    gem5_verify_config(
+        name='analytical_timing_' + mem,
+        verifiers=(), # No need for verfiers this will return non-zero on fail
+        config=joinpath(getcwd(), 'analytical-run.py'),
+        config_args=['--mem', mem],
+        valid_isas=(constants.null_tag,),
+    )
@@ -0,0 +1,50 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+'''
+Switch from an atomic to a timing CPU in the middle of a CPU test
+workload, and check that the TLB translations handed over to the timing
+CPU save TLB misses compared with flushing its TLBs at the switch.
+'''
+
+from testlib import *
+
+workload = 'Bubblesort'
+isa = constants.gcn3_x86_tag
+
+path = joinpath(config.bin_path, 'cpu_tests', isa.lower())
+url = config.resource_url + '/gem5/cpu_tests/benchmarks/bin/x86/' + workload
+workload_binary = DownloadedProgram(url, path, workload)
+binary = joinpath(workload_binary.path, workload)
+
+gem5_verify_config(
+    name='tlb_handover_{}'.format(workload),
+    verifiers=(), # No need for verifiers, this returns non-zero on fail
+    config=joinpath(getcwd(), 'tlb-handover-run.py'),
+    config_args=[binary],
+    valid_isas=(isa,),
+    fixtures=[workload_binary]
+)
@@ -0,0 +1,115 @@
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Run a binary on an atomic CPU, switch to a timing CPU and count the
+# TLB misses of the timing CPU right after the switch. This is done
+# twice in separate processes, once with the translations handed over
+# to the timing CPU and once with its TLBs flushed after the switch.
+# The handed over translations must save misses, and the config exits
+# with a non-zero status if they do not.
+
+import argparse
+import multiprocessing
+import sys
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser()
+parser.add_argument('binary', type=str)
+args = parser.parse_args()
+
+warm_ticks = m5.ticks.fromSeconds(100e-6)
+window_ticks = m5.ticks.fromSeconds(10e-6)
+
+system = System()
+system.workload = SEWorkload.init_compatible(args.binary)
+system.clk_domain = SrcClockDomain(clock='1GHz',
+                                   voltage_domain=VoltageDomain())
+system.mem_mode = 'atomic'
+system.mem_ranges = [AddrRange('512MB')]
+system.membus = SystemXBar()
+
+system.cpu = AtomicSimpleCPU()
+system.cpu.workload = Process(cmd=[args.binary])
+system.cpu.createThreads()
+system.cpu.icache_port = system.membus.cpu_side_ports
+system.cpu.dcache_port = system.membus.cpu_side_ports
+system.cpu.createInterruptController()
+system.cpu.interrupts[0].pio = system.membus.mem_side_ports
+system.cpu.interrupts[0].int_requestor = system.membus.cpu_side_ports
+system.cpu.interrupts[0].int_responder = system.membus.mem_side_ports
+
+# The timing CPU takes over the ports, the thread and the interrupt
+# controller of the atomic CPU at the switch
+system.switch_cpu = TimingSimpleCPU(switched_out=True)
+system.switch_cpu.workload = system.cpu.workload
+system.switch_cpu.isa = system.cpu.isa
+
+system.mem_ctrl = SimpleMemory(range=system.mem_ranges[0])
+system.mem_ctrl.port = system.membus.mem_side_ports
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system=False, system=system)
+
+def tlbMisses(cpu):
+    return sum(tlb.resolveStat(stat).value
+               for tlb in (cpu.mmu.itb, cpu.mmu.dtb)
+               for stat in ('rdMisses', 'wrMisses'))
+
+def run(flush, result):
+    m5.instantiate()
+    exit_event = m5.simulate(warm_ticks)
+    if exit_event.getCause() != 'simulate() limit reached':
+        print("The binary exited before the switch")
+        sys.exit(1)
+
+    m5.switchCpus(system, [ (system.cpu, system.switch_cpu) ])
+    if flush:
+        system.switch_cpu.flushTLBs()
+
+    m5.stats.reset()
+    m5.simulate(window_ticks)
+    result.value = tlbMisses(system.switch_cpu)
+    sys.exit(0)
+
+misses = {}
+for flush in (False, True):
+    # Each run needs its own process, as a process can only instantiate
+    # the simulated system once
+    result = multiprocessing.Value('d')
+    p = multiprocessing.Process(target=run, args=(flush, result))
+    p.start()
+    p.join()
+    if p.exitcode != 0:
+        print("The run %s flushing the TLBs failed" %
+              ('with' if flush else 'without'), file=sys.stderr)
+        sys.exit(1)
+    misses[flush] = result.value
+
+print("TLB misses after the switch: %d handed over, %d flushed" %
+      (misses[False], misses[True]))
+sys.exit(0 if misses[False] < misses[True] else 1)
@@ -0,0 +1,310 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script converts gem5 traces between the protobuf format, as
+# written by ProtoOutputStream, and the columnar block-compressed format,
+# as written by ColumnarOutputStream (see src/proto/columnar_io.hh). The
+# direction of the conversion is picked based on the magic number of the
+# input. As both formats hold the same messages, the conversion works on
+# the wire format of the records and applies to any trace, e.g. elastic
+# data dependency and instruction fetch traces or packet traces.
+#
+# Usage: convert_trace_format.py [--block-records N] <input> <output>
+#
+# A protobuf output is gzipped if its name ends with .gz.
+
+import argparse
+import gzip
+import struct
+import sys
+import zlib
+
+import protolib
+
+COLUMNAR_MAGIC = 0x74633567
+COLUMNAR_VERSION = 1
+PROTO_MAGIC = b'gem5'
+
+# Column kinds of the columnar format, and the protobuf wire types they
+# correspond to
+VARINT, BYTES, FIXED32, FIXED64 = range(4)
+WIRE_TYPE = { VARINT : 0, FIXED64 : 1, BYTES : 2, FIXED32 : 5 }
+KIND = { wire : kind for kind, wire in WIRE_TYPE.items() }
+
+MASK64 = (1 << 64) - 1
+
+def putVarint(buf, value):
+    while value >= 0x80:
+        buf.append((value & 0x7f) | 0x80)
+        value >>= 7
+    buf.append(value)
+
+def getVarint(buf, pos):
+    result = 0
+    shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        result |= (b & 0x7f) << shift
+        if not (b & 0x80):
+            return result, pos
+        shift += 7
+
+def splitRecord(record):
+    """
+    Split a serialized record into a list of (field number, kind, value)
+    tuples, where the value is an integer or a byte string.
+    """
+    fields = []
+    pos = 0
+    while pos < len(record):
+        tag, pos = getVarint(record, pos)
+        number, wire = tag >> 3, tag & 0x7
+        if wire not in KIND:
+            print("Unsupported wire type", wire, "of field", number)
+            exit(-1)
+        kind = KIND[wire]
+        if kind == VARINT:
+            value, pos = getVarint(record, pos)
+        elif kind == FIXED32:
+            value = struct.unpack_from('<I', record, pos)[0]
+            pos += 4
+        elif kind == FIXED64:
+            value = struct.unpack_from('<Q', record, pos)[0]
+            pos += 8
+        else:
+            size, pos = getVarint(record, pos)
+            value = bytes(record[pos:pos + size])
+            pos += size
+        fields.append((number, kind, value))
+    return fields
+
+def readProtoMessages(proto_in):
+    """
+    Generate the serialized messages of a protobuf trace, the header
+    first.
+    """
+    while True:
+        size, _ = protolib._DecodeVarint32(proto_in)
+        if size == 0:
+            return
+        yield proto_in.read(size)
+
+def encodeBlock(records):
+    """
+    Encode a block of split records as the column table followed by the
+    counts and values of each column.
+    """
+    numbers = sorted(set((number, kind) for fields in records
+                         for number, kind, _ in fields))
+    if len(set(number for number, _ in numbers)) != len(numbers):
+        print("Fields change their wire type within the trace")
+        exit(-1)
+
+    block = bytearray()
+    putVarint(block, len(numbers))
+    data = bytearray()
+    for number, kind in numbers:
+        counts = bytearray()
+        values = bytearray()
+        last = 0
+        for fields in records:
+            field_values = [ v for n, _, v in fields if n == number ]
+            putVarint(counts, len(field_values))
+            for value in field_values:
+                if kind == BYTES:
+                    putVarint(values, len(value))
+                    values += value
+                    continue
+                delta = (value - last) & MASK64
+                if delta >> 63:
+                    delta -= 1 << 64
+                putVarint(values, ((delta << 1) ^ (delta >> 63)) & MASK64)
+                last = value
+        putVarint(block, number)
+        block.append(kind)
+        putVarint(block, len(counts))
+        putVarint(block, len(values))
+        data += counts + values
+
+    # The leading field of the first record is the key of the block
+    key = 0
+    if numbers and numbers[0][1] != BYTES:
+        key = next((v for n, _, v in records[0] if n == numbers[0][0]), 0)
+    return bytes(block + data), key
+
+def protoToColumnar(proto_in, out, block_records):
+    messages = readProtoMessages(proto_in)
+    header = next(messages, None)
+    if header is None:
+        print("Trace has no header")
+        exit(-1)
+    out.write(struct.pack('<III', COLUMNAR_MAGIC, COLUMNAR_VERSION,
+                          len(header)))
+    out.write(header)
+    offset = 12 + len(header)
+
+    index = []
+    num_records = 0
+    records = []
+    def flush():
+        nonlocal offset, num_records
+        raw, key = encodeBlock(records)
+        compressed = zlib.compress(raw, 1)
+        index.append((offset, num_records, key))
+        out.write(struct.pack('<III', len(records), len(raw),
+                              len(compressed)))
+        out.write(compressed)
+        offset += 12 + len(compressed)
+        num_records += len(records)
+        del records[:]
+
+    for message in messages:
+        records.append(splitRecord(message))
+        if len(records) == block_records:
+            flush()
+    if records:
+        flush()
+
+    out.write(struct.pack('<III', 0, 0, 0))
+    for entry in index:
+        out.write(struct.pack('<QQQ', *entry))
+    out.write(struct.pack('<QQI', offset + 12, len(index), COLUMNAR_MAGIC))
+    return num_records
+
+def columnarToProto(col_in, out):
+    preamble = col_in.read(12)
+    magic, version, header_size = struct.unpack('<III', preamble)
+    if version != COLUMNAR_VERSION:
+        print("Unsupported columnar trace version", version)
+        exit(-1)
+    out.write(PROTO_MAGIC)
+    header = col_in.read(header_size)
+    protolib._EncodeVarint32(out, len(header))
+    out.write(header)
+
+    num_records = 0
+    while True:
+        block_header = col_in.read(12)
+        if len(block_header) < 12:
+            break
+        count, raw_size, compressed_size = struct.unpack('<III',
+                                                         block_header)
+        if count == 0:
+            break
+        compressed = col_in.read(compressed_size)
+        if len(compressed) < compressed_size:
+            print("Trace ends in a truncated block")
+            break
+        raw = zlib.decompress(compressed)
+
+        pos = 0
+        num_columns, pos = getVarint(raw, pos)
+        columns = []
+        for _ in range(num_columns):
+            number, pos = getVarint(raw, pos)
+            kind = raw[pos]
+            pos += 1
+            counts_size, pos = getVarint(raw, pos)
+            values_size, pos = getVarint(raw, pos)
+            columns.append([number, kind, counts_size, values_size])
+        for column in columns:
+            counts_pos = pos
+            values_pos = pos + column[2]
+            pos = values_pos + column[3]
+            # Cursors into the counts and values, and the last value
+            column[2:] = [counts_pos, values_pos, 0]
+
+        for _ in range(count):
+            record = bytearray()
+            for column in columns:
+                number, kind, counts_pos, values_pos, last = column
+                n, counts_pos = getVarint(raw, counts_pos)
+                tag = (number << 3) | WIRE_TYPE[kind]
+                for _ in range(n):
+                    putVarint(record, tag)
+                    if kind == BYTES:
+                        size, values_pos = getVarint(raw, values_pos)
+                        putVarint(record, size)
+                        record += raw[values_pos:values_pos + size]
+                        values_pos += size
+                        continue
+                    zigzag, values_pos = getVarint(raw, values_pos)
+                    delta = (zigzag >> 1) ^ -(zigzag & 1)
+                    last = (last + delta) & MASK64
+                    if kind == FIXED32:
+                        record += struct.pack('<I', last & 0xffffffff)
+                    elif kind == FIXED64:
+                        record += struct.pack('<Q', last)
+                    else:
+                        putVarint(record, last)
+                column[2:] = [counts_pos, values_pos, last]
+            protolib._EncodeVarint32(out, len(record))
+            out.write(record)
+        num_records += count
+    return num_records
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert gem5 traces between the protobuf and the "
+        "columnar format")
+    parser.add_argument("--block-records", type=int, default=4096,
+                        help="Number of records in a block of a columnar "
+                        "output")
+    parser.add_argument("input", help="Trace to convert")
+    parser.add_argument("output", help="Converted trace")
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        magic = f.read(4)
+    to_proto = len(magic) == 4 and \
+        struct.unpack('<I', magic)[0] == COLUMNAR_MAGIC
+
+    if to_proto:
+        trace_in = open(args.input, 'rb')
+        if args.output.endswith('.gz'):
+            trace_out = gzip.open(args.output, 'wb')
+        else:
+            trace_out = open(args.output, 'wb')
+        num_records = columnarToProto(trace_in, trace_out)
+    else:
+        trace_in = protolib.openFileRd(args.input)
+        if trace_in.read(4) != PROTO_MAGIC:
+            print("Unrecognized file")
+            exit(-1)
+        trace_out = open(args.output, 'wb')
+        num_records = protoToColumnar(trace_in, trace_out,
+                                      args.block_records)
+
+    trace_in.close()
+    trace_out.close()
+    print("Converted", num_records, "records to the",
+          "protobuf" if to_proto else "columnar", "format")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script checks the analytical timing mode of the memory
+# controller against the detailed DRAM and NVM command scheduling. It
+# runs the sweep of configs/dram/sweep.py, or configs/nvm/sweep.py for
+# the NVM mode, twice, once with each model, and compares the
+# bandwidth, read latency and, for DRAM, row hit rate of every state of
+# the sweep, that is every combination of stride and number of banks.
+# The script fails if the mean error of any of them is beyond its
+# bound, e.g.
+#
+#   util/dram_analytical_check.py build/X86/gem5.opt \
+#       --rd-perc 100 --rd-perc 70 --mode DRAM --mode DRAM_ROTATE \
+#       --mode NVM
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# Stats of the memory interface that are compared, and the mean relative
+# error, or absolute for the row hit rate, each is allowed
+checked_stats = {
+    'avgRdBW' : ('bw_tol', True),
+    'avgWrBW' : ('bw_tol', True),
+    'avgMemAccLat' : ('lat_tol', True),
+    'pageHitRate' : ('hit_tol', False),
+}
+
+stat_re = re.compile(
+    r'^\S*mem_ctrls\d*\.(?:dram|nvm)\.(\w+)\s+([-\d.e+naif]+)')
+
+def parse_dumps(stats_file):
+    """Return the checked stats of every dump in a stats file."""
+    dumps = []
+    with open(stats_file) as f:
+        for line in f:
+            if line.startswith('---------- Begin'):
+                dumps.append({})
+                continue
+            m = stat_re.match(line)
+            if m and dumps and m.group(1) in checked_stats:
+                dumps[-1][m.group(1)] = float(m.group(2))
+    return dumps
+
+def run_sweep(args, outdir, script, extra):
+    cmd = [args.gem5, '-d', outdir, script] + extra
+    print(' '.join(cmd))
+    with open(outdir + '.log', 'w') as log:
+        status = subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT)
+    if status != 0:
+        sys.exit("Error: %s failed, see %s.log" % (' '.join(cmd), outdir))
+    return parse_dumps(os.path.join(outdir, 'stats.txt'))
+
+def compare(args, detailed, analytical):
+    """Print the error of every stat and return whether all are in
+    bounds."""
+    ok = True
+    for stat, (tol_name, relative) in sorted(checked_stats.items()):
+        errors = []
+        for ref, val in zip(detailed, analytical):
+            if stat not in ref or stat not in val:
+                continue
+            if relative:
+                # skip states where the stat does not apply, e.g. the
+                # write bandwidth of a read-only sweep
+                if ref[stat] == 0 or ref[stat] != ref[stat]:
+                    continue
+                errors.append(abs(val[stat] - ref[stat]) / ref[stat])
+            else:
+                errors.append(abs(val[stat] - ref[stat]) / 100.0)
+        if not errors:
+            continue
+        tol = getattr(args, tol_name)
+        mean = sum(errors) / len(errors)
+        status = 'ok' if mean <= tol else 'FAIL'
+        ok = ok and mean <= tol
+        print("  %-14s mean error %6.2f%%, max %6.2f%% over %d states "
+              "(bound %.1f%%) %s" % (stat, 100 * mean, 100 * max(errors),
+                                     len(errors), 100 * tol, status))
+    return ok
+
+parser = argparse.ArgumentParser(
+    description="Check the analytical DRAM timing against the detailed "
+    "model")
+parser.add_argument('gem5', help="gem5 binary to run")
+parser.add_argument('--outdir', default='m5out/analytical_check',
+                    help="Directory for the output of the runs")
+parser.add_argument('--mem-type', default='DDR3_1600_8x8',
+                    help="DRAM type to check")
+parser.add_argument('--nvm-type', default='NVM_2400_1x64',
+                    help="NVM type to check")
+parser.add_argument('--mode', action='append',
+                    help="Sweep mode(s), DRAM, DRAM_ROTATE and/or NVM")
+parser.add_argument('--rd-perc', type=int, action='append',
+                    help="Percentage(s) of reads")
+parser.add_argument('--bw-tol', type=float, default=0.1,
+                    help="Bound on the mean relative bandwidth error")
+parser.add_argument('--lat-tol', type=float, default=0.2,
+                    help="Bound on the mean relative read latency error")
+parser.add_argument('--hit-tol', type=float, default=0.1,
+                    help="Bound on the mean absolute row hit rate error")
+
+args = parser.parse_args()
+
+ok = True
+for mode in args.mode or ['DRAM']:
+    for rd_perc in args.rd_perc or [100]:
+        if mode == 'NVM':
+            mem_type = args.nvm_type
+            script = 'configs/nvm/sweep.py'
+            extra = ['--nvm-type', mem_type]
+        else:
+            mem_type = args.mem_type
+            script = 'configs/dram/sweep.py'
+            extra = ['--mem-type', mem_type]
+        name = '%s_%s_%d' % (mem_type, mode, rd_perc)
+        extra += ['--mode', mode, '--rd_perc', str(rd_perc)]
+        results = []
+        for model in ['detailed', 'analytical']:
+            outdir = os.path.join(args.outdir, name, model)
+            os.makedirs(outdir, exist_ok=True)
+            results.append(run_sweep(args, outdir, script, extra +
+                (['--analytical-timing'] if model == 'analytical' else [])))
+        print("%s:" % name)
+        ok = compare(args, *results) and ok
+
+if not ok:
+    sys.exit("Error: the analytical timing is out of bounds")
+
+print("The analytical timing is within bounds")
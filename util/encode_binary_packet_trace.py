@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2021 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script converts a protobuf packet trace, as recorded by the
+# MemTraceProbe, to the binary packet trace format that the TraceGen
+# maps into memory (see src/cpu/testers/traffic_gen/binary_trace.hh).
+# The binary trace has fixed-size records, and is therefore larger than
+# the gzipped protobuf trace, but it can be replayed without decoding.
+#
+# Usage: encode_binary_packet_trace.py <protobuf input> <binary output>
+
+import os
+import protolib
+import struct
+import subprocess
+import sys
+
+util_dir = os.path.dirname(os.path.realpath(__file__))
+# Make sure the proto definitions are up to date.
+subprocess.check_call(['make', '--quiet', '-C', util_dir, 'packet_pb2.py'])
+import packet_pb2
+
+BINARY_MAGIC = 0x70623567
+BINARY_VERSION = 1
+
+# Header: magic, version, tick frequency, number of records, record size
+HEADER = struct.Struct('<IIQQII')
+# Record: tick, address, size, flags, command
+RECORD = struct.Struct('<QQIIII')
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: ", sys.argv[0], " <protobuf input> <binary output>")
+        exit(-1)
+
+    # Open the file in read mode
+    proto_in = protolib.openFileRd(sys.argv[1])
+
+    try:
+        binary_out = open(sys.argv[2], 'wb')
+    except IOError:
+        print("Failed to open ", sys.argv[2], " for writing")
+        exit(-1)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4).decode()
+
+    if magic_number != "gem5":
+        print("Unrecognized file", sys.argv[1])
+        exit(-1)
+
+    header = packet_pb2.PacketHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    print("Object id:", header.obj_id)
+    print("Tick frequency:", header.tick_freq)
+
+    # Leave room for the header, which is written once the number of
+    # records is known
+    binary_out.write(bytes(HEADER.size))
+
+    num_packets = 0
+    packet = packet_pb2.Packet()
+    while protolib.decodeMessage(proto_in, packet):
+        num_packets += 1
+        binary_out.write(RECORD.pack(packet.tick, packet.addr, packet.size,
+                                     packet.flags, packet.cmd, 0))
+
+    binary_out.seek(0)
+    binary_out.write(HEADER.pack(BINARY_MAGIC, BINARY_VERSION,
+                                 header.tick_freq, num_packets,
+                                 RECORD.size, 0))
+
+    print("Converted packets:", num_packets)
+
+    binary_out.close()
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()